@@ -43,7 +43,7 @@
 void layout_test_simple(struct dm_disk_if *d) {
   int c, lbn, count = 0, runlbn = 0;
   struct dm_pbn pbn, trkpbn = {0,0,0};
-  printf("got a dm_disk with %d sectors!\n", d->dm_sectors);
+  printf("got a dm_disk with %lld sectors!\n", d->dm_sectors);
 
   for(c = 0; c < d->dm_sectors; c ++) {
     int lbn2;
@@ -421,7 +421,7 @@ void layout_test_trackbound(struct dm_disk_if *d) {
   int lbn = 55000;
 
   for(c = 0; c < 1000; c++) {
-    int l1, l2;
+    dm_lbn_t l1, l2;
     struct dm_pbn pbn;
     int remapsector = 0;
 
@@ -429,7 +429,7 @@ void layout_test_trackbound(struct dm_disk_if *d) {
 
     d->layout->dm_get_track_boundaries(d, &pbn, &l1, &l2, &remapsector);
 
-    printf("test_trackbound: %d -> (%d, %d) (%d)\n", lbn, l1, l2, remapsector);
+    printf("test_trackbound: %d -> (%lld, %lld) (%d)\n", lbn, l1, l2, remapsector);
     ddbg_assert((l1 <= lbn) && (lbn <= l2));
 
     lbn +=  (d->layout->dm_get_sectors_lbn(d, lbn) + 13); 
@@ -564,7 +564,7 @@ void test_zonefoo(struct dm_disk_if *d) {
   printf("got %d zones\n", nz);
   for(i = 0; i < nz; i++) {
     d->layout->dm_get_zone(d, i, &z);
-    printf("zone %2d: %d (%d,%d) (%d,%d)\n", 
+    printf("zone %2d: %d (%d,%d) (%lld,%lld)\n", 
 	   i, z.spt,
 	   z.cyl_low, z.cyl_high,
 	   z.lbn_low, z.lbn_high);
@@ -95,13 +95,15 @@ dm_angle_t  dm_angle_dtoi(double);
 
 
 // this tries to be compatible with disksim
-typedef enum {
+// nonnegative results are lbns
+enum {
   DM_SLIPPED = -1,   // may also include unused spares XXX is this right?
   DM_REMAPPED = -2,
   DM_OK = -3,
   DM_NX = -4         // doesn't exist -- there are holes in the cyl space
                      // on e.g. atlas10k
-} dm_ptol_result_t;
+};
+typedef dm_lbn_t dm_ptol_result_t;
 
 
 typedef enum {
@@ -157,8 +159,8 @@ typedef enum {
 struct dm_layout_zone {
   int spt;  // number of sectors per track
 
-  int lbn_low;
-  int lbn_high;
+  dm_lbn_t lbn_low;
+  dm_lbn_t lbn_high;
 
   int cyl_low;
   int cyl_high;
@@ -174,14 +176,14 @@ struct dm_layout_if {
   // of disksim's global of the same name.
   dm_ptol_result_t
   (*dm_translate_ltop)(struct dm_disk_if *, 
-		       int lbn, 
+		       dm_lbn_t lbn, 
 		       dm_layout_maptype,
 		       struct dm_pbn *result,
 		       int *remapsector);
 
   dm_ptol_result_t
   (*dm_translate_ltop_0t)(struct dm_disk_if *, 
-			  int lbn, 
+			  dm_lbn_t lbn, 
 			  dm_layout_maptype,
 			  struct dm_pbn *result,
 			  int *remapsector);
@@ -203,7 +205,7 @@ struct dm_layout_if {
   // the number of physical sectors on the track containing the given lbn
   int
   (*dm_get_sectors_lbn)(struct dm_disk_if *d,
-			int lbn);
+			dm_lbn_t lbn);
   
   // as above for pbns
   int
@@ -220,8 +222,8 @@ struct dm_layout_if {
   dm_ptol_result_t
   (*dm_get_track_boundaries)(struct dm_disk_if *d,
 			     struct dm_pbn *,
-			     int *first_lbn,
-			     int *last_lbn,
+			     dm_lbn_t *first_lbn,
+			     dm_lbn_t *last_lbn,
 			     int *remapsector);
 
 
@@ -230,8 +232,8 @@ struct dm_layout_if {
   // the LBNs may be slipped or remapped.
   dm_ptol_result_t
   (*dm_seek_distance)(struct dm_disk_if *,
-		      int start_lbn,
-		      int dest_lbn);
+		      dm_lbn_t start_lbn,
+		      dm_lbn_t dest_lbn);
 
   // Compute the starting offset of a pbn relative to 0.  This
   // accounts for all skews, slips, etc.
@@ -278,8 +280,8 @@ struct dm_layout_if {
   // Compute the angular distance/offset between two logical blocks.
   dm_angle_t
   (*dm_lbn_offset)(struct dm_disk_if *,
-		   int lbn1,
-		   int lbn2);
+		   dm_lbn_t lbn1,
+		   dm_lbn_t lbn2);
 
 
   // how big will this layout struct be when marshaled
@@ -482,7 +484,7 @@ struct dm_disk_if {
 
   //  int dm_tracks;  // what needs this?
   int dm_surfaces;
-  int dm_sectors;
+  dm_lbn_t dm_sectors;
 
 
   struct dm_layout_if   *layout;
@@ -73,6 +73,9 @@ typedef int64_t dm_time_t;
 
 typedef uint64_t dm_pbn_t;
 
+// logical block numbers, and counts of them
+typedef long long dm_lbn_t;
+
 
 #ifdef __cplusplus
 }
@@ -135,10 +135,10 @@ addmult(dm_angle_t start, int mult, dm_angle_t q, dm_angle_t x)
 
 // optimize these someday (binsearch, maybe)
 static struct dm_layout_g1_band *
-find_band_lbn(struct dm_layout_g1 *l, int lbn)
+find_band_lbn(struct dm_layout_g1 *l, dm_lbn_t lbn)
 {
   struct dm_layout_g1_band *b = &l->bands[0];
-  int bandstart = 0;
+  dm_lbn_t bandstart = 0;
   int bandno = 0;
 
   while((lbn >= b->blksinband) || (lbn < 0)) {
@@ -154,7 +154,7 @@ find_band_lbn(struct dm_layout_g1 *l, int lbn)
 }
 
 static int 
-g1_st_lbn(struct dm_disk_if *d, int lbn) {
+g1_st_lbn(struct dm_disk_if *d, dm_lbn_t lbn) {
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_lbn(l, lbn);
   return b->blkspertrack;
@@ -487,7 +487,7 @@ g1_ptol_nosparing(struct dm_disk_if *d,
 {
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
   struct dm_pbn pbn = *p;
 
   p = &pbn;
@@ -528,7 +528,7 @@ g1_ptol_sectpertrackspare(struct dm_disk_if *d,
   int firstblkoncyl;
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
   struct dm_pbn pbn = *p;
   p = &pbn;
 
@@ -606,7 +606,7 @@ g1_ptol_sectpercylspare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
   struct dm_pbn pbn = *p;
   p = &pbn;
 
@@ -697,7 +697,7 @@ g1_ptol_sectperrangespare(struct dm_disk_if *d,
   
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
 
   struct dm_pbn pbn = *p;
   p = &pbn;
@@ -774,7 +774,7 @@ g1_ptol_sectperzonespare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
 
   struct dm_pbn pbn = *p;
   p = &pbn;
@@ -847,7 +847,7 @@ g1_ptol_trackspare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
 
   struct dm_pbn pbn = *p;
   p = &pbn;
@@ -924,15 +924,15 @@ g1_ptol_trackspare(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_nosparing(struct dm_disk_if *d,
 			      struct dm_pbn *p,
-			      int *first_lbn,
-			      int *last_lbn,
+			      dm_lbn_t *first_lbn,
+			      dm_lbn_t *last_lbn,
 			      int *remapsector)
 {
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
-  int temp_lbn = lbn;
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t temp_lbn = lbn;
 
   //  int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -963,8 +963,8 @@ g1_track_boundaries_nosparing(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_sectpertrackspare(struct dm_disk_if *d,
 				      struct dm_pbn *p,
-				      int *first_lbn,
-				      int *last_lbn,
+				      dm_lbn_t *first_lbn,
+				      dm_lbn_t *last_lbn,
 				      int *remapsector)
 
 {
@@ -974,8 +974,8 @@ g1_track_boundaries_sectpertrackspare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
-  int temp_lbn = lbn;
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t temp_lbn = lbn;
 
   int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -1014,8 +1014,8 @@ g1_track_boundaries_sectpertrackspare(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_sectpercylspare(struct dm_disk_if *d,
 				    struct dm_pbn *p,
-				    int *first_lbn,
-				    int *last_lbn,
+				    dm_lbn_t *first_lbn,
+				    dm_lbn_t *last_lbn,
 				    int *remapsector)
 
 {
@@ -1026,8 +1026,8 @@ g1_track_boundaries_sectpercylspare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
-  int temp_lbn = lbn;
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t temp_lbn = lbn;
 
   //  int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -1101,8 +1101,8 @@ g1_track_boundaries_sectpercylspare(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_sectperrangespare(struct dm_disk_if *d,
 				      struct dm_pbn *p,
-				      int *first_lbn,
-				      int *last_lbn,
+				      dm_lbn_t *first_lbn,
+				      dm_lbn_t *last_lbn,
 				      int *remapsector)
 
 {
@@ -1114,8 +1114,8 @@ g1_track_boundaries_sectperrangespare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
-  int temp_lbn = lbn;
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t temp_lbn = lbn;
 
   //  int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -1184,8 +1184,8 @@ g1_track_boundaries_sectperrangespare(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_sectperzonespare(struct dm_disk_if *d,
 				     struct dm_pbn *p,
-				     int *first_lbn,
-				     int *last_lbn,
+				     dm_lbn_t *first_lbn,
+				     dm_lbn_t *last_lbn,
 				     int *remapsector)
 {
   /* lbn equals first block in band */
@@ -1195,8 +1195,8 @@ g1_track_boundaries_sectperzonespare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
-  int temp_lbn = lbn;
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t temp_lbn = lbn;
 
   //  int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -1273,8 +1273,8 @@ g1_track_boundaries_sectperzonespare(struct dm_disk_if *d,
 dm_ptol_result_t
 g1_track_boundaries_trackspare(struct dm_disk_if *d,
 			       struct dm_pbn *p,
-			       int *first_lbn,
-			       int *last_lbn,
+			       dm_lbn_t *first_lbn,
+			       dm_lbn_t *last_lbn,
 			       int *remapsector)
 {
   int i;
@@ -1284,7 +1284,8 @@ g1_track_boundaries_trackspare(struct dm_disk_if *d,
 
   struct dm_layout_g1 *l = (struct dm_layout_g1 *)d->layout;
   struct dm_layout_g1_band *b = find_band_pbn(l, p);
-  int lbn = l->band_blknos[b->num];
+  dm_lbn_t lbn = l->band_blknos[b->num];
+  dm_lbn_t blkno;
 
   //  int lbnspertrack = b->blkspertrack - b->sparecnt;
 
@@ -1320,7 +1321,7 @@ g1_track_boundaries_trackspare(struct dm_disk_if *d,
     lbn = DM_SLIPPED;
   }
 
-  p->sector = lbn + (trackno * b->blkspertrack) - b->deadspace;
+  blkno = lbn + (trackno * b->blkspertrack) - b->deadspace;
 
 
 
@@ -1329,21 +1330,21 @@ g1_track_boundaries_trackspare(struct dm_disk_if *d,
       *first_lbn = lbn;
     }
     else {
-      *first_lbn = ((p->sector + b->blkspertrack) <= lbn) 
+      *first_lbn = ((blkno + b->blkspertrack) <= lbn) 
 	? DM_SLIPPED 
-	: max(p->sector, lbn);
+	: max(blkno, lbn);
     }
   }
 
   if(last_lbn) {
-    p->sector += (b->blkspertrack - 1);
+    blkno += (b->blkspertrack - 1);
     if(lbn < 0) {
       *last_lbn = lbn;
     }
     else {
-      *last_lbn = (p->sector <= lbn) 
+      *last_lbn = (blkno <= lbn) 
 	? DM_SLIPPED 
-	: p->sector;
+	: blkno;
     }
   }
 
@@ -1356,7 +1357,7 @@ g1_track_boundaries_trackspare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_0t(struct dm_disk_if *d, 
-		  int lbn, 
+		  dm_lbn_t lbn,
 		  dm_layout_maptype maptype,
 		  struct dm_pbn *result,
 		  int *remapsector)
@@ -1396,7 +1397,7 @@ g1_ltop_0t(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_nosparing(struct dm_disk_if *d, 
-		  int lbn, 
+		  dm_lbn_t lbn,
 		  dm_layout_maptype maptype,
 		  struct dm_pbn *result,
 		  int *remapsector)
@@ -1411,11 +1412,11 @@ g1_ltop_nosparing(struct dm_disk_if *d,
   lbn += b->deadspace;
 
   blkspertrack = b->blkspertrack;
-  result->cyl = lbn / (blkspertrack * d->dm_surfaces) + b->startcyl;
+  result->cyl = (int) (lbn / (blkspertrack * d->dm_surfaces)) + b->startcyl;
 
-  result->cyl = (lbn / blkspertrack) % d->dm_surfaces;
+  result->cyl = (int) ((lbn / blkspertrack) % d->dm_surfaces);
   result->cyl = g1_surfno_on_cyl(l,b,result);
-  result->sector = lbn % blkspertrack;
+  result->sector = (int) (lbn % blkspertrack);
 
   return DM_OK;
 }
@@ -1423,7 +1424,7 @@ g1_ltop_nosparing(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_sectpertrackspare(struct dm_disk_if *d, 
-			  int lbn, 
+			  dm_lbn_t lbn,
 			  dm_layout_maptype maptype,
 			  struct dm_pbn *result,
 			  int *remapsector)
@@ -1441,7 +1442,7 @@ g1_ltop_sectpertrackspare(struct dm_disk_if *d,
   lbn -= l->band_blknos[b->num];
   lbn += b->deadspace;
 
-  trackno = lbn / lbnspertrack;
+  trackno = (int) (lbn / lbnspertrack);
 
 
 
@@ -1481,7 +1482,7 @@ g1_ltop_sectpertrackspare(struct dm_disk_if *d,
     ddbg_assert(0);
   }
   else {
-    result->sector = lbn;
+    result->sector = (int) lbn;
   }
 
   return DM_OK;
@@ -1490,7 +1491,7 @@ g1_ltop_sectpertrackspare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_sectpercylspare(struct dm_disk_if *d, 
-			int lbn, 
+			dm_lbn_t lbn,
 			dm_layout_maptype maptype,
 			struct dm_pbn *result,
 			int *remapsector)
@@ -1515,7 +1516,7 @@ g1_ltop_sectpercylspare(struct dm_disk_if *d,
   blkspercyl = blkspertrack * d->dm_surfaces;
   lbnspercyl = blkspercyl - b->sparecnt;
 
-  cyl = lbn / lbnspercyl;
+  cyl = (int) (lbn / lbnspercyl);
   lbn = lbn % lbnspercyl;
 
   if ((maptype == MAP_ADDSLIPS) || (maptype == MAP_FULL)) {
@@ -1538,22 +1539,22 @@ g1_ltop_sectpercylspare(struct dm_disk_if *d,
 	{
 	  if(remapsector) *remapsector = 1;
 	  lbn = b->remap[i];
-	  cyl = lbn / blkspercyl;
+	  cyl = (int) (lbn / blkspercyl);
 	  lbn = lbn % blkspercyl;
 	  goto g1_ltop_sectpercylspare_done;
 	}
     }
   }
    
-  cyl += lbn / lbnspercyl;
+  cyl += (int) (lbn / lbnspercyl);
   lbn = lbn % lbnspercyl;
 
  g1_ltop_sectpercylspare_done:
   
   result->cyl = cyl + b->startcyl;
-  result->head = lbn / blkspertrack;
+  result->head = (int) (lbn / blkspertrack);
   result->head = g1_surfno_on_cyl(l,b,result);
-  result->sector = lbn % blkspertrack;
+  result->sector = (int) (lbn % blkspertrack);
 
   return DM_OK;
 }
@@ -1563,7 +1564,7 @@ g1_ltop_sectpercylspare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_sectperrangespare(struct dm_disk_if *d, 
-			  int lbn, 
+			  dm_lbn_t lbn,
 			  dm_layout_maptype maptype,
 			  struct dm_pbn *result,
 			  int *remapsector)
@@ -1586,7 +1587,7 @@ g1_ltop_sectperrangespare(struct dm_disk_if *d,
   blkspercyl = b->blkspertrack * d->dm_surfaces;
   blksperrange = blkspercyl * l->rangesize;
   lbnsperrange = blksperrange - b->sparecnt;
-  rangeno = lbn / lbnsperrange;
+  rangeno = (int) (lbn / lbnsperrange);
 
   lbn = lbn % lbnsperrange;
 
@@ -1615,11 +1616,11 @@ g1_ltop_sectperrangespare(struct dm_disk_if *d,
 
   
   result->cyl = b->startcyl + 
-    (rangeno * l->rangesize) + (lbn / blkspercyl);
+    (rangeno * l->rangesize) + (int) (lbn / blkspercyl);
 
-  result->head = (lbn % blkspercyl) / b->blkspertrack;
+  result->head = (int) ((lbn % blkspercyl) / b->blkspertrack);
   result->head = g1_surfno_on_cyl(l,b,result);
-  result->sector = lbn % b->blkspertrack;
+  result->sector = (int) (lbn % b->blkspertrack);
 
   return DM_OK;
 }
@@ -1627,7 +1628,7 @@ g1_ltop_sectperrangespare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_sectperzonespare(struct dm_disk_if *d, 
-			 int lbn, 
+			 dm_lbn_t lbn,
 			 dm_layout_maptype maptype,
 			 struct dm_pbn *result,
 			 int *remapsector)
@@ -1664,10 +1665,10 @@ g1_ltop_sectperzonespare(struct dm_disk_if *d,
 
   blkspercyl = b->blkspertrack * d->dm_surfaces;
 
-  result->cyl = b->startcyl + lbn / blkspercyl;
-  result->head = (lbn % blkspercyl) / b->blkspertrack;
+  result->cyl = b->startcyl + (int) (lbn / blkspercyl);
+  result->head = (int) ((lbn % blkspercyl) / b->blkspertrack);
   result->head = g1_surfno_on_cyl(l,b,result);
-  result->sector = lbn % b->blkspertrack;
+  result->sector = (int) (lbn % b->blkspertrack);
 
   return DM_OK;
 }
@@ -1686,7 +1687,7 @@ g1_ltop_sectperzonespare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_ltop_trackspare(struct dm_disk_if *d, 
-		   int lbn, 
+		   dm_lbn_t lbn,
 		   dm_layout_maptype maptype,
 		   struct dm_pbn *result,
  		   int *remapsector)
@@ -1703,7 +1704,7 @@ g1_ltop_trackspare(struct dm_disk_if *d,
   lbn += b->deadspace;
 
   blkspertrack = b->blkspertrack;
-  trackno = lbn/blkspertrack;
+  trackno = (int) (lbn/blkspertrack);
   if ((maptype == MAP_ADDSLIPS) || (maptype == MAP_FULL)) {
     for (i=0; i<b->numslips; i++) {
       if (b->slip[i] <= trackno) {
@@ -1723,7 +1724,7 @@ g1_ltop_trackspare(struct dm_disk_if *d,
   result->cyl = (trackno/d->dm_surfaces) + b->startcyl;
   result->head = trackno % d->dm_surfaces;
   result->head = g1_surfno_on_cyl(l,b,result);
-  result->sector = lbn % blkspertrack;
+  result->sector = (int) (lbn % blkspertrack);
 
   return DM_OK;
 }
@@ -1731,11 +1732,11 @@ g1_ltop_trackspare(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g1_seek_distance(struct dm_disk_if *d,
-		 int start_lbn,
-		 int end_lbn)
+		 dm_lbn_t start_lbn,
+		 dm_lbn_t end_lbn)
 {
   struct dm_pbn p1, p2;
-  int rv;
+  dm_ptol_result_t rv;
 
   rv = d->layout->dm_translate_ltop(d, start_lbn, MAP_NONE, &p1, 0);
   if(rv != DM_OK) {
@@ -1772,7 +1773,7 @@ g1_get_sector_width(struct dm_disk_if *d,
 }
 
 static dm_angle_t
-g1_lbn_offset(struct dm_disk_if *d, int lbn1, int lbn2)
+g1_lbn_offset(struct dm_disk_if *d, dm_lbn_t lbn1, dm_lbn_t lbn2)
 {
   struct dm_pbn pbn1, pbn2;
   dm_angle_t a1, a2;
@@ -1799,7 +1800,7 @@ layout_g1_marshaled_len(struct dm_disk_if *d) {
   int result = sizeof(struct dm_marshal_hdr) + sizeof(struct dm_layout_g1); 
 
   // band blknos
-  result += l->bands_len * sizeof(int);
+  result += l->bands_len * sizeof(dm_lbn_t);
 
   // add the zones
   result += l->bands_len * sizeof(struct dm_layout_g1_band);
@@ -1854,8 +1855,8 @@ layout_g1_marshal(struct dm_disk_if *d, char *buff) {
   }
 
   // do the band blknos array
-  memcpy(ptr, l->band_blknos, l->bands_len * sizeof(int));
-  ptr += l->bands_len * sizeof(int);
+  memcpy(ptr, l->band_blknos, l->bands_len * sizeof(dm_lbn_t));
+  ptr += l->bands_len * sizeof(dm_lbn_t);
 
   return ptr;
 }
@@ -1910,9 +1911,9 @@ layout_g1_unmarshal(struct dm_marshal_hdr *hdr,
   }
 
   // do the band blknos array
-  l->band_blknos = malloc(l->bands_len * sizeof(int));
-  memcpy(l->band_blknos, ptr, l->bands_len * sizeof(int));
-  ptr += l->bands_len * sizeof(int);
+  l->band_blknos = malloc(l->bands_len * sizeof(dm_lbn_t));
+  memcpy(l->band_blknos, ptr, l->bands_len * sizeof(dm_lbn_t));
+  ptr += l->bands_len * sizeof(dm_lbn_t);
 
 
   l->disk = parent;
@@ -165,7 +165,7 @@ struct dm_layout_g1 {
 
   struct dm_layout_g1_band *bands;
   int bands_len;
-  int         *band_blknos;    // first lbn per band indexed by band
+  dm_lbn_t    *band_blknos;    // first lbn per band indexed by band
   dm_skew_unit_t skew_units;
 };
 
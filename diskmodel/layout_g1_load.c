@@ -100,6 +100,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include <libparam/libparam.h>
 #include <libparam/bitvector.h>
@@ -195,7 +196,7 @@ dm_layout_g1_loadparams(struct lp_block *b, struct dm_disk_if *d)
 
 
 static void checknumblocks(struct dm_layout_g1 *d) {
-  int numblocks = 0;
+  dm_lbn_t numblocks = 0;
   int i;
   // XXX kill me
   FILE *outputfile = stderr;
@@ -316,7 +317,7 @@ int disk_load_zones(struct lp_list *lst,
   }
 
   layout->bands = malloc(layout->bands_len * sizeof(struct dm_layout_g1_band));
-  layout->band_blknos = malloc(layout->bands_len * sizeof(int));
+  layout->band_blknos = malloc(layout->bands_len * sizeof(dm_lbn_t));
   bzero(layout->bands, layout->bands_len * sizeof(struct dm_layout_g1_band));
 
   result = layout->bands;
@@ -475,6 +476,11 @@ dm_layout_g1_compute_blksinband(struct dm_disk_if *d,
 
   int cylcnt = b->endcyl - b->startcyl + 1;
 
+  // lbns are 64-bit but offsets within a band (slips, defects,
+  // p->sector during translation) are ints
+  ddbg_assert3((long long)cylcnt * b->blkspertrack * d->dm_surfaces <= INT_MAX,
+	       ("Zone at cylinder %d has more than %d blocks", 
+		b->startcyl, INT_MAX));
 
   blksinband = cylcnt * b->blkspertrack * d->dm_surfaces;
   blksinband -= b->deadspace;
@@ -37,7 +37,7 @@
 
 static struct dm_layout_g2_zone *
 find_zone_lbn(struct dm_disk_if *d,
-	      int lbn)
+	      dm_lbn_t lbn)
 {
   int c;
   struct dm_layout_g2 *l = (struct dm_layout_g2 *)d->layout;
@@ -92,7 +92,7 @@ g2_nodecmp(const void *p1, const void *p2)
 
 static dm_ptol_result_t
 ltop(struct dm_disk_if *d, 
-     int lbn, 
+     dm_lbn_t lbn, 
      dm_layout_maptype mt,
      struct dm_pbn *result,
      int *remapsector)
@@ -116,7 +116,7 @@ ltop(struct dm_disk_if *d,
   }
   else {
     *result = rn->loc;
-    result->sector += (lbn - rn->lbn);
+    result->sector += (int) (lbn - rn->lbn);
     return DM_OK;
   }
 }
@@ -124,7 +124,7 @@ ltop(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 ltop_0t(struct dm_disk_if *d, 
-	int lbn, 
+	dm_lbn_t lbn, 
 	dm_layout_maptype mt,
 	struct dm_pbn *result,
 	int *remapsector)
@@ -233,7 +233,7 @@ g2_defect_count(struct dm_disk_if *d,
 
 static int
 st_lbn(struct dm_disk_if *d,
-       int lbn)
+       dm_lbn_t lbn)
 {
   struct dm_layout_g2_zone *z = find_zone_lbn(d, lbn);
   return z->st;
@@ -257,8 +257,8 @@ st_pbn(struct dm_disk_if *d,
 static void
 track_boundaries(struct dm_disk_if *d,
 		 struct dm_pbn *p,
-		 int *l1,
-		 int *l2,
+		 dm_lbn_t *l1,
+		 dm_lbn_t *l2,
 		 int *remapsector)
 {
   struct dm_pbn p1, p2;
@@ -414,11 +414,11 @@ atop(struct dm_disk_if *d,
 
 static dm_ptol_result_t
 g2_seek_distance(struct dm_disk_if *d,
-		 int start_lbn,
-		 int end_lbn)
+		 dm_lbn_t start_lbn,
+		 dm_lbn_t end_lbn)
 {
   struct dm_pbn p1, p2;
-  int rv;
+  dm_ptol_result_t rv;
 
   rv = d->layout->dm_translate_ltop(d, start_lbn, MAP_NONE, &p1, 0);
   if(rv != DM_OK) {
@@ -54,7 +54,7 @@ struct dm_layout_g2 {
 
 
 struct dm_layout_g2_node {
-  int lbn;
+  dm_lbn_t lbn;
   //  int cyl;
   //  int head;
   struct dm_pbn loc; // location of lbnlow
@@ -69,8 +69,8 @@ struct dm_layout_g2_cyl {
 };
 
 struct dm_layout_g2_surf {
-  int lbnlow;
-  int lbnhigh;
+  dm_lbn_t lbnlow;
+  dm_lbn_t lbnhigh;
   // pointers back to ltop map extents
   struct dm_layout_g2_node *extents;
   int extents_len;
@@ -82,8 +82,8 @@ struct dm_layout_g2_zone {
   int cyllow;
   int cylhigh;
 
-  int lbnlow;
-  int lbnhigh;
+  dm_lbn_t lbnlow;
+  dm_lbn_t lbnhigh;
 
   dm_angle_t csskew; // cyl switch
   dm_angle_t hsskew; // head switch
@@ -141,7 +141,7 @@ static int layout_g2_loadmap(struct dm_layout_g2 *l)
 
   curr = &l->ltop_map[0];
   // ltop map
-  while(fscanf(fd, "lbn %d --> cyl %d, head %d, sect %d, %s %d\n",
+  while(fscanf(fd, "lbn %lld --> cyl %d, head %d, sect %d, %s %d\n",
 	       &curr->lbn,
 	       &curr->loc.cyl,
 	       &curr->loc.head,
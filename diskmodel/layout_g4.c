@@ -37,7 +37,7 @@
 #define __inline__ __inline
 #endif
 
-static inline int min(int x, int y) {
+static inline dm_lbn_t min(dm_lbn_t x, dm_lbn_t y) {
   return x < y ? x : y;
 }
 
@@ -61,7 +61,7 @@ static inline int min(int x, int y) {
 
 static int
 slipcount_bins(struct dm_layout_g4 *l,
-	       int lbn,
+	       dm_lbn_t lbn,
 	       int low,
 	       int high)
 {
@@ -86,11 +86,11 @@ slipcount_bins(struct dm_layout_g4 *l,
 
 static int 
 slipcount(struct dm_layout_g4 *l,
-	  int lbn)
+	  dm_lbn_t lbn)
 {
   int i;
   int ct;
-  int l2 = lbn;
+  dm_lbn_t l2 = lbn;
 
   // the upper limit of l->slips_len is not in error
   i = slipcount_bins(l, lbn, 0, l->slips_len);
@@ -110,7 +110,7 @@ slipcount(struct dm_layout_g4 *l,
 
 static int 
 slipcount_rev(struct dm_layout_g4 *l,
-	      int lbn,
+	      dm_lbn_t lbn,
 	      int *slip_len) 
 {
   int i = 0;
@@ -139,7 +139,7 @@ slipcount_rev(struct dm_layout_g4 *l,
 
 struct remap *
 remap_lbn(struct dm_layout_g4 *l,
-	  int lbn)
+	  dm_lbn_t lbn)
 {
   int i;
   struct remap *r, *result = 0;
@@ -208,8 +208,8 @@ struct g4_path *
 g4_r(struct dm_layout_g4 *l, 
      union g4_node *n,
      g4_node_t t,
-     int *lbn,
-     int max,
+     dm_lbn_t *lbn,
+     dm_lbn_t max,
      struct dm_pbn *p,
      struct g4_path *acc) // accumlator
 {
@@ -228,7 +228,7 @@ g4_r(struct dm_layout_g4 *l,
       if(n->t->low <= *lbn && *lbn <= n->t->high) {
 
 	// ?
-	resid = *lbn - n->t->low;
+	resid = (int) (*lbn - n->t->low);
 
 	nn = 0;
 	goto out;
@@ -264,10 +264,10 @@ g4_r(struct dm_layout_g4 *l,
 	if(e->lbn <= *lbn && *lbn < (e->lbn + e->runlen)) {
 	  *lbn -= e->lbn;
 
-	  quot = *lbn / e->len;
+	  quot = (int) (*lbn / e->len);
 	  // XXX
 	  quot = e->cylrunlen < 0 ? -quot : quot;
-	  resid = *lbn % e->len;
+	  resid = (int) (*lbn % e->len);
 
 	  nn = &e->child;
 	  tt = e->childtype;
@@ -330,13 +330,13 @@ g4_r(struct dm_layout_g4 *l,
 }
 
 struct g4_path *
-g4_recurse(struct dm_layout_g4 *l, int *lbn, struct dm_pbn *p) 
+g4_recurse(struct dm_layout_g4 *l, dm_lbn_t *lbn, struct dm_pbn *p) 
 {
-  int lbncopy;
+  dm_lbn_t lbncopy;
   struct dm_pbn pbncopy;
   struct g4_path *acc = calloc(1, sizeof(*acc));
   union g4_node n;
-  int max;
+  dm_lbn_t max;
 
   if(lbn) {
     lbncopy = *lbn;
@@ -362,7 +362,7 @@ g4_recurse(struct dm_layout_g4 *l, int *lbn, struct dm_pbn *p)
 
 dm_ptol_result_t
 ltop(struct dm_disk_if *d,
-     int lbn, 
+     dm_lbn_t lbn, 
      dm_layout_maptype junk,
      struct dm_pbn *result,
      int *remapsector)
@@ -376,7 +376,7 @@ ltop(struct dm_disk_if *d,
 
   if((r = remap_lbn(l, lbn))) {
     *result = r->dest;
-    result->sector += (lbn - r->off);
+    result->sector += (int) (lbn - r->off);
     return DM_OK;
     // not always -- spare remaps
     // return DM_REMAPPED;
@@ -398,7 +398,7 @@ ltop(struct dm_disk_if *d,
       n = &p->path[i];
       switch(n->type) {
       case TRACK:
-	result->sector = n->n.t->low + lbn;
+	result->sector = n->n.t->low + (int) lbn;
 	break;
 	
       case IDX:
@@ -435,7 +435,7 @@ ptol(struct dm_disk_if *d,
      struct dm_pbn *pbn,
      int *remapsector)
 {
-  int result = 0;
+  dm_lbn_t result = 0;
   struct dm_pbn pbncopy = *pbn; // we modify this
   struct remap *r;
 
@@ -504,7 +504,7 @@ ptol(struct dm_disk_if *d,
 
 static int
 g4_spt(struct dm_layout_g4 *l,
-       int *lbn,
+       dm_lbn_t *lbn,
        struct dm_pbn *pbn)
 {
   struct g4_path *p;
@@ -528,7 +528,7 @@ g4_spt(struct dm_layout_g4 *l,
 
 int
 g4_spt_lbn(struct dm_disk_if *d,
-	   int lbn)
+	   dm_lbn_t lbn)
 {
   int result;
   struct dm_layout_g4 *l = (struct dm_layout_g4 *)d->layout;
@@ -569,11 +569,11 @@ g4_spt_pbn(struct dm_disk_if *d,
 dm_ptol_result_t
 g4_track_bound(struct dm_disk_if *d,
 	       struct dm_pbn *pbn,
-	       int *l0,
-	       int *ln,
+	       dm_lbn_t *l0,
+	       dm_lbn_t *ln,
 	       int *remapsector)
 {
-  int lbn;
+  dm_lbn_t lbn;
   struct remap *r;
   struct dm_pbn pi;
   struct dm_layout_g4 *l = (struct dm_layout_g4 *)d->layout;
@@ -766,7 +766,7 @@ g4_get_zone(struct dm_disk_if *d, int n, struct dm_layout_zone *z)
   z->lbn_low = e->lbn;
   z->lbn_high = min(d->dm_sectors, e->lbn + e->runlen);
   z->cyl_low = e->cyl;
-  z->cyl_high = min(d->dm_cyls, e->cyl + e->cylrunlen);
+  z->cyl_high = (int) min(d->dm_cyls, e->cyl + e->cylrunlen);
 
 
   return 0;
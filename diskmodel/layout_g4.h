@@ -36,7 +36,7 @@ struct pat;
 struct rect;
 
 struct slip {
-  int off;
+  dm_lbn_t off;
   int count;  // positive for slips, negative for spares
 };
 
@@ -46,7 +46,7 @@ struct slip {
 
 
 struct remap {
-  int off;
+  dm_lbn_t off;
   int count;
   struct dm_pbn dest;
 
@@ -74,7 +74,7 @@ struct idx_ent {
 
   // Offset
 
-  int lbn;      // absolute if top-level, relative otherwise
+  dm_lbn_t lbn; // absolute if top-level, relative otherwise
   int cyl;      // ditto
 
   // skew to the start of each inst relative to the start of the
@@ -57,7 +57,7 @@ marshal_g4_remaps(struct remap *remaps, int n) {
     struct lp_value *v;
     struct remap *ri = &remaps[i];
 
-    v = lp_new_intv(ri->off);
+    v = lp_new_intv((int) ri->off);
     lp_list_add(l,v);
     v = lp_new_intv(ri->count);
     lp_list_add(l,v);
@@ -88,7 +88,7 @@ marshal_g4_slip(struct slip *slips, int n) {
 
   for( ; i < n; i++) {
     struct lp_value *v;
-    v = lp_new_intv(slips[i].off);
+    v = lp_new_intv((int) slips[i].off);
     lp_list_add(l,v);
     v = lp_new_intv(slips[i].count - slips[i-1].count);
     lp_list_add(l,v);
@@ -130,10 +130,10 @@ marshal_g4_idx_ent(struct idx_ent *e,
   char *ctstr; // child type
   int coffset; // offset of child in its array
 
-  printf("%s() lbn %d alen %f off %f\n", __func__, e->lbn,
+  printf("%s() lbn %lld alen %f off %f\n", __func__, e->lbn,
 	 dm_angle_itod(e->alen), dm_angle_itod(e->off));
 
-  v = lp_new_intv(e->lbn);
+  v = lp_new_intv((int) e->lbn);
   lp_list_add(l, v);
   v = lp_new_intv(e->cyl);
   lp_list_add(l, v);
@@ -216,7 +216,7 @@ get_tracetime(struct trace *t, int lbn1, int lbn2) {
 int
 adjust_lbns(struct dm_disk_if *d, int *l1, int *l2) {
   struct dm_pbn pbn;
-  int l0, ln;
+  dm_lbn_t l0, ln;
 
   if(l1) {
     d->layout->dm_translate_ltop(d, *l1, MAP_FULL, &pbn, 0);
@@ -438,7 +438,7 @@ do_idx_ent(struct dm_disk_if *d,        // diskmodel
   // li[i] contains the first lbn of the ith instance of e.
   int *li = calloc(quot, sizeof(*li));
 
-  printf("%s() lbn %d e->lbn %d alen %f off %f quot %d\n", 
+  printf("%s() lbn %d e->lbn %lld alen %f off %f quot %d\n", 
 	 __func__, lbn, e->lbn, alen, aoff, quot);
 
   if(e->alen != 0 || e->off != 0) {
@@ -518,7 +518,7 @@ do_idx_ent(struct dm_disk_if *d,        // diskmodel
     // If e is the first instance in its parent index, its offset is
     // defined to be 0.  Otherwise, correct according to the fit.
     if(e->lbn > lbn) {
-      printf("fix aoff (%d, %d)\n", lbn, e->lbn);
+      printf("fix aoff (%d, %lld)\n", lbn, e->lbn);
       aoff = fix_angle(aoff - a / period);
       e->off = dm_angle_dtoi(aoff);
     }
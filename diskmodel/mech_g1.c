@@ -285,10 +285,10 @@ dm_acctime_g1(struct dm_disk_if *d,
 	      struct dm_mech_acctimes *breakdown)
 {
   struct dm_pbn pbn = *start;
-  int lbnhigh; // highest lbn on the current track
+  dm_lbn_t lbnhigh; // highest lbn on the current track
 
-  int l;       // first lbn to read
-  int lastlbn; // last lbn to read
+  dm_lbn_t l;       // first lbn to read
+  dm_lbn_t lastlbn; // last lbn to read
 
   struct dm_mech_state s = *istate;
   struct dm_mech_state s2;
@@ -332,7 +332,7 @@ dm_acctime_g1(struct dm_disk_if *d,
     result += dm_acctime_track(d, 
 			       &s, 
 			       &pbn, 
-			       lbnhigh - l + 1, 
+			       (int) (lbnhigh - l + 1), 
 			       rw,
 			       immed,
 			       &s2,
@@ -40,10 +40,11 @@ void testsUsage(void) {
 
 int 
 layout_bogon(struct dm_disk_if *d) {
-  int lbn = 0;
-  int i, rv;
+  dm_lbn_t lbn = 0;
+  int i;
+  dm_ptol_result_t rv;
   struct dm_pbn p, p2;
-  int l0, ln;
+  dm_lbn_t l0, ln;
   int bad = 0;
 
   do {
@@ -55,7 +56,7 @@ layout_bogon(struct dm_disk_if *d) {
       p2.sector++;
       rv = d->layout->dm_translate_ptol(d, &p2, 0);
       if(rv >= 0) {
-	printf("(%d,%d,%d) -> %d  !!! max (%d,%d,%d)\n",
+	printf("(%d,%d,%d) -> %lld  !!! max (%d,%d,%d)\n",
 	       p2.cyl, p2.head, p2.sector, rv,
 	       p.cyl, p.head, p.sector);
 	bad++;
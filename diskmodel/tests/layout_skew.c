@@ -38,7 +38,8 @@ void testsUsage(void) {
 
 int 
 layout_test_simple(struct dm_disk_if *d) {
-  int count = 0, runlbn = 0, lbn = 0;
+  int count = 0, runlbn = 0;
+  dm_lbn_t lbn = 0;
   struct dm_pbn pbn, trkpbn = {0,0,0};
   int bad = 0;
 
@@ -57,7 +58,7 @@ layout_test_simple(struct dm_disk_if *d) {
     skew = d->layout->dm_pbn_skew(d, &pbn);
 
 
-    printf("%d -> (%d,%d,%d) @ %f\n", 
+    printf("%lld -> (%d,%d,%d) @ %f\n", 
 	   lbn, pbn.cyl, pbn.head, pbn.sector, dm_angle_itod(skew)); 
 
     d->layout->dm_get_track_boundaries(d, &pbn, 0, &lbn, 0);
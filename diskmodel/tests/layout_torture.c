@@ -37,7 +37,7 @@ void testsUsage(void) {
 
 int 
 layout_torture(struct dm_disk_if *d) {
-  int lbn, lbn2;
+  dm_lbn_t lbn, lbn2;
   struct dm_pbn pbn, pbn2, pbn3, pbn4;
   int rv;
   int bad = 0;
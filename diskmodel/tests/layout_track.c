@@ -36,16 +36,16 @@ void testsUsage(void) {
 }
 
 int layout_test_trackbound(struct dm_disk_if *d) {
-  int c;
+  dm_lbn_t c;
   int badct = 0;
   int bad = 0;
   int lastbad = 0;
-  int lastlbn; // last lbn on the previous track
+  dm_lbn_t lastlbn; // last lbn on the previous track
 
   setlinebuf(stdout);
 
   for(c = 0; c < d->dm_sectors; ) {
-    int l1 = 0, l2 = 0;
+    dm_lbn_t l1 = 0, l2 = 0;
     struct dm_pbn pbn;
     int sptl, sptp;
     int remapsector = 0;
@@ -62,30 +62,30 @@ int layout_test_trackbound(struct dm_disk_if *d) {
 
     d->layout->dm_get_track_boundaries(d, &pbn, &l1, &l2, 0);
 
-	//printf("%d -> (%d,%d) = %d (%d)\n", c, l1, l2, l2 - l1 + 1, sptl);
+	//printf("%lld -> (%lld,%lld) = %lld (%d)\n", c, l1, l2, l2 - l1 + 1, sptl);
 
     if(l1 >= d->dm_sectors) {
-      printf("l1 past end of disk! (%d >= %d)\n", l1, d->dm_sectors);
+      printf("l1 past end of disk! (%lld >= %lld)\n", l1, d->dm_sectors);
     }
     
     if(l2 >= d->dm_sectors) {
-      printf("l2 past end of disk! (%d >= %d)\n", l2, d->dm_sectors);
+      printf("l2 past end of disk! (%lld >= %lld)\n", l2, d->dm_sectors);
     }
     
 
     // sanity checks
     if(l1 >= l2) {
-      printf("test_trackbound: %d >= %d\n", l1, l2);
+      printf("test_trackbound: %lld >= %lld\n", l1, l2);
       bad = 1;
     }
 
     if(l2 - l1 + 1 > sptl) {
-      printf("%d > %d (phys spt)\n", l2 - l1 + 1, sptl);
+      printf("%lld > %d (phys spt)\n", l2 - l1 + 1, sptl);
       bad = 1;
     }
 
     if(!((l1 <= c) && (c <= l2))) {
-      printf("test_trackbound: %d (%d,%d,%d) -> (%d, %d) \n", 
+      printf("test_trackbound: %lld (%d,%d,%d) -> (%lld, %lld) \n", 
 	     c, pbn.cyl, pbn.head, pbn.sector,
 	     l1, l2);
       bad = 1;
@@ -94,13 +94,13 @@ int layout_test_trackbound(struct dm_disk_if *d) {
     // "smoothness" test... the results should cover the lbn space
     if(!lastbad && (c>0) && (l1 != (lastlbn+1)) && (lastlbn != l2)) 
     {
-      printf("test_trackbound (%d): (%d,%d) <> %d+1\n", c, l1, l2, lastlbn);
+      printf("test_trackbound (%lld): (%lld,%lld) <> %lld+1\n", c, l1, l2, lastlbn);
       bad = 1;
     }
     
     lastlbn = l2;
     if(bad) {
-      printf("bad %d\n", c);
+      printf("bad %lld\n", c);
       badct++;
     }
 
@@ -83,7 +83,7 @@ diskinfo_lbn_address(int cyl, int head, int sector, int *lbn)
   pbn.cyl = cyl;
   pbn.head = head;
   pbn.sector = sector;
-  *lbn = adisk->layout->dm_translate_ptol(adisk, &pbn, &r);
+  *lbn = (int) adisk->layout->dm_translate_ptol(adisk, &pbn, &r);
 
   if ((*lbn < 0) || (r != 0)) {
     *lbn = -1;
@@ -109,11 +109,14 @@ diskinfo_track_boundaries(int cyl, int head, int *lbn1, int *lbn2)
 {
 #ifndef DISKINFO_ONLY
   int r = 0;
+  dm_lbn_t l1, l2;
   struct dm_pbn pbn;
   pbn.cyl = cyl;
   pbn.head = head;
   pbn.sector = 0;
-  adisk->layout->dm_get_track_boundaries(adisk,&pbn,lbn1,lbn2,&r);
+  adisk->layout->dm_get_track_boundaries(adisk,&pbn,&l1,&l2,&r);
+  *lbn1 = (int) l1;
+  *lbn2 = (int) l2;
 
   if ((*lbn1 < 0) || (r != 0)) {
     internal_error("diskinfo_lbn_address: %d cyl out of bounds!\n",cyl);
@@ -386,11 +389,11 @@ diskinfo_cyl_firstlbn(int cyl, int rand_max_offset)
 {
 
   int currtrack = -1;
-  int lbn = -1;
+  dm_lbn_t lbn = -1;
   int i = 0;
-  int lbn2;
+  dm_lbn_t lbn2;
 
-  int minlbn = adisk->dm_sectors;
+  int minlbn = (int) adisk->dm_sectors;
   struct dm_pbn pbn;
   int r = 0; 
 
@@ -400,7 +403,7 @@ diskinfo_cyl_firstlbn(int cyl, int rand_max_offset)
     pbn.sector = 0;
     adisk->layout->dm_get_track_boundaries(adisk,&pbn,&lbn,&lbn2,&r);
     if ((lbn >= 0) && (lbn < minlbn)) {
-      minlbn = lbn;
+      minlbn = (int) lbn;
       currtrack = i;
     }
   }
@@ -412,7 +415,7 @@ diskinfo_cyl_firstlbn(int cyl, int rand_max_offset)
 
   ddbg_assert(lbn >= 0);
 
-  return(lbn);
+  return((int) lbn);
 }
  
 /*---------------------------------------------------------------------------*
@@ -13,10 +13,12 @@ int disksim_iosim_loadparams(struct lp_block *b);
 
 typedef enum {
    DISKSIM_IOSIM_IO_TRACE_TIME_SCALE,
-   DISKSIM_IOSIM_IO_MAPPINGS
+   DISKSIM_IOSIM_IO_MAPPINGS,
+   DISKSIM_IOSIM_CLOSED_LOOP_STREAM_DEPTH,
+   DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME
 } disksim_iosim_param_t;
 
-#define DISKSIM_IOSIM_MAX_PARAM		DISKSIM_IOSIM_IO_MAPPINGS
+#define DISKSIM_IOSIM_MAX_PARAM		DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME
 extern void * DISKSIM_IOSIM_loaders[];
 extern lp_paramdep_t DISKSIM_IOSIM_deps[];
 
@@ -24,9 +26,11 @@ extern lp_paramdep_t DISKSIM_IOSIM_deps[];
 static struct lp_varspec disksim_iosim_params [] = {
    {"I/O Trace Time Scale", D, 0 },
    {"I/O Mappings", LIST, 0 },
+   {"Closed-loop stream depth", I, 0 },
+   {"Closed-loop stream service time", D, 0 },
    {0,0,0}
 };
-#define DISKSIM_IOSIM_MAX 2
+#define DISKSIM_IOSIM_MAX 4
 static struct lp_mod disksim_iosim_mod = { "disksim_iosim", disksim_iosim_params, DISKSIM_IOSIM_MAX, (lp_modloader_t)disksim_iosim_loadparams,  0, 0, DISKSIM_IOSIM_loaders, DISKSIM_IOSIM_deps };
 
 
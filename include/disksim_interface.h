@@ -44,7 +44,7 @@ extern "C" {
 struct disksim_request {
   int flags;
   short devno;
-  unsigned long blkno;
+  long long blkno;
   int bytecount;
   double start;
   int batchno;
@@ -79,6 +79,9 @@ typedef void(*disksim_interface_desched_t)(double t, void *ctx);
 // ofile is the name of disksim's output file.
 // ctx is an arbitrary pointer which will be passed back to the callback
 // functions when they are invoked.
+// Every handle is an independent simulation instance.  Instances may
+// run concurrently on different threads, provided each one is only
+// used by one thread at a time.
 struct disksim_interface * 
 disksim_interface_initialize (const char *pfile, 
 			      const char *ofile,
@@ -363,6 +363,16 @@ int lp_mod_name(char *);
 // 6th arg is number of overrides
 int lp_loadfile(FILE *in, struct lp_tlt ***, int *, char *, char **, int);
 
+// when nonzero, lp_loadfile() only records topologies and instantiations
+// in the tlts; lp_instantiate_tlts() carries them out later.  This lets
+// one parse be instantiated several times with different overrides.
+// The setting applies to the calling thread only.
+void lp_defer_instantiation(int);
+
+// carries out the topologies and instantiations recorded by a deferred
+// lp_loadfile(), applying the given overrides
+int lp_instantiate_tlts(struct lp_tlt **, int, char **, int);
+
 // free the parse tree referenced by pt containing len tlts
 void lp_destroy(struct lp_tlt **pt, int len);
 
@@ -372,6 +382,11 @@ int *lp_instantiate(char *targ, char *name);
 int
 lp_loadparams(void *it, struct lp_block *b, struct lp_mod *m);
 
+// re-run the loader for one scalar parameter of an existing object
+// returns -1 if m has no such int/double/string parameter
+int
+lp_setparam(void *it, struct lp_mod *m, char *name, char *value);
+
 
 #define LP_PATH_MAX 1024
 
@@ -382,6 +397,14 @@ char *lp_search_path(char *cwd, char *name);
 int lp_inst_list(struct lp_inst *i);
 
 int dumb_split(char *s, char **t, int *i);
+
+// splits "block:param" at the first ':' into caller-frees copies
+// returns -1, with only s1 set, if there is no ':'
+int dumb_split2(char *s, char **s1, char **s2);
+
+// does the override component spec range (e.g. disk0 .. disk3,
+// disk*) cover the component name?
+int range_match(char *range, char *name);
     
 
 #ifdef __cplusplus
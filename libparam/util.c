@@ -47,18 +47,35 @@
 
 #include <fcntl.h>
 
-//#include <libgen.h>
+#ifndef WIN32
+#include <libgen.h> // dirname()
+#endif
 
 #include "libparam.h"
 #include "bitvector.h"
 
+/* Deferral is per thread, so that one simulation parsing ahead */
+/* (see lp_defer_instantiation()) cannot stop another, set up on */
+/* a different thread, from instantiating its own parse.         */
+#ifdef _WIN32
+#define LP_TLS	__declspec(thread)
+#else
+#define LP_TLS	__thread
+#endif
+
 static lp_topoloader_t topoloader = 0;
+static LP_TLS int deferred = 0;
 
 void lp_register_topoloader(lp_topoloader_t l) 
 {
   topoloader = l;
 }
 
+void lp_defer_instantiation(int defer)
+{
+  deferred = defer;
+}
+
 
 
 
@@ -562,6 +579,10 @@ void lp_unparse_tlts(struct lp_tlt **tlts,
 int lp_inst_list(struct lp_inst *i)
 {
   int c;
+
+  if(deferred) {
+    return 0;
+  }
   
   /*      unparse_block(spec, outputfile); */
 
@@ -692,10 +713,40 @@ void load_block(struct lp_block *b) {
 void load_topo(struct lp_topospec *t, int len) 
 {
 /*    unparse_topospec(t, outputfile); */
+  if(deferred) {
+    return;
+  }
   topoloader(t, len);
 }
 
 
+/* blocks were already loaded as they were parsed; topospecs are always
+ * parsed one at a time */
+int lp_instantiate_tlts(struct lp_tlt **tlts, 
+			int tlts_len, 
+			char **cli_overrides,
+			int cli_overrides_len) 
+{
+  int c;
+
+  deferred = 0;
+  overrides = cli_overrides;
+  overrides_len = cli_overrides_len;
+
+  for(c = 0; c < tlts_len; c++) {
+    if(!tlts[c]) continue;
+
+    switch(tlts[c]->what) {
+    case TLT_TOPO: load_topo(tlts[c]->it.topo, 1); break;
+    case TLT_INST: lp_inst_list(tlts[c]->it.inst); break;
+    default:       break;
+    }
+  }
+
+  return 0;
+}
+
+
 
 
 
@@ -910,7 +961,7 @@ int lp_add_type(char *newt, char *parent) {
 
     lp_typetbl = realloc(lp_typetbl, newlen * sizeof(int *));
 
-    bzero(lp_typetbl + c, c * sizeof(int *));
+    bzero(lp_typetbl + c, (newlen - c) * sizeof(int *));
     lp_typetbl_len = newlen;
   }
   else return -1;
@@ -946,7 +997,7 @@ int lp_add_param(struct lp_param ***b, int *plen,
     /* didn't find a free slot -- double the array */
     int newlen = 2 * (*plen) + 1;
     (*b) = realloc((*b), newlen * sizeof(int *));
-    bzero((int *)(*b) + *plen, ((*plen) + 1) * sizeof(int*));
+    bzero((*b) + *plen, ((*plen) + 1) * sizeof(int*));
     (*b)[(*plen)] = p;
     *plen = newlen;
   }
@@ -1383,6 +1434,37 @@ lp_loadparams(void *it, struct lp_block *b, struct lp_mod *m) {
 }
 
 
+/* apply a single scalar parameter to an already-loaded object by
+ * running its loader again, e.g. to change a setting partway through
+ * a simulation.  Dependencies are not consulted.  Returns -1 if m
+ * has no such parameter or it isn't an int, double or string. */
+int
+lp_setparam(void *it, struct lp_mod *m, char *name, char *value) {
+  int c;
+
+  for(c = 0; c < m->modvars_len; c++) {
+    if(!strcmp(m->modvars[c].name, name)) break;
+  }
+  if(c >= m->modvars_len) return -1;
+
+  switch(m->modvars[c].type) {
+  case I:
+    ((lp_paramloader_int)m->param_loaders[c])(it, atoi(value));
+    break;
+  case D:
+    ((lp_paramloader_double)m->param_loaders[c])(it, atof(value));
+    break;
+  case S:
+    ((lp_paramloader_string)m->param_loaders[c])(it, value);
+    break;
+  default:
+    return -1;
+  }
+
+  return 0;
+}
+
+
 char *
 lp_search_path(char *cwd, char *name)
 {
@@ -145,20 +145,20 @@ mems_get_avg_sectpercyl (int devno)
 
 /* Find the cylinder, surface, and block mapping of a block */
 void
-mems_get_mapping (int maptype, int devno, int blkno, 
+mems_get_mapping (int maptype, int devno, disksim_lbn_t blkno, 
 		   int *cylptr, int *surfaceptr, int *blkptr)
 {
   mems_t *dev = getmems(devno);
-  mems_sled_t *sled = mems_lbn_to_sled(dev, blkno);
+  mems_sled_t *sled = mems_lbn_to_sled(dev, (lbn_t) blkno);
   tipsector_coord_set_t up, dn;
   tipset_t tipset;
 
   if ((blkno < 0) || (blkno >= dev->numblocks)) {
-    fprintf(stderr, "Invalid blkno at mems_get_mapping (%d)\n", blkno);
+    fprintf(stderr, "Invalid blkno at mems_get_mapping (%lld)\n", blkno);
     exit(1);
   }
 
-  mems_lbn_to_position(blkno, sled, &up, &dn, &tipset, cylptr, surfaceptr, blkptr);
+  mems_lbn_to_position((lbn_t) blkno, sled, &up, &dn, &tipset, cylptr, surfaceptr, blkptr);
 }
 
 
@@ -189,7 +189,7 @@ double
 mems_get_seektime (int devno, ioreq_event *req, int checkcache, double maxtime)
 {
   mems_t *dev = getmems(req->devno);
-  mems_sled_t *sled = mems_lbn_to_sled(dev, req->blkno);
+  mems_sled_t *sled = mems_lbn_to_sled(dev, (lbn_t) req->blkno);
   double up_time;
   double dn_time;
   tipsector_coord_set_t up;
@@ -198,7 +198,7 @@ mems_get_seektime (int devno, ioreq_event *req, int checkcache, double maxtime)
 
   // fprintf(stderr, "Entering mems_get_seektime()\n");
 
-  mems_lbn_to_position(req->blkno, sled, &up, &dn, &tipset, NULL, NULL, NULL);
+  mems_lbn_to_position((lbn_t) req->blkno, sled, &up, &dn, &tipset, NULL, NULL, NULL);
   up_time = mems_seek_time(sled, &sled->pos, &up.servo_start, NULL, NULL, NULL, NULL);
   dn_time = mems_seek_time(sled, &sled->pos, &dn.servo_start, NULL, NULL, NULL, NULL);
   return min(up_time, dn_time);
@@ -236,13 +236,13 @@ mems_get_average_position (tipsector_coord_set_t *up,
 
 // #define DISTANCE_DEBUG
 int
-mems_get_distance (int devno, ioreq_event *req, int exact, int direction)
+mems_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction)
 {
   coord_t *start_position;
   coord_t *dest_position;
 
   mems_t *dev = getmems(devno);
-  mems_sled_t *sled = mems_lbn_to_sled(dev, req->blkno);
+  mems_sled_t *sled = mems_lbn_to_sled(dev, (lbn_t) req->blkno);
 
   tipsector_coord_set_t up, down;
   tipset_t tipset;
@@ -252,7 +252,7 @@ mems_get_distance (int devno, ioreq_event *req, int exact, int direction)
   int x1, x2, y1, y2;
 
 #ifdef DISTANCE_DEBUG
-  fprintf(outputfile, "mems_get_distance -- devno = %d, req->blkno = %d, exact = %d, direction = %d\n",
+  fprintf(outputfile, "mems_get_distance -- devno = %d, req->blkno = %lld, exact = %lld, direction = %d\n",
 	  devno, req->blkno, exact, direction);
 #endif
 
@@ -263,7 +263,7 @@ mems_get_distance (int devno, ioreq_event *req, int exact, int direction)
   else
     {
       // find the starting position
-      mems_lbn_to_position(exact,
+      mems_lbn_to_position((lbn_t) exact,
 			   sled,
 			   &up, &down,
 			   &tipset,
@@ -277,7 +277,7 @@ mems_get_distance (int devno, ioreq_event *req, int exact, int direction)
   // dest_position = (coord_t *)malloc(sizeof(coord_t));
   
   // find the destination position
-  mems_lbn_to_position(req->blkno,
+  mems_lbn_to_position((lbn_t) req->blkno,
 		       sled,
 		       &up, &down,
 		       &tipset,
@@ -377,7 +377,7 @@ mems_get_maxoutstanding (int devno)
 
 
 /* How many blocks are available across all sleds on the device? */
-int
+disksim_lbn_t
 mems_get_number_of_blocks (int devno)
 {
   mems_t *dev = getmems(devno);
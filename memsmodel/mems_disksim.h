@@ -50,9 +50,9 @@ double mems_get_blktranstime (ioreq_event *curr);
 int    mems_get_busno (ioreq_event *curr);
 int    mems_get_depth (int devno);
 int    mems_get_inbus (int devno);
-void   mems_get_mapping (int maptype, int devno, int blkno, int *cylptr, int *surfaceptr, int *blkptr);
+void   mems_get_mapping (int maptype, int devno, disksim_lbn_t blkno, int *cylptr, int *surfaceptr, int *blkptr);
 int    mems_get_maxoutstanding (int devno);
-int    mems_get_number_of_blocks (int devno);
+disksim_lbn_t mems_get_number_of_blocks (int devno);
 int    mems_get_numcyls (int devno);
 double mems_get_seektime (int devno, ioreq_event *req, int checkcache, double maxtime);
 double mems_get_servtime (int devno, ioreq_event *req, int checkcache, double maxtime);
@@ -65,7 +65,7 @@ void   mems_read_specs (FILE *parfile, int devno, int copies);
 void   mems_read_toprints (FILE *parfile);
 void   mems_resetstats (void);
 int    mems_set_depth (int devno, int inbusno, int depth, int slotno);
-int    mems_get_distance (int devno, ioreq_event *req, int exact, int direction);
+int    mems_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction);
 
 /* not implemented (but easily done if necessary):
  *
@@ -194,8 +194,8 @@ mems_get_new_extent(ioreq_event *curr)
   // mems_extent_t *new_extent = (mems_extent_t *)getfromextraq();
   mems_extent_mallocs++;
 
-  new_extent->firstblock = curr->blkno;
-  new_extent->lastblock  = curr->blkno + curr->bcount - 1;
+  new_extent->firstblock = (int) curr->blkno;
+  new_extent->lastblock  = (int) curr->blkno + curr->bcount - 1;
   new_extent->completed_block_media = -1;
   new_extent->completed_block_bus = -1;
   new_extent->bus_done = FALSE;
@@ -212,7 +212,7 @@ mems_get_new_extent(ioreq_event *curr)
 void
 mems_update_reqinfo(ioreq_event *curr)
 {
-  mems_reqinfo_t *r = curr->mems_reqinfo;
+  mems_reqinfo_t *r = curr->dev.mems.reqinfo;
   mems_extent_t *extent_ptr = r->extents;
   ioreq_event *event_ptr;
   ioreq_event *next_event_ptr;
@@ -226,13 +226,13 @@ mems_update_reqinfo(ioreq_event *curr)
   while(event_ptr)
     {
       next_event_ptr = event_ptr->batch_next;
-      free(((mems_reqinfo_t *)event_ptr->mems_reqinfo)->extents);
+      free(((mems_reqinfo_t *)event_ptr->dev.mems.reqinfo)->extents);
       mems_reqinfo_frees++;
-      if (event_ptr->mems_reqinfo != r) 
+      if (event_ptr->dev.mems.reqinfo != r) 
 	{
-	  free(event_ptr->mems_reqinfo);
+	  free(event_ptr->dev.mems.reqinfo);
 	  mems_reqinfo_frees++;
-	  //addtoextraq(event_ptr->mems_reqinfo);
+	  //addtoextraq(event_ptr->dev.mems.reqinfo);
 	}
       event_ptr = next_event_ptr;
     }
@@ -286,7 +286,7 @@ mems_update_reqinfo(ioreq_event *curr)
 	{
 	  r->batch_arrival_time = curr->time;
 	}
-      event_ptr->mems_reqinfo = NULL;
+      event_ptr->dev.mems.reqinfo = NULL;
       event_ptr = event_ptr->batch_next;
       extent_ptr = extent_ptr->next;
     }
@@ -334,8 +334,8 @@ mems_get_new_reqinfo (ioreq_event *curr)
 static struct mems_prefetch_info *
 mems_get_prefetch_info (ioreq_event *curr)
 {
-  mems_sled_t    *sled = curr->mems_sled;
-  mems_reqinfo_t *reqinfo = curr->mems_reqinfo;
+  mems_sled_t    *sled = curr->dev.mems.sled;
+  mems_reqinfo_t *reqinfo = curr->dev.mems.reqinfo;
   struct mems_prefetch_info *p;
 
   if (!sled->prefetch_depth) return NULL;
@@ -387,8 +387,8 @@ static void
 mems_request_complete (ioreq_event *curr,
 		       double latency)
 {
-  mems_sled_t *sled = curr->mems_sled;
-  mems_reqinfo_t *reqinfo = curr->mems_reqinfo;
+  mems_sled_t *sled = curr->dev.mems.sled;
+  mems_reqinfo_t *reqinfo = curr->dev.mems.reqinfo;
   ioreq_event *batch_ptr;
   ioreq_event *next_ptr;
 
@@ -399,7 +399,7 @@ mems_request_complete (ioreq_event *curr,
 #endif
 
   {	/* Verify that we're not insane here */
-    mems_reqinfo_t *r = curr->mems_reqinfo;
+    mems_reqinfo_t *r = curr->dev.mems.reqinfo;
     // assert ((r->bus_done == TRUE) && (r->media_done == TRUE));
   }
 
@@ -521,7 +521,7 @@ mems_energy_update_sled_seek(mems_sled_t *sled,
   sled->stat.total_energy_j += energy_j;
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       reqinfo->request_energy_uj += energy_j * 1000000.0;
     }
   
@@ -552,7 +552,7 @@ mems_energy_update_sled_servo(mems_sled_t *sled,
   sled->stat.total_energy_j += energy_j;
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       int num_tips_req = sled->tip_sectors_per_lbn *
 	(reqinfo->next_block_end - reqinfo->next_block_start + 1);
       double energy_j_req =
@@ -590,7 +590,7 @@ mems_energy_update_sled_data(mems_sled_t *sled,
   
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       int num_tips_req = sled->tip_sectors_per_lbn *
 	(reqinfo->next_block_end - reqinfo->next_block_start + 1);
       double energy_j_req =
@@ -611,12 +611,12 @@ mems_energy_update_sled_data(mems_sled_t *sled,
 void
 mems_io_access_arrive(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
 
 #ifdef VERBOSE_EVENTLOOP
-  printf("\nIO_ACCESS_ARRIVE: %f -- %s for %d(%d), batchno = %d, batch_complete = %d\n",
-	 simtime, (curr->flags & READ) ? "R" : "W", curr->blkno, curr->bcount, curr->batchno, curr->batch_complete);
+  printf("\nIO_ACCESS_ARRIVE: %f -- %s for %lld(%d), batchno = %d, batch_complete = %d\n",
+	 simtime, (curr->flags & READ) ? "R" : "W", curr->blkno, curr->bcount, curr->batchno, (curr->flags & BATCH_COMPLETE) ? 1 : 0);
   fflush(stdout);
 #endif
  
@@ -625,11 +625,9 @@ mems_io_access_arrive(ioreq_event *curr)
    * - Map the request to the appropriate sled. */
 
   curr->batch_next = NULL;
-  curr->batch_prev = NULL;
-  curr->batch_size = 0;
 
-  curr->mems_sled = mems_lbn_to_sled(dev, curr->blkno);
-  curr->mems_reqinfo = mems_get_new_reqinfo(curr);
+  curr->dev.mems.sled = mems_lbn_to_sled(dev, (lbn_t) curr->blkno);
+  curr->dev.mems.reqinfo = mems_get_new_reqinfo(curr);
   
   dev->busowned = mems_get_busno(curr);
   
@@ -641,7 +639,7 @@ mems_io_access_arrive(ioreq_event *curr)
 void
 mems_device_overhead_complete(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
 
 #ifdef VERBOSE_EVENTLOOP
@@ -668,7 +666,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	  busreq->type = MEMS_BUS_INITIATE;
 	  busreq->time = simtime;
 	  addtointq((event *)busreq);
-	  ((mems_reqinfo_t *)(curr->mems_reqinfo))->bus_pending = TRUE;
+	  ((mems_reqinfo_t *)(curr->dev.mems.reqinfo))->bus_pending = TRUE;
 	}
       else
 	{
@@ -688,7 +686,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	  //  is that if one request of the batch is cached, then the rest
 	  //  are as well.  I may need to make that explicit.
 
-	  mems_reqinfo_t *reqinfo = curr->mems_reqinfo;
+	  mems_reqinfo_t *reqinfo = curr->dev.mems.reqinfo;
 	  mems_extent_t *extent_ptr = reqinfo->extents;
 
 	  if (mems_buffer_check(extent_ptr->firstblock,
@@ -716,7 +714,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	}
     }
   /*
-  else if ((curr->batchno != 0) && (curr->batch_complete == TRUE))
+  else if ((curr->batchno != 0) && (curr->flags & BATCH_COMPLETE))
     {
       if (!(curr->flags & READ))
 	{
@@ -724,7 +722,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	  busreq->type = MEMS_BUS_INITIATE;
 	  busreq->time = simtime;
 	  addtointq((event *)busreq);
-	  ((mems_reqinfo_t *)(curr->mems_reqinfo))->bus_pending = TRUE;    
+	  ((mems_reqinfo_t *)(curr->dev.mems.reqinfo))->bus_pending = TRUE;    
 	}
     }
   */
@@ -741,7 +739,7 @@ mems_device_overhead_complete(ioreq_event *curr)
   // requests from multiple batches.  when a batch (any batch) is
   // complete, then MEMS_SLED_SCHEDULE will pull it out of the ioqueue
   // and start crunching on it.
-  if ((curr->batchno == 0) || (curr->batch_complete == TRUE))
+  if ((curr->batchno == 0) || (curr->flags & BATCH_COMPLETE))
     {
 
       /* If the sled is in the inactive power-saving state, reactivate it */
@@ -755,7 +753,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	  r->type = MEMS_SLED_SCHEDULE;
 	  r->time = simtime + sled->startup_time_ms;
 	  /* FIXME: curr->time doesn't work (for simtime).  Why? */
-	  r->mems_sled = sled;
+	  r->dev.mems.sled = sled;
 	  addtointq((event *)r);
 	
 	  sled->active = MEMS_SLED_ACTIVE;
@@ -847,7 +845,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 	    }
 	  mems_commit_move(sled, update_coord);
 	
-	  r->mems_sled = sled;
+	  r->dev.mems.sled = sled;
 	  addtointq((event *)r);
 	  sled->active = MEMS_SLED_ACTIVE;
 	
@@ -860,7 +858,7 @@ mems_device_overhead_complete(ioreq_event *curr)
 void
 mems_sled_schedule(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
   ioreq_event *old_active_request;
   
@@ -935,13 +933,13 @@ mems_sled_schedule(ioreq_event *curr)
 	      // printf("more than one request was returned!\n");
 	      mems_update_reqinfo(sled->active_request);
 #ifdef VERBOSE_EVENTLOOP	  
-	      print_extent_info(sled->active_request->mems_reqinfo);
+	      print_extent_info(sled->active_request->dev.mems.reqinfo);
 #endif
 	    }
 	  
 	  old_active_request = sled->active_request;
 	  sled->active_request = ioreq_copy(sled->active_request);
-	  old_active_request->mems_reqinfo = NULL;
+	  old_active_request->dev.mems.reqinfo = NULL;
 	  
 	  /* Just got a new active request, so throw out old prefetch info */
 	  /*
@@ -981,7 +979,7 @@ mems_sled_schedule(ioreq_event *curr)
       struct tipset first_tipset;
       mems_extent_t *extent_ptr;
       
-      reqinfo = sled->active_request->mems_reqinfo;
+      reqinfo = sled->active_request->dev.mems.reqinfo;
       
 #ifdef VERBOSE_EVENTLOOP
       printf("MEMS_SLED_SCHEDULE:: before\n");
@@ -1151,7 +1149,7 @@ mems_sled_schedule(ioreq_event *curr)
   // printf("I DID THIS!!\n");
 #ifdef VERBOSE_EVENTLOOP
   printf("MEMS_SLED_SCHEDULE:: after\n");
-  print_extent_info(sled->active_request->mems_reqinfo);
+  print_extent_info(sled->active_request->dev.mems.reqinfo);
 #endif
 
   curr->type = MEMS_SLED_SEEK;
@@ -1168,7 +1166,7 @@ mems_update_seek_stats(double seek_time,
 {
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       
       reqinfo->subtrack_access_num++;
       // printf("subtrack_access_num = %d\n", reqinfo->subtrack_access_num);
@@ -1223,7 +1221,7 @@ mems_update_seek_stats(double seek_time,
 void
 mems_sled_seek(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   enum direction_enum { UP, DOWN } direction;
   double time_up, x_up, y_up, to_up;
   double time_dn = 0.0;
@@ -1300,7 +1298,7 @@ mems_sled_seek(ioreq_event *curr)
 void
 mems_sled_servo(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   double timedelta;
 
 #ifdef VERBOSE_EVENTLOOP
@@ -1339,7 +1337,7 @@ mems_sled_servo(ioreq_event *curr)
    * we're building a quality simulator here. */
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       mems_extent_t *extent_ptr = reqinfo->extents;
       int i;
       int data_to_write = TRUE;
@@ -1379,7 +1377,7 @@ mems_sled_servo(ioreq_event *curr)
 void
 mems_sled_data(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   double timedelta;
 
 #ifdef VERBOSE_EVENTLOOP
@@ -1409,7 +1407,7 @@ mems_sled_data(ioreq_event *curr)
 void
 mems_sled_update(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
 
 #ifdef VERBOSE_EVENTLOOP
   printf("MEMS_SLED_UPDATE: %f\n", simtime);
@@ -1418,7 +1416,7 @@ mems_sled_update(ioreq_event *curr)
   
   if (sled->active_request)
     {
-      mems_reqinfo_t *reqinfo = sled->active_request->mems_reqinfo;
+      mems_reqinfo_t *reqinfo = sled->active_request->dev.mems.reqinfo;
       int extent;
       mems_extent_t *extent_ptr;
       mems_extent_t *next_extent;
@@ -1534,7 +1532,7 @@ mems_sled_update(ioreq_event *curr)
 void
 mems_io_interrupt_complete(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
 
 #ifdef VERBOSE_EVENTLOOP
@@ -1559,11 +1557,11 @@ mems_io_interrupt_complete(ioreq_event *curr)
     case COMPLETION:
       // SCHLOS - this is where it messes up the mems_reqinfo!!
       //  mems_reqinfo is somehow getting set as the ioreq_event
-      if (curr->mems_reqinfo)
+      if (curr->dev.mems.reqinfo)
 	{
-	  free(curr->mems_reqinfo);
+	  free(curr->dev.mems.reqinfo);
 	  mems_reqinfo_frees++;
-	  //addtoextraq((event *)curr->mems_reqinfo);
+	  //addtoextraq((event *)curr->dev.mems.reqinfo);
 	}
       addtoextraq((event *)curr);
       if (dev->busowned != -1)
@@ -1591,9 +1589,9 @@ mems_io_interrupt_complete(ioreq_event *curr)
 void
 mems_bus_initiate(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
-  mems_reqinfo_t *reqinfo = curr->mems_reqinfo;
+  mems_reqinfo_t *reqinfo = curr->dev.mems.reqinfo;
   mems_extent_t *extent_ptr;
   int num_extents;
   int i;
@@ -1657,7 +1655,7 @@ mems_bus_initiate(ioreq_event *curr)
 void
 mems_bus_transfer(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
 
 #ifdef VERBOSE_EVENTLOOP
   printf("MEMS_BUS_TRANSFER: %f\n", simtime);
@@ -1673,9 +1671,9 @@ mems_bus_transfer(ioreq_event *curr)
 void
 mems_bus_update(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   mems_t *dev = getmems(curr->devno);
-  mems_reqinfo_t *reqinfo = curr->mems_reqinfo;
+  mems_reqinfo_t *reqinfo = curr->dev.mems.reqinfo;
   mems_extent_t *extent_ptr;
   mems_extent_t *bus_extent;
   int extent;
@@ -1868,7 +1866,7 @@ mems_bus_update(ioreq_event *curr)
 void
 mems_io_qlen_maxcheck(ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
       /* Used only at initialization time to set up queue stuff */
 
   curr->tempint1 = -1;
@@ -1884,7 +1882,7 @@ mems_io_qlen_maxcheck(ioreq_event *curr)
 void
 mems_event_arrive (ioreq_event *curr)
 {
-  mems_sled_t *sled = curr->mems_sled;
+  mems_sled_t *sled = curr->dev.mems.sled;
   double timedelta;
 
   switch (curr->type)
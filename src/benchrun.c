@@ -0,0 +1,126 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* benchrun runs a command and reports what it cost the host: elapsed   */
+/* wall clock time, user and system CPU time and the peak resident set  */
+/* size, as one line                                                    */
+/*                                                                      */
+/*    wall <s> user <s> sys <s> maxrss <KB>                             */
+/*                                                                      */
+/* written to the -o file (standard error otherwise).  valid/runbench   */
+/* uses it to time each simulation; the exit status is the command's.   */
+/*                                                                      */
+/*    benchrun [-o file] <command> [args]...                            */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+
+static void usage (char *progname)
+{
+   fprintf(stderr, "usage: %s [-o file] <command> [args]...\n", progname);
+   exit(1);
+}
+
+
+static double benchrun_now (void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return((double) ts.tv_sec + ((double) ts.tv_nsec / 1e9));
+}
+
+
+static double benchrun_secs (struct timeval *tv)
+{
+   return((double) tv->tv_sec + ((double) tv->tv_usec / 1e6));
+}
+
+
+int main (int argc, char **argv)
+{
+   char *filename = NULL;
+   FILE *fp = stderr;
+   struct rusage ru;
+   double start;
+   double wall;
+   pid_t pid;
+   int status;
+   int arg = 1;
+
+   if (((arg + 1) < argc) && (strcmp(argv[arg], "-o") == 0)) {
+      filename = argv[arg + 1];
+      arg += 2;
+   }
+   if (arg >= argc) {
+      usage(argv[0]);
+   }
+
+   start = benchrun_now();
+   pid = fork();
+   if (pid < 0) {
+      perror("fork");
+      exit(1);
+   }
+   if (pid == 0) {
+      execvp(argv[arg], argv + arg);
+      fprintf(stderr, "Cannot run %s\n", argv[arg]);
+      _exit(127);
+   }
+   if (wait4(pid, &status, 0, &ru) != pid) {
+      perror("wait4");
+      exit(1);
+   }
+   wall = benchrun_now() - start;
+
+   if (filename && ((fp = fopen(filename, "w")) == NULL)) {
+      fprintf(stderr, "Cannot open %s\n", filename);
+      exit(1);
+   }
+   /* ru_maxrss is in kilobytes on Linux and the BSDs */
+   fprintf(fp, "wall %.3f user %.3f sys %.3f maxrss %ld\n", wall, benchrun_secs(&ru.ru_utime), benchrun_secs(&ru.ru_stime), (long) ru.ru_maxrss);
+   if (filename) {
+      fclose(fp);
+   }
+
+   if (WIFEXITED(status)) {
+      return(WEXITSTATUS(status));
+   }
+   return(128 + WTERMSIG(status));
+}
@@ -0,0 +1,140 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* complog2txt turns a binary completion log (see disksim_complog.h)    */
+/* back into text.  By default it writes the requests in the ASCII      */
+/* trace format, in order of arrival, just as "Output file for trace of */
+/* I/O requests simulated" would have listed them (apart from requests  */
+/* still outstanding when the simulation ended).  With -a it writes     */
+/* every field of every record, in order of completion.                 */
+/*                                                                      */
+/*    complog2txt [-a] <completion log> <output file>                   */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "disksim_global.h"
+#include "disksim_complog.h"
+
+
+typedef struct {
+   complog_rec rec;
+   long        seq;	/* completion order, to break ties */
+} complog_entry;
+
+
+static void usage (char *progname)
+{
+   fprintf(stderr, "usage: %s [-a] <completion log> <output file>\n", progname);
+   exit(1);
+}
+
+
+static int complog_entry_compare (const void *a, const void *b)
+{
+   const complog_entry *x = a;
+   const complog_entry *y = b;
+
+   if (x->rec.arrival != y->rec.arrival) {
+      return((x->rec.arrival < y->rec.arrival) ? -1 : 1);
+   }
+   return((x->seq < y->seq) ? -1 : (x->seq > y->seq));
+}
+
+
+int main (int argc, char **argv)
+{
+   int all = FALSE;
+   FILE *infile;
+   FILE *outfile;
+   complog_entry *entries = NULL;
+   complog_rec rec;
+   long cnt = 0;
+   long size = 0;
+   long i;
+
+   if ((argc == 4) && (strcmp(argv[1], "-a") == 0)) {
+      all = TRUE;
+      argv++;
+   } else if (argc != 3) {
+      usage(argv[0]);
+   }
+
+   if ((infile = fopen(argv[1], "rb")) == NULL) {
+      fprintf(stderr, "Completion log %s cannot be opened for read access\n", argv[1]);
+      exit(1);
+   }
+   if (!complog_read_header(infile)) {
+      fprintf(stderr, "%s is not a completion log\n", argv[1]);
+      exit(1);
+   }
+   if (strcmp(argv[2], "stdout") == 0) {
+      outfile = stdout;
+   } else if ((outfile = fopen(argv[2], "w")) == NULL) {
+      fprintf(stderr, "Output file %s cannot be opened for write access\n", argv[2]);
+      exit(1);
+   }
+
+   if (all) {
+      fprintf(outfile, "# arrival\tstart\tdone\tqtime\tdevno\tblkno\tbcount\tflags\n");
+      while (complog_read(infile, &rec)) {
+         fprintf(outfile, "%.6f\t%.6f\t%.6f\t%.6f\t%d\t%lld\t%d\t%x\n", rec.arrival, rec.start, rec.done, rec.qtime, rec.devno, rec.blkno, rec.bcount, rec.flags);
+      }
+   } else {
+      while (complog_read(infile, &rec)) {
+         if (cnt == size) {
+            size = (size) ? (2 * size) : 65536;
+            entries = realloc(entries, (size * sizeof(complog_entry)));
+            if (entries == NULL) {
+               fprintf(stderr, "Out of memory\n");
+               exit(1);
+            }
+         }
+         entries[cnt].rec = rec;
+         entries[cnt].seq = cnt;
+         cnt++;
+      }
+      qsort(entries, cnt, sizeof(complog_entry), complog_entry_compare);
+      for (i = 0; i < cnt; i++) {
+         rec = entries[i].rec;
+         fprintf(outfile, "%.6f\t%d\t%lld\t%d\t%x\n", rec.arrival, rec.devno, rec.blkno, rec.bcount, rec.flags);
+      }
+      free(entries);
+   }
+
+   fclose(infile);
+   if (fclose(outfile) != 0) {
+      fprintf(stderr, "Error writing %s\n", argv[2]);
+      exit(1);
+   }
+   exit(0);
+}
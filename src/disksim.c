@@ -2,6 +2,12 @@
 #include "disksim_ioface.h"
 #include "disksim_pfface.h"
 #include "disksim_iotrace.h"
+#include "disksim_tracefile.h"
+#include "disksim_intq.h"
+#include "disksim_stat.h"
+#include "disksim_complog.h"
+#include "disksim_tseries.h"
+#include "disksim_profile.h"
 #include "config.h"
 
 #include "modules/disksim_global_param.h"
@@ -17,54 +23,193 @@
 #endif
 
 
-disksim_t *disksim = NULL;
+DISKSIM_TLS disksim_t *disksim = NULL;
 
 /* legacy hack for HPL traces... */
 #define PRINT_TRACEFILE_HEADER	FALSE
 
 
-/*** Functions to allocate and deallocate empty event structures ***/
+/*** Pooled allocation of events and other small, frequently used objects ***/
+
+/* Objects are carved out of fixed-size slabs, one size class per       */
+/* DISKSIM_POOL_GRAIN bytes, and freed objects go onto the free list of */
+/* their class.  A small header in front of each object records its     */
+/* class and type, so any object can be freed through any path and the  */
+/* per-type counters stay right.  Slabs are never given back while the  */
+/* simulation runs; disksim_cleanup passes them on to the next          */
+/* simulation run by the same thread.                                   */
+
+#define POOL_SLABSIZE	8192
+
+typedef union pool_obj {
+   union pool_obj *next;	/* while on a free list */
+   struct {
+      short type;
+      short cls;		/* -1 for objects too big for a slab */
+   } tag;			/* while handed out */
+   double align;
+} pool_obj;
+
+typedef struct pool_slab {
+   struct pool_slab *next;
+   int    cls;
+} pool_slab;
+
+static DISKSIM_TLS pool_slab *pool_spare[DISKSIM_POOL_CLASSES];
+
+
+/* Adds a slab worth of objects to an empty free list, reusing a slab */
+/* left behind by an earlier simulation when there is one.            */
+
+static void pool_refill (int cls)
+{
+   int size = sizeof(pool_obj) + ((cls + 1) * DISKSIM_POOL_GRAIN);
+   int cnt = (POOL_SLABSIZE - sizeof(pool_slab)) / size;
+   pool_slab *slab;
+   char *base;
+   int i;
+
+   if ((slab = pool_spare[cls]) != NULL) {
+      pool_spare[cls] = slab->next;
+      bzero(slab, POOL_SLABSIZE);
+   } else {
+      slab = calloc(1, POOL_SLABSIZE);
+      ddbg_assert(slab != 0);
+   }
+   slab->cls = cls;
+   slab->next = disksim->poolslabs;
+   disksim->poolslabs = slab;
+   disksim->poolslabcnt++;
+
+   /* lowest address first */
+   base = (char *) (slab + 1);
+   for (i = (cnt - 1); i >= 0; i--) {
+      pool_obj *obj = (pool_obj *) (base + (i * size));
+      obj->next = disksim->poolfree[cls];
+      disksim->poolfree[cls] = obj;
+   }
+}
+
+
+/* Allocates an object of at least size bytes, counted against type. */
+/* Like malloc, the contents are not cleared.                        */
+
+void * disksim_pool_get (int type, int size)
+{
+   pool_stat *stat = &disksim->poolstat[type];
+   int cls = (size - 1) / DISKSIM_POOL_GRAIN;
+   pool_obj *obj;
+
+   if (cls >= DISKSIM_POOL_CLASSES) {
+      obj = malloc(sizeof(pool_obj) + size);
+      ddbg_assert(obj != 0);
+      cls = -1;
+   } else {
+      if (disksim->poolfree[cls] == NULL) {
+         pool_refill(cls);
+      }
+      obj = disksim->poolfree[cls];
+      disksim->poolfree[cls] = obj->next;
+   }
+   obj->tag.type = type;
+   obj->tag.cls = cls;
+
+   stat->allocs++;
+   stat->live++;
+   if (stat->live > stat->peak) {
+      stat->peak = stat->live;
+   }
+   return(obj + 1);
+}
+
+
+/* Returns an object from disksim_pool_get to its free list. */
+
+void disksim_pool_put (void *ptr)
+{
+   pool_obj *obj;
+   int cls;
+
+   if (ptr == NULL) {
+      return;
+   }
+   obj = (pool_obj *) ptr - 1;
+   cls = obj->tag.cls;
+   disksim->poolstat[obj->tag.type].live--;
+   if (cls < 0) {
+      free(obj);
+      return;
+   }
+   obj->next = disksim->poolfree[cls];
+   disksim->poolfree[cls] = obj;
+}
 
-/* Creates new, empty events (using malloc) and puts them on the extraq. */
-/* Called by getfromextraq when the queue is found to be empty.          */
 
-#define EXTRAEVENTS 32
+/* Hands this simulation's slabs to the next one on this thread.  Nothing */
+/* allocated from the pool may be touched afterwards.                    */
 
-static void allocateextra ()
+static void pool_cleanup ()
 {
+   pool_slab *slab;
    int i;
-   event *temp = NULL;
 
-   StaticAssert (sizeof(event) == DISKSIM_EVENT_SIZE);
+   while ((slab = disksim->poolslabs) != NULL) {
+      disksim->poolslabs = slab->next;
+      slab->next = pool_spare[slab->cls];
+      pool_spare[slab->cls] = slab;
+   }
+   disksim->poolslabcnt = 0;
+   for (i = 0; i < DISKSIM_POOL_CLASSES; i++) {
+      disksim->poolfree[i] = NULL;
+   }
+}
 
-   temp = calloc(EXTRAEVENTS, sizeof(event));
 
-   //   if ((temp = (event *)DISKSIM_malloc(ALLOCSIZE)) == NULL) {
+static void pool_resetstats ()
+{
+   int i;
+
+   for (i = 0; i < DISKSIM_POOL_TYPES; i++) {
+      disksim->poolstat[i].allocs = 0.0;
+      disksim->poolstat[i].peak = disksim->poolstat[i].live;
+   }
+}
 
-   ddbg_assert(temp != 0);
 
-   //   for (i=0; i<((ALLOCSIZE/DISKSIM_EVENT_SIZE)-1); i++) {
+static void pool_printstats ()
+{
+   static char *names[DISKSIM_POOL_TYPES] = {
+      "Event", "Cache", "Outstand", "SSD request", "SSD list"
+   };
+   double runtime = (simtime - warmuptime) / (double) 1000.0;
+   char label[40];
+   int i;
 
-   for(i = 0; i < EXTRAEVENTS; i++) {
-      temp[i].next = &temp[i+1];
+   fprintf (outputfile, "Allocator slabs:         %d\t%d bytes\n", disksim->poolslabcnt, (disksim->poolslabcnt * POOL_SLABSIZE));
+   for (i = 0; i < DISKSIM_POOL_TYPES; i++) {
+      pool_stat *stat = &disksim->poolstat[i];
+      sprintf (label, "Allocator %s", names[i]);
+      fprintf (outputfile, "%s allocations:\t%.0f\n", label, stat->allocs);
+      fprintf (outputfile, "%s allocations per second:\t%f\n", label, ((runtime > 0.0) ? (stat->allocs / runtime) : 0.0));
+      fprintf (outputfile, "%s peak live:\t%d\n", label, stat->peak);
    }
-   temp[EXTRAEVENTS-1].next = disksim->extraq;
-   disksim->extraq = temp;
-   disksim->extraqlen += EXTRAEVENTS;
-   //   disksim->extraqlen = ALLOCSIZE / DISKSIM_EVENT_SIZE;
+   fprintf (outputfile, "\n");
 }
 
+
+/*** Functions to allocate and deallocate empty event structures ***/
+
 /* A simple check to make sure that you're not adding an event
    to the extraq that is already there! */
 
 int addtoextraq_check(event *ev)
 {
-    event *temp = disksim->extraq;
+    pool_obj *temp = disksim->poolfree[(sizeof(event) - 1) / DISKSIM_POOL_GRAIN];
 
     while (temp != NULL) {
-	if (ev == temp) {
+	if ((pool_obj *) ev - 1 == temp) {
 	  // I did it this way so that I could break at this line -schlos
-	    ddbg_assert(ev != temp);
+	    ddbg_assert((pool_obj *) ev - 1 != temp);
 	}
 	temp = temp->next;
     }
@@ -77,44 +222,35 @@ INLINE void addtoextraq (event *temp)
 {
   // addtoextraq_check(temp);
 
-   if (temp == NULL) {
-      return;
-   }
-   temp->next = disksim->extraq;
-   temp->prev = NULL;
-   disksim->extraq = temp;
-   disksim->extraqlen++;
+   disksim_pool_put(temp);
 }
 
 
-/* Allocates an event structure from the extraq free pool; if empty, */
-/* calls allocateextra to create some more.                          */
+/* Allocates a cleared event-sized structure from the pool, counted  */
+/* against type (e.g. cache descriptors against DISKSIM_POOL_CACHE). */
+/* Clearing keeps results independent of whatever the previous user  */
+/* of the memory left in fields that some paths never set.           */
 
-INLINE event * getfromextraq ()
+event * getfromextraq_type (int type)
 {
   event *temp;
 
-  if(disksim->extraqlen == 0) {
-    allocateextra();
-    temp = disksim->extraq;
-    disksim->extraq = disksim->extraq->next;
-  }
-  else if(disksim->extraqlen == 1) {
-    temp = disksim->extraq;
-    disksim->extraq = NULL;
-  }
-  else {
-    temp = disksim->extraq;
-    disksim->extraq = disksim->extraq->next;
-  }
+  StaticAssert (sizeof(event) == DISKSIM_EVENT_SIZE);
 
-  disksim->extraqlen--;
-  temp->next = NULL;
-  temp->prev = NULL;
+  temp = disksim_pool_get(type, sizeof(event));
+  bzero(temp, sizeof(event));
   return temp;
 }
 
 
+/* Allocates an event structure from the extraq free pool. */
+
+INLINE event * getfromextraq ()
+{
+  return getfromextraq_type(DISKSIM_POOL_EVENT);
+}
+
+
 /* Deallocates a list of event structures to the extraq free pool. */
 
 void addlisttoextraq (event **headptr)
@@ -147,6 +283,7 @@ event *event_copy (event *orig)
    event *new = getfromextraq();
    memmove((char *)new, (char *)orig, DISKSIM_EVENT_SIZE);
 /* bcopy ((char *)orig, (char *)new, DISKSIM_EVENT_SIZE); */
+   new->intqpos = 0;
    return((event *) new);
 }
 
@@ -158,24 +295,14 @@ event *event_copy (event *orig)
 
 static void disksim_dumpintq ()
 {
-   event *tmp;
-   int i = 0;
-
-   tmp = disksim->intq;
-   while (tmp != NULL) {
-      i++;
-      fprintf (outputfile, "time %f, type %d\n", 
-	       tmp->time, tmp->type);
-      tmp = tmp->next;
-   }
+   intq_dump(outputfile);
 }
 
 
 
 /* Add an event to the intq.  The "time" field indicates when the event is */
 /* scheduled to occur, and the intq is maintained in ascending time order. */
-
-/* make this a binheap or something ... avoid walking the list */
+/* See disksim_intq.c for the available queue implementations.            */
 
 INLINE void addtointq (event *newint)
 {
@@ -192,6 +319,22 @@ INLINE void addtointq (event *newint)
    }
 #endif
 
+   /* On the tick grid the check is exact: events up to the threshold */
+   /* late are moved up to the current time, anything later is fatal.  */
+   if (disksim->inttime) {
+      disksim_tick_t tick = disksim_msec_to_ticks(newint->time);
+
+      if (tick < disksim->simtick) {
+         if ((disksim->simtick - tick) > DISKSIM_TIME_THRESHOLD_TICKS) {
+            fprintf(stderr, "Attempting to addtointq an event whose time has passed\n");
+            fprintf(stderr, "simtime %f, curr->time %f, type = %d\n", simtime, newint->time, newint->type);
+            exit(1);
+         }
+         tick = disksim->simtick;
+      }
+      newint->time = disksim_ticks_to_msec(tick);
+   }
+
 
    switch(disksim->trace_mode) {
    case DISKSIM_MASTER:
@@ -236,32 +379,21 @@ INLINE void addtointq (event *newint)
    }
 
 
-   if (disksim->intq == NULL) {
-      disksim->intq = newint;
-      newint->next = NULL;
-      newint->prev = NULL;
-   } 
-   else if (newint->time < disksim->intq->time) {
-      newint->next = disksim->intq;
-      disksim->intq->prev = newint;
-      disksim->intq = newint;
-      newint->prev = NULL;
-   } else {
-      event *run = disksim->intq;
-      assert(run->next != run);
-      while (run->next != NULL) {
-         if (newint->time < run->next->time) {
-            break;
-         }
-         run = run->next;
-      }
+   intq_insert(newint);
+}
 
-      newint->next = run->next;
-      run->next = newint;
-      newint->prev = run;
-      if (newint->next != NULL) {
-         newint->next->prev = newint;
-      }
+
+/* Advances the clock.  With integer event times the new time is put */
+/* on the tick grid (event times already are; external times may not */
+/* be).                                                               */
+
+void disksim_set_simtime (double time)
+{
+   if (disksim->inttime) {
+      disksim->simtick = disksim_msec_to_ticks(time);
+      simtime = disksim_ticks_to_msec(disksim->simtick);
+   } else {
+      simtime = time;
    }
 }
 
@@ -270,52 +402,17 @@ INLINE void addtointq (event *newint)
 
 INLINE static event * getfromintq ()
 {
-   event *temp = NULL;
-
-   if (disksim->intq == NULL) {
-      return(NULL);
-   }
-   temp = disksim->intq;
-   disksim->intq = disksim->intq->next;
-   if (disksim->intq != NULL) {
-      disksim->intq->prev = NULL;
-   }
-
-   temp->next = NULL;
-   temp->prev = NULL;
-   return(temp);
+   return(intq_getnext());
 }
 
 
 /* Removes a given event from the intq, thus descheduling it.  Returns */
-/* TRUE if the event was found, FALSE if it was not.                   */
+/* TRUE if the event was found, FALSE if it was not.  The event's      */
+/* intqpos handle locates it without searching the queue.              */
 
 INLINE int removefromintq (event *curr)
 {
-   event *tmp;
-
-   tmp = disksim->intq;
-   while (tmp != NULL) {
-      if (tmp == curr) {
-         break;
-      }
-      tmp = tmp->next;
-   }
-   if (tmp == NULL) {
-      return(FALSE);
-   }
-   if (curr->next != NULL) {
-      curr->next->prev = curr->prev;
-   }
-   if (curr->prev == NULL) {
-      disksim->intq = curr->next;
-   } else {
-      curr->prev->next = curr->next;
-   }
-
-   curr->next = NULL;
-   curr->prev = NULL;
-   return(TRUE);
+   return(intq_remove(curr));
 }
 
 
@@ -393,6 +490,9 @@ void getparam_bool (FILE *parfile, char *parname, int *parptr)
 
 void resetstats ()
 {
+   disksim->intqcancels = 0;
+   disksim->intqtimercancels = 0;
+   pool_resetstats();
    if (disksim->external_control | disksim->synthgen | disksim->iotrace) {
       io_resetstats();
    }
@@ -406,10 +506,21 @@ static void stat_warmup_done (timer_event *timer)
 {
    warmuptime = simtime;
    resetstats();
+   disksim->warmup_pending = FALSE;
    addtoextraq((event *)timer);
 }
 
 
+/* TRUE once both the warm-up time and the warm-up I/O count (if any) */
+/* have passed, i.e. the last statistics reset has happened.          */
+
+int disksim_warmup_done (void)
+{
+   return((disksim->warmup_pending == FALSE) &&
+          (disksim->totalreqs >= disksim->warmup_iocnt));
+}
+
+
 
 
 int disksim_global_loadparams(struct lp_block *b)
@@ -433,10 +544,29 @@ int disksim_global_loadparams(struct lp_block *b)
 
 void disksim_printstats2()
 {
+   char jsonname[sizeof(disksim->outputfilename) + 8];
+
+   if (disksim->statjson) {
+      sprintf (jsonname, "%.250s.json", disksim->outputfilename);
+      if (stat_json_open (jsonname) != 0) {
+         fprintf (stderr, "Statistics file %s cannot be opened for write access\n", jsonname);
+      }
+   }
    fprintf (outputfile, "\nSIMULATION STATISTICS\n");
    fprintf (outputfile, "---------------------\n\n");
    fprintf (outputfile, "Total time of run:       %f\n\n", simtime);
    fprintf (outputfile, "Warm-up time:            %f\n\n", warmuptime);
+   fprintf (outputfile, "Events handled:          %.0f\n", disksim->intqhandled);
+   fprintf (outputfile, "Events descheduled:      %d\n", disksim->intqcancels);
+   fprintf (outputfile, "Timers descheduled:      %d\n\n", disksim->intqtimercancels);
+   stat_json_value ("", "Total time of run", simtime);
+   stat_json_value ("", "Warm-up time", warmuptime);
+   stat_json_value ("", "Events handled", disksim->intqhandled);
+   stat_json_value ("", "Events descheduled", disksim->intqcancels);
+   stat_json_value ("", "Timers descheduled", disksim->intqtimercancels);
+   if (disksim->poolprintstats) {
+      pool_printstats();
+   }
 
    if (disksim->synthgen) {
       pf_printstats();
@@ -444,6 +574,12 @@ void disksim_printstats2()
    if (disksim->external_control | disksim->synthgen | disksim->iotrace) {
       io_printstats();
    }
+   if (disksim->profile) {
+      profile_print(disksim->profile);
+   }
+   if (stat_json_close () != 0) {
+      fprintf (stderr, "Error writing statistics file %s\n", jsonname);
+   }
 }
 
 
@@ -464,8 +600,10 @@ static void setcallbacks ()
    disksim->timerfunc_ioqueue = NULL;
    disksim->timerfunc_cachemem = NULL;
    disksim->timerfunc_cachedev = NULL;
+   disksim->timerfunc_tseries = NULL;
 
    disksim->timerfunc_disksim = stat_warmup_done;
+   disksim->timerfunc_tseries = tseries_tick;
    disksim->external_io_done_notify = NULL;
 
    io_setcallbacks();
@@ -477,8 +615,13 @@ static void initialize ()
 {
    int val = (disksim->synthgen) ? 0 : 1;
 
+   /* the warm-up and interval statistics timers need theirs */
+   setcallbacks();
    iotrace_initialize_file (disksim->iotracefile, disksim->traceformat, PRINT_TRACEFILE_HEADER);
-   while (disksim->intq) {
+   if ((disksim->iotracefile) && (disksim->traceprefetch)) {
+      iotrace_prefetch_start (disksim->iotracefile, disksim->traceformat);
+   }
+   while (intq_peek()) {
       addtoextraq(getfromintq());
    }
    if (disksim->external_control | disksim->synthgen | disksim->iotrace) {
@@ -490,6 +633,7 @@ static void initialize ()
       DISKSIM_srand48(disksim->seedval);
    }
    simtime = 0.0;
+   disksim->simtick = 0;
 }
 
 
@@ -529,7 +673,7 @@ getnextevent(void)
    event *temp;
 
    if (curr) {
-      simtime = curr->time;
+      disksim_set_simtime(curr->time);
 
       if (curr->type == NULL_EVENT) {
 	if ((disksim->iotrace) && io_using_external_event(curr)) {
@@ -562,9 +706,65 @@ getnextevent(void)
 }
 
 
+#ifdef SUPPORT_CHECKPOINTS
+
+/* A checkpoint is the program's writable data (.data through .bss) */
+/* followed by the in-use part of the checkpoint heap (see          */
+/* disksim_malloc.c), which together hold all of the simulation's   */
+/* state: events, queues, caches, device models, the random number  */
+/* generator, trace and output file positions and so on.  The heap  */
+/* starts at a page boundary so it can be mapped straight back in.  */
+
+/* laid out by the GNU linker */
+extern char __executable_start[];
+extern char __data_start[];
+extern char _end[];
+
+#define CHECKPOINT_MAGIC	"DSIMCKP1"
+
+typedef struct checkpoint_header {
+   char        magic[8];
+   disksim_t  *disksim;
+   char       *image;		/* where the program was loaded */
+   size_t      imagelen;
+   size_t      dataoff;		/* writable data, relative to image */
+   size_t      datalen;
+   char       *heap;
+   size_t      heaplen;
+   off_t       heapoff;		/* file offset of the heap */
+} checkpoint_header;
+
+
+/* Adds delta to every word in [start, start+len) that points into the */
+/* old program image, for resuming in a program that was loaded at a   */
+/* different address (e.g. with address space randomization).  This    */
+/* is conservative: a non-pointer that happens to hold such a value is */
+/* changed too, which is vanishingly unlikely but not impossible, so   */
+/* checkpointed runs are best done with randomization turned off.      */
+
+static void checkpoint_relocate (char *start, size_t len, char *image, size_t imagelen, long delta)
+{
+   char **p = (char **) start;
+   char **end = (char **) (start + len);
+
+   for ( ; p < end; p++) {
+      if ((*p >= image) && (*p < (image + imagelen))) {
+         *p += delta;
+      }
+   }
+}
+
+#endif
+
+
 void disksim_checkpoint (char *checkpointfilename)
 {
+#ifdef SUPPORT_CHECKPOINTS
    FILE *checkpointfile;
+   checkpoint_header hdr;
+   char defaultname[300];
+   char tmpname[300];
+   long pagesize = sysconf(_SC_PAGESIZE);
 
 //printf ("disksim_checkpoint: simtime %f, totalreqs %d\n", simtime, disksim->totalreqs);
    if (disksim->checkpoint_disable) {
@@ -572,16 +772,40 @@ void disksim_checkpoint (char *checkpointfilename)
       return;
    }
 
-   if ((checkpointfile = fopen(checkpointfilename, "w")) == NULL) {
+   bzero (&hdr, sizeof(hdr));
+   if (!disksim_heap_extent (&hdr.heap, &hdr.heaplen)) {
+      fprintf (outputfile, "Checkpoint at simtime %f skipped because this program does not use the checkpoint heap\n", simtime);
+      return;
+   }
+
+   if ((disksim->iotracefile) && (strcmp (disksim->iotracefilename, "stdin") == 0)) {
+      fprintf (outputfile, "Checkpoint at simtime %f skipped because iotrace comes from stdin\n", simtime);
+      return;
+   }
+
+   if ((disksim->iotrace_info) && (disksim->iotrace_info->prefetch)) {
+      fprintf (outputfile, "Checkpoint at simtime %f skipped because iotrace is being prefetched\n", simtime);
+      return;
+   }
+
+   if ((disksim->iotrace_info) && (disksim->iotrace_info->merge)) {
+      fprintf (outputfile, "Checkpoint at simtime %f skipped because iotrace is a merge of several traces\n", simtime);
+      return;
+   }
+
+   if (checkpointfilename[0] == 0) {
+      sprintf (defaultname, "%.250s.ckpt", disksim->outputfilename);
+      checkpointfilename = defaultname;
+   }
+   /* write a new file and rename it over the old one, so a crash */
+   /* part way through leaves the previous checkpoint intact      */
+   sprintf (tmpname, "%.250s.tmp", checkpointfilename);
+   if ((checkpointfile = fopen(tmpname, "wb")) == NULL) {
       fprintf (outputfile, "Checkpoint at simtime %f skipped because checkpointfile cannot be opened for write access\n", simtime);
       return;
    }
 
    if (disksim->iotracefile) {
-      if (strcmp (disksim->iotracefilename, "stdin") == 0) {
-         fprintf (outputfile, "Checkpoint at simtime %f skipped because iotrace comes from stdin\n", simtime);
-         return;
-      }
       fflush (disksim->iotracefile);
       fgetpos (disksim->iotracefile, &disksim->iotracefileposition);
    }
@@ -591,15 +815,45 @@ void disksim_checkpoint (char *checkpointfilename)
       fgetpos (outios, &disksim->outiosfileposition);
    }
 
+   if (disksim->complog) {
+      complog_sync (disksim->complog, &disksim->complogfileposition);
+   }
+
+   if (disksim->tseries) {
+      tseries_sync (disksim->tseries, &disksim->tseriesfileposition);
+   }
+
    if (outputfile) {
       fflush (outputfile);
       fgetpos (outputfile, &disksim->outputfileposition);
    }
 
-   rewind (checkpointfile);
-   fwrite (disksim, disksim->totallength, 1, checkpointfile);
+   memcpy (hdr.magic, CHECKPOINT_MAGIC, sizeof(hdr.magic));
+   hdr.disksim = disksim;
+   hdr.image = __executable_start;
+   hdr.imagelen = _end - __executable_start;
+   hdr.dataoff = __data_start - __executable_start;
+   hdr.datalen = _end - __data_start;
+   hdr.heapoff = sizeof(hdr) + hdr.datalen;
+   hdr.heapoff = ((hdr.heapoff + pagesize - 1) / pagesize) * pagesize;
+
+   fwrite (&hdr, sizeof(hdr), 1, checkpointfile);
+   fwrite (__data_start, hdr.datalen, 1, checkpointfile);
+   fseeko (checkpointfile, hdr.heapoff, SEEK_SET);
+   fwrite (hdr.heap, hdr.heaplen, 1, checkpointfile);
    fflush (checkpointfile);
+
+   if (ferror(checkpointfile) || fsync(fileno(checkpointfile))) {
+      fprintf (outputfile, "Checkpoint at simtime %f skipped because checkpointfile could not be written\n", simtime);
+      fclose (checkpointfile);
+      unlink (tmpname);
+      return;
+   }
    fclose (checkpointfile);
+   rename (tmpname, checkpointfilename);
+#else
+   fprintf (outputfile, "Checkpoint at simtime %f skipped because checkpointing is not supported on this platform\n", simtime);
+#endif
 }
 
 
@@ -625,11 +879,18 @@ static void prime_simulation ()
    if (disksim->warmup_event) {
       addtointq((event *)disksim->warmup_event);
       disksim->warmup_event = NULL;
+      disksim->warmup_pending = TRUE;
    }
    if (disksim->checkpoint_interval > 0.0) {
       disksim_register_checkpoint (disksim->checkpoint_interval);
    }
+   if (disksim->tseries) {
+      tseries_start (disksim->tseries);
+   }
    if (disksim->iotrace) {
+      if (io_stream_prime()) {
+         return;
+      }
       if ((curr = io_get_next_external_event(disksim->iotracefile)) == NULL) {
          disksim_cleanstats();
          return;
@@ -665,11 +926,24 @@ static void prime_simulation ()
 void disksim_simulate_event (int num)
 {
   event *curr;
+  int type = NULL_EVENT;
+  void *func = NULL;
   
+  if (disksim->profile) {
+    profile_start (disksim->profile);
+  }
   if ((curr = getnextevent()) == NULL) {
     disksim_simstop ();
   } 
   else {
+    /* the handler may free or reuse the event */
+    if (disksim->profile) {
+      profile_dequeued (disksim->profile);
+      type = curr->type;
+      if (type == TIMER_EXPIRED) {
+	func = ((timer_event *) curr)->func;
+      }
+    }
    
     switch(disksim->trace_mode) {
     case DISKSIM_NONE:
@@ -683,7 +957,8 @@ void disksim_simulate_event (int num)
       break;
     }
 
-    simtime = curr->time;
+    disksim_set_simtime(curr->time);
+    disksim->intqhandled += 1.0;
     
     if (curr->type == INTR_EVENT) 
     {
@@ -733,6 +1008,9 @@ void disksim_simulate_event (int num)
       fprintf(stderr, "Unrecognized event in simulate: %d\n", curr->type);
       exit(1);
     }
+    if (disksim->profile) {
+      profile_handled (disksim->profile, type, func);
+    }
     
 
 #ifdef FDEBUG
@@ -781,7 +1059,12 @@ static void disksim_setup_iotracefile (char *filename)
       assert (disksim->external_control == 0);
       //如果使用用户自定义的trace文件，disksim->iotrace = 1
 	  disksim->iotrace = 1;
-      if (strcmp(filename, "stdin") == 0) 
+      if (disksim->iotracefile != NULL)
+	  {
+	     /* already opened by the caller, e.g. an in-memory copy from */
+	     /* the sweep driver                                           */
+      }
+      else if (strcmp(filename, "stdin") == 0) 
 	  {
 	     disksim->iotracefile = stdin;
       } 
@@ -792,6 +1075,12 @@ static void disksim_setup_iotracefile (char *filename)
 	      exit(1);
 	      }
       }
+      /* compressed traces are read through a decompressing stream */
+      if ((disksim->checkpoint_restored) && (disksim->iotracestate != NULL)) {
+         disksim->iotracefile = tracefile_reopen (disksim->iotracefile, disksim->iotracestate);
+      } else {
+         disksim->iotracefile = tracefile_open (disksim->iotracefile, &disksim->iotracestate);
+      }
    } 
    //如果适用系统自己生成的trace，那么disksim->iotracefile = NULL
    else
@@ -979,33 +1268,85 @@ void disksim_setup_disksim (int argc, char **argv)
 void disksim_restore_from_checkpoint (char *filename)
 {
 #ifdef SUPPORT_CHECKPOINTS
+   checkpoint_header hdr;
+   FILE *savedstdin = stdin;
+   FILE *savedstdout = stdout;
+   FILE *savedstderr = stderr;
+   long delta;
    int fd;
-   void *startaddr;
-   int totallength;
    int ret;
 
-   fd = open (filename, O_RDWR);
-   assert (fd >= 0);
-   ret = read (fd, &startaddr, sizeof (void *));
-   assert (ret == sizeof(void *));
-   ret = read (fd, &totallength, sizeof (int));
-   assert (ret == sizeof(int));
-   disksim = (disksim_t *) mmap (startaddr, totallength, (PROT_READ|PROT_WRITE), (MAP_PRIVATE), fd, 0);
-   //printf ("mmap at %p, ret %d, len %d, addr %p\n", disksim, ret, totallength, startaddr);
-   //perror("");
-   assert (disksim == startaddr);
+   fd = open (filename, O_RDONLY);
+   if (fd < 0) {
+      fprintf (stderr, "Checkpoint file %s cannot be opened for read access\n", filename);
+      exit (1);
+   }
+   if ((read (fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+       (memcmp (hdr.magic, CHECKPOINT_MAGIC, sizeof(hdr.magic)) != 0)) {
+      fprintf (stderr, "%s is not a disksim checkpoint\n", filename);
+      exit (1);
+   }
+   if ((hdr.imagelen != (size_t) (_end - __executable_start)) ||
+       (hdr.dataoff != (size_t) (__data_start - __executable_start)) ||
+       (hdr.datalen != (size_t) (_end - __data_start))) {
+      fprintf (stderr, "Checkpoint %s was written by a different disksim program\n", filename);
+      exit (1);
+   }
+
+   /* From here until the heap is mapped nothing may be allocated: the */
+   /* program data read in includes the checkpoint heap's bookkeeping. */
+   disksim_heap_release ();
+   if (pread (fd, __data_start, hdr.datalen, sizeof(hdr)) != (ssize_t) hdr.datalen) {
+      fprintf (stderr, "Checkpoint %s is truncated\n", filename);
+      exit (1);
+   }
+   /* the C library's streams, copied into our data by the loader */
+   stdin = savedstdin;
+   stdout = savedstdout;
+   stderr = savedstderr;
+   if (disksim_heap_map (fd, hdr.heapoff, hdr.heaplen) != 0) {
+      fprintf (stderr, "Checkpoint %s cannot be mapped back in at %p\n", filename, hdr.heap);
+      exit (1);
+   }
+   close (fd);
+
+   delta = __executable_start - hdr.image;
+   if (delta != 0) {
+      checkpoint_relocate (__data_start, hdr.datalen, hdr.image, hdr.imagelen, delta);
+      checkpoint_relocate (hdr.heap, hdr.heaplen, hdr.image, hdr.imagelen, delta);
+      stdin = savedstdin;
+      stdout = savedstdout;
+      stderr = savedstderr;
+   }
+   disksim = hdr.disksim;
+   disksim->checkpoint_restored = TRUE;
+
+   /* anything pointing outside the program and its heap is stale */
+   ddbg_assert_setfile (stderr);
+   disksim->overrides = NULL;
+   disksim->overrides_len = 0;
+   disksim->parfile = NULL;
+   statdeffile = NULL;
+   disksim->exectrace = NULL;
+   disksim->intqtrace = NULL;
+   disksim->iotracefile = NULL;
+   outios = NULL;
+   iotrace_detach_file(FALSE);
 
    disksim_setup_outputfile (disksim->outputfilename, "r+");
-   if (outputfile != NULL) {
+   if ((outputfile != NULL) && (outputfile != stdout)) {
       ret = fsetpos (outputfile, &disksim->outputfileposition);
       assert (ret >= 0);
+      /* drop whatever the interrupted run wrote after the checkpoint */
+      ret = ftruncate (fileno(outputfile), ftello(outputfile));
+      assert (ret >= 0);
    }
    disksim_setup_iotracefile (disksim->iotracefilename);
    if (disksim->iotracefile != NULL) {
       ret = fsetpos (disksim->iotracefile, &disksim->iotracefileposition);
       assert (ret >= 0);
    }
-   if ((strcmp(disksim->outiosfilename, "0") != 0) && (strcmp(disksim->outiosfilename, "null") != 0)) {
+   if ((disksim->outiosfilename[0] != 0) && (strcmp(disksim->outiosfilename, "0") != 0) && (strcmp(disksim->outiosfilename, "null") != 0)) {
       if ((outios = fopen(disksim->outiosfilename, "r+")) == NULL) {
          fprintf(stderr, "Outios %s cannot be opened for write access\n", disksim->outiosfilename);
          exit(1);
@@ -1013,6 +1354,15 @@ void disksim_restore_from_checkpoint (char *filename)
       ret = fsetpos (outios, &disksim->outiosfileposition);
       assert (ret >= 0);
    }
+   if (disksim->complog) {
+      complog_restore (disksim->complog, disksim->complogfilename, &disksim->complogfileposition);
+   }
+   if (disksim->tseries) {
+      tseries_restore (disksim->tseries, disksim->tseriesfilename, &disksim->tseriesfileposition);
+   }
+   if (disksim->profile) {
+      profile_restore (disksim->profile);
+   }
 #else
    assert ("Checkpoint/restore not supported on this platform" == 0);
 #endif
@@ -1023,7 +1373,10 @@ void disksim_restore_from_checkpoint (char *filename)
 void disksim_run_simulation ()
 {
   int event_count = 0;
-  DISKSIM_srand48(1000003);
+  /* a run resumed from a checkpoint carries on with its own stream */
+  if (disksim->checkpoint_restored == FALSE) {
+    DISKSIM_srand48(1000003);
+  }
   while (disksim->stop_sim == FALSE) {
     disksim_simulate_event(event_count);
     //    printf("disksim_run_simulation: event %d\n", event_count);
@@ -1044,9 +1397,12 @@ void disksim_cleanup(void)
   }
   
   
+  iotrace_prefetch_stop();
+  iotrace_detach_file(TRUE);
   if (disksim->iotracefile) 
   {
     fclose(disksim->iotracefile);
+    disksim->iotracestate = NULL;
   }
   
   
@@ -1057,6 +1413,31 @@ void disksim_cleanup(void)
     fclose(outios);
     outios = NULL;
   }
+
+  if (disksim->complog)
+  {
+    if (complog_close(disksim->complog) != 0) {
+      fprintf(stderr, "Error writing completion log %s\n", disksim->complogfilename);
+    }
+    disksim->complog = NULL;
+  }
+
+  if (disksim->tseries)
+  {
+    if (tseries_close(disksim->tseries) != 0) {
+      fprintf(stderr, "Error writing interval statistics %s\n", disksim->tseriesfilename);
+    }
+    disksim->tseries = NULL;
+  }
+
+  if (disksim->intqtrace)
+  {
+    fclose(disksim->intqtrace);
+    disksim->intqtrace = NULL;
+  }
+
+  intq_cleanup();
+  pool_cleanup();
 }
 
 void disksim_printstats(void) {
@@ -1087,6 +1468,7 @@ disksim_initialize_disksim_structure (struct disksim *disksim)
    warmuptime = 0.0;	/* gets remapped to disksim->warmuptime */
    // simtime 对应的宏定义为  (disksim->simtime)
    simtime = 0.0;	/* gets remapped to disksim->warmuptime */
+   disksim->simtick = 0;
    disksim->lastphystime = 0.0;
    disksim->checkpoint_interval = 0.0;
 
@@ -560,11 +560,7 @@ fprintf (outputfile, "Entered bus_get_data_transfered - devno %d, depth %d, busn
 }
 
 
-/* temporary global variables */
-static int disksim_bus_printidlestats;
-static int disksim_bus_printarbwaitstats;
-
-
+/* the print flags are kept in disksim->businfo, with the buses */
 
 int disksim_bus_stats_loadparams(struct lp_block *b) {
    
@@ -685,10 +681,6 @@ bus *disksim_bus_loadparams(struct lp_block *b,
     bzero(disksim->businfo, sizeof(businfo_t));
   }
 
-  //   disksim->businfo->bus_printidlestats = disksim_bus_printidlestats;
-  //   disksim->businfo->bus_printarbwaitstats = disksim_bus_printarbwaitstats;
-
-
    for(c = 0; c < numbuses; c++) {
      if(!disksim->businfo->buses[c]) { break; } 
    }
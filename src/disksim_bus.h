@@ -118,6 +118,7 @@ typedef struct {
 typedef struct bus_ev {
    double time;
    int type;
+   int intqpos;
    struct bus_ev *next;
    struct bus_ev *prev;
    int devno;
@@ -141,3 +141,13 @@ struct cache_if *disksim_cache_loadparams(struct lp_block *b)
   return result;
 }
 
+
+/* change one parameter of a cache that has already been loaded */
+int disksim_cache_setparam(struct cache_if *c, char *name, char *value)
+{
+  if(disksim_cachemem_setparam(c, name, value) == 0) {
+    return 0;
+  }
+  return disksim_cachedev_setparam(c, name, value);
+}
+
@@ -152,6 +152,7 @@ struct cache_if {
 };
 
 struct cache_if *disksim_cache_loadparams(struct lp_block *b);
+int disksim_cache_setparam(struct cache_if *c, char *name, char *value);
 
 void cache_setcallbacks(void);
 
@@ -202,28 +202,31 @@ static int cachedev_count_dirty_blocks (struct cache_dev *cache)
 }
 
 
+/* The valid and dirty maps only cover the cache device's own blocks, */
+/* so (having passed the hit checks) blkno fits in an int.           */
+
 static void cachedev_setbits (bitstr_t *bitmap, ioreq_event *req)
 {
-   bit_nset (bitmap, req->blkno, (req->blkno+req->bcount-1));
+   bit_nset (bitmap, (int) req->blkno, ((int) req->blkno+req->bcount-1));
 }
 
 
 static void cachedev_clearbits (bitstr_t *bitmap, ioreq_event *req)
 {
-   bit_nclear (bitmap, req->blkno, (req->blkno+req->bcount-1));
+   bit_nclear (bitmap, (int) req->blkno, ((int) req->blkno+req->bcount-1));
 }
 
 
 static int cachedev_isreadhit (struct cache_dev *cache, ioreq_event *req)
 {
-   int lastblk = req->blkno + req->bcount;
+   disksim_lbn_t lastblk = req->blkno + req->bcount;
    int i;
 
    if (lastblk >= cache->size) {
       return (0);
    }
 
-   for (i=req->blkno; i<lastblk; i++) {
+   for (i=(int) req->blkno; i<lastblk; i++) {
       if (bit_test(cache->validmap,i) == 0) {
          return (0);
       }
@@ -300,7 +303,7 @@ static void cachedev_idlework_callback (void *idleworkparam, int idledevno)
       cache->stat.maxbufferspace = cache->bufferspace;
    }
 
-   flushdesc = (struct cache_dev_event *) getfromextraq();
+   flushdesc = (struct cache_dev_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
    flushdesc->type = CACHE_EVENT_IDLEFLUSH_READ;
    flushreq = (ioreq_event *) getfromextraq();
    flushreq->buf = flushdesc;
@@ -324,7 +327,7 @@ cachedev_get_block (struct cache_if *c,
 		    void *doneparam)
 {
   struct cache_dev *cache = (struct cache_dev *)c;
-   struct cache_dev_event *rwdesc = (struct cache_dev_event *) getfromextraq();
+   struct cache_dev_event *rwdesc = (struct cache_dev_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
    ioreq_event *fillreq;
    int devno;
 
@@ -682,7 +685,7 @@ cachedev_initialize (struct cache_if *c,
    }
 
    if (device_get_number_of_blocks(cache->cache_devno) < cache->size) {
-      fprintf (stderr, "Size of cachedev exceeds that of actual cache device (devno %d): %d > %d\n", cache->cache_devno, cache->size, device_get_number_of_blocks(cache->cache_devno));
+      fprintf (stderr, "Size of cachedev exceeds that of actual cache device (devno %d): %d > %lld\n", cache->cache_devno, cache->size, device_get_number_of_blocks(cache->cache_devno));
       ddbg_assert(0);
    }
 }
@@ -702,44 +705,62 @@ cachedev_printstats (struct cache_if *c, char *prefix)
    int blocks = cache->stat.readblocks + cache->stat.writeblocks;
 
    fprintf (outputfile, "%scache requests:             %6d\n", prefix, reqs);
+   stat_json_value(prefix, "cache requests", reqs);
    if (reqs == 0) {
       return;
    }
 
    fprintf (outputfile, "%scache read requests:        %6d  \t%6.4f\n", prefix, cache->stat.reads, ((double) cache->stat.reads / (double) reqs));
+   stat_json_value(prefix, "cache read requests", cache->stat.reads);
 
    if (cache->stat.reads) {
      fprintf(outputfile, "%scache blocks read:           %6d  \t%6.4f\n", prefix, cache->stat.readblocks, ((double) cache->stat.readblocks / (double) blocks));
+     stat_json_value(prefix, "cache blocks read", cache->stat.readblocks);
      fprintf(outputfile, "%scache read misses:          %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.readmisses, ((double) cache->stat.readmisses / (double) reqs), ((double) cache->stat.readmisses / (double) cache->stat.reads));
+     stat_json_value(prefix, "cache read misses", cache->stat.readmisses);
     
  fprintf(outputfile, "%scache read full hits:       %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.readhitsfull, ((double) cache->stat.readhitsfull / (double) reqs), ((double) cache->stat.readhitsfull / (double) cache->stat.reads));
+     stat_json_value(prefix, "cache read full hits", cache->stat.readhitsfull);
 
      fprintf(outputfile, "%scache population writes:         %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.popwrites, ((double) cache->stat.popwrites / (double) reqs), ((double) cache->stat.popwrites / (double) cache->stat.reads));
+     stat_json_value(prefix, "cache population writes", cache->stat.popwrites);
 
      fprintf(outputfile, "%scache block population writes:    %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.popwriteblocks, ((double) cache->stat.popwriteblocks / (double) blocks), ((double) cache->stat.popwriteblocks / (double) cache->stat.readblocks));
+     stat_json_value(prefix, "cache block population writes", cache->stat.popwriteblocks);
    }
 
    fprintf(outputfile, "%scache write requests:       %6d  \t%6.4f\n", prefix, cache->stat.writes, ((double) cache->stat.writes / (double) reqs));
+   stat_json_value(prefix, "cache write requests", cache->stat.writes);
 
    if (cache->stat.writes) {
      fprintf(outputfile, "%scache blocks written:        %6d  \t%6.4f\n", prefix, cache->stat.writeblocks, ((double) cache->stat.writeblocks / (double) blocks));
+     stat_json_value(prefix, "cache blocks written", cache->stat.writeblocks);
      fprintf(outputfile, "%scache write misses:         %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writemisses, ((double) cache->stat.writemisses / (double) reqs), ((double) cache->stat.writemisses / (double) cache->stat.writes));
+     stat_json_value(prefix, "cache write misses", cache->stat.writemisses);
 
       fprintf(outputfile, "%scache full write hits:   %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writehitsfull, ((double) cache->stat.writehitsfull / (double) reqs), ((double) cache->stat.writehitsfull / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache full write hits", cache->stat.writehitsfull);
 
       fprintf(outputfile, "%scache destage pre-reads:     %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagereads, ((double) cache->stat.destagereads / (double) reqs), ((double) cache->stat.destagereads / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache destage pre-reads", cache->stat.destagereads);
       fprintf(outputfile, "%scache block destage pre-reads: %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagereadblocks, ((double) cache->stat.destagereadblocks / (double) blocks), ((double) cache->stat.destagereadblocks / (double) cache->stat.writeblocks));
+      stat_json_value(prefix, "cache block destage pre-reads", cache->stat.destagereadblocks);
 
       fprintf(outputfile, "%scache destages (write):     %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagewrites, ((double) cache->stat.destagewrites / (double) reqs), ((double) cache->stat.destagewrites / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache destages (write)", cache->stat.destagewrites);
 
       fprintf(outputfile, "%scache block destages (write): %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagewriteblocks, ((double) cache->stat.destagewriteblocks / (double) blocks), ((double) cache->stat.destagewriteblocks / (double) cache->stat.writeblocks));
+      stat_json_value(prefix, "cache block destages (write)", cache->stat.destagewriteblocks);
 
       fprintf(outputfile, "%scache end dirty blocks:      %6d  \t%6.4f\n", prefix, cachedev_count_dirty_blocks(cache), ((double) cachedev_count_dirty_blocks(cache) / (double) cache->stat.writeblocks));
+      stat_json_value(prefix, "cache end dirty blocks", cachedev_count_dirty_blocks(cache));
    }
 
    fprintf (outputfile, "%scache bufferspace use end:             %6d\n", prefix, cache->bufferspace);
+   stat_json_value(prefix, "cache bufferspace use end", cache->bufferspace);
 
    fprintf (outputfile, "%scache bufferspace use max:             %6d\n", prefix, cache->stat.maxbufferspace);
+   stat_json_value(prefix, "cache bufferspace use max", cache->stat.maxbufferspace);
 }
 
 
@@ -799,4 +820,14 @@ struct cache_if *disksim_cachedev_loadparams(struct lp_block *b)
 }
 
 
+/* change one parameter of a loaded device cache; -1 if c isn't one */
+int disksim_cachedev_setparam(struct cache_if *c, char *name, char *value)
+{
+  if(c->cache_copy != disksim_cache_dev.cache_copy) {
+    return -1;
+  }
+  return lp_setparam(c, &disksim_cachedev_mod, name, value);
+}
+
+
 
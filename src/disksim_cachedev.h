@@ -138,6 +138,7 @@
 struct cache_dev_event {
    double time;
    int type;
+   int intqpos;
    struct cache_dev_event *next;
    struct cache_dev_event *prev;
    void (**donefunc)(void *,ioreq_event *);	/* Function to call when complete */
@@ -193,6 +194,7 @@ struct cache_dev {
 };
 
 void cachedev_setcallbacks(void);
+int disksim_cachedev_setparam(struct cache_if *c, char *name, char *value);
 
 
 #endif // DISKSIM_CACHEDEV_H
@@ -156,14 +156,14 @@ static void cache_empty_donefunc (void *doneparam, ioreq_event *req)
 }
 
 
-static int cache_concatok (void *concatokparam, int blkno1, int bcount1, int blkno2, int bcount2)
+static int cache_concatok (void *concatokparam, disksim_lbn_t blkno1, int bcount1, disksim_lbn_t blkno2, int bcount2)
 {
    struct cache_mem *cache = concatokparam;
    if ((cache->size) && (cache->maxscatgath != 0)) {
       int linesize = max(cache->linesize, 1);
-      int lineno1 = blkno1 / linesize;
-      int lineno2 = (blkno2 + bcount2 - 1) / linesize;
-      int scatgathcnt = lineno2 - lineno1;
+      disksim_lbn_t lineno1 = blkno1 / linesize;
+      disksim_lbn_t lineno2 = (blkno2 + bcount2 - 1) / linesize;
+      disksim_lbn_t scatgathcnt = lineno2 - lineno1;
       if (scatgathcnt > cache->maxscatgath) {
 	 return(0);
       }
@@ -232,11 +232,11 @@ static int cache_count_dirty_atoms (struct cache_mem *cache)
 }
 
 
-static cache_atom * cache_find_atom (struct cache_mem *cache, int devno, int lbn)
+static cache_atom * cache_find_atom (struct cache_mem *cache, int devno, disksim_lbn_t lbn)
 {
    cache_atom *tmp = cache->hash[(lbn & CACHE_HASHMASK)];
 /*
-fprintf (outputfile, "Entered cache_find_atom: devno %d, lbn %d, CACHE_HASHMASK %x, setno %d\n", devno, lbn, CACHE_HASHMASK, (lbn & CACHE_HASHMASK));
+fprintf (outputfile, "Entered cache_find_atom: devno %d, lbn %lld, CACHE_HASHMASK %x, setno %d\n", devno, lbn, CACHE_HASHMASK, (int) (lbn & CACHE_HASHMASK));
 */
    while ((tmp) && ((tmp->lbn != lbn) || (tmp->devno != devno))) {
       tmp = tmp->hash_next;
@@ -246,7 +246,7 @@ fprintf (outputfile, "Entered cache_find_atom: devno %d, lbn %d, CACHE_HASHMASK
 
 
 #if 0
-static void cache_remove_lbn_from_hash (struct cache_mem *cache, int devno, int lbn)
+static void cache_remove_lbn_from_hash (struct cache_mem *cache, int devno, disksim_lbn_t lbn)
 {
    cache_atom *tmp;
 
@@ -258,7 +258,7 @@ static void cache_remove_lbn_from_hash (struct cache_mem *cache, int devno, int
 
 
 #if 0
-static void cache_check_for_residence (struct cache_mem *cache, int devno, int lbn, int size, int *miss)
+static void cache_check_for_residence (struct cache_mem *cache, int devno, disksim_lbn_t lbn, int size, int *miss)
 {
    cache_atom *line = NULL;
    int i;
@@ -281,7 +281,7 @@ static void cache_check_for_residence (struct cache_mem *cache, int devno, int l
 #if 0
 /* Use for setting VALID, LOCKDOWN, DIRTY and other atom state bits */
 
-static void cache_set_state (struct cache_mem *cache, int devno, int lbn, int size, int mask)
+static void cache_set_state (struct cache_mem *cache, int devno, disksim_lbn_t lbn, int size, int mask)
 {
    cache_atom *line = NULL;
    int i;
@@ -303,7 +303,7 @@ static void cache_set_state (struct cache_mem *cache, int devno, int lbn, int si
 #if 0
 /* Use for clearing VALID, LOCKDOWN, DIRTY and other atom state bits */
 
-static void cache_reset_state (struct cache_mem *cache, int devno, int lbn, int size, int mask)
+static void cache_reset_state (struct cache_mem *cache, int devno, disksim_lbn_t lbn, int size, int mask)
 {
    cache_atom *line = NULL;
    int i;
@@ -386,7 +386,7 @@ static void cache_access (struct cache_mem *cache, cache_atom *line)
    while (line->line_prev) {
       line = line->line_prev;
    }
-   set = (cache->mapmask) ? (line->lbn % cache->mapmask) : 0;
+   set = (cache->mapmask) ? (int) (line->lbn % cache->mapmask) : 0;
    if (line->lru_next) {
       segnum = line->state & CACHE_SEGNUM;
       cache_remove_from_lrulist(&cache->map[set], line, segnum);
@@ -456,7 +456,7 @@ static void cache_add_to_lockstruct (struct cachelockw **head, void *identifier)
    int i;
 
    if (tmp == NULL) {
-      tmp = (struct cachelockw *) getfromextraq();
+      tmp = (struct cachelockw *) getfromextraq_type(DISKSIM_POOL_CACHE);
 	  memset((char *)tmp, 0, sizeof(struct cachelockw));
       /* bzero ((char *)tmp, sizeof(struct cachelockw)); */
       tmp->entry[0] = identifier;
@@ -480,7 +480,7 @@ static void cache_add_to_lockstruct (struct cachelockw **head, void *identifier)
             return;
          }
       }
-      tmp->next = (struct cachelockw *) getfromextraq();
+      tmp->next = (struct cachelockw *) getfromextraq_type(DISKSIM_POOL_CACHE);
       tmp = tmp->next;
 	  memset ((char *)tmp, 0, sizeof(struct cachelockw));
       /* bzero ((char *)tmp, sizeof(struct cachelockw)); */
@@ -711,11 +711,11 @@ static int cache_free_read_lock (struct cache_mem *cache, cache_atom *target, io
 }
 
 
-static void cache_get_read_lock_range (struct cache_mem *cache, int start, int end, cache_atom *startatom, struct cache_mem_event *waiter)
+static void cache_get_read_lock_range (struct cache_mem *cache, disksim_lbn_t start, disksim_lbn_t end, cache_atom *startatom, struct cache_mem_event *waiter)
 {
    cache_atom *line = (startatom->lbn == start) ? startatom : NULL;
    int lockgran = 1;
-   int i;
+   disksim_lbn_t i;
 
    for (i=start; i<=end; i++) {
       if (line == NULL) {
@@ -732,18 +732,18 @@ static void cache_get_read_lock_range (struct cache_mem *cache, int start, int e
 }
 
 
-static int cache_issue_flushreq (struct cache_mem *cache, int start, int end, cache_atom *startatom, struct cache_mem_event *waiter)
+static int cache_issue_flushreq (struct cache_mem *cache, disksim_lbn_t start, disksim_lbn_t end, cache_atom *startatom, struct cache_mem_event *waiter)
 {
    ioreq_event *flushreq;
    ioreq_event *flushwait;
    int waiting = (cache->IOwaiters == waiter) ? 1 : 0;
 
-   // fprintf (outputfile, "Entered issue_flushreq: start %d, end %d\n", start, end);
+   // fprintf (outputfile, "Entered issue_flushreq: start %lld, end %lld\n", start, end);
 
    flushreq = (ioreq_event *) getfromextraq();
    flushreq->devno = startatom->devno;
    flushreq->blkno = start;
-   flushreq->bcount = end - start + 1;
+   flushreq->bcount = (int) (end - start + 1);
    flushreq->busno = startatom->busno;
    flushreq->slotno = startatom->slotno;
    flushreq->type = IO_ACCESS_ARRIVE;
@@ -766,18 +766,18 @@ static int cache_issue_flushreq (struct cache_mem *cache, int start, int end, ca
    }
    waiter->accblkno = -1;
    cache->stat.destagewrites++;
-   cache->stat.destagewriteatoms += end - start + 1;
+   cache->stat.destagewriteatoms += flushreq->bcount;
 
    cache_get_read_lock_range(cache, start, end, startatom, waiter);
 
-   // fprintf (outputfile, "Issueing dirty block write-back: blkno %d, bcount %d, devno %d\n", flushreq->blkno, flushreq->bcount, flushreq->devno);
+   // fprintf (outputfile, "Issueing dirty block write-back: blkno %lld, bcount %d, devno %d\n", flushreq->blkno, flushreq->bcount, flushreq->devno);
 
    (*cache->issuefunc)(cache->issueparam, flushreq);
    return(1);
 }
 
 
-static int cache_flush_cluster (struct cache_mem *cache, int devno, int blkno, int linecnt, int dir)
+static disksim_lbn_t cache_flush_cluster (struct cache_mem *cache, int devno, disksim_lbn_t blkno, int linecnt, int dir)
 {
    cache_atom *line = NULL;
    int lastclean = 0;
@@ -812,12 +812,12 @@ static int cache_flush_cluster (struct cache_mem *cache, int devno, int blkno, i
 static int cache_initiate_dirty_block_flush (struct cache_mem *cache, cache_atom *dirtyline, struct cache_mem_event *allocdesc)
 {
    cache_atom *dirtyatom = 0;
-   int dirtyend = 0;
-   int dirtystart = -1;
+   disksim_lbn_t dirtyend = 0;
+   disksim_lbn_t dirtystart = -1;
    cache_atom *tmp = dirtyline;
    int flushcnt = 0;
 
-   // fprintf (outputfile, "Entered cache_initiate_dirty_block_flush: %d\n", dirtyline->lbn);
+   // fprintf (outputfile, "Entered cache_initiate_dirty_block_flush: %lld\n", dirtyline->lbn);
 
    while (tmp) {
       int writelocked = cache_atom_iswritelocked(cache, tmp);
@@ -846,7 +846,7 @@ static int cache_initiate_dirty_block_flush (struct cache_mem *cache, cache_atom
       if ((cache->flush_maxlinecluster > 1) && (dirtystart == dirtyline->lbn)) {
          dirtystart = cache_flush_cluster(cache, dirtyatom->devno, dirtystart, 1, -1);
       }
-      linecnt = 1 + ((dirtyline->lbn - dirtystart) / linesize);
+      linecnt = 1 + (int) ((dirtyline->lbn - dirtystart) / linesize);
       if ((linecnt < cache->flush_maxlinecluster) && (dirtyend == (dirtyline->lbn + linesize -1))) {
 	 dirtyend = cache_flush_cluster(cache, dirtyatom->devno, dirtyend, linecnt, 1);
       }
@@ -861,7 +861,7 @@ static int cache_initiate_dirty_block_flush (struct cache_mem *cache, cache_atom
 
 static struct cache_mem_event *cache_get_flushdesc()
 {
-   struct cache_mem_event *flushdesc = (struct cache_mem_event *) getfromextraq();
+   struct cache_mem_event *flushdesc = (struct cache_mem_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
    flushdesc->type = CACHE_EVENT_SYNC;
    flushdesc->donefunc = &disksim->donefunc_cachemem_empty;
    flushdesc->req = NULL;
@@ -1067,12 +1067,12 @@ cache_replace_loop_continue:
 /* Also fill pointer to block allocated.  Null indicates that blocks must  */
 /* be written out but no specific one has yet been allocated.              */
 
-static int cache_get_free_atom (struct cache_mem *cache, int lbn, cache_atom **ret, struct cache_mem_event *allocdesc)
+static int cache_get_free_atom (struct cache_mem *cache, disksim_lbn_t lbn, cache_atom **ret, struct cache_mem_event *allocdesc)
 {
    int writeouts = 0;
-   int set = (cache->mapmask) ? (lbn % cache->mapmask) : 0;
+   int set = (cache->mapmask) ? (int) (lbn % cache->mapmask) : 0;
 
-   // fprintf (outputfile, "Entered cache_get_free_atom: lbn %d, set %d, freelist %p\n", lbn, set, cache->map[set].freelist);
+   // fprintf (outputfile, "Entered cache_get_free_atom: lbn %lld, set %d, freelist %p\n", lbn, set, cache->map[set].freelist);
 
    if (cache->map[set].freelist == NULL) {
       writeouts = cache_replace(cache, set, allocdesc);
@@ -1098,13 +1098,13 @@ struct cache_mem_event *cache_allocate_space_continue (struct cache_mem *cache,
 */
 
    int devno = allocdesc->req->devno;
-   int lbn = allocdesc->lockstop;
-   int stop = allocdesc->allocstop;
+   disksim_lbn_t lbn = allocdesc->lockstop;
+   disksim_lbn_t stop = allocdesc->allocstop;
    cache_atom *cleaned = allocdesc->cleaned;
    cache_atom *lineprev = allocdesc->lineprev;
    int linesize = (cache->linesize) ? cache->linesize : 1;
 
-   // fprintf (outputfile, "Entered allocate_space_continue: lbn %d, stop %d\n", lbn, stop);
+   // fprintf (outputfile, "Entered allocate_space_continue: lbn %lld, stop %lld\n", lbn, stop);
 
    if (allocdesc->waitees) {
       struct cache_mem_event *rwdesc = allocdesc->waitees;
@@ -1186,12 +1186,12 @@ struct cache_mem_event *cache_allocate_space_continue (struct cache_mem *cache,
 }
 
 
-static struct cache_mem_event * cache_allocate_space (struct cache_mem *cache, int lbn, int size, struct cache_mem_event *rwdesc)
+static struct cache_mem_event * cache_allocate_space (struct cache_mem *cache, disksim_lbn_t lbn, int size, struct cache_mem_event *rwdesc)
 {
-   struct cache_mem_event *allocdesc = (struct cache_mem_event *) getfromextraq();
+   struct cache_mem_event *allocdesc = (struct cache_mem_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
    int linesize = max(1, cache->linesize);
 
-   // fprintf (outputfile, "Entered cache_allocate_space: lbn %d, size %d, linesize %d\n", lbn, size, cache->linesize);
+   // fprintf (outputfile, "Entered cache_allocate_space: lbn %lld, size %d, linesize %d\n", lbn, size, cache->linesize);
 
    allocdesc->type = CACHE_EVENT_ALLOCATE;
    allocdesc->req = rwdesc->req;
@@ -1216,10 +1216,10 @@ static int cache_get_rw_lock (struct cache_mem *cache, int locktype, struct cach
    cache_atom *tmp = line;
    int j = 0;
 
-   int lbn = rwdesc->req->blkno;
+   disksim_lbn_t lbn = rwdesc->req->blkno;
    int devno = rwdesc->req->devno;
 
-   // fprintf (outputfile, "Entered cache_get_rw_lock: lbn %d, i %d, stop %d, locktype %d\n", line->lbn, i, stop, locktype);
+   // fprintf (outputfile, "Entered cache_get_rw_lock: lbn %lld, i %d, stop %d, locktype %d\n", line->lbn, i, stop, locktype);
 
    while (j < stop) {
       if (locktype == 1) {
@@ -1231,7 +1231,7 @@ static int cache_get_rw_lock (struct cache_mem *cache, int locktype, struct cach
          lockgran = cache_get_write_lock(cache, tmp, rwdesc);
       }
 
-   // fprintf (outputfile, "got lock: lockgran %d, lbn %d\n", lockgran, tmp->lbn);
+   // fprintf (outputfile, "got lock: lockgran %d, lbn %lld\n", lockgran, tmp->lbn);
 
       if (lockgran == 0) {
          return(1);
@@ -1260,22 +1260,22 @@ static int cache_get_rw_lock (struct cache_mem *cache, int locktype, struct cach
 }
 
 
-static int cache_issue_fillreq (struct cache_mem *cache, int start, int end, struct cache_mem_event *rwdesc, int prefetchtype)
+static int cache_issue_fillreq (struct cache_mem *cache, disksim_lbn_t start, disksim_lbn_t end, struct cache_mem_event *rwdesc, int prefetchtype)
 {
    ioreq_event *fillreq;
    int linesize = max(cache->linesize, 1);
 
-   // fprintf (outputfile, "Entered cache_issue_fillreq: start %d, end %d, prefetchtype %d\n", start, end, prefetchtype);
+   // fprintf (outputfile, "Entered cache_issue_fillreq: start %lld, end %lld, prefetchtype %d\n", start, end, prefetchtype);
 
    if (prefetchtype & CACHE_PREFETCH_FRONTOFLINE) {
       cache_atom *line = cache_find_atom(cache, rwdesc->req->devno, start);
-      int validstart = -1;
+      disksim_lbn_t validstart = -1;
       int lockgran = cache->lockgran;
       while (start % linesize) {
          line = line->line_prev;
          if (line->state & CACHE_VALID) {
 /*
-fprintf (outputfile, "already valid backwards: lbn %d\n", line->lbn);
+fprintf (outputfile, "already valid backwards: lbn %lld\n", line->lbn);
 */
             break;
 /*
@@ -1308,13 +1308,13 @@ fprintf (outputfile, "already valid backwards: lbn %d\n", line->lbn);
    }
    if (prefetchtype & CACHE_PREFETCH_RESTOFLINE) {
       cache_atom *line = cache_find_atom(cache, rwdesc->req->devno, end);
-      int validend = -1;
+      disksim_lbn_t validend = -1;
       int lockgran = cache->lockgran;
       while ((end+1) % linesize) {
          line = line->line_next;
          if (line->state & CACHE_VALID) {
 /*
-fprintf (outputfile, "already valid forwards: lbn %d\n", line->lbn);
+fprintf (outputfile, "already valid forwards: lbn %lld\n", line->lbn);
 */
             break;
 /*
@@ -1348,29 +1348,30 @@ fprintf (outputfile, "already valid forwards: lbn %d\n", line->lbn);
 
    fillreq  = ioreq_copy(rwdesc->req);
    fillreq->blkno = start;
-   fillreq->bcount = end - start + 1;
+   fillreq->bcount = (int) (end - start + 1);
    fillreq->type = IO_ACCESS_ARRIVE;
    fillreq->flags |= READ;
-   rwdesc->req->tempint1 = start;
-   rwdesc->req->tempint2 = end;
+	/* fill extent, relative to the request (it spans at most a line) */
+   rwdesc->req->tempint1 = (int) (start - rwdesc->req->blkno);
+   rwdesc->req->tempint2 = (int) (end - rwdesc->req->blkno);
    rwdesc->type = (rwdesc->type == CACHE_EVENT_READ) ? CACHE_EVENT_READEXTRA : CACHE_EVENT_WRITEFILLEXTRA;
    cache_waitfor_IO(cache, 1, rwdesc, fillreq);
 
-   // fprintf (outputfile, "%f: Issueing line fill request: blkno %d, bcount %d\n", simtime, fillreq->blkno, fillreq->bcount);
+   // fprintf (outputfile, "%f: Issueing line fill request: blkno %lld, bcount %d\n", simtime, fillreq->blkno, fillreq->bcount);
 
    (*cache->issuefunc)(cache->issueparam, fillreq);
-   return(end - start + 1);
+   return(fillreq->bcount);
 }
 
 
 static void cache_unlock_attached_prefetch (struct cache_mem *cache, struct cache_mem_event *rwdesc)
 {
-   int fillstart = rwdesc->req->tempint1;
-   int fillend = rwdesc->req->tempint2 + 1;  /* one beyond, actually */
-   int reqstart = rwdesc->req->blkno;
-   int reqend = reqstart + rwdesc->req->bcount;  /* one beyond, actually */
+   disksim_lbn_t fillstart = rwdesc->req->blkno + rwdesc->req->tempint1;
+   disksim_lbn_t fillend = rwdesc->req->blkno + rwdesc->req->tempint2 + 1;  /* one beyond, actually */
+   disksim_lbn_t reqstart = rwdesc->req->blkno;
+   disksim_lbn_t reqend = reqstart + rwdesc->req->bcount;  /* one beyond, actually */
 
-   // fprintf (outputfile, "Entered cache_unlock_attached_prefetch: fillstart %d, fillend %d, reqstart %d, reqend %d\n", fillstart, fillend, reqstart, reqend);
+   // fprintf (outputfile, "Entered cache_unlock_attached_prefetch: fillstart %lld, fillend %lld, reqstart %lld, reqend %lld\n", fillstart, fillend, reqstart, reqend);
 
    if (fillstart < reqstart) {
       int lockgran = cache->lockgran;
@@ -1432,9 +1433,9 @@ static int cache_read_continue (struct cache_mem *cache, struct cache_mem_event
 
    int linesize = max(1, cache->linesize);
    int devno = readdesc->req->devno;
-   int lbn = readdesc->req->blkno;
+   disksim_lbn_t lbn = readdesc->req->blkno;
    int size = readdesc->req->bcount;
-   int validpoint = readdesc->validpoint;
+   disksim_lbn_t validpoint = readdesc->validpoint;
 
    if (cache->size == 0) {
       cache_waitfor_IO(cache, 1, readdesc, readdesc->req);
@@ -1445,9 +1446,9 @@ static int cache_read_continue (struct cache_mem *cache, struct cache_mem_event
       (*cache->issuefunc)(cache->issueparam, ioreq_copy(readdesc->req));
       return(1);
    }
-   i = readdesc->lockstop;
+   i = (int) readdesc->lockstop;
 
-   // fprintf (outputfile, "Entered cache_read_continue: lbn %d, size %d, i %d\n", lbn, size, i);
+   // fprintf (outputfile, "Entered cache_read_continue: lbn %lld, size %d, i %d\n", lbn, size, i);
 
 read_cont_loop:
    while (i < size) {
@@ -1461,10 +1462,10 @@ read_cont_loop:
             continue;
          }
       }
-      stop = min(rounduptomult((size - i), cache->atomsperbit), (linesize - ((lbn + i) % linesize)));
+      stop = min(rounduptomult((size - i), cache->atomsperbit), (linesize - (int) ((lbn + i) % linesize)));
 
-      // fprintf (outputfile, "stop %d, lbn %d, atomsperbit %d, i %d, size %d, linesize %d\n", stop, lbn, cache->atomsperbit, i, size, linesize);
-      // fprintf (outputfile, "validpoint %d, i %d\n", validpoint, i);
+      // fprintf (outputfile, "stop %d, lbn %lld, atomsperbit %d, i %d, size %d, linesize %d\n", stop, lbn, cache->atomsperbit, i, size, linesize);
+      // fprintf (outputfile, "validpoint %lld, i %d\n", validpoint, i);
 
       j = 0;
       tmp = line;
@@ -1473,7 +1474,7 @@ read_cont_loop:
       while (j < stop) {
          int locktype = (tmp->state & CACHE_VALID) ? 1 : 2;
 
-         // fprintf (outputfile, "j %d, valid %d, validpoint %d, curlock %d, lockgran %d\n", j, (tmp->state & CACHE_VALID), validpoint, curlock, lockgran);
+         // fprintf (outputfile, "j %d, valid %d, validpoint %lld, curlock %d, lockgran %d\n", j, (tmp->state & CACHE_VALID), validpoint, curlock, lockgran);
 
          if (locktype > curlock) {
             curlock = locktype;
@@ -1519,7 +1520,7 @@ read_cont_loop:
          tmp = tmp->line_next;
          j++;
       }
-      if ((validpoint != -1) && ((cache->read_line_by_line) || (!cache_concatok(cache, validpoint, 1, (validpoint+1), (line->lbn + stop - validpoint))))) {
+      if ((validpoint != -1) && ((cache->read_line_by_line) || (!cache_concatok(cache, validpoint, 1, (validpoint+1), (int) (line->lbn + stop - validpoint))))) {
          /* Start fill of the line */
          readdesc->allocstop |= 1;
          cache->stat.fillreads++;
@@ -1530,9 +1531,9 @@ read_cont_loop:
          readdesc->validpoint = -1;
          return(1);
       }
-      i += linesize - ((lbn + i) % linesize);
+      i += linesize - (int) ((lbn + i) % linesize);
 
-      //fprintf (outputfile, "validpoint %d, i %d\n", validpoint, i);
+      //fprintf (outputfile, "validpoint %lld, i %d\n", validpoint, i);
    }
 
    if (validpoint != -1) {
@@ -1573,23 +1574,23 @@ static int cache_write_continue (struct cache_mem *cache, struct cache_mem_event
    cache_atom *tmp;
    int lockgran;
    int i, j;
-   int startfillstart;
-   int startfillstop = 0;
-   int endfillstart;
-   int endfillstop = 0;
+   disksim_lbn_t startfillstart;
+   disksim_lbn_t startfillstop = 0;
+   disksim_lbn_t endfillstart;
+   disksim_lbn_t endfillstop = 0;
    int ret;
 
    int devno = writedesc->req->devno;
-   int lbn = writedesc->req->blkno;
+   disksim_lbn_t lbn = writedesc->req->blkno;
    int size = writedesc->req->bcount;
    int linesize = (cache->linesize > 1) ? cache->linesize : 1;
 
    if (cache->size == 0) {
       return(0);
    }
-   i = writedesc->lockstop;
+   i = (int) writedesc->lockstop;
 
-   // fprintf (outputfile, "Entered cache_write_continue: lbn %d, size %d, i %d\n", lbn, size, i);
+   // fprintf (outputfile, "Entered cache_write_continue: lbn %lld, size %d, i %d\n", lbn, size, i);
 
 write_cont_loop:
 
@@ -1610,7 +1611,7 @@ write_cont_loop:
             }
          }
       }
-      stop = min(rounduptomult((size - i), cache->atomsperbit), (linesize - ((lbn + i) % linesize)));
+      stop = min(rounduptomult((size - i), cache->atomsperbit), (linesize - (int) ((lbn + i) % linesize)));
       j = 0;
       tmp = line;
       lockgran = 0;
@@ -1635,7 +1636,7 @@ write_cont_loop:
             }
             startfillstop = tmp->lbn;
          } else if ((tmp->state & CACHE_VALID) == 0) {
-            int tmpval = tmp->lbn - (lbn + size - 1);
+            disksim_lbn_t tmpval = tmp->lbn - (lbn + size - 1);
             writedesc->allocstop |= 2;
             if ((tmpval > 0) && (tmpval < (cache->atomsperbit - ((lbn + size - 1) % cache->atomsperbit)))) {
                tmp->state |= CACHE_VALID;
@@ -1655,18 +1656,17 @@ write_cont_loop:
       /* (fill) first -- flag undo of allocation to bypass (no bypass for now */
 
       if ((startfillstart != -1) || (endfillstart != -1)) {
-         int fillblkno = (startfillstart != -1) ? startfillstart : endfillstart;
-         int fillbcount = 1 - fillblkno;
-         fillbcount += ((startfillstart != -1) && (endfillstart == -1)) ? startfillstop : endfillstop;
+         disksim_lbn_t fillblkno = (startfillstart != -1) ? startfillstart : endfillstart;
+         int fillbcount = 1 + (int) ((((startfillstart != -1) && (endfillstart == -1)) ? startfillstop : endfillstop) - fillblkno);
          cache->stat.writeinducedfills++;
 
-         // fprintf (outputfile, "Write induced fill: blkno %d, bcount %d\n", fillblkno, fillbcount);
+         // fprintf (outputfile, "Write induced fill: blkno %lld, bcount %d\n", fillblkno, fillbcount);
 
          cache->stat.writeinducedfillatoms += cache_issue_fillreq(cache, fillblkno, (fillblkno + fillbcount - 1), writedesc, cache->writefill_prefetch_type);
          return(1);
       }
 
-      i += linesize - ((lbn + i) % linesize);
+      i += linesize - (int) ((lbn + i) % linesize);
    }
    cache->stat.writes++;
    cache->stat.writeatoms += writedesc->req->bcount;
@@ -1696,11 +1696,11 @@ cachemem_get_block (struct cache_if *c,
 		    void *doneparam)
 {
   struct cache_mem *cache = (struct cache_mem *)c;
-   struct cache_mem_event *rwdesc = (struct cache_mem_event *) getfromextraq();
+   struct cache_mem_event *rwdesc = (struct cache_mem_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
    int ret;
 
    // fprintf (outputfile, "totalreqs = %d\n", disksim->totalreqs);
-   // fprintf (outputfile, "%.5f: Entered cache_get_block: rw %d, devno %d, blkno %d, size %d\n", simtime, (req->flags & READ), req->devno, req->blkno, req->bcount);
+   // fprintf (outputfile, "%.5f: Entered cache_get_block: rw %d, devno %d, blkno %lld, size %d\n", simtime, (req->flags & READ), req->devno, req->blkno, req->bcount);
 
    rwdesc->type = (req->flags & READ) ? CACHE_EVENT_READ : CACHE_EVENT_WRITE;
    rwdesc->donefunc = donefunc;
@@ -1720,7 +1720,7 @@ cachemem_get_block (struct cache_if *c,
       ret = cache_write_continue(cache, rwdesc);
    }
 
-   // fprintf (outputfile, "rwdesc %p, ret %x, validpoint %d\n", rwdesc, ret, rwdesc->validpoint);
+   // fprintf (outputfile, "rwdesc %p, ret %x, validpoint %lld\n", rwdesc, ret, rwdesc->validpoint);
 
    if (ret == 0) {
       (*donefunc)(doneparam, req);
@@ -1744,7 +1744,7 @@ cachemem_free_block_clean (struct cache_if *c,
    int lockgran = 0;
    int i;
 
-   // fprintf (outputfile, "%.5f: Entered cache_free_block_clean: blkno %d, bcount %d, devno %d\n", simtime, req->blkno, req->bcount, req->devno);
+   // fprintf (outputfile, "%.5f: Entered cache_free_block_clean: blkno %lld, bcount %d, devno %d\n", simtime, req->blkno, req->bcount, req->devno);
 
    cache->stat.freeblockcleans++;
    if (cache->size == 0) {
@@ -1791,19 +1791,20 @@ cachemem_free_block_dirty (struct cache_if *c,
    ioreq_event *flushreq = 0;
    struct cache_mem_event *writedesc = 0;
    int lockgran = 0;
-   int flushblkno = req->blkno;
+   disksim_lbn_t flushblkno = req->blkno;
+   disksim_lbn_t flushend;
    int flushbcount = req->bcount;
    int linebyline = cache->linebylinetmp;
    int i;
 
    int writethru = (cache->size == 0) || (cache->writescheme != CACHE_WRITE_BACK);
 
-   // fprintf (outputfile, "%.5f, Entered cache_free_block_dirty: blkno %d, size %d, writethru %d\n", simtime, req->blkno, req->bcount, writethru);
+   // fprintf (outputfile, "%.5f, Entered cache_free_block_dirty: blkno %lld, size %d, writethru %d\n", simtime, req->blkno, req->bcount, writethru);
 
    cache->linebylinetmp = 0;
    cache->stat.freeblockdirtys++;
    if (writethru) {
-      writedesc = (struct cache_mem_event *) getfromextraq();
+      writedesc = (struct cache_mem_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
       writedesc->type = CACHE_EVENT_SYNC;
       writedesc->donefunc = donefunc;
       writedesc->doneparam = doneparam;
@@ -1823,14 +1824,14 @@ cachemem_free_block_dirty (struct cache_if *c,
       return(1);
    }
 
-   // fprintf (outputfile, "flushblkno %d, reqblkno %d, atomsperbit %d\n", flushblkno, req->blkno, cache->atomsperbit);
+   // fprintf (outputfile, "flushblkno %lld, reqblkno %lld, atomsperbit %d\n", flushblkno, req->blkno, cache->atomsperbit);
 
    flushblkno -= (req->blkno % cache->atomsperbit);
-   flushbcount += (req->blkno % cache->atomsperbit);
-   i = flushblkno + flushbcount;
-   flushbcount += rounduptomult(i, cache->atomsperbit) - i;
+   flushbcount += (int) (req->blkno % cache->atomsperbit);
+   flushend = flushblkno + flushbcount;
+   flushbcount += (int) (rounduptomult(flushend, cache->atomsperbit) - flushend);
 
-   // fprintf (outputfile, "in free_block_dirty: flushblkno %d, flushsize %d\n", flushblkno, flushbcount);
+   // fprintf (outputfile, "in free_block_dirty: flushblkno %lld, flushsize %d\n", flushblkno, flushbcount);
 
    for (i=0; i<flushbcount; i++) {
       if (line == NULL) {
@@ -1871,7 +1872,7 @@ cachemem_free_block_dirty (struct cache_if *c,
       }
       cache_waitfor_IO(cache, 1, writedesc, flushreq);
 
-      // fprintf (outputfile, "Issueing dirty block flush: writedesc %p, req %p, blkno %d, bcount %d, devno %d\n", writedesc, writedesc->req, flushreq->blkno, flushreq->bcount, flushreq->devno);
+      // fprintf (outputfile, "Issueing dirty block flush: writedesc %p, req %p, blkno %lld, bcount %d, devno %d\n", writedesc, writedesc->req, flushreq->blkno, flushreq->bcount, flushreq->devno);
 
       (*cache->issuefunc)(cache->issueparam, flushreq);
       if (cache->writescheme == CACHE_WRITE_SYNCONLY) {
@@ -1906,7 +1907,7 @@ cache_write_line_by_line (struct cache_mem *cache,
           /* partial write sync must have been initiated if it is done */
       ASSERT(!reqdone);
 
-      tmp = (struct cache_mem_event *) getfromextraq();
+      tmp = (struct cache_mem_event *) getfromextraq_type(DISKSIM_POOL_CACHE);
       tmp->req = writedesc->req;
       tmp->locktype = writedesc->req->blkno;
       tmp->lockstop = writedesc->req->bcount;
@@ -1918,7 +1919,7 @@ cache_write_line_by_line (struct cache_mem *cache,
       cache->partwrites = tmp;
    }
    if (reqdone) {
-      tmp->req->bcount = tmp->accblkno - flushreq->blkno;
+      tmp->req->bcount = (int) (tmp->accblkno - flushreq->blkno);
       tmp->req->blkno = flushreq->blkno;
       tmp->req->type = 0;
       cachemem_free_block_clean((struct cache_if *)cache, tmp->req);
@@ -1932,11 +1933,11 @@ cache_write_line_by_line (struct cache_mem *cache,
             tmp->next->prev = tmp->prev;
          }
          tmp->req->blkno = tmp->locktype;
-         tmp->req->bcount = tmp->lockstop;
+         tmp->req->bcount = (int) tmp->lockstop;
          (*writedesc->donefunc)(writedesc->doneparam, tmp->req);
          addtoextraq((event *) tmp);
       } else {
-         tmp->req->bcount = tmp->locktype + tmp->lockstop - tmp->accblkno;
+         tmp->req->bcount = (int) (tmp->locktype + tmp->lockstop - tmp->accblkno);
          tmp->req->blkno = tmp->accblkno;
 	 cache->linebylinetmp = 1;
          cachemem_free_block_dirty((struct cache_if *)cache, tmp->req, writedesc->donefunc, writedesc->doneparam);
@@ -1962,14 +1963,14 @@ cachemem_disk_access_complete (struct cache_if *c, ioreq_event *curr)
    ioreq_event *req;
    struct cache_mem_event *tmp = cache->IOwaiters;
 
-   // fprintf (outputfile, "Entered cache_disk_access_complete: blkno %d, bcount %d, devno %d\n", curr->blkno, curr->bcount, curr->devno);
+   // fprintf (outputfile, "Entered cache_disk_access_complete: blkno %lld, bcount %d, devno %d\n", curr->blkno, curr->bcount, curr->devno);
 
    while (tmp) {
       req = tmp->req;
       while (req) {
          if ((curr->devno == req->devno) && ((curr->blkno == tmp->accblkno) || ((tmp->accblkno == -1) && ((req->next) || (tmp->type == CACHE_EVENT_SYNC) || (tmp->type == CACHE_EVENT_IDLESYNC)) && (curr->blkno == req->blkno)))) {
 
-   // fprintf (outputfile, "Matched: tmp %p, req %p, blkno %d, accblkno %d, reqblkno %d\n", tmp, req, curr->blkno, tmp->accblkno, req->blkno);
+   // fprintf (outputfile, "Matched: tmp %p, req %p, blkno %lld, accblkno %lld, reqblkno %lld\n", tmp, req, curr->blkno, tmp->accblkno, req->blkno);
 
             goto completed_access;
          }
@@ -2145,6 +2146,30 @@ cachemem_setcallbacks(void)
 }
 
 
+/* A sampled trace (see "Trace sample rate") gets the same fraction of */
+/* the cache, in whole lines, before the cache atoms are allocated.    */
+
+static void
+cachemem_sample_scale (struct cache_mem *cache)
+{
+   int linesize = (cache->linesize) ? cache->linesize : 1;
+   int size = (int) (((double) cache->size * disksim->tracesample) + 0.5);
+   int i, j;
+
+   cache->sampled = TRUE;
+   if ((cache->size == 0) || (cache->map[0].freelist != NULL)) {
+      return;
+   }
+   size = max(linesize, (size - (size % linesize)));
+   for (j=0; j<(cache->mapmask+1); j++) {
+      for (i=0; i<CACHE_MAXSEGMENTS; i++) {
+         cache->map[j].maxactive[i] = (int) (((double) cache->map[j].maxactive[i] * (double) size / (double) cache->size) + 0.5);
+      }
+   }
+   cache->size = size;
+}
+
+
 static void 
 cachemem_initialize (struct cache_if *c, 
 		     void (**issuefunc)(void *,ioreq_event *), 
@@ -2178,6 +2203,9 @@ cachemem_initialize (struct cache_if *c,
    for (i=0; i<CACHE_HASHSIZE; i++) {
       cache->hash[i] = 0;
    }
+   if (TRACE_SAMPLED && !cache->sampled) {
+      cachemem_sample_scale(cache);
+   }
    for (j=0; j<(cache->mapmask+1); j++) {
       cache_mapentry *mapentry = &cache->map[j];
       for (i=0; i<CACHE_MAXSEGMENTS; i++) {
@@ -2194,7 +2222,7 @@ cachemem_initialize (struct cache_if *c,
          int linesize = (cache->linesize) ? cache->linesize : 1;
          tmp = NULL;
          for (i=0; i<atomcnt; i++) {
-            cache_atom *newatom = (cache_atom *) getfromextraq();
+            cache_atom *newatom = (cache_atom *) getfromextraq_type(DISKSIM_POOL_CACHE);
 			memset((char *) newatom, 0, DISKSIM_EVENT_SIZE);
             /* bzero ((char *) newatom, DISKSIM_EVENT_SIZE); */
             if (i % linesize) {
@@ -2247,46 +2275,63 @@ cachemem_printstats (struct cache_if *c, char *prefix)
    int atoms = cache->stat.readatoms + cache->stat.writeatoms;
 
    fprintf (outputfile, "%scache requests:             %6d\n", prefix, reqs);
+   stat_json_value(prefix, "cache requests", reqs);
    if (reqs == 0) {
       return;
    }
 
    fprintf (outputfile, "%scache read requests:        %6d  \t%6.4f\n", prefix, cache->stat.reads, ((double) cache->stat.reads / (double) reqs));
+   stat_json_value(prefix, "cache read requests", cache->stat.reads);
 
    if (cache->stat.reads) {
 
       fprintf(outputfile, "%scache atoms read:           %6d  \t%6.4f\n", prefix, cache->stat.readatoms, ((double) cache->stat.readatoms / (double) atoms));
+      stat_json_value(prefix, "cache atoms read", cache->stat.readatoms);
 
       fprintf(outputfile, "%scache read misses:          %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.readmisses, ((double) cache->stat.readmisses / (double) reqs), ((double) cache->stat.readmisses / (double) cache->stat.reads));
+      stat_json_value(prefix, "cache read misses", cache->stat.readmisses);
 
       fprintf(outputfile, "%scache read full hits:       %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.readhitsfull, ((double) cache->stat.readhitsfull / (double) reqs), ((double) cache->stat.readhitsfull / (double) cache->stat.reads));
+      stat_json_value(prefix, "cache read full hits", cache->stat.readhitsfull);
 
       fprintf(outputfile, "%scache fills (read):         %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.fillreads, ((double) cache->stat.fillreads / (double) reqs), ((double) cache->stat.fillreads / (double) cache->stat.reads));
+      stat_json_value(prefix, "cache fills (read)", cache->stat.fillreads);
 
       fprintf(outputfile, "%scache atom fills (read):    %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.fillreadatoms, ((double) cache->stat.fillreadatoms / (double) atoms), ((double) cache->stat.fillreadatoms / (double) cache->stat.readatoms));
+      stat_json_value(prefix, "cache atom fills (read)", cache->stat.fillreadatoms);
    }
 
    fprintf(outputfile, "%scache write requests:       %6d  \t%6.4f\n", prefix, cache->stat.writes, ((double) cache->stat.writes / (double) reqs));
+   stat_json_value(prefix, "cache write requests", cache->stat.writes);
 
    if (cache->stat.writes) {
 
       fprintf(outputfile, "%scache atoms written:        %6d  \t%6.4f\n", prefix, cache->stat.writeatoms, ((double) cache->stat.writeatoms / (double) atoms));
+      stat_json_value(prefix, "cache atoms written", cache->stat.writeatoms);
 
       fprintf(outputfile, "%scache write misses:         %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writemisses, ((double) cache->stat.writemisses / (double) reqs), ((double) cache->stat.writemisses / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache write misses", cache->stat.writemisses);
 
       fprintf(outputfile, "%scache write hits (clean):   %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writehitsclean, ((double) cache->stat.writehitsclean / (double) reqs), ((double) cache->stat.writehitsclean / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache write hits (clean)", cache->stat.writehitsclean);
 
       fprintf(outputfile, "%scache write hits (dirty):   %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writehitsdirty, ((double) cache->stat.writehitsdirty / (double) reqs), ((double) cache->stat.writehitsdirty / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache write hits (dirty)", cache->stat.writehitsdirty);
 
       fprintf(outputfile, "%scache fills (write):        %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writeinducedfills, ((double)cache->stat.writeinducedfills / (double) reqs), ((double) cache->stat.writeinducedfills / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache fills (write)", cache->stat.writeinducedfills);
 
       fprintf(outputfile, "%scache atom fills (write):   %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.writeinducedfillatoms, ((double)cache->stat.writeinducedfillatoms / (double) atoms), ((double) cache->stat.writeinducedfillatoms / (double) cache->stat.writeatoms));
+      stat_json_value(prefix, "cache atom fills (write)", cache->stat.writeinducedfillatoms);
 
       fprintf(outputfile, "%scache destages (write):     %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagewrites, ((double) cache->stat.destagewrites / (double) reqs), ((double) cache->stat.destagewrites / (double) cache->stat.writes));
+      stat_json_value(prefix, "cache destages (write)", cache->stat.destagewrites);
 
       fprintf(outputfile, "%scache atom destages (write): %6d  \t%6.4f  \t%6.4f\n", prefix, cache->stat.destagewriteatoms, ((double) cache->stat.destagewriteatoms / (double) atoms), ((double) cache->stat.destagewriteatoms / (double) cache->stat.writeatoms));
+      stat_json_value(prefix, "cache atom destages (write)", cache->stat.destagewriteatoms);
 
       fprintf(outputfile, "%scache end dirty atoms:      %6d  \t%6.4f\n", prefix, cache_count_dirty_atoms(cache), ((double) cache_count_dirty_atoms(cache) / (double) cache->stat.writeatoms));
+      stat_json_value(prefix, "cache end dirty atoms", cache_count_dirty_atoms(cache));
    }
 
 
@@ -2356,6 +2401,7 @@ cachemem_copy (struct cache_if *c)
    new->write_line_by_line = cache->write_line_by_line;
    new->maxscatgath = cache->maxscatgath;
    new->no_write_allocate = cache->no_write_allocate;
+   new->sampled = cache->sampled;
 
    return (struct cache_if *)new;
 }
@@ -2465,6 +2511,16 @@ struct cache_if *disksim_cachemem_loadparams(struct lp_block *b)
 }
 
 
+/* change one parameter of a loaded memory cache; -1 if c isn't one */
+int disksim_cachemem_setparam(struct cache_if *c, char *name, char *value)
+{
+  if(c->cache_copy != disksim_cache_mem.cache_copy) {
+    return -1;
+  }
+  return lp_setparam(c, &disksim_cachemem_mod, name, value);
+}
+
+
 
 
 
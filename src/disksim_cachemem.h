@@ -128,8 +128,8 @@ typedef struct cacheatom {
    struct cacheatom *line_next;
    struct cacheatom *line_prev;
    int devno;
-   int lbn;
    int state;
+   disksim_lbn_t lbn;
    struct cacheatom *lru_next;
    struct cacheatom *lru_prev;
    cache_lockholders *readlocks;
@@ -142,20 +142,21 @@ typedef struct cacheatom {
 struct cache_mem_event {
    double time;
    int type;
+   int intqpos;
    struct cache_mem_event *next;
    struct cache_mem_event *prev;
    void (**donefunc)(void *,ioreq_event *);	/* Function to call when complete */
    void *doneparam;		/* parameter for donefunc */
    int flags;
    ioreq_event *req;
-   int accblkno;		/* start blkno of waited for ioacc */
+   disksim_lbn_t accblkno;	/* start blkno of waited for ioacc */
    cache_atom *cleaned;
    cache_atom *lineprev;
-   int locktype;
-   int lockstop;
-   int allocstop;
+   disksim_lbn_t locktype;	/* also original blkno of a partial write */
+   disksim_lbn_t lockstop;	/* also next lbn to allocate */
+   disksim_lbn_t allocstop;
    struct cache_mem_event *waitees;
-   int validpoint;
+   disksim_lbn_t validpoint;
 };
 
 
@@ -224,6 +225,7 @@ struct cache_mem {
    int write_line_by_line;
    int maxscatgath;
    int no_write_allocate;
+   int sampled;					/* size scaled to the trace sample */
    int flush_policy;
    double flush_period;
    double flush_idledelay;
@@ -279,6 +281,7 @@ struct cache_mem {
 #define CACHE_FLUSH_MAX		1
 
 void cachemem_setcallbacks(void);
+int disksim_cachemem_setparam(struct cache_if *c, char *name, char *value);
 
 #endif // DISKSIM_CACHEMEM_H
 
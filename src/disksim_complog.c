@@ -0,0 +1,376 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* Binary completion log (see disksim_complog.h).  Records are encoded   */
+/* into one of two COMPLOG_BUFLEN buffers.  When one fills up it is      */
+/* handed to the writer thread and the simulation carries on in the      */
+/* other, so it only waits if the writer has still not written out the   */
+/* previous buffer.  The hand-off is rare enough that a mutex is cheap.  */
+/* Without threads the full buffer is just written out in place.         */
+
+#include "disksim_global.h"
+#include "disksim_complog.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define COMPLOG_BUFRECS		16384
+#define COMPLOG_BUFLEN		(COMPLOG_BUFRECS * COMPLOG_RECLEN)
+
+struct complog {
+   FILE          *outfile;
+   int            error;
+   int            cur;		/* buffer being filled */
+   int            fill;		/* records in it */
+#ifndef _WIN32
+   pthread_t      thread;
+   pthread_mutex_t lock;
+   pthread_cond_t cond;
+   int            running;
+   int            stop;		/* asks the writer to exit */
+   int            pending;	/* buffer handed to the writer, or -1 */
+   size_t         pendinglen;
+#endif
+   char          *buf[2];
+};
+
+
+static INLINE void complog_put64 (char *ptr, u_int64_t val)
+{
+   int i;
+
+   for (i=0; i<8; i++) {
+      ptr[i] = (char) (val >> (8 * i));
+   }
+}
+
+
+static INLINE void complog_put32 (char *ptr, u_int32_t val)
+{
+   int i;
+
+   for (i=0; i<4; i++) {
+      ptr[i] = (char) (val >> (8 * i));
+   }
+}
+
+
+static INLINE u_int64_t complog_get64 (unsigned char *ptr)
+{
+   u_int64_t val = 0;
+   int i;
+
+   for (i=7; i>=0; i--) {
+      val = (val << 8) | ptr[i];
+   }
+   return(val);
+}
+
+
+static INLINE u_int32_t complog_get32 (unsigned char *ptr)
+{
+   return((u_int32_t) ptr[0] | ((u_int32_t) ptr[1] << 8) | ((u_int32_t) ptr[2] << 16) | ((u_int32_t) ptr[3] << 24));
+}
+
+
+static INLINE void complog_putdouble (char *ptr, double val)
+{
+   u_int64_t bits;
+
+   memcpy(&bits, &val, sizeof(bits));
+   complog_put64(ptr, bits);
+}
+
+
+static INLINE double complog_getdouble (unsigned char *ptr)
+{
+   u_int64_t bits = complog_get64(ptr);
+   double val;
+
+   memcpy(&val, &bits, sizeof(val));
+   return(val);
+}
+
+
+static void complog_write (complog *log, char *buf, size_t len)
+{
+   if ((len > 0) && (fwrite(buf, 1, len, log->outfile) != len)) {
+      log->error = TRUE;
+   }
+}
+
+
+#ifndef _WIN32
+
+static void * complog_main (void *arg)
+{
+   complog *log = arg;
+
+   pthread_mutex_lock(&log->lock);
+   while (TRUE) {
+      while ((log->pending < 0) && !log->stop) {
+         pthread_cond_wait(&log->cond, &log->lock);
+      }
+      if (log->pending < 0) {
+         break;
+      }
+      pthread_mutex_unlock(&log->lock);
+      complog_write(log, log->buf[log->pending], log->pendinglen);
+      pthread_mutex_lock(&log->lock);
+      log->pending = -1;
+      pthread_cond_broadcast(&log->cond);
+   }
+   pthread_mutex_unlock(&log->lock);
+   return(NULL);
+}
+
+
+/* Hands the current buffer to the writer and switches to the other. */
+
+static void complog_handoff (complog *log)
+{
+   if (!log->running) {
+      complog_write(log, log->buf[log->cur], (log->fill * COMPLOG_RECLEN));
+      log->fill = 0;
+      return;
+   }
+   pthread_mutex_lock(&log->lock);
+   while (log->pending >= 0) {
+      pthread_cond_wait(&log->cond, &log->lock);
+   }
+   log->pending = log->cur;
+   log->pendinglen = log->fill * COMPLOG_RECLEN;
+   pthread_cond_broadcast(&log->cond);
+   pthread_mutex_unlock(&log->lock);
+   log->cur ^= 1;
+   log->fill = 0;
+}
+
+
+/* Waits until the writer has nothing left to write. */
+
+static void complog_drain (complog *log)
+{
+   if (!log->running) {
+      return;
+   }
+   pthread_mutex_lock(&log->lock);
+   while (log->pending >= 0) {
+      pthread_cond_wait(&log->cond, &log->lock);
+   }
+   pthread_mutex_unlock(&log->lock);
+}
+
+
+void complog_pause (complog *log)
+{
+   if ((log == NULL) || !log->running) {
+      return;
+   }
+   if (log->fill > 0) {
+      complog_handoff(log);
+   }
+   complog_drain(log);
+   fflush(log->outfile);
+   pthread_mutex_lock(&log->lock);
+   log->stop = TRUE;
+   pthread_cond_broadcast(&log->cond);
+   pthread_mutex_unlock(&log->lock);
+   pthread_join(log->thread, NULL);
+   pthread_mutex_destroy(&log->lock);
+   pthread_cond_destroy(&log->cond);
+   log->running = FALSE;
+}
+
+
+/* (Re)starts the writer thread.  If it cannot be started, full */
+/* buffers are written out in place instead.                    */
+
+void complog_resume (complog *log)
+{
+   if ((log == NULL) || log->running) {
+      return;
+   }
+   log->stop = FALSE;
+   log->pending = -1;
+   pthread_mutex_init(&log->lock, NULL);
+   pthread_cond_init(&log->cond, NULL);
+   if (pthread_create(&log->thread, NULL, complog_main, log) != 0) {
+      pthread_mutex_destroy(&log->lock);
+      pthread_cond_destroy(&log->cond);
+      return;
+   }
+   log->running = TRUE;
+}
+
+#else
+
+static void complog_handoff (complog *log)
+{
+   complog_write(log, log->buf[log->cur], (log->fill * COMPLOG_RECLEN));
+   log->fill = 0;
+}
+
+static void complog_drain (complog *log) { }
+void complog_pause (complog *log) { }
+void complog_resume (complog *log) { }
+
+#endif
+
+
+complog * complog_open (char *filename)
+{
+   complog *log;
+   char hdr[COMPLOG_HDRLEN];
+
+   log = calloc(1, sizeof(complog));
+   if (log == NULL) {
+      return(NULL);
+   }
+   log->buf[0] = malloc(COMPLOG_BUFLEN);
+   log->buf[1] = malloc(COMPLOG_BUFLEN);
+   if ((log->buf[0] == NULL) || (log->buf[1] == NULL) || ((log->outfile = fopen(filename, "wb")) == NULL)) {
+      free(log->buf[0]);
+      free(log->buf[1]);
+      free(log);
+      return(NULL);
+   }
+   memcpy(hdr, COMPLOG_MAGIC, 8);
+   complog_put32((hdr + 8), COMPLOG_VERSION);
+   complog_put32((hdr + 12), COMPLOG_RECLEN);
+   complog_write(log, hdr, COMPLOG_HDRLEN);
+   complog_resume(log);
+   return(log);
+}
+
+
+void complog_put (complog *log, complog_rec *rec)
+{
+   char *ptr = log->buf[log->cur] + (log->fill * COMPLOG_RECLEN);
+
+   complog_putdouble(ptr, rec->arrival);
+   complog_putdouble((ptr + 8), rec->start);
+   complog_putdouble((ptr + 16), rec->done);
+   complog_putdouble((ptr + 24), rec->qtime);
+   complog_put64((ptr + 32), (u_int64_t) rec->blkno);
+   complog_put32((ptr + 40), (u_int32_t) rec->devno);
+   complog_put32((ptr + 44), (u_int32_t) rec->bcount);
+   complog_put32((ptr + 48), (u_int32_t) rec->flags);
+   complog_put32((ptr + 52), 0);
+   if (++log->fill == COMPLOG_BUFRECS) {
+      complog_handoff(log);
+   }
+}
+
+
+/* Writes out everything logged so far and, if pos is given, notes */
+/* where the log continues.                                        */
+
+void complog_sync (complog *log, fpos_t *pos)
+{
+   if (log->fill > 0) {
+      complog_handoff(log);
+   }
+   complog_drain(log);
+   fflush(log->outfile);
+   if (pos) {
+      fgetpos(log->outfile, pos);
+   }
+}
+
+
+void complog_restore (complog *log, char *filename, fpos_t *pos)
+{
+   int ret;
+
+#ifndef _WIN32
+   log->running = FALSE;
+#endif
+   log->fill = 0;
+   if ((log->outfile = fopen(filename, "r+b")) == NULL) {
+      fprintf(stderr, "Completion log %s cannot be opened for write access\n", filename);
+      exit(1);
+   }
+   ret = fsetpos(log->outfile, pos);
+   assert(ret >= 0);
+#ifndef _WIN32
+   /* drop whatever the interrupted run logged after the checkpoint */
+   ret = ftruncate(fileno(log->outfile), ftello(log->outfile));
+   assert(ret >= 0);
+#endif
+   complog_resume(log);
+}
+
+
+int complog_close (complog *log)
+{
+   int error;
+
+   complog_sync(log, NULL);
+   complog_pause(log);
+   error = log->error | (fclose(log->outfile) != 0);
+   free(log->buf[0]);
+   free(log->buf[1]);
+   free(log);
+   return(error);
+}
+
+
+int complog_read_header (FILE *infile)
+{
+   unsigned char hdr[COMPLOG_HDRLEN];
+
+   if ((fread(hdr, 1, COMPLOG_HDRLEN, infile) != COMPLOG_HDRLEN) || (memcmp(hdr, COMPLOG_MAGIC, 8) != 0)) {
+      return(0);
+   }
+   return((complog_get32(hdr + 8) == COMPLOG_VERSION) && (complog_get32(hdr + 12) == COMPLOG_RECLEN));
+}
+
+
+int complog_read (FILE *infile, complog_rec *rec)
+{
+   unsigned char ptr[COMPLOG_RECLEN];
+
+   if (fread(ptr, 1, COMPLOG_RECLEN, infile) != COMPLOG_RECLEN) {
+      return(0);
+   }
+   rec->arrival = complog_getdouble(ptr);
+   rec->start = complog_getdouble(ptr + 8);
+   rec->done = complog_getdouble(ptr + 16);
+   rec->qtime = complog_getdouble(ptr + 24);
+   rec->blkno = (disksim_lbn_t) complog_get64(ptr + 32);
+   rec->devno = (int) complog_get32(ptr + 40);
+   rec->bcount = (int) complog_get32(ptr + 44);
+   rec->flags = (int) complog_get32(ptr + 48);
+   return(1);
+}
@@ -0,0 +1,84 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#ifndef DISKSIM_COMPLOG_H
+#define DISKSIM_COMPLOG_H
+
+/* Binary completion log.  One fixed-size record per completed request, */
+/* written in large blocks by a writer thread, so that logging costs    */
+/* the simulation little more than a copy.  complog2txt turns a log     */
+/* back into text (see "Output file for binary I/O completions").       */
+/*                                                                      */
+/* A 16-byte file header (magic, version, record length) is followed by */
+/* COMPLOG_RECLEN-byte records in completion order: the arrival, start, */
+/* completion and queue times (doubles, in milliseconds), blkno         */
+/* (int64), then devno, bcount, flags and a zero pad (int32).  All      */
+/* values are little-endian.                                            */
+
+#define COMPLOG_MAGIC		"DSIMCPL1"
+#define COMPLOG_VERSION		1
+#define COMPLOG_HDRLEN		16
+#define COMPLOG_RECLEN		56
+
+typedef struct complog_rec {
+   double  arrival;	/* reached the device driver */
+   double  start;	/* device started on it */
+   double  done;	/* completed */
+   double  qtime;	/* waited in the device's queue */
+   disksim_lbn_t blkno;
+   int     devno;
+   int     bcount;
+   int     flags;
+} complog_rec;
+
+typedef struct complog complog;
+
+complog * complog_open (char *filename);
+void complog_put (complog *log, complog_rec *rec);
+int  complog_close (complog *log);
+
+/* writes out everything logged so far and, if pos is given, notes */
+/* where the log carries on (e.g. for a checkpoint)                */
+void complog_sync (complog *log, fpos_t *pos);
+
+/* stop (after writing out everything logged so far) and restart the */
+/* writer thread, which does not survive fork()                       */
+void complog_pause (complog *log);
+void complog_resume (complog *log);
+
+/* carries on at pos of filename after a checkpoint restore */
+void complog_restore (complog *log, char *filename, fpos_t *pos);
+
+/* reading a log back; both return 0 at the end or on a bad file */
+int  complog_read_header (FILE *infile);
+int  complog_read (FILE *infile, complog_rec *rec);
+
+#endif    /* DISKSIM_COMPLOG_H */
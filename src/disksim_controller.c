@@ -252,7 +252,7 @@ void controller_send_event_up_path (controller *currctlr, ioreq_event *curr, dou
 int controller_get_data_transfered(int ctlno, int devno)
 {
    double tmptime;
-   int tmpblks;
+   disksim_lbn_t tmpblks;
    controller *currctlr = getctlr(ctlno);
    ioreq_event *tmp = currctlr->datatransfers;
 /*
@@ -162,12 +162,8 @@ void device_add(struct device_header *d, int ldevno) {
 #endif
 
   disksim->deviceinfo->devices = realloc(disksim->deviceinfo->devices, 
-					 newlen*sizeof(int));
-#ifndef WIN32
-  bzero(disksim->deviceinfo->devices + c, zerocnt * sizeof(int));
-#else
+					 newlen*sizeof(*(disksim->deviceinfo->devices)));
   bzero(disksim->deviceinfo->devices + c, zerocnt * sizeof(*(disksim->deviceinfo->devices)));
-#endif
 
   disksim->deviceinfo->devs_len = newlen;
 
@@ -209,8 +205,7 @@ void device_setcallbacks (void)
    /* call for each type of device */
    disk_setcallbacks ();
    simpledisk_setcallbacks ();
-   /* mems checkpointing not supported */
-   fprintf(stderr,"Warning: mems checkpointing not supported (yet)!\n");
+   /* mems and ssd devices keep no callbacks of their own */
 }
 
 
@@ -324,7 +319,7 @@ INLINE int device_get_slotno (int devno)
 }
 
 
-INLINE int device_get_number_of_blocks (int devno)
+INLINE disksim_lbn_t device_get_number_of_blocks (int devno)
 {
    ASSERT1 ((devno >= 0) && (devno < numdevices), "devno", devno);
    return disksim->deviceinfo->devices[devno]->get_number_of_blocks(devno);
@@ -367,7 +362,7 @@ INLINE int device_get_avg_sectpercyl (int devno)
 
 INLINE void device_get_mapping (int maptype, 
 				int devno, 
-				int blkno, 
+				disksim_lbn_t blkno, 
 				int *cylptr, 
 				int *surfaceptr, 
 				int *blkptr)
@@ -389,9 +384,19 @@ INLINE void device_event_arrive (ioreq_event *curr)
 }
 
 
+void device_get_counters (int devno, device_counters *counters)
+{
+   ASSERT1 ((devno >= 0) && (devno < numdevices), "devno", devno);
+   bzero ((char *)counters, sizeof(device_counters));
+   if (disksim->deviceinfo->devices[devno]->get_counters) {
+      disksim->deviceinfo->devices[devno]->get_counters(devno, counters);
+   }
+}
+
+
 INLINE int device_get_distance (int devno, 
 				ioreq_event *req, 
-				int exact, 
+				disksim_lbn_t exact, 
 				int direction)
 {
    ASSERT1 ((devno >= 0) && (devno < numdevices), "devno", devno);
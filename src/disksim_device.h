@@ -113,6 +113,15 @@ typedef struct device_info {
 
 struct device_header;
 
+/* running totals of device-internal activity, for the interval */
+/* statistics (see disksim_tseries.c); they restart at a reset  */
+typedef struct device_counters {
+   int     cacheaccesses;	/* on-board cache or buffer */
+   int     cachehits;
+   int     cleans;		/* SSD cleaning */
+   int     pagesmoved;
+} device_counters;
+
 /*  struct device_header { */
 /*    int device_type; */
 /*    int device_len; */
@@ -180,7 +189,7 @@ struct device_header {
   int     (*get_slotno)(int diskno);
 
 
-  int     (*get_number_of_blocks)(int diskno);
+  disksim_lbn_t (*get_number_of_blocks)(int diskno);
   int     (*get_maxoutstanding)(int diskno);
   int     (*get_numcyls)(int diskno);
   double  (*get_blktranstime)(ioreq_event *curr);
@@ -188,7 +197,7 @@ struct device_header {
   
   void    (*get_mapping)(int maptype, 
 			 int diskno, 
-			 int blkno, 
+			 disksim_lbn_t blkno, 
 			 int *cylptr, 
 			 int *surfaceptr, 
 			 int *blkptr);
@@ -197,7 +206,7 @@ struct device_header {
   
   int     (*get_distance)(int diskno, 
 			  ioreq_event *req, 
-			  int exact, 
+			  disksim_lbn_t exact, 
 			  int direction);
   
   double  (*get_servtime)(int diskno, 
@@ -223,6 +232,10 @@ struct device_header {
 				 ioreq_event *curr, 
 				 int busno, 
 				 double arbdelay);
+
+  /* optional; the counters start out zero */
+  void    (*get_counters)(int devno, 
+			  device_counters *counters);
   
 };
 
@@ -234,7 +247,7 @@ int     device_get_busno (ioreq_event *curr);
 int     device_get_slotno (int diskno);
 
 
-int     device_get_number_of_blocks (int diskno);
+disksim_lbn_t device_get_number_of_blocks (int diskno);
 int     device_get_maxoutstanding (int diskno);
 int     device_get_numcyls (int diskno);
 double  device_get_blktranstime (ioreq_event *curr);
@@ -242,16 +255,18 @@ int     device_get_avg_sectpercyl (int devno);
 
 void    device_get_mapping (int maptype, 
 			    int diskno, 
-			    int blkno, 
+			    disksim_lbn_t blkno, 
 			    int *cylptr, 
 			    int *surfaceptr, 
 			    int *blkptr);
 
 void    device_event_arrive (ioreq_event *curr);
 
+void    device_get_counters (int devno, device_counters *counters);
+
 int     device_get_distance (int diskno, 
 			     ioreq_event *req, 
-			     int exact, 
+			     disksim_lbn_t exact, 
 			     int direction);
 
 double  device_get_servtime (int diskno, 
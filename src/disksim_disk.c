@@ -398,7 +398,7 @@ static void disk_postpass_perdisk (disk *currdisk)
 
   if ((currdisk->segsize < 1) ||
       (currdisk->segsize > currdisk->model->dm_sectors)) {
-    fprintf(stderr, "Invalid value for segsize in disk_postpass_perdisk: %d\n", currdisk->model->dm_sectors);
+    fprintf(stderr, "Invalid value for segsize in disk_postpass_perdisk: %lld\n", currdisk->model->dm_sectors);
     ddbg_assert(0);;
   }
 
@@ -625,6 +625,9 @@ static void disk_buffer_printstats (int *set, int setsize, char *prefix)
     return;
   }
   fprintf(outputfile, "%sNumber of buffer accesses:    %d\n", prefix, total);
+  stat_json_value(prefix, "Number of buffer accesses", total);
+  stat_json_value(prefix, "Buffer hits", hits);
+  stat_json_value(prefix, "Buffer read hits", fullreadhits);
   fprintf(outputfile, "%sBuffer hit ratio:        %6d \t%f\n", prefix, hits, ((double) hits / (double) total));
   fprintf(outputfile, "%sBuffer miss ratio:            %6d \t%f\n", prefix, misses, ((double) misses / (double) total));
   fprintf(outputfile, "%sBuffer read hit ratio:        %6d \t%f \t%f\n", prefix, fullreadhits, ((double) fullreadhits / (double) max(1,reads)), ((double) fullreadhits / (double) total));
@@ -833,7 +836,7 @@ void disk_printstats (void)
       continue;
     }
     fprintf(outputfile, "Disk #%d:\n\n", set[i]);
-    fprintf(outputfile, "Disk #%d highest block number requested: %d\n", set[i], currdisk->stat.highblkno);
+    fprintf(outputfile, "Disk #%d highest block number requested: %lld\n", set[i], currdisk->stat.highblkno);
     sprintf(prefix, "Disk #%d ", set[i]);
     ioqueue_printstats(&currdisk->queue, 1, prefix);
     disk_seek_printstats(&set[i], 1, prefix);
@@ -1111,7 +1114,7 @@ void disk_acctimestats (disk *currdisk, int distance, double seektime,
 }
 
 
-static int disk_get_number_of_blocks(int n) {
+static disksim_lbn_t disk_get_number_of_blocks(int n) {
   return disksim->diskinfo->disks[n]->model->dm_sectors;
 }
 
@@ -1119,11 +1122,19 @@ static int disk_get_numcyls(int n) {
   return disksim->diskinfo->disks[n]->model->dm_cyls;
 }
 
+// buffer accesses and hits, counted as in disk_buffer_printstats
+static void disk_get_counters(int n, device_counters *counters) {
+  diskstat *stat = &disksim->diskinfo->disks[n]->stat;
+
+  counters->cachehits = stat->fullreadhits + stat->appendhits + stat->prependhits + stat->parthits + stat->readinghits;
+  counters->cacheaccesses = counters->cachehits + stat->readmisses + stat->writemisses;
+}
+
 // this is an alias for dm_translate_ltop, basically
 static void 
 disk_get_mapping(int maptype, 
 		 int n, 
-		 int lbn, 
+		 disksim_lbn_t lbn, 
 		 int *c, 
 		 int *h, 
 		 int *s)
@@ -1179,5 +1190,6 @@ struct device_header disk_hdr_initializer = {
   disk_get_seektime,
   disk_get_acctime,
   disk_bus_delay_complete,
-  disk_bus_ownership_grant
+  disk_bus_ownership_grant,
+  disk_get_counters
 };
@@ -195,12 +195,12 @@ typedef struct seg {
    disk_buffer_state_t state;
    struct seg  *next;
    struct seg  *prev;
-   int          startblkno;
-   int          endblkno;
+   disksim_lbn_t startblkno;
+   disksim_lbn_t endblkno;
    disk_buffer_outstate_t outstate;
    int		outbcount;
-   int		minreadaheadblkno;      /* min prefetch blkno + 1 */
-   int		maxreadaheadblkno;      /* max prefetch blkno + 1 */
+   disksim_lbn_t minreadaheadblkno;      /* min prefetch blkno + 1 */
+   disksim_lbn_t maxreadaheadblkno;      /* max prefetch blkno + 1 */
 
    struct diskreq_t *diskreqlist;       /* sorted by ascendingly first blkno */
    int          size;
@@ -212,7 +212,7 @@ typedef struct seg {
 
    ioreq_event *access;                 /* copy of the active ioreq
                                          * using this seg -rcohen */
-   int		hold_blkno; 		/* used for prepending */
+   disksim_lbn_t hold_blkno; 		/* used for prepending */
    int		hold_bcount;		/* sequential writes   */
    struct diskreq_t *recyclereq;        /* diskreq to recycle this seg */
 } segment;
@@ -223,8 +223,8 @@ typedef struct diskreq_t {
    ioreq_event 	       *ioreqlist;	/* sorted by ascending blkno */
    struct diskreq_t    *seg_next;	/* list attached to a segment */
    struct diskreq_t    *bus_next;
-   int			outblkno;
-   int			inblkno;
+   disksim_lbn_t	outblkno;
+   disksim_lbn_t	inblkno;
    segment	       *seg;		/* associated cache segment */
    int          	watermark;
    disk_cache_hit_t     hittype;	/* for cache use */
@@ -240,7 +240,7 @@ typedef struct {
    int     seekdistance;
    int     zeroseeks;
    int     zerolatency;
-   int     highblkno;
+   disksim_lbn_t highblkno;
    statgen seekdiststats;
    statgen seektimestats;
    statgen rotlatstats;
@@ -277,7 +277,7 @@ typedef struct disk {
   struct dm_disk_if    *model;
 
   struct dm_mech_state mech_state;
-  int track_low, track_high; // track boundaries for the current track
+  dm_lbn_t track_low, track_high; // track boundaries for the current track
 
   int	               devno;
 
@@ -363,8 +363,8 @@ typedef struct disk {
   int		disconnectinseek;
 
   // ctlr
-  int		immedstart;
-  int		immedend;
+  disksim_lbn_t	immedstart;
+  disksim_lbn_t	immedend;
 
   // list of all the cache segments(?)
   segment      *seglist;
@@ -566,11 +566,11 @@ segment * disk_buffer_recyclable_segment(disk *currdisk, int isread);
 diskreq * disk_buffer_seg_owner(segment *seg, int effective);
 int  disk_buffer_attempt_seg_ownership(disk *currdisk, diskreq *currdiskreq);
 
-int  disk_buffer_get_max_readahead(disk *currdisk, 
+disksim_lbn_t disk_buffer_get_max_readahead(disk *currdisk, 
 				   segment *seg, 
 				   ioreq_event *curr);
 
-int  disk_buffer_block_available(disk *currdisk, segment *seg, int blkno);
+int  disk_buffer_block_available(disk *currdisk, segment *seg, disksim_lbn_t blkno);
 int  disk_buffer_reusable_segment_check(disk *currdisk, segment *currseg);
 int  disk_buffer_overlap(segment *seg, ioreq_event *curr);
 int  disk_buffer_check_segments(disk *currdisk, 
@@ -578,7 +578,7 @@ int  disk_buffer_check_segments(disk *currdisk,
 				int *buffer_reading);
 
 void disk_buffer_set_segment(disk *currdisk, diskreq *currdiskreq);
-void disk_buffer_segment_wrap(segment *seg, int endblkno);
+void disk_buffer_segment_wrap(segment *seg, disksim_lbn_t endblkno);
 void disk_buffer_remove_from_seg(diskreq *currdiskreq);
 void disk_interferestats(disk *currdisk, ioreq_event *curr);
 
@@ -630,7 +630,7 @@ void    disk_event_arrive(ioreq_event *curr);
 
 int     disk_get_distance(int diskno, 
 			  ioreq_event *req, 
-			  int exact, 
+			  disksim_lbn_t exact, 
 			  int direction);
 
 double  disk_get_servtime(int diskno, 
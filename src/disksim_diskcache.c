@@ -110,14 +110,14 @@
 
 
 #if 0
-static int disk_buffer_segment_wrap_needed (segment *seg, int endblkno)
+static int disk_buffer_segment_wrap_needed (segment *seg, disksim_lbn_t endblkno)
 {
    return(seg->startblkno < (endblkno - seg->size));
 }
 #endif
 
 
-void disk_buffer_segment_wrap (segment *seg, int endblkno)
+void disk_buffer_segment_wrap (segment *seg, disksim_lbn_t endblkno)
 {
    seg->startblkno = max(seg->startblkno, (endblkno - seg->size));
 }
@@ -129,7 +129,7 @@ void disk_buffer_segment_wrap (segment *seg, int endblkno)
 
 int disk_buffer_overlap (segment *seg, ioreq_event *curr)
 {
-   int tmp;
+   disksim_lbn_t tmp;
 
    if ((curr->blkno >= seg->startblkno) && (curr->blkno < seg->endblkno)) {
       return(TRUE);
@@ -393,7 +393,7 @@ fflush(outputfile);
      written to media.
 */
 
-int disk_buffer_block_available (disk *currdisk, segment *seg, int blkno)
+int disk_buffer_block_available (disk *currdisk, segment *seg, disksim_lbn_t blkno)
 {
    diskreq *seg_owner;
 
@@ -521,7 +521,7 @@ static void disk_buffer_stats (disk *currdisk, ioreq_event *curr, segment *seg,
          break;
 
       default:
-	 fprintf(stderr, "Invalid hittype in disk_buffer_stats - blkno %d, bcount %d, state %d\n", curr->blkno, curr->bcount, seg->state);
+	 fprintf(stderr, "Invalid hittype in disk_buffer_stats - blkno %lld, bcount %d, state %d\n", curr->blkno, curr->bcount, seg->state);
          exit(1);
    }
    return;
@@ -1359,7 +1359,7 @@ fflush(outputfile);
 	 break;
 
       default:
-	 fprintf(stderr, "Invalid segment state in disk_buffer_set_segment - blkno %d, bcount %d, state %d\n", currdiskreq->ioreqlist->blkno, currdiskreq->ioreqlist->bcount, seg->state);
+	 fprintf(stderr, "Invalid segment state in disk_buffer_set_segment - blkno %lld, bcount %d, state %d\n", currdiskreq->ioreqlist->blkno, currdiskreq->ioreqlist->bcount, seg->state);
          exit(1);
    }
 
@@ -1521,7 +1521,7 @@ fflush(outputfile);
                   exit(1);
 	       }
                seg->hold_blkno = seg->startblkno;
-	       seg->hold_bcount = seg->endblkno - seg->startblkno;
+	       seg->hold_bcount = (int) (seg->endblkno - seg->startblkno);
 	    }
 	 } else {
 	    break;
@@ -1635,9 +1635,9 @@ fflush(outputfile);
 }
 
 
-int disk_buffer_get_max_readahead (disk *currdisk, segment *seg, ioreq_event *curr)
+disksim_lbn_t disk_buffer_get_max_readahead (disk *currdisk, segment *seg, ioreq_event *curr)
 {
-   int endreq;
+   disksim_lbn_t endreq;
 
    if (!(curr->flags & READ)) {
       fprintf(stderr, "No read-ahead for write accesses, in disk_buffer_get_max_readahead\n");
@@ -1649,8 +1649,8 @@ int disk_buffer_get_max_readahead (disk *currdisk, segment *seg, ioreq_event *cu
    if (currdisk->contread == BUFFER_NO_READ_AHEAD) {
       return(endreq);
    } else if (currdisk->contread == BUFFER_DEC_PREFETCH_SCHEME) {
-      int startlbn;
-      int endlbn;
+      dm_lbn_t startlbn;
+      dm_lbn_t endlbn;
       struct dm_pbn pbn;
       //      band* bandptr;
 
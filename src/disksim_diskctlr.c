@@ -108,6 +108,20 @@
 
 #include "inst.h"
 
+
+/* Converts a simulated time (msec) to a diskmodel time.  With integer */
+/* event times the value is rounded to the tick grid first, so times   */
+/* that are equal in DiskSim stay equal in the mechanical model.        */
+
+static INLINE dm_time_t
+disk_time_dtoi (double t)
+{
+  if (disksim->inttime) {
+    return(disksim_msec_to_ticks(t) * DM_TIME_NSEC);
+  }
+  return(dm_time_dtoi(t));
+}
+
 // move these protos, etc, to "disk_private.h" or something!
 static void 
 disk_buffer_sector_done (disk *currdisk, 
@@ -956,7 +970,7 @@ disk_request_needs_bus(disk *currdisk,
 	      busioreq->type = IO_INTERRUPT_ARRIVE;
 	      busioreq->cause = RECONNECT;
 	    }
-	    busioreq->bcount = min(seg->endblkno,(tmpioreq->blkno + tmpioreq->bcount)) - currdiskreq->outblkno;
+	    busioreq->bcount = (int) (min(seg->endblkno,(tmpioreq->blkno + tmpioreq->bcount)) - currdiskreq->outblkno);
 	  }
       } 
       else {			/* WRITE */
@@ -991,12 +1005,12 @@ disk_request_needs_bus(disk *currdisk,
 		busioreq->bcount = min(tmpioreq->bcount,seg->size);
 	      } 
 	    else {
-	      int i1 = tmpioreq->blkno + tmpioreq->bcount - 
+	      disksim_lbn_t i1 = tmpioreq->blkno + tmpioreq->bcount - 
 		currdiskreq->outblkno;
 
-	      int i2 = seg->size - seg->endblkno + seg_owner->inblkno;
+	      disksim_lbn_t i2 = seg->size - seg->endblkno + seg_owner->inblkno;
 
-	      busioreq->bcount = min(i1, i2);
+	      busioreq->bcount = (int) min(i1, i2);
 	    }
 	  }
       }
@@ -1119,12 +1133,12 @@ disk_select_bus_request(disk *currdisk, ioreq_event **busioreq)
 			 simtime);
 
 		fprintf (outputfile, "                       "
-			 "seg = %d-%d\n", 
+			 "seg = %lld-%lld\n", 
 			 currdiskreq->seg->startblkno, 
 			 currdiskreq->seg->endblkno);
 
 		fprintf (outputfile, "                       "
-			 "diskreq = %d, %d, %d (1==R)\n",
+			 "diskreq = %lld, %d, %d (1==R)\n",
 			 currdiskreq->ioreqlist->blkno, 
 			 currdiskreq->ioreqlist->bcount, 
 			 (currdiskreq->ioreqlist->flags & READ));
@@ -1525,7 +1539,7 @@ disk_initiate_seek (disk *currdisk,
 
 
   if(disk_printhack && (simtime >= disk_printhacktime)) {
-    fprintf (outputfile, "%12.6f            Entering disk_initiate_seek to %d for disk %d\n", simtime, curr->blkno, curr->devno);
+    fprintf (outputfile, "%12.6f            Entering disk_initiate_seek to %lld for disk %d\n", simtime, curr->blkno, curr->devno);
     fflush(outputfile);
   }
 
@@ -1536,7 +1550,7 @@ disk_initiate_seek (disk *currdisk,
 
   // new ltop
   {
-    int rv;
+    dm_ptol_result_t rv;
     uint64_t nsecs;
     struct dm_mech_state end;
     struct dm_mech_state begin = currdisk->mech_state;
@@ -2402,7 +2416,7 @@ disk_request_arrive(ioreq_event *curr)
 	    simtime, new_diskreq);
 
     fprintf(outputfile, "                        disk = %d, "
-	    "blkno = %d, bcount = %d, read = %d\n",
+	    "blkno = %lld, bcount = %d, read = %d\n",
 	    curr->devno, curr->blkno, curr->bcount, (READ & curr->flags));
     fflush(outputfile);
   }
@@ -3452,7 +3466,7 @@ disk_buffer_transfer_size(disk *currdisk,
     }
     if(seg->endblkno > currdiskreq->outblkno) {
       seg->outstate = BUFFER_TRANSFERING;
-      curr->bcount = seg->outbcount = min(seg->endblkno,(tmpioreq->blkno + tmpioreq->bcount)) - currdiskreq->outblkno;
+      curr->bcount = seg->outbcount = (int) (min(seg->endblkno,(tmpioreq->blkno + tmpioreq->bcount)) - currdiskreq->outblkno);
     } else if(currdisk->hold_bus_for_whole_read_xfer || 
 	       currdisk->neverdisconnect) {
       seg->outstate = BUFFER_TRANSFERING;
@@ -3530,7 +3544,7 @@ disk_buffer_transfer_size(disk *currdisk,
 
     }
     seg->outstate = BUFFER_TRANSFERING;
-    curr->bcount = seg->outbcount = 
+    curr->bcount = seg->outbcount = (int)
       min((seg->size - (currdiskreq->outblkno - seg_owner->inblkno)), 
 	  (tmpioreq->blkno + tmpioreq->bcount - currdiskreq->outblkno));
     /*
@@ -4001,7 +4015,7 @@ disk_buffer_seekdone(disk *currdisk, ioreq_event *curr)
 #endif
 
   // first and last blocks on current track
-  int first, last;
+  dm_lbn_t first, last;
 
   int remapsector = 0;
 
@@ -4062,7 +4076,7 @@ disk_buffer_seekdone(disk *currdisk, ioreq_event *curr)
     currdisk->track_low = first;
     currdisk->track_high = last;
 
-    curr->bcount = last - first + 1;
+    curr->bcount = (int) (last - first + 1);
     last++;  // the controller code works in terms of 1-past-the-end
 
     ddbg_assert3(((first <= curr->blkno) && (curr->blkno <= last )),
@@ -4097,7 +4111,7 @@ disk_buffer_seekdone(disk *currdisk, ioreq_event *curr)
     // global_currangle/global_currtime/foo before, we're going to
     // set the angle of the state we pass in to be (simtime % period) 
 
-    dm_time_t isimtime = dm_time_dtoi(seg->time) - currdisk->currtime_i;
+    dm_time_t isimtime = disk_time_dtoi(seg->time) - currdisk->currtime_i;
     dm_time_t residtime = 
       isimtime % currdisk->model->mech->dm_period(currdisk->model);
 
@@ -4181,14 +4195,14 @@ disk_buffer_seekdone(disk *currdisk, ioreq_event *curr)
 static int
 dbsd_setup(disk *cd, 
 	   ioreq_event *curr, 
-	   int *blkno,
-	   int *cause,
-	   int *first,
-	   int *last,
-	   int *next,
+	   disksim_lbn_t *blkno,
+	   disksim_lbn_t *cause,
+	   dm_lbn_t *first,
+	   dm_lbn_t *last,
+	   dm_lbn_t *next,
 	   int *remapsector) 
 {
-  int rv;
+  dm_ptol_result_t rv;
   struct dm_pbn pbn;
 
 
@@ -4274,7 +4288,7 @@ void dbsd_check_times(void)
     // global_currangle/global_currtime/... before, we're going to
     // set the angle of the state we pass in to be (simtime % period) 
 
-    dm_time_t reqtime = dm_time_dtoi(seg->time) - currdisk->currtime_i;
+    dm_time_t reqtime = disk_time_dtoi(seg->time) - currdisk->currtime_i;
     // dm_time_t reqtime = dm_time_dtoi(seg->time);
 
     dm_time_t residtime = 
@@ -4310,7 +4324,7 @@ void dbsd_check_times(void)
 
 
     currdisk->currtime = seg->time + dm_time_itod(nsecs);
-    currdisk->currtime_i = dm_time_dtoi(seg->time) + nsecs;
+    currdisk->currtime_i = disk_time_dtoi(seg->time) + nsecs;
 
     curr->time = seg->time + dm_time_itod(nsecs);
     
@@ -4343,22 +4357,22 @@ disk_buffer_sector_done (disk *currdisk, ioreq_event *curr)
   diskreq *currdiskreq = currdisk->effectivehda;
   ioreq_event *tmpioreq;
 
-  int first, last;    // first/last lbn on track
-  int next; // first lbn on next track
-  int firstblkno;
-  int lastblkno;
+  dm_lbn_t first, last;    // first/last lbn on track
+  dm_lbn_t next; // first lbn on next track
+  disksim_lbn_t firstblkno;
+  disksim_lbn_t lastblkno;
   int endlat = 0;
 
   // As far as I can tell, these are set up to be the lbn and sector
   // prior (rotationally, on the track) to curr->blkno and curr->cause.
-  int currblkno = -1;
-  int currcause = -1;
+  disksim_lbn_t currblkno = -1;
+  disksim_lbn_t currcause = -1;
 
   dm_time_t diff_i;
   double mydiff;
   int remapsector = 0;
 
-  int rv;
+  dm_ptol_result_t rv;
   struct dm_pbn pbn;
 
   disksim_inst_enter();
@@ -4399,19 +4413,19 @@ disk_buffer_sector_done (disk *currdisk, ioreq_event *curr)
   if(!curr->bcount) { // first sector after repos (? see comment below)
     curr->time = simtime;
     
-    diff_i = (dm_time_dtoi(seg->time) - currdisk->currtime_i) % currdisk->model->mech->dm_period(currdisk->model);
+    diff_i = (disk_time_dtoi(seg->time) - currdisk->currtime_i) % currdisk->model->mech->dm_period(currdisk->model);
     currdisk->mech_state.theta += currdisk->model->mech->dm_rotate(currdisk->model, &diff_i);
   }
 
 
   // update the rotational state of the disk
-  diff_i = dm_time_dtoi(simtime - seg->time);
+  diff_i = disk_time_dtoi(simtime - seg->time);
   currdisk->mech_state.theta += currdisk->model->mech->dm_rotate(currdisk->model, &diff_i );
     
   // for bcount == 0, used to dbsd_check_times() here
 
   currdisk->currtime = simtime;
-  currdisk->currtime_i = dm_time_dtoi(simtime);
+  currdisk->currtime_i = disk_time_dtoi(simtime);
 
     
   if(!currdisk->read_direct_to_buffer 
@@ -4632,11 +4646,11 @@ disk_buffer_sector_done (disk *currdisk, ioreq_event *curr)
     // this seems like a type error; currcause was a sector number, now its
     // an lbn.
     {
-      int newcurrcause;
+      dm_ptol_result_t newcurrcause;
       struct dm_pbn pbn;
       pbn.cyl = currdisk->mech_state.cyl;
       pbn.head = currdisk->mech_state.head;
-      pbn.sector = currcause;
+      pbn.sector = (int) currcause;
 
       newcurrcause = currdisk->model->layout->dm_translate_ptol(currdisk->model, 
 							     &pbn, 
@@ -4715,7 +4729,7 @@ disk_buffer_estimate_servtime(disk *currdisk,
   struct dm_pbn destpbn;
   double tmptime;
   int tmpblkno;
-  int lastontrack;
+  dm_lbn_t lastontrack;
   int hittype = BUFFER_NOMATCH;
 
   if(currdisk->const_acctime) {
@@ -4780,7 +4794,7 @@ disk_buffer_estimate_servtime(disk *currdisk,
     lastontrack++;
 
     
-    curr->bcount = min(curr->bcount, (lastontrack - curr->blkno));
+    curr->bcount = (int) min(curr->bcount, (lastontrack - curr->blkno));
 
 
 
@@ -4945,7 +4959,7 @@ disk_buffer_estimate_seektime(disk *currdisk,
  * indicates that head switches should be counted as a distance of 1.
  */
 
-int disk_get_distance(int diskno, ioreq_event *req, int exact, int direction)
+int disk_get_distance(int diskno, ioreq_event *req, disksim_lbn_t exact, int direction)
 {
   disk *currdisk = getdisk (diskno);
   int cyl1, head1;
@@ -112,6 +112,7 @@
 #ifdef _WIN32
 #define u_int		unsigned int
 #define u_int64_t	unsigned __int64
+#define int64_t		__int64
 #endif
 
 /* must enable this on Suns and Alphas */
@@ -173,6 +174,11 @@ typedef      unsigned u_int;
 #define EMCSYMM         9
 #define EMCBACKEND      10
 #define BATCH           11
+#define COLUMNAR        12
+#define BLKTRACE        13
+#define MSRCSV          14
+#define SPC             15
+#define MERGE           16
 #define DEFAULT		ASCII
 
 /* Time conversions */
@@ -238,6 +244,21 @@ typedef      unsigned u_int;
 */
 #define DISKSIM_TIME_THRESHOLD  0.0013
 
+/* With "Integer event times" set, every scheduled event time is rounded */
+/* to a whole number of nanoseconds (ticks) as it enters the intq, and   */
+/* the clock advances in ticks.  simtime stays a double in milliseconds */
+/* for the models, but it only ever takes values on the tick grid, so    */
+/* events computed along different paths for the same instant compare   */
+/* equal and come out in scheduling order.                               */
+
+typedef int64_t disksim_tick_t;
+
+#define DISKSIM_TICKS_PER_MSEC	1000000
+#define DISKSIM_TIME_THRESHOLD_TICKS	1300	/* DISKSIM_TIME_THRESHOLD */
+
+#define disksim_msec_to_ticks(t)	((disksim_tick_t) floor(((t) * DISKSIM_TICKS_PER_MSEC) + 0.5))
+#define disksim_ticks_to_msec(k)	((double) (k) / DISKSIM_TICKS_PER_MSEC)
+
 typedef union {
    u_int32_t	value;
    char		byte[4];
@@ -245,9 +266,13 @@ typedef union {
 
 #define StaticAssert(c) switch (c) case 0: case (c):
 
+/* Every event type starts with these fields.  intqpos is the event's  */
+/* intq handle, 0 while it is not scheduled (see disksim_intq.c).       */
+
 typedef struct foo {
    double time;
    int type;
+   int intqpos;
    struct ev *next;
    struct ev *prev;
    int    temp;
@@ -259,45 +284,60 @@ typedef struct foo {
 typedef struct ev {
    double time;
    int type;
+   int intqpos;
    struct ev *next;
    struct ev *prev;
    int    temp;
    char space[DISKSIM_EVENT_SPACESIZE];
 } event;
 
+/* Logical block numbers, and device or volume capacities in blocks,    */
+/* are 64-bit.  Request sizes (bcount) stay int.                        */
+
+typedef long long disksim_lbn_t;
+
+/* The fields looked at on every hop of a request (up to and including */
+/* cause) fill the first 64 bytes on LP64 hosts, so that with the other */
+/* fields the whole structure fits in DISKSIM_EVENT_SIZE there too.     */
+/* Whether a request ends its batch is the BATCH_COMPLETE bit in flags. */
+
 typedef struct ioreq_ev {
    double time;
    int    type;
+   int    intqpos;
    struct ioreq_ev *next;
    struct ioreq_ev *prev;
+   disksim_lbn_t blkno;
    int    bcount;
-   int    blkno;
    u_int  flags;
+   int    devno;
    u_int  busno;
    u_int  slotno;
-   int    devno;
-   int    opid;
-   void  *buf;
    int    cause;
-   int    tempint1;
-   int    tempint2;
+   void  *buf;
    void  *tempptr1;
    void  *tempptr2;
-   void  *mems_sled;	 /* mems sled associated with a particular event */
-   void  *mems_reqinfo; /* per-request info for mems subsystem */
-   int    ssd_elem_num;	 /* SSD: element to which this request went */
-   int    ssd_gang_num ; /* SSD: gang to which this request went */
-   double start_time;    /* temporary; used for memulator timing */
+   int    tempint1;
+   int    tempint2;
    int    batchno;
-   int    batch_complete;
-   int    batch_size;
-   struct ioreq_ev *batch_next;
-   struct ioreq_ev *batch_prev;
+   int    opid;
+   struct ioreq_ev *batch_next;	/* BATCH_FCFS and mems batches */
+   union {			/* a request only reaches one kind of device */
+      struct {
+         void *sled;		/* mems sled associated with a particular event */
+         void *reqinfo;		/* per-request info for mems subsystem */
+      } mems;
+      struct {
+         int elem_num;		/* SSD: element to which this request went */
+         int gang_num;		/* SSD: gang to which this request went */
+      } ssd;
+   } dev;
 } ioreq_event;
 
 typedef struct timer_ev {
    double time;
    int type;
+   int intqpos;
    struct timer_ev *next;
    struct timer_ev *prev;
    void (**func)(struct timer_ev *);
@@ -308,6 +348,7 @@ typedef struct timer_ev {
 typedef struct intr_ev {
    double time;
    int    type;
+   int    intqpos;
    struct intr_ev * next;
    struct intr_ev * prev;
    int    vector;
@@ -335,7 +376,36 @@ struct ctlrinfo;
 struct pf_info;
 struct synthio_info;
 struct iotrace_info;
+struct tracefile;
 struct rand48_info;
+struct ioqueue_tsps;
+struct intq_heap;
+struct intq_cal;
+union pool_obj;
+struct pool_slab;
+
+/* Object types handed out by the pooled allocator (disksim_pool_get). */
+/* Objects of the same size share slabs whatever their type; the type  */
+/* only selects the counters printed with "Print allocator stats".     */
+
+#define DISKSIM_POOL_EVENT	0	/* events of every kind */
+#define DISKSIM_POOL_CACHE	1	/* cache descriptors and lock waiters */
+#define DISKSIM_POOL_OUTSTAND	2	/* logorg outstanding requests */
+#define DISKSIM_POOL_SSDREQ	3	/* SSD element requests */
+#define DISKSIM_POOL_SSDLIST	4	/* SSD list nodes and parunit lists */
+#define DISKSIM_POOL_TYPES	5
+
+/* sizes are rounded up to a multiple of DISKSIM_POOL_GRAIN; anything */
+/* bigger than DISKSIM_POOL_MAXSIZE comes straight from malloc        */
+#define DISKSIM_POOL_GRAIN	16
+#define DISKSIM_POOL_MAXSIZE	1024
+#define DISKSIM_POOL_CLASSES	(DISKSIM_POOL_MAXSIZE / DISKSIM_POOL_GRAIN)
+
+typedef struct pool_stat {
+   double allocs;	/* since the last statistics reset */
+   int    live;
+   int    peak;		/* since the last statistics reset */
+} pool_stat;
 
 typedef event*(*disksim_iodone_notify_t)(ioreq_event *, void *ctx);
 
@@ -349,15 +419,23 @@ typedef struct disksim {
    int    warmup_iocnt;
    double warmuptime;
    timer_event *warmup_event;
+   int    warmup_pending;    /* warmup_event is in the intq */
    double simtime;
+   disksim_tick_t simtick;   /* simtime in ticks, with inttime set */
+   int    inttime;
    int    checkpoint_disable;
    int    checkpoint_iocnt;
    double checkpoint_interval;
    event *checkpoint_event;
+   int    checkpoint_restored;
    int    traceformat;
    int    endian;
    int    traceendian;
    int    traceheader;
+   int    traceprefetch;
+   double tracestart;        /* trace time window, in ms; 0 is open */
+   double tracestop;
+   double tracesample;       /* fraction of the trace simulated */
    int    iotrace;
    int    synthgen;
    int    external_control;
@@ -367,24 +445,49 @@ typedef struct disksim {
 
    FILE * parfile;
    FILE * iotracefile;
+   struct tracefile *iotracestate;   /* decompressor, for compressed traces */
    FILE * statdeffile;
    FILE * outputfile;
    FILE * outios;
+   struct complog *complog;          /* binary completion log */
+   struct tseries *tseries;          /* interval statistics */
+   struct profile *profile;          /* of the simulator itself */
    char   iotracefilename[256];
    char   outputfilename[256];
    char   outiosfilename[256];
+   char   complogfilename[256];
+   char   tseriesfilename[256];
    char   checkpointfilename[256];
+   char   pointsuffix[16];          /* a sweep point's, for its output files */
    fpos_t iotracefileposition;
    fpos_t outputfileposition;
    fpos_t outiosfileposition;
+   fpos_t complogfileposition;
+   fpos_t tseriesfileposition;
+   double tseriesinterval;          /* in milliseconds */
    event *intq;
    event *intqhint;
-   event *extraq;
    int    intqlen;
-   int    extraqlen;
+   int    intqtype;
+   u_int64_t intqseq;
+   struct intq_heap *intqheap;
+   struct intq_cal *intqcal;
+   FILE  *intqtrace;
+   double intqhandled;              /* events handled since the start of the run */
+   int    intqcancels;
+   int    intqtimercancels;
+   union pool_obj *poolfree[DISKSIM_POOL_CLASSES];
+   struct pool_slab *poolslabs;
+   int    poolslabcnt;
+   pool_stat poolstat[DISKSIM_POOL_TYPES];
+   int    poolprintstats;
+   int    statjson;                 /* also write statistics as JSON */
+   FILE * statjsonfile;             /* open while statistics are printed */
+   int    statjsoncnt;
    int    stop_sim;
    int    seedval;
    double lastphystime;
+   double lastouttime;   /* arrival to completion of the last request a queue finished */
 
 /* call-back indirections for allowing checkpoint restores to deal with */
 /* functions whose addresses change on recompilation.                   */
@@ -397,12 +500,13 @@ typedef struct disksim {
    void         (*donefunc_cachedev_empty) (void *, ioreq_event *);
    void         (*idlework_cachemem)       (void *, int);
    void         (*idlework_cachedev)       (void *, int);
-   int          (*concatok_cachemem)       (void *, int, int, int, int);
+   int          (*concatok_cachemem)       (void *, disksim_lbn_t, int, disksim_lbn_t, int);
    int          (*enablement_disk)         (ioreq_event *);
    void         (*timerfunc_disksim)       (timer_event *);
    void         (*timerfunc_ioqueue)       (timer_event *);
    void         (*timerfunc_cachemem)      (timer_event *);
    void         (*timerfunc_cachedev)      (timer_event *);
+   void         (*timerfunc_tseries)       (timer_event *);
 
 /* opaque structures for different modules */
    struct iosim_info *iosim_info;
@@ -418,6 +522,7 @@ typedef struct disksim {
    struct synthio_info *synthio_info;
    struct iotrace_info *iotrace_info;
    struct rand48_info *rand48_info;
+   struct ioqueue_tsps *ioqueue_tsps;
 
    char **overrides;
    int overrides_len;
@@ -431,7 +536,15 @@ typedef struct disksim {
 
 } disksim_t;
 
-extern disksim_t *disksim;
+/* Each thread has its own current simulation, so independent instances */
+/* (see disksim_interface.h) can run concurrently on different threads. */
+#ifdef _WIN32
+#define DISKSIM_TLS	__declspec(thread)
+#else
+#define DISKSIM_TLS	__thread
+#endif
+
+extern DISKSIM_TLS disksim_t *disksim;
 
 /* remapping #defines for some of the variables in disksim_t */
 #define warmuptime       (disksim->warmuptime)
@@ -440,6 +553,9 @@ extern disksim_t *disksim;
 #define outputfile       (disksim->outputfile)
 #define outios           (disksim->outios)
 
+/* only a fraction of the trace is simulated (see "Trace sample rate") */
+#define TRACE_SAMPLED    ((disksim->tracesample > 0.0) && (disksim->tracesample < 1.0))
+
 
 #ifndef _WIN32
 #define	min(x,y)	((x) < (y) ? (x) : (y))
@@ -471,8 +587,12 @@ void disksim_register_checkpoint (double atsimtime);
 INLINE void addtoextraq (event *temp);
 void addlisttoextraq (event **headptr);
 INLINE event * getfromextraq (void);
+event * getfromextraq_type (int type);
+void * disksim_pool_get (int type, int size);
+void disksim_pool_put (void *obj);
 event * event_copy (event *orig);
 INLINE void addtointq (event *temp);
+void   disksim_set_simtime (double time);
 INLINE int removefromintq (event *curr);
 void scanparam_int (char *parline, char *parname, int *parptr, int parchecks, int parminval, int parmaxval);
 void getparam_int (FILE *parfile, char *parname, int *parptr, int parchecks, int parminval, int parmaxval);
@@ -487,6 +607,8 @@ event * io_done_notify (ioreq_event *curr);
 
 int disksim_initialize_disksim_structure (struct disksim *);
 int disksim_loadparams(char *inputfile, int synthgen);
+int disksim_parseparams(char *inputfile);
+int disksim_setparam(char *comp, char *param, char *value);
 void disksim_setup_disksim (int argc, char **argv);
 void disksim_set_external_io_done_notify (disksim_iodone_notify_t);
 void disksim_cleanup_and_printstats (void);
@@ -495,6 +617,7 @@ void disksim_printstats2 (void);
 void disksim_simulate_event (int);
 void disksim_restore_from_checkpoint (char *filename);
 void disksim_run_simulation ();
+int  disksim_warmup_done (void);
 
 void disksim_printstats(void);
 
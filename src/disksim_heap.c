@@ -0,0 +1,111 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* Routes the disksim program's allocations to the checkpoint heap             */
+/* (see disksim_malloc.c).  The program is linked with                         */
+/*                                                                             */
+/*    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free,--wrap=strdup */
+/*                                                                             */
+/* so that calls to these from the simulator and the libraries linked          */
+/* into it land here, while the C library keeps its own allocations            */
+/* (stdio buffers and the like) in the system heap.  Blocks that did           */
+/* not come from the checkpoint heap, e.g. because it could not be             */
+/* reserved, are handed back to the system allocator.                          */
+
+#include <errno.h>
+
+#include "disksim_global.h"
+
+void *__real_malloc (size_t size);
+void *__real_calloc (size_t nmemb, size_t size);
+void *__real_realloc (void *ptr, size_t size);
+void  __real_free (void *ptr);
+
+
+void *__wrap_malloc (size_t size)
+{
+   void *ptr = disksim_heap_malloc(size);
+
+   return((ptr != NULL) ? ptr : __real_malloc(size));
+}
+
+
+void *__wrap_calloc (size_t nmemb, size_t size)
+{
+   void *ptr;
+
+   if ((size != 0) && (nmemb > ((size_t) -1) / size)) {
+      errno = ENOMEM;
+      return(NULL);
+   }
+   ptr = disksim_heap_malloc(nmemb * size);
+   if (ptr == NULL) {
+      return(__real_calloc(nmemb, size));
+   }
+   bzero(ptr, (nmemb * size));
+   return(ptr);
+}
+
+
+void *__wrap_realloc (void *ptr, size_t size)
+{
+   if (ptr == NULL) {
+      return(__wrap_malloc(size));
+   }
+   if (!disksim_heap_owns(ptr)) {
+      return(__real_realloc(ptr, size));
+   }
+   return(disksim_heap_realloc(ptr, size));
+}
+
+
+void __wrap_free (void *ptr)
+{
+   if (ptr == NULL) {
+      return;
+   }
+   if (disksim_heap_owns(ptr)) {
+      disksim_heap_free(ptr);
+   } else {
+      __real_free(ptr);
+   }
+}
+
+
+char *__wrap_strdup (const char *s)
+{
+   char *new = __wrap_malloc(strlen(s) + 1);
+
+   if (new != NULL) {
+      strcpy(new, s);
+   }
+   return(new);
+}
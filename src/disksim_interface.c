@@ -138,6 +138,7 @@
 #include "disksim_ioface.h"
 #include "disksim_interface.h"
 #include "disksim_disk.h"
+#include "disksim_intq.h"
 
 #include "config.h"
 
@@ -150,6 +151,7 @@ struct disksim_interface {
   disksim_interface_sched_t sched_fn;
   disksim_interface_desched_t desched_fn;
   void *ctx;
+  int event_count;
 };
 */
 
@@ -313,7 +315,7 @@ disksim_interface_shutdown (struct disksim_interface *iface,
       exit(1);
    }
 
-   simtime = curtime;
+   disksim_set_simtime(curtime);
    disksim_printstats ();
 
    // fprintf (stderr, "disksim_shutdown done\n");
@@ -335,18 +337,18 @@ disksim_interface_dump_stats (struct disksim_interface *iface,
 
    // fprintf (stderr, "disksim_dump_stats\n");
 
-   if ((disksim->intq) && (disksim->intq->time < curtime) && ((disksim->intq->time + 0.0001) >= curtime)) {
-      curtime = disksim->intq->time;
+   if ((intq_peek()) && (intq_peek()->time < curtime) && ((intq_peek()->time + 0.0001) >= curtime)) {
+      curtime = intq_peek()->time;
    }
    if (((curtime + 0.0001) < simtime) 
-       || ((disksim->intq) 
-	   && (disksim->intq->time < curtime))) 
+       || ((intq_peek()) 
+	   && (intq_peek()->time < curtime))) 
    {
-     fprintf (stderr, "external time is mismatched with disksim time: %f vs. %f (%f)\n", curtime, simtime, ((disksim->intq) ? disksim->intq->time : 0.0));
+     fprintf (stderr, "external time is mismatched with disksim time: %f vs. %f (%f)\n", curtime, simtime, ((intq_peek()) ? intq_peek()->time : 0.0));
      exit (1);
    }
 
-   simtime = curtime;
+   disksim_set_simtime(curtime);
    disksim_cleanstats();
    disksim_printstats();
 
@@ -354,8 +356,6 @@ disksim_interface_dump_stats (struct disksim_interface *iface,
 }
 
 
-static int event_count = 0;
-
 /* This is the callback for handling internal disksim events while running */
 /* as a slave of a system-level simulation.  "syssimtime" should be the    */
 /* current simulated time of the system-level simulation.                  */
@@ -375,36 +375,36 @@ disksim_interface_internal_event (struct disksim_interface *iface,
    /* not be possible with the descheduling below (allow it if it is not */
    /* possible to deschedule.                                            */
 
-   if (disksim->intq != NULL 
-       && (disksim->intq->time + 0.0001) < curtime) 
+   if (intq_peek() != NULL 
+       && (intq_peek()->time + 0.0001) < curtime) 
    {
-     fprintf (stderr, "external time is ahead of disksim time: %f > %f\n", curtime, disksim->intq->time);
+     fprintf (stderr, "external time is ahead of disksim time: %f > %f\n", curtime, intq_peek()->time);
      exit (1);
    }
 
    // fprintf(stderr, "disksim_internal_event: intq->time=%f curtime=%f\n", disksim->intq->time, curtime);
 
    /* while next event time is same as now, handle next event */
-   if(disksim->intq != NULL){
-     ASSERT (disksim->intq->time >= simtime);
+   if(intq_peek() != NULL){
+     ASSERT (intq_peek()->time >= simtime);
    }
 
-   while ((disksim->intq != NULL) 
-	  && (disksim->intq->time <= (curtime + 0.0001))) 
+   while ((intq_peek() != NULL) 
+	  && (intq_peek()->time <= (curtime + 0.0001))) 
    {
        
      // fprintf (stderr, "handling internal event: type %d\n", disksim->intq->type);
      
-     disksim_simulate_event(event_count++);
+     disksim_simulate_event(iface->event_count++);
    }
 
-   if (disksim->intq != NULL) {
+   if (intq_peek() != NULL) {
       /* Note: this could be a dangerous operation when employing checkpoint */
       /* and, specifically, restore -- functions move around when programs   */
       /* are changed and recompiled...                                       */
 
       iface->sched_fn(disksim_interface_internal_event, 
-		      disksim->intq->time,
+		      intq_peek()->time,
 		      iface->ctx);
    }
 
@@ -439,7 +439,9 @@ disksim_interface_request_arrive (struct disksim_interface *iface,
    new->flags = requestdesc->flags;
    new->bcount = requestdesc->bytecount / 512;
    new->batchno = requestdesc->batchno;
-   new->batch_complete = requestdesc->batch_complete;
+   if (requestdesc->batch_complete) {
+      new->flags |= BATCH_COMPLETE;
+   }
       
    new->flags |= TIME_CRITICAL;
    
@@ -450,25 +452,25 @@ disksim_interface_request_arrive (struct disksim_interface *iface,
    io_map_trace_request (new);
 
    /* issue it into simulator */
-   if (disksim->intq) {
+   if (intq_peek()) {
      iface->desched_fn(0.0, iface->ctx);
    }
    addtointq ((event *)new);
 
    /* while next event time is same as now, handle next event */
-   while ((disksim->intq != NULL) 
-	  && (disksim->intq->time <= (curtime + 0.0001))) 
+   while ((intq_peek() != NULL) 
+	  && (intq_peek()->time <= (curtime + 0.0001))) 
    {
-     disksim_simulate_event (event_count++);
+     disksim_simulate_event (iface->event_count++);
    }
 
-   if (disksim->intq) {
+   if (intq_peek()) {
       /* Note: this could be a dangerous operation when employing checkpoint */
       /* and, specifically, restore -- functions move around when programs   */
       /* are changed and recompiled...                                       */
 
       iface->sched_fn(disksim_interface_internal_event, 
-		      disksim->intq->time,
+		      intq_peek()->time,
 		      iface->ctx);
    }
 }
@@ -477,13 +479,20 @@ disksim_interface_request_arrive (struct disksim_interface *iface,
 
 
 void disksim_free_disksim(struct disksim_interface *iface) {
+  disksim = iface->disksim;
   disksim_cleanup();
   free(iface->disksim);
   free(iface);
+  disksim = NULL;
 }
 
 double disksim_time_to_msec(double x) { return x; }
-double disksim_time_from_msec(double x) { return x; }
+double disksim_time_from_msec(double x) {
+  if ((disksim != NULL) && disksim->inttime) {
+    return disksim_ticks_to_msec(disksim_msec_to_ticks(x));
+  }
+  return x;
+}
 
 struct dm_disk_if *
 disksim_getdiskmodel(struct disksim_interface *i, int disknum) 
@@ -43,6 +43,7 @@ struct disksim_interface {
   disksim_interface_sched_t sched_fn;
   disksim_interface_desched_t desched_fn;
   void *ctx;
+  int event_count;
 };
 
 #endif
@@ -0,0 +1,700 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#include "disksim_global.h"
+#include "disksim_intq.h"
+#include "config.h"
+
+#define INTQ_HEAP_INITSIZE	256
+
+#define INTQ_CAL_MINBUCKETS	16
+#define INTQ_CAL_INITWIDTH	1.0	/* milliseconds */
+#define INTQ_CAL_SAMPLES	25	/* events used to estimate the width */
+#define INTQ_CAL_MAXCOST	4	/* steps per operation before retuning */
+
+/* intqpos of an event sitting on the list; heap entries use their */
+/* array index plus one.                                           */
+#define INTQ_ONLIST		1
+
+
+/*** Time-ordered linked list ***/
+
+/* Walks the list from the head, so the new event lands behind every */
+/* event already scheduled for the same time.                        */
+
+static INLINE void intq_list_insert (event *newint)
+{
+   newint->intqpos = INTQ_ONLIST;
+   if (disksim->intq == NULL) {
+      disksim->intq = newint;
+      newint->next = NULL;
+      newint->prev = NULL;
+   } 
+   else if (newint->time < disksim->intq->time) {
+      newint->next = disksim->intq;
+      disksim->intq->prev = newint;
+      disksim->intq = newint;
+      newint->prev = NULL;
+   } else {
+      event *run = disksim->intq;
+      assert(run->next != run);
+      while (run->next != NULL) {
+         if (newint->time < run->next->time) {
+            break;
+         }
+         run = run->next;
+      }
+
+      newint->next = run->next;
+      run->next = newint;
+      newint->prev = run;
+      if (newint->next != NULL) {
+         newint->next->prev = newint;
+      }
+   }
+}
+
+
+static INLINE event * intq_list_getnext ()
+{
+   event *temp = NULL;
+
+   if (disksim->intq == NULL) {
+      return(NULL);
+   }
+   temp = disksim->intq;
+   disksim->intq = disksim->intq->next;
+   if (disksim->intq != NULL) {
+      disksim->intq->prev = NULL;
+   }
+
+   temp->next = NULL;
+   temp->prev = NULL;
+   temp->intqpos = 0;
+   return(temp);
+}
+
+
+/* The handle says whether curr is on the list; checking the back link */
+/* as well rejects stale handles left in copies of scheduled events.   */
+
+static INLINE int intq_list_remove (event *curr)
+{
+   if (curr->intqpos != INTQ_ONLIST) {
+      return(FALSE);
+   }
+   if ((curr->prev) ? (curr->prev->next != curr) : (disksim->intq != curr)) {
+      return(FALSE);
+   }
+   if (curr->next != NULL) {
+      curr->next->prev = curr->prev;
+   }
+   if (curr->prev == NULL) {
+      disksim->intq = curr->next;
+   } else {
+      curr->prev->next = curr->next;
+   }
+
+   curr->next = NULL;
+   curr->prev = NULL;
+   curr->intqpos = 0;
+   return(TRUE);
+}
+
+
+/*** d-ary heap, ordered by (time, insertion sequence) ***/
+
+#define INTQ_SIGNBIT	((u_int64_t) 1 << 63)
+
+/* Maps a time to an unsigned integer with the same ordering: an IEEE   */
+/* double's bit pattern already sorts like its value when non-negative; */
+/* negatives are flipped below them.  -0.0 is folded into 0.0 first so */
+/* that equal times always get equal keys.                              */
+
+static INLINE u_int64_t intq_timekey (double time)
+{
+   union {
+      double    d;
+      u_int64_t u;
+   } k;
+
+   k.d = time + 0.0;
+   return((k.u & INTQ_SIGNBIT) ? ~k.u : (k.u | INTQ_SIGNBIT));
+}
+
+
+static INLINE int intq_ent_before (intq_ent *a, intq_ent *b)
+{
+   return ((a->key < b->key) || ((a->key == b->key) && (a->seq < b->seq)));
+}
+
+
+/* Every store into the array goes through here to keep handles current. */
+
+static INLINE void intq_heap_put (intq_heap *h, int pos, intq_ent *ent)
+{
+   h->ents[pos] = *ent;
+   ent->ev->intqpos = pos + 1;
+}
+
+
+static void intq_heap_siftup (intq_heap *h, int pos)
+{
+   intq_ent tmp = h->ents[pos];
+
+   while (pos > 0) {
+      int parent = (pos - 1) / h->arity;
+      if (!intq_ent_before(&tmp, &h->ents[parent])) {
+         break;
+      }
+      intq_heap_put(h, pos, &h->ents[parent]);
+      pos = parent;
+   }
+   intq_heap_put(h, pos, &tmp);
+}
+
+
+static void intq_heap_siftdown (intq_heap *h, int pos)
+{
+   intq_ent tmp = h->ents[pos];
+
+   while (1) {
+      int first = (pos * h->arity) + 1;
+      int last = first + h->arity;
+      int best = first;
+      int i;
+
+      if (first >= h->len) {
+         break;
+      }
+      if (last > h->len) {
+         last = h->len;
+      }
+      for (i = (first + 1); i < last; i++) {
+         if (intq_ent_before(&h->ents[i], &h->ents[best])) {
+            best = i;
+         }
+      }
+      if (!intq_ent_before(&h->ents[best], &tmp)) {
+         break;
+      }
+      intq_heap_put(h, pos, &h->ents[best]);
+      pos = best;
+   }
+   intq_heap_put(h, pos, &tmp);
+}
+
+
+static INLINE void intq_heap_insert (intq_heap *h, event *curr)
+{
+   if (h->len == h->size) {
+      h->size = (h->size) ? (2 * h->size) : INTQ_HEAP_INITSIZE;
+      h->ents = realloc(h->ents, h->size * sizeof(intq_ent));
+      ddbg_assert(h->ents != NULL);
+   }
+   h->ents[h->len].key = intq_timekey(curr->time);
+   h->ents[h->len].seq = disksim->intqseq++;
+   h->ents[h->len].ev = curr;
+   h->len++;
+   intq_heap_siftup(h, (h->len - 1));
+
+   curr->next = NULL;
+   curr->prev = NULL;
+}
+
+
+/* Removes the entry at position pos, refilling the hole with the last */
+/* entry and moving that one whichever way restores heap order.        */
+
+static INLINE event * intq_heap_delete (intq_heap *h, int pos)
+{
+   event *curr = h->ents[pos].ev;
+
+   curr->intqpos = 0;
+   h->len--;
+   if (pos < h->len) {
+      intq_heap_put(h, pos, &h->ents[h->len]);
+      if ((pos > 0) && intq_ent_before(&h->ents[pos], &h->ents[(pos - 1) / h->arity])) {
+         intq_heap_siftup(h, pos);
+      } else {
+         intq_heap_siftdown(h, pos);
+      }
+   }
+   return(curr);
+}
+
+
+static INLINE event * intq_heap_getnext (intq_heap *h)
+{
+   if (h->len == 0) {
+      return(NULL);
+   }
+   return(intq_heap_delete(h, 0));
+}
+
+
+static INLINE int intq_heap_remove (intq_heap *h, event *curr)
+{
+   int pos = curr->intqpos - 1;
+
+   if ((pos < 0) || (pos >= h->len) || (h->ents[pos].ev != curr)) {
+      return(FALSE);
+   }
+   intq_heap_delete(h, pos);
+   return(TRUE);
+}
+
+
+/*** Calendar queue ***/
+
+static INLINE u_int64_t intq_cal_vbucket (intq_cal *c, double time)
+{
+   return((time > 0.0) ? (u_int64_t) (time / c->width) : 0);
+}
+
+
+/* Files curr behind any events in its bucket with the same time, so   */
+/* simultaneous events come out in FIFO order just as from the list.   */
+
+static INLINE void intq_cal_link (intq_cal *c, event *curr)
+{
+   u_int64_t vb = intq_cal_vbucket(c, curr->time);
+   int b = (int) (vb & (c->nbuckets - 1));
+   event *run = c->buckets[b];
+
+   curr->intqpos = b + 1;
+   if ((run == NULL) || (curr->time < run->time)) {
+      curr->prev = NULL;
+      curr->next = run;
+      if (run != NULL) {
+         run->prev = curr;
+      }
+      c->buckets[b] = curr;
+   } else {
+      while ((run->next != NULL) && !(curr->time < run->next->time)) {
+         run = run->next;
+         c->cost++;
+      }
+      curr->next = run->next;
+      curr->prev = run;
+      run->next = curr;
+      if (curr->next != NULL) {
+         curr->next->prev = curr;
+      }
+   }
+   if ((c->len == 0) || (vb < c->cur)) {
+      c->cur = vb;
+   }
+   c->len++;
+}
+
+
+static INLINE void intq_cal_unlink (intq_cal *c, event *curr)
+{
+   if (curr->next != NULL) {
+      curr->next->prev = curr->prev;
+   }
+   if (curr->prev == NULL) {
+      c->buckets[curr->intqpos - 1] = curr->next;
+   } else {
+      curr->prev->next = curr->next;
+   }
+   curr->next = NULL;
+   curr->prev = NULL;
+   curr->intqpos = 0;
+   c->len--;
+}
+
+
+/* Finds the earliest event, scanning at most one year of buckets from */
+/* cur before falling back to comparing every bucket head.  Advances   */
+/* cur to the bucket found, as nothing can lie in the ones skipped.    */
+
+static event * intq_cal_find (intq_cal *c)
+{
+   u_int64_t vb = c->cur;
+   event *curr = NULL;
+   int i;
+
+   if (c->len == 0) {
+      return(NULL);
+   }
+   for (i = 0; i < c->nbuckets; i++, vb++) {
+      event *head = c->buckets[vb & (c->nbuckets - 1)];
+      if ((head != NULL) && (intq_cal_vbucket(c, head->time) <= vb)) {
+         curr = head;
+         break;
+      }
+      c->cost++;
+   }
+   if (curr == NULL) {
+      for (i = 0; i < c->nbuckets; i++) {
+         event *head = c->buckets[i];
+         if ((head != NULL) && ((curr == NULL) || (head->time < curr->time))) {
+            curr = head;
+         }
+      }
+      vb = intq_cal_vbucket(c, curr->time);
+      c->cost += c->nbuckets;
+   }
+   c->cur = vb;
+   return(curr);
+}
+
+
+/* Estimates a bucket width from the first few events in dequeue order: */
+/* three times their mean separation, leaving out separations over     */
+/* twice the overall mean so a lone far-off event does not inflate it.  */
+/* If a year of buckets does not turn up enough events, the width is   */
+/* far too small and the spread of the whole queue is used instead.    */
+
+static double intq_cal_width (intq_cal *c)
+{
+   double times[INTQ_CAL_SAMPLES];
+   double avg;
+   double sum = 0.0;
+   u_int64_t vb = c->cur;
+   int cnt = 0;
+   int used = 0;
+   int i;
+
+   if (c->len < 2) {
+      return(c->width);
+   }
+   for (i = 0; (i < c->nbuckets) && (cnt < INTQ_CAL_SAMPLES); i++, vb++) {
+      event *run = c->buckets[vb & (c->nbuckets - 1)];
+      while ((run != NULL) && (cnt < INTQ_CAL_SAMPLES) && (intq_cal_vbucket(c, run->time) == vb)) {
+         times[cnt++] = run->time;
+         run = run->next;
+      }
+   }
+
+   if (cnt < 2) {
+      double mintime = 0.0;
+      double maxtime = 0.0;
+      int first = TRUE;
+      for (i = 0; i < c->nbuckets; i++) {
+         event *run;
+         for (run = c->buckets[i]; run != NULL; run = run->next) {
+            if (first || (run->time < mintime)) {
+               mintime = run->time;
+            }
+            if (first || (run->time > maxtime)) {
+               maxtime = run->time;
+            }
+            first = FALSE;
+         }
+      }
+      avg = (maxtime - mintime) / (c->len - 1);
+      return((avg > 0.0) ? (3.0 * avg) : c->width);
+   }
+
+   avg = (times[cnt - 1] - times[0]) / (cnt - 1);
+   for (i = 1; i < cnt; i++) {
+      double sep = times[i] - times[i - 1];
+      if (sep <= (2.0 * avg)) {
+         sum += sep;
+         used++;
+      }
+   }
+   return((sum > 0.0) ? (3.0 * sum / used) : c->width);
+}
+
+
+static void intq_cal_resize (intq_cal *c, int nbuckets)
+{
+   event **oldbuckets = c->buckets;
+   int oldnbuckets = c->nbuckets;
+   int i;
+
+   c->width = intq_cal_width(c);
+   c->buckets = calloc(nbuckets, sizeof(event *));
+   ddbg_assert(c->buckets != NULL);
+   c->nbuckets = nbuckets;
+   c->len = 0;
+   for (i = 0; i < oldnbuckets; i++) {
+      event *curr = oldbuckets[i];
+      while (curr != NULL) {
+         event *next = curr->next;
+         intq_cal_link(c, curr);
+         curr = next;
+      }
+   }
+   free(oldbuckets);
+   c->ops = 0;
+   c->cost = 0;
+}
+
+
+/* Doubles or halves the calendar as the queue length crosses twice or */
+/* half the bucket count, and otherwise re-estimates the width once    */
+/* every 2*nbuckets operations if they have been taking too many steps. */
+
+static INLINE void intq_cal_tune (intq_cal *c)
+{
+   c->ops++;
+   if (c->len > (2 * c->nbuckets)) {
+      intq_cal_resize(c, (2 * c->nbuckets));
+   } else if ((c->len < (c->nbuckets / 2)) && (c->nbuckets > INTQ_CAL_MINBUCKETS)) {
+      intq_cal_resize(c, (c->nbuckets / 2));
+   } else if (c->ops >= (2 * c->nbuckets)) {
+      if (c->cost > (INTQ_CAL_MAXCOST * c->ops)) {
+         intq_cal_resize(c, c->nbuckets);
+      }
+      c->ops = 0;
+      c->cost = 0;
+   }
+}
+
+
+static INLINE void intq_cal_insert (intq_cal *c, event *curr)
+{
+   intq_cal_link(c, curr);
+   intq_cal_tune(c);
+}
+
+
+static INLINE event * intq_cal_getnext (intq_cal *c)
+{
+   event *curr = intq_cal_find(c);
+
+   if (curr != NULL) {
+      intq_cal_unlink(c, curr);
+      intq_cal_tune(c);
+   }
+   return(curr);
+}
+
+
+static INLINE int intq_cal_remove (intq_cal *c, event *curr)
+{
+   int b = curr->intqpos - 1;
+
+   if ((b < 0) || (b >= c->nbuckets)) {
+      return(FALSE);
+   }
+   if ((curr->prev) ? (curr->prev->next != curr) : (c->buckets[b] != curr)) {
+      return(FALSE);
+   }
+   intq_cal_unlink(c, curr);
+   intq_cal_tune(c);
+   return(TRUE);
+}
+
+
+/*** Event stream recording ***/
+
+static void intq_trace (int op, event *curr)
+{
+   intq_traceop rec;
+
+   rec.time = curr->time;
+   rec.id = (u_int64_t) (size_t) curr;
+   rec.op = op;
+   rec.type = curr->type;
+   if (fwrite(&rec, sizeof(rec), 1, disksim->intqtrace) != 1) {
+      ddbg_assert2(0, "write to event queue trace file failed");
+   }
+}
+
+
+/*** Dispatch ***/
+
+void intq_insert (event *curr)
+{
+   if (disksim->intqtrace) {
+      intq_trace(INTQ_OP_INSERT, curr);
+   }
+   if (disksim->intqtype == INTQ_LIST) {
+      intq_list_insert(curr);
+   } else if (disksim->intqtype == INTQ_CALENDAR) {
+      intq_cal_insert(disksim->intqcal, curr);
+   } else {
+      intq_heap_insert(disksim->intqheap, curr);
+   }
+   disksim->intqlen++;
+}
+
+
+event * intq_getnext ()
+{
+   event *curr;
+
+   if (disksim->intqtype == INTQ_LIST) {
+      curr = intq_list_getnext();
+   } else if (disksim->intqtype == INTQ_CALENDAR) {
+      curr = intq_cal_getnext(disksim->intqcal);
+   } else {
+      curr = intq_heap_getnext(disksim->intqheap);
+   }
+   if (curr) {
+      disksim->intqlen--;
+      if (disksim->intqtrace) {
+         intq_trace(INTQ_OP_GETNEXT, curr);
+      }
+   }
+   return(curr);
+}
+
+
+int intq_remove (event *curr)
+{
+   int found;
+
+   if (disksim->intqtrace) {
+      intq_trace(INTQ_OP_REMOVE, curr);
+   }
+   if (disksim->intqtype == INTQ_LIST) {
+      found = intq_list_remove(curr);
+   } else if (disksim->intqtype == INTQ_CALENDAR) {
+      found = intq_cal_remove(disksim->intqcal, curr);
+   } else {
+      found = intq_heap_remove(disksim->intqheap, curr);
+   }
+   if (found) {
+      disksim->intqlen--;
+      disksim->intqcancels++;
+      if (curr->type == TIMER_EXPIRED) {
+         disksim->intqtimercancels++;
+      }
+   }
+   return(found);
+}
+
+
+/* Returns the next scheduled event without dequeueing it. */
+
+event * intq_peek ()
+{
+   if (disksim->intqtype == INTQ_LIST) {
+      return(disksim->intq);
+   }
+   if (disksim->intqtype == INTQ_CALENDAR) {
+      return(intq_cal_find(disksim->intqcal));
+   }
+   if (disksim->intqheap->len == 0) {
+      return(NULL);
+   }
+   return(disksim->intqheap->ents[0].ev);
+}
+
+
+/* Switches implementations, carrying over anything already scheduled */
+/* in the order it would have been dequeued.                          */
+
+void intq_settype (int type)
+{
+   event *pending = NULL;
+   event *tail = NULL;
+   event *curr;
+
+   ddbg_assert((type >= INTQ_MIN_TYPE) && (type <= INTQ_MAX_TYPE));
+
+   while ((curr = intq_getnext()) != NULL) {
+      if (tail) {
+         tail->next = curr;
+      } else {
+         pending = curr;
+      }
+      tail = curr;
+   }
+   if (tail) {
+      tail->next = NULL;
+   }
+
+   intq_cleanup();
+   disksim->intqtype = type;
+   if (type == INTQ_CALENDAR) {
+      disksim->intqcal = calloc(1, sizeof(intq_cal));
+      ddbg_assert(disksim->intqcal != NULL);
+      disksim->intqcal->nbuckets = INTQ_CAL_MINBUCKETS;
+      disksim->intqcal->width = INTQ_CAL_INITWIDTH;
+      disksim->intqcal->buckets = calloc(INTQ_CAL_MINBUCKETS, sizeof(event *));
+      ddbg_assert(disksim->intqcal->buckets != NULL);
+   } else if (type != INTQ_LIST) {
+      disksim->intqheap = calloc(1, sizeof(intq_heap));
+      ddbg_assert(disksim->intqheap != NULL);
+      disksim->intqheap->arity = (type == INTQ_4HEAP) ? 4 : 2;
+   }
+
+   while ((curr = pending) != NULL) {
+      pending = curr->next;
+      intq_insert(curr);
+   }
+}
+
+
+/* Prints the intq to the given file, presumably for debug.  Heap and */
+/* calendar entries are printed in storage order, not dequeue order.  */
+
+void intq_dump (FILE *fp)
+{
+   event *tmp;
+   int i;
+
+   if (disksim->intqtype == INTQ_LIST) {
+      for (tmp = disksim->intq; tmp != NULL; tmp = tmp->next) {
+         fprintf (fp, "time %f, type %d\n", tmp->time, tmp->type);
+      }
+      return;
+   }
+   if (disksim->intqtype == INTQ_CALENDAR) {
+      for (i = 0; i < disksim->intqcal->nbuckets; i++) {
+         for (tmp = disksim->intqcal->buckets[i]; tmp != NULL; tmp = tmp->next) {
+            fprintf (fp, "time %f, type %d\n", tmp->time, tmp->type);
+         }
+      }
+      return;
+   }
+   for (i = 0; i < disksim->intqheap->len; i++) {
+      tmp = disksim->intqheap->ents[i].ev;
+      fprintf (fp, "time %f, type %d\n", tmp->time, tmp->type);
+   }
+}
+
+
+/* Releases the heap or calendar storage, leaving an empty list; the */
+/* events themselves belong to the caller.                            */
+
+void intq_cleanup ()
+{
+   if (disksim->intqheap) {
+      free(disksim->intqheap->ents);
+      free(disksim->intqheap);
+      disksim->intqheap = NULL;
+   }
+   if (disksim->intqcal) {
+      free(disksim->intqcal->buckets);
+      free(disksim->intqcal);
+      disksim->intqcal = NULL;
+   }
+   disksim->intqtype = INTQ_LIST;
+}
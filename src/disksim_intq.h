@@ -0,0 +1,106 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#ifndef DISKSIM_INTQ_H
+#define DISKSIM_INTQ_H
+
+#include "disksim_global.h"
+
+/* Implementations of the intq, the queue of scheduled events.  Selected */
+/* with the "Event queue type" global parameter.  Each scheduled event   */
+/* carries its own position in the queue (intqpos), so descheduling it   */
+/* does not search the queue.                                            */
+
+#define INTQ_LIST	0	/* time-ordered doubly-linked list */
+#define INTQ_BINHEAP	1	/* binary heap */
+#define INTQ_4HEAP	2	/* 4-ary heap */
+#define INTQ_CALENDAR	3	/* calendar queue with self-tuning bucket width */
+
+#define INTQ_MIN_TYPE	INTQ_LIST
+#define INTQ_MAX_TYPE	INTQ_CALENDAR
+
+/* Heap entries carry the event time, as an integer key that orders the */
+/* same way (see intq_timekey), and an insertion sequence number, so     */
+/* events scheduled for the same time come out in FIFO order just as     */
+/* they do from the list.                                                */
+
+typedef struct intq_ent {
+   u_int64_t key;
+   u_int64_t seq;
+   event    *ev;
+} intq_ent;
+
+typedef struct intq_heap {
+   intq_ent *ents;
+   int       len;
+   int       size;
+   int       arity;
+} intq_heap;
+
+/* Calendar queue (Brown, CACM 1988).  Bucket i holds, in time order, the */
+/* events whose virtual bucket floor(time/width) is congruent to i mod    */
+/* nbuckets.  The bucket count follows the queue length and the width is */
+/* re-estimated from the events near the head whenever it changes, or    */
+/* when dequeues start costing too many bucket visits.                   */
+
+typedef struct intq_cal {
+   event   **buckets;
+   int       nbuckets;		/* always a power of two */
+   double    width;
+   u_int64_t cur;		/* no event lies in a virtual bucket before this */
+   int       len;
+   int       ops;		/* operations since the width was last checked */
+   int       cost;		/* bucket and list steps taken by those operations */
+} intq_cal;
+
+/* Records written when "Event queue trace file" is set, and replayed by */
+/* intqbench to compare the implementations on a real event stream.      */
+
+#define INTQ_OP_INSERT	1
+#define INTQ_OP_GETNEXT	2
+#define INTQ_OP_REMOVE	3
+
+typedef struct intq_traceop {
+   double    time;
+   u_int64_t id;		/* event address; ids are reused as events recycle */
+   int       op;
+   int       type;
+} intq_traceop;
+
+void          intq_settype (int type);
+void          intq_insert (event *curr);
+event        *intq_getnext (void);
+int           intq_remove (event *curr);
+event        *intq_peek (void);
+void          intq_dump (FILE *fp);
+void          intq_cleanup (void);
+
+#endif   /* DISKSIM_INTQ_H */
@@ -109,6 +109,8 @@
 #include "disksim_ioqueue.h"
 #include "disksim_bus.h"
 #include "disksim_controller.h"
+#include "disksim_complog.h"
+#include "disksim_tseries.h"
 #include "config.h"
 
 #include "modules/modules.h"
@@ -149,7 +151,7 @@ fprintf (outputfile, "iodriver_send_event_down_path: busno %d, slotno %d\n", bus
 }
 
 
-double iodriver_raise_priority (int iodriverno, int opid, int devno, int blkno, void *chan)
+double iodriver_raise_priority (int iodriverno, int opid, int devno, disksim_lbn_t blkno, void *chan)
 {
    logorg_raise_priority(sysorgs, numsysorgs, opid, devno, blkno, chan);
    return(0.0);
@@ -271,7 +273,7 @@ fprintf (outputfile, "Entered iodriver_schedule - devno %d, blkno %d, bcount %d,
       if ((ctl->maxreqsize) && (curr->bcount > ctl->maxreqsize)) {
          ioreq_event *totalreq = ioreq_copy(curr);
 /*
-fprintf (outputfile, "%f, oversized request: opid %d, blkno %d, bcount %d, maxreqsize %d\n", simtime, curr->opid, curr->blkno, curr->bcount, ctl->maxreqsize);
+fprintf (outputfile, "%f, oversized request: opid %d, blkno %lld, bcount %d, maxreqsize %d\n", simtime, curr->opid, curr->blkno, curr->bcount, ctl->maxreqsize);
 */
          curr->bcount = ctl->maxreqsize;
          if (ctl->oversized) {
@@ -295,7 +297,7 @@ static void update_iodriver_statistics()
 }
 
 
-static void iodriver_check_c700_based_status (iodriver *curriodriver, int devno, int cause, int type, int blkno)
+static void iodriver_check_c700_based_status (iodriver *curriodriver, int devno, int cause, int type, disksim_lbn_t blkno)
 {
    ctlr *ctl;
    ioreq_event *tmp;
@@ -399,6 +401,7 @@ void iodriver_access_complete (int iodriverno, intr_event *intrp)
    int devno;
    int skip = 0;
    ctlr *ctl = NULL;
+   complog_rec rec;
 
    if (iodrivers[iodriverno]->type == STANDALONE) {
       req = ioreq_copy((ioreq_event *) intrp->infoptr);
@@ -441,13 +444,13 @@ void iodriver_access_complete (int iodriverno, intr_event *intrp)
 	  && (req->blkno >= tmp->next->blkno) 
 	  && (req->blkno < (tmp->next->blkno + tmp->next->bcount))) 
       {
-	fprintf (outputfile, "%f, part of oversized request completed: opid %d, blkno %d, bcount %d, maxreqsize %d\n", simtime, req->opid, req->blkno, req->bcount, ctl->maxreqsize);
+	fprintf (outputfile, "%f, part of oversized request completed: opid %d, blkno %lld, bcount %d, maxreqsize %d\n", simtime, req->opid, req->blkno, req->bcount, ctl->maxreqsize);
 
 	if ((req->blkno + ctl->maxreqsize) < (tmp->next->blkno + tmp->next->bcount)) 
 	{
 	  fprintf (outputfile, "more to go\n");
 	  req->blkno += ctl->maxreqsize;
-	  req->bcount = min(ctl->maxreqsize, 
+	  req->bcount = (int) min(ctl->maxreqsize, 
 			    (tmp->next->blkno + tmp->next->bcount - req->blkno));
 	  goto schedule_next;
 	} 
@@ -473,6 +476,11 @@ void iodriver_access_complete (int iodriverno, intr_event *intrp)
    devno = req->devno;
    req = ioqueue_physical_access_done(iodrivers[iodriverno]->devices[devno].queue, req);
 
+   /* for a request split across devices, the completion log gets the */
+   /* start and queue times of the part that finished last             */
+   rec.start = simtime - disksim->lastphystime;
+   rec.qtime = disksim->lastouttime - disksim->lastphystime;
+
    if (ctl) {
       ctl->numoutstanding--;
    }
@@ -519,6 +527,28 @@ void iodriver_access_complete (int iodriverno, intr_event *intrp)
 	ioreq_event *temp = ioqueue_get_specific_request (overallqueue, tmp);
 	ioreq_event *temp2 = ioqueue_physical_access_done (overallqueue, temp);
 	ASSERT (temp2 != NULL);
+	if (disksim->complog) {
+	  rec.arrival = simtime - disksim->lastouttime;
+	  rec.done = simtime;
+	  /* a request that joined an access already queued or under way */
+	  /* (e.g. a read of blocks being written) only counts from when  */
+	  /* it arrived                                                   */
+	  if (rec.start < rec.arrival) {
+	    rec.start = rec.arrival;
+	  }
+	  if (rec.qtime > (rec.start - rec.arrival)) {
+	    rec.qtime = rec.start - rec.arrival;
+	  }
+	  rec.devno = temp->devno;
+	  rec.blkno = temp->blkno;
+	  rec.bcount = temp->bcount;
+	  rec.flags = temp->flags;
+	  complog_put(disksim->complog, &rec);
+	}
+	if (disksim->tseries) {
+	  tseries_done(disksim->tseries, temp, disksim->lastouttime);
+	}
+	io_stream_done(temp);
 	addtoextraq((event *)temp);
 	temp = NULL;
 	
@@ -753,7 +783,7 @@ event * iodriver_request (int iodriverno, ioreq_event *curr)
    fprintf (stderr, "Entered iodriver_request - simtime %f, devno %d, blkno %d, cause %d\n", simtime, curr->devno, curr->blkno, curr->cause);
 */
    if (outios) {
-      fprintf(outios, "%.6f\t%d\t%d\t%d\t%x\n", simtime, curr->devno, curr->blkno, curr->bcount, curr->flags);
+      fprintf(outios, "%.6f\t%d\t%lld\t%d\t%x\n", simtime, curr->devno, curr->blkno, curr->bcount, curr->flags);
    }
 
 #if 0
@@ -763,6 +793,9 @@ event * iodriver_request (int iodriverno, ioreq_event *curr)
    /* add to the overall queue to start tracking */
    ret = ioreq_copy (curr);
    ioqueue_add_new_request (overallqueue, ret);
+   if (disksim->tseries) {
+      tseries_arrive(disksim->tseries, ret);
+   }
    ret = NULL;
  
    disksim->totalreqs++;
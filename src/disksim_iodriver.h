@@ -220,7 +220,7 @@ void    iodriver_cleanstats (void);
 event * iodriver_request (int iodriverno, ioreq_event *curr);
 void    iodriver_schedule (int iodriverno, ioreq_event *curr);
 double  iodriver_tick (void);
-double  iodriver_raise_priority (int iodriverno, int opid, int devno, int blkno, void *chan);
+double  iodriver_raise_priority (int iodriverno, int opid, int devno, disksim_lbn_t blkno, void *chan);
 void    iodriver_interrupt_arrive (int iodriverno, intr_event *intrp);
 void    iodriver_access_complete (int iodriverno, intr_event *intrp);
 void    iodriver_respond_to_device (int iodriverno, intr_event *intrp);
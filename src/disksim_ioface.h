@@ -132,10 +132,12 @@ void    io_initialize (int standalone);
 void    io_internal_event (ioreq_event *curr);
 event * io_get_next_external_event (FILE *tracefile);
 int     io_using_external_event (event *curr);
+int     io_stream_prime (void);
+void    io_stream_done (ioreq_event *curr);
 event * io_request (ioreq_event *curr);
 void    io_schedule (ioreq_event *curr);
 double  io_tick (void);
-double  io_raise_priority (int opid, int devno, int blkno, void *chan);
+double  io_raise_priority (int opid, int devno, disksim_lbn_t blkno, void *chan);
 void    io_interrupt_arrive (ioreq_event *intrp);
 void    io_interrupt_complete (ioreq_event *intrp);
 void    io_catch_stray_events (ioreq_event *curr);
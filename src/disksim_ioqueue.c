@@ -176,7 +176,7 @@ void print_batch_fcfs_queue(subqueue *queue)
   printf(" iobufcnt = %d\n", queue->iobufcnt);
 
   for (i = 0; i < queue->iobufcnt; i++) {
-    printf(" %d %d %d %d %d %d\n",
+    printf(" %lld %d %d %d %lld %lld\n",
 	   tmp->blkno,
 	   tmp->batchno,
 	   tmp->state,
@@ -189,7 +189,7 @@ void print_batch_fcfs_queue(subqueue *queue)
       
       printf("  batch_size = %d\n", tmp->batch_size);
       while (event_ptr != NULL) {
-	printf("   %d\n", event_ptr->blkno);
+	printf("   %lld\n", event_ptr->blkno);
 	event_ptr = event_ptr->batch_next;
       }
     }
@@ -205,21 +205,21 @@ void ioqueue_print_contents (ioqueue *queue)
    tmp = queue->base.list->next;
    fprintf (outputfile, "Contents of base queue: listlen %d\n", queue->base.listlen);
    for (i = 0; i < queue->base.iobufcnt; i++) {
-      fprintf(outputfile, "State: %d, blkno: %d\n", tmp->state, tmp->blkno);
+      fprintf(outputfile, "State: %d, blkno: %lld\n", tmp->state, tmp->blkno);
       tmp = tmp->next;
    }
 
    tmp = queue->timeout.list->next;
    fprintf(outputfile, "Contents of timeout queue: listlen %d\n", queue->timeout.listlen);
    for (i = 0; i < queue->timeout.iobufcnt; i++) {
-      fprintf(outputfile, "State: %d, blkno: %d\n", tmp->state, tmp->blkno);
+      fprintf(outputfile, "State: %d, blkno: %lld\n", tmp->state, tmp->blkno);
       tmp = tmp->next;
    }
 
    tmp = queue->priority.list->next;
    fprintf(outputfile, "Contents of priority queue: listlen %d\n", queue->priority.listlen);
    for (i = 0; i < queue->priority.iobufcnt; i++) {
-      fprintf(outputfile, "State: %d, blkno: %d\n", tmp->state, tmp->blkno);
+      fprintf(outputfile, "State: %d, blkno: %lld\n", tmp->state, tmp->blkno);
       tmp = tmp->next;
    }
 }
@@ -232,9 +232,9 @@ static void ioqueue_print_subqueue_state (subqueue *queue)
 
    tmp = queue->list->next;
    fprintf(outputfile, "\nContents of subqueue: listlen %d\n", queue->listlen);
-   fprintf(outputfile, "Subqueue state: lastblkno %d, lastcylno %d, lastsurface %d, dir %d\n", queue->lastblkno, queue->lastcylno, queue->lastsurface, queue->dir);
+   fprintf(outputfile, "Subqueue state: lastblkno %lld, lastcylno %d, lastsurface %d, dir %d\n", queue->lastblkno, queue->lastcylno, queue->lastsurface, queue->dir);
    for (i = 0; i < queue->iobufcnt; i++) {
-      fprintf(outputfile, "State: %d, blkno: %d, cylno %d, surface %d\n", tmp->state, tmp->blkno, tmp->cylinder, tmp->surface);
+      fprintf(outputfile, "State: %d, blkno: %lld, cylno %d, surface %d\n", tmp->state, tmp->blkno, tmp->cylinder, tmp->surface);
       tmp = tmp->next;
    }
 }
@@ -290,9 +290,9 @@ int ioqueue_get_number_of_requests_initiated (ioqueue *queue)
 }
 
 
-int ioqueue_get_dist (ioqueue *queue, int blkno)
+disksim_lbn_t ioqueue_get_dist (ioqueue *queue, disksim_lbn_t blkno)
 {
-   int lastblkno;
+   disksim_lbn_t lastblkno;
 
    if (queue->lastsubqueue == IOQUEUE_BASE) {
       lastblkno = queue->base.lastblkno;
@@ -304,14 +304,14 @@ int ioqueue_get_dist (ioqueue *queue, int blkno)
       fprintf(stderr, "Unknown queue identification at ioqueue_get_dist - %d\n", queue->lastsubqueue);
       exit(1);
    }
-   return(abs(blkno - lastblkno));
+   return(llabs(blkno - lastblkno));
 }
 
 
 static void 
 ioqueue_get_cylinder_mapping(ioqueue *queue, 
 			     iobuf *curr, 
-			     int blkno, 
+			     disksim_lbn_t blkno, 
 			     int *cylptr, 
 			     int *surfptr, 
 			     int cylmaptype)
@@ -346,7 +346,7 @@ ioqueue_get_cylinder_mapping(ioqueue *queue,
          break;
 
       case MAP_AVGCYLMAP:
-         *cylptr = blkno / queue->sectpercyl;
+         *cylptr = (int) (blkno / queue->sectpercyl);
          *surfptr = 0;
          break;
 
@@ -364,7 +364,7 @@ ioqueue_get_cylinder_mapping(ioqueue *queue,
 }
 
 
-void ioqueue_set_concatok_function (ioqueue *queue, int (**concatok)(void *,int,int,int,int), void *concatokparam)
+void ioqueue_set_concatok_function (ioqueue *queue, int (**concatok)(void *,disksim_lbn_t,int,disksim_lbn_t,int), void *concatokparam)
 {
    queue->concatok = concatok;
    queue->concatokparam = concatokparam;
@@ -571,10 +571,9 @@ static void ioqueue_insert_batch_fcfs_to_queue (subqueue *queue, iobuf *new_iobu
       }
       
       event_ptr->batch_next = new_iobuf->iolist;
-      event_ptr->batch_next->batch_prev = event_ptr;
       event_ptr->batch_next->batch_next = NULL;
 
-      if (new_iobuf->iolist->batch_complete == TRUE) {
+      if (new_iobuf->iolist->flags & BATCH_COMPLETE) {
 	tmp->batch_complete = TRUE;
       } else {
 	tmp->batch_complete = FALSE;
@@ -678,7 +677,7 @@ static int ioqueue_check_concat (subqueue *queue, iobuf *req1, iobuf *req2, int
 {
    ioreq_event *tmp;
    int seqscheme = queue->bigqueue->seqscheme;
-   int (**concatok)(void *,int,int,int,int) = queue->bigqueue->concatok;
+   int (**concatok)(void *,disksim_lbn_t,int,disksim_lbn_t,int) = queue->bigqueue->concatok;
    void *concatokparam = queue->bigqueue->concatokparam;
 
    if (req1->next != req2) {
@@ -888,13 +887,13 @@ static int ioqueue_get_priority_level (ioqueue *ioqueue, iobuf *req)
 }
 
 
-static iobuf * ioqueue_get_request_from_pri_lbn_vscan_queue (subqueue *queue, int numlbns, int vscan_value)
+static iobuf * ioqueue_get_request_from_pri_lbn_vscan_queue (subqueue *queue, disksim_lbn_t numlbns, disksim_lbn_t vscan_value)
 {
    int schedalg;
    int priority_factor;
    int age_factor;
    iobuf *tmp;
-   int curr_effpri = 0, best_effpri = 0;
+   disksim_lbn_t curr_effpri = 0, best_effpri = 0;
    iobuf *ret = NULL;
    int i;
 
@@ -968,13 +967,13 @@ static iobuf * ioqueue_get_request_from_lbn_scan_queue (subqueue *queue)
 
 /* Queue contains >= 2 items when called */
 
-static iobuf * ioqueue_get_request_from_lbn_vscan_queue (subqueue *queue, int value)
+static iobuf * ioqueue_get_request_from_lbn_vscan_queue (subqueue *queue, disksim_lbn_t value)
 {
    iobuf *temp;
    iobuf *head;
    iobuf *top = NULL;
    iobuf *bottom = NULL;
-   int diff1, diff2;
+   disksim_lbn_t diff1, diff2;
    int tmpdir;
    iobuf *bestbottom;
 
@@ -1085,7 +1084,7 @@ static iobuf *ioqueue_identify_request_on_cylinder (subqueue *queue)
 
    int lastcylno;
    int lastsurface;
-   int lastblkno;
+   disksim_lbn_t lastblkno;
 
    lastcylno = queue->lastcylno;
    lastsurface = queue->lastsurface;
@@ -1469,29 +1468,49 @@ service_time(unsigned int current_cyl,
 
 #define MAX_TSPS 10
 
-static double min_time;
-static int current_head=0;
-static int sched_count=0;
-
-static iobuf *requests[MAX_TSPS];
+/* TSPS scheduling state, kept per simulation rather than in statics */
+/* so that simulation instances stay independent.                    */
+typedef struct ioqueue_tsps {
+  double min_time;
+  int current_head;
+  int sched_count;
+  iobuf *requests[MAX_TSPS];
+} ioqueue_tsps_t;
+
+/* #defines to remap the ioqueue_tsps variables to their original names */
+#define tsps_min_time      (disksim->ioqueue_tsps->min_time)
+#define tsps_current_head  (disksim->ioqueue_tsps->current_head)
+#define tsps_sched_count   (disksim->ioqueue_tsps->sched_count)
+#define tsps_requests      (disksim->ioqueue_tsps->requests)
+
+static void ioqueue_tsps_initialize (void)
+{
+  if (disksim->ioqueue_tsps != NULL) {
+    return;
+  }
+  disksim->ioqueue_tsps = DISKSIM_malloc(sizeof(ioqueue_tsps_t));
+  bzero((char *)disksim->ioqueue_tsps, sizeof(ioqueue_tsps_t));
+}
 
 static void remove_tsps(iobuf *tmp){
   int i;
   iobuf *temp;
 
+  ioqueue_tsps_initialize();
+
   temp = tmp;
-  for(i=0;i<sched_count;i++){
-    if(requests[current_head+i] == temp){
-      if((current_head+i+1) < MAX_TSPS){
-	requests[current_head+i] = requests[current_head+i+1];
-	temp = requests[current_head+i+1];
+  for(i=0;i<tsps_sched_count;i++){
+    if(tsps_requests[tsps_current_head+i] == temp){
+      if((tsps_current_head+i+1) < MAX_TSPS){
+	tsps_requests[tsps_current_head+i] = tsps_requests[tsps_current_head+i+1];
+	temp = tsps_requests[tsps_current_head+i+1];
       }else{
-	requests[current_head+i] = NULL;
+	tsps_requests[tsps_current_head+i] = NULL;
       }
     }
   }
-  if(sched_count != 0){
-    sched_count--;
+  if(tsps_sched_count != 0){
+    tsps_sched_count--;
   }
 }
 
@@ -1515,7 +1534,7 @@ static void calc_sp(iobuf **array, subqueue *queue, int checkcache, int no_reque
   for (i=0; i<no_requests; i++) {
     temp = array[i];
     
-    /*    if(acc_time > min_time){
+    /*    if(acc_time > tsps_min_time){
       break;
       }*/
     test->blkno = temp->blkno;
@@ -1542,21 +1561,21 @@ static void calc_sp(iobuf **array, subqueue *queue, int checkcache, int no_reque
     last_cylinder = temp->cylinder;
     last_head = temp->surface;
   }
-  if(acc_time < min_time){
+  if(acc_time < tsps_min_time){
     //    fprintf(stderr,"time = %f\n",acc_time);
     //fprintf(stderr,"Setting up acc_time\n");
     for (i=0; i<MAX_TSPS; i++) {
       if(i<no_requests){
 	//	fprintf(stderr,"i = %d %d\n",i,array[i]->blkno);
-	requests[i] = array[i];
+	tsps_requests[i] = array[i];
       }else{
-	requests[i] = NULL;
+	tsps_requests[i] = NULL;
       }
     }
     //    fprintf(stderr,"\n");
-    min_time = acc_time;
-    sched_count = no_requests;
-    current_head = 0;
+    tsps_min_time = acc_time;
+    tsps_sched_count = no_requests;
+    tsps_current_head = 0;
   }
   addtoextraq((event *) test);
 }
@@ -1626,6 +1645,7 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
    //   ioreq_event *tmp;
    
    ASSERT((ageweight >= 0) && (ageweight <= 3));
+   ioqueue_tsps_initialize();
    
    /*   singledisk = getdisk(queue->bigqueue->devno);
    for(j=0;j<singledisk->numbands;j++){
@@ -1637,9 +1657,9 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
    readdelay = queue->bigqueue->readdelay;
    writedelay = queue->bigqueue->writedelay;
    weight = (double) queue->bigqueue->to_time;*/
-   if(sched_count != 0){
-     if(requests[current_head] != NULL){
-       best = requests[current_head];
+   if(tsps_sched_count != 0){
+     if(tsps_requests[tsps_current_head] != NULL){
+       best = tsps_requests[tsps_current_head];
        test = (ioreq_event *) getfromextraq();
        test->blkno = best->blkno;
        test->bcount = best->totalsize;
@@ -1648,9 +1668,9 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
        test->time = simtime;
        acc_time = device_get_acctime(test->devno, test, 100000);
        addtoextraq((event *) test);
-       current_head++;
-       sched_count--;
-       fprintf (stderr, "2Selected request: %f, cylno %d, blkno %d, read %d, devno %d\n",
+       tsps_current_head++;
+       tsps_sched_count--;
+       fprintf (stderr, "2Selected request: %f, cylno %d, blkno %lld, read %d, devno %d\n",
 		acc_time, best->cylinder, best->blkno, (best->flags & READ), best->iolist->devno);     
        return(best);
      }else{
@@ -1662,7 +1682,7 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
 
    //fprintf(outputfile, "get_request_from_sptf::  listlen = %d\n", queue->listlen);
 
-   min_time = 100000;
+   tsps_min_time = 100000;
    for (i=0; i<queue->listlen; i++) {
 
       if (READY_TO_GO(temp,queue) && (ioqueue_seqstream_head(queue->bigqueue, queue->list->next, temp))) {
@@ -1739,10 +1759,10 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
      mintime, best->cylinder, best->blkno, (best->flags & READ), best->iolist->devno);*/
    
    perm(test_requests,request_count,queue,checkcache,request_count);
-   fprintf(stderr,"sched count = %d\n",sched_count);
-   if(sched_count != 0){
-     if(requests[current_head] != NULL){
-       best = requests[current_head];
+   fprintf(stderr,"sched count = %d\n",tsps_sched_count);
+   if(tsps_sched_count != 0){
+     if(tsps_requests[tsps_current_head] != NULL){
+       best = tsps_requests[tsps_current_head];
        test = (ioreq_event *) getfromextraq();
        test->blkno = best->blkno;
        test->bcount = best->totalsize;
@@ -1751,11 +1771,11 @@ ioqueue_get_request_from_opt_tsps_queue(subqueue *queue,
        test->time = simtime;
        acc_time = device_get_acctime(test->devno, test, 100000);
        addtoextraq((event *) test);
-       current_head++;
-       sched_count--;
+       tsps_current_head++;
+       tsps_sched_count--;
 
-       fprintf (stderr, "3Selected request: %f, cylno %d, blkno %d, read %d, devno %d %f\n",
-		acc_time, best->cylinder, best->blkno, (best->flags & READ), best->iolist->devno, min_time);      
+       fprintf (stderr, "3Selected request: %f, cylno %d, blkno %lld, read %d, devno %d %f\n",
+		acc_time, best->cylinder, best->blkno, (best->flags & READ), best->iolist->devno, tsps_min_time);      
        return(best);
      }else{ 
        fprintf(stderr,"ERROR: request NULL with count != 0\n");
@@ -2891,7 +2911,7 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
 	 tmp = tmp->next;
       }
       if ((tmp->state != PENDING) || (ioqueue_request_match(done, tmp) == 0)) {
-	 fprintf(stderr, "Completed event not found pending in ioqueue - blkno %d, tmp->blkno %d, tmp->totalsize %d, %d, %d, %d, %d\n", done->blkno, tmp->blkno, tmp->totalsize, (tmp == NULL), done->opid, tmp->opid, done->bcount);
+	 fprintf(stderr, "Completed event not found pending in ioqueue - blkno %lld, tmp->blkno %lld, tmp->totalsize %d, %d, %d, %d, %d\n", done->blkno, tmp->blkno, tmp->totalsize, (tmp == NULL), done->opid, tmp->opid, done->bcount);
          fprintf(stderr, "tmp->state %d\n", tmp->state);
 	 assert(0);
       }
@@ -2921,6 +2941,7 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
       queue->numcomplete++;
       stat_update(&queue->accstats, (simtime - tmp->starttime));
       disksim->lastphystime = simtime - tmp->starttime;
+      disksim->lastouttime = simtime - tmp->iob_un.time;
       stat_update(&queue->outtimestats, (simtime - tmp->iob_un.time));
       // printf("Updated outtimestats with %f - simtime = %f, iob_un.time = %f\n", simtime - tmp->iob_un.time, simtime, tmp->iob_un.time);
       if (tmp->flags & READ) {
@@ -2939,6 +2960,7 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
    } else {
      if (queue->sched_alg == BATCH_FCFS) {
        ioreq_event *batch_ptr = tmp->batch_list;
+       ioreq_event *batch_prev = NULL;
        // trv = tmp->batch_list;
        trv = done;
 
@@ -2951,18 +2973,15 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
 	     break;
 	   } else if (tmp->batch_list == batch_ptr) {
 	     tmp->batch_list = batch_ptr->batch_next;
-	     batch_ptr->batch_next->batch_prev = NULL;
 	     tmp->batch_size--;
 	     break;
 	   } else {
-	     batch_ptr->batch_prev->batch_next = batch_ptr->batch_next;
-	     if (batch_ptr->batch_next != NULL) {
-	       batch_ptr->batch_next->batch_prev = batch_ptr->batch_prev;
-	     }
+	     batch_prev->batch_next = batch_ptr->batch_next;
 	     tmp->batch_size--;
 	     break;
 	   }
 	 }
+	 batch_prev = batch_ptr;
 	 batch_ptr = batch_ptr->batch_next;
        }
        
@@ -2976,6 +2995,7 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
        queue->numcomplete++;
        stat_update(&queue->accstats, (simtime - tmp->starttime));
        disksim->lastphystime = simtime - tmp->starttime;
+       disksim->lastouttime = simtime - tmp->iob_un.time;
        stat_update(&queue->outtimestats, (simtime - tmp->iob_un.time));
        // printf("Updated outtimestats with %f - simtime = %f\n", simtime - tmp->iob_un.time, simtime);
        if (tmp->flags & READ) {
@@ -3008,6 +3028,7 @@ fprintf (outputfile, "Entering remove_completed_request - %d\n", queue->listlen)
       while (trv) {
          stat_update(&queue->accstats, (simtime - tmp->starttime));
          disksim->lastphystime = simtime - tmp->starttime;
+         disksim->lastouttime = simtime - trv->time;
          stat_update(&queue->outtimestats, (simtime - trv->time));
 	 // printf("Updated outtimestats with %f - simtime = %f\n", simtime - tmp->iob_un.time, simtime);
          if (trv->flags & READ) {
@@ -3216,7 +3237,7 @@ fprintf (outputfile, "Entering ioqueue_add_new_request: %d\n", new->blkno);
    if (tmp->batchno == -1) {
      tmp->batch_complete = TRUE;
    } else {
-     tmp->batch_complete = new->batch_complete;
+     tmp->batch_complete = (new->flags & BATCH_COMPLETE) ? TRUE : FALSE;
    }
    switch(queue->pri_scheme) {
       case ALLEQUAL:
@@ -4179,6 +4200,9 @@ void ioqueue_printstats (ioqueue **set, int setsize, char *sourcestr)
    fprintf(outputfile, "%sTotal Requests handled:\t%d\n", sourcestr, numcomplete);
    fprintf(outputfile, "%sRequests per second:   \t%f\n", sourcestr, ((double)1000 * (double)numcomplete / (simtime - warmuptime)));
    fprintf(outputfile, "%sCompletely idle time:  \t%f   \t%f\n", sourcestr, idletime, (idletime / (simtime - warmuptime)));
+   stat_json_value(sourcestr, "Total Requests handled", numcomplete);
+   stat_json_value(sourcestr, "Requests per second", ((double)1000 * (double)numcomplete / (simtime - warmuptime)));
+   stat_json_value(sourcestr, "Completely idle time", idletime);
 
    stat_print_set(statset, (3*setsize), sourcestr);
 
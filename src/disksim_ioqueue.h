@@ -131,8 +131,8 @@ int		ioqueue_get_number_in_queue (struct ioq *queue);
 int		ioqueue_get_number_of_requests (struct ioq *queue);
 int		ioqueue_get_number_of_requests_initiated (struct ioq *queue);
 int		ioqueue_get_reqoutstanding (struct ioq *queue);
-int		ioqueue_get_dist (struct ioq *queue, int blkno);
-void		ioqueue_set_concatok_function (struct ioq *queue, int (**concatok)(void *,int,int,int,int), void *concatokparam);
+disksim_lbn_t	ioqueue_get_dist (struct ioq *queue, disksim_lbn_t blkno);
+void		ioqueue_set_concatok_function (struct ioq *queue, int (**concatok)(void *,disksim_lbn_t,int,disksim_lbn_t,int), void *concatokparam);
 void		ioqueue_set_idlework_function (struct ioq *queue, void (**idlework)(void *,int), void *idleworkparam, double idledelay);
 void		ioqueue_set_enablement_function (struct ioq *queue, int (**enablement)(ioreq_event *));
 void		ioqueue_reset_idledetecter (struct ioq *queue, int timechange);
@@ -180,7 +180,7 @@ typedef struct iob {
    struct iob *prev;
    int       totalsize;
    int       devno;
-   int       blkno;
+   disksim_lbn_t blkno;
    int       flags;
    int       batchno;
    int       batch_size;
@@ -214,7 +214,7 @@ typedef struct subq {
    int		dir;
    double	vscan_value;
    int		vscan_cyls;
-   u_int	lastblkno;
+   disksim_lbn_t lastblkno;
    int		lastsurface;
    int		lastcylno;
    int		optcylno;
@@ -263,7 +263,7 @@ typedef struct ioq {
    timer_event *idledetect;
    int		(**coalesceok)(void *,int,int,int,int);
    void *	coalesceokparam;
-   int		(**concatok)(void *,int,int,int,int);
+   int		(**concatok)(void *,disksim_lbn_t,int,disksim_lbn_t,int);
    void *	concatokparam;
    int		concatmax;
    int		comboverlaps;
@@ -303,7 +303,7 @@ typedef struct ioq {
    int		maxwritelen;
    int		overlapscombed;
    int		readoverlapscombed;
-   int		seqblkno;
+   disksim_lbn_t seqblkno;
    int		seqflags;
    int		seqreads;
    int		seqwrites;
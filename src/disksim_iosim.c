@@ -100,6 +100,7 @@
 
 
 #include "disksim_iosim.h"
+#include "disksim_profile.h"
 
 #include "modules/modules.h"
 
@@ -124,6 +125,7 @@ ioreq_event * ioreq_copy (ioreq_event *old)
    ioreq_event *new = (ioreq_event *) getfromextraq();
    memmove ((char *)new, (char *)old, sizeof(ioreq_event));
    /* bcopy ((char *)old, (char *)new, sizeof (ioreq_event)); */
+   new->intqpos = 0;
    return(new);
 }
 
@@ -188,7 +190,7 @@ double io_tick()
 }
 
 
-double io_raise_priority (int opid, int devno, int blkno, void *chan)
+double io_raise_priority (int opid, int devno, disksim_lbn_t blkno, void *chan)
 {
    return (iodriver_raise_priority(0, opid, devno, blkno, chan));
 }
@@ -558,11 +560,11 @@ void io_map_trace_request (ioreq_event *temp)
 	       temp->blkno *= -tracemap2[i];
 	    } else {
 	       if (temp->blkno % tracemap2[i]) {
-	          fprintf(stderr, "Small sector size disk using odd sector number: %d\n", temp->blkno);
+	          fprintf(stderr, "Small sector size disk using odd sector number: %lld\n", temp->blkno);
 	          exit(1);
 	       }
 /*
-	       fprintf (outputfile, "mapping block number %d to %d\n", temp->blkno, (temp->blkno / tracemap2[i]));
+	       fprintf (outputfile, "mapping block number %lld to %lld\n", temp->blkno, (temp->blkno / tracemap2[i]));
 */
 	       temp->blkno /= tracemap2[i];
 	    }
@@ -591,6 +593,7 @@ void io_map_trace_request (ioreq_event *temp)
 event * io_get_next_external_event (FILE *iotracefile)
 {
    ioreq_event *temp;
+   double profstart = 0.0;
 
    ASSERT(io_extq == NULL);
 
@@ -605,7 +608,13 @@ event * io_get_next_external_event (FILE *iotracefile)
                 break;
    }
 
+   if (disksim->profile) {
+      profstart = profile_trace_start(disksim->profile);
+   }
    temp = iotrace_get_ioreq_event(iotracefile, disksim->traceformat, temp);
+   if (disksim->profile) {
+      profile_trace_done(disksim->profile, profstart);
+   }
    if (temp) {
       switch (disksim->traceformat) {
          case VALIDATE: io_validate_do_stats2 (temp);
@@ -617,10 +626,10 @@ event * io_get_next_external_event (FILE *iotracefile)
 	 last_request_arrive = temp->time;
       }
       temp->time = (temp->time * ioscale) + tracebasetime;
-      if ((temp->time < simtime) && (!disksim->closedios)) {
+      if ((temp->time < simtime) && (!disksim->closedios) && (!iostreamdepth)) {
          fprintf(stderr, "Trace event appears out of time order in trace - simtime %f, time %f\n", simtime, temp->time);
 	 fprintf(stderr, "ioscale %f, tracebasetime %f\n", ioscale, tracebasetime);
-	 fprintf(stderr, "devno %d, blkno %d, bcount %d, flags %d\n", temp->devno, temp->blkno, temp->bcount, temp->flags);
+	 fprintf(stderr, "devno %d, blkno %lld, bcount %d, flags %d\n", temp->devno, temp->blkno, temp->bcount, temp->flags);
          exit(1);
       }
       if (tracemappings) {
@@ -647,6 +656,170 @@ int io_using_external_event (event *curr)
 }
 
 
+/* Per-stream closed-loop replay (see ``Closed-loop stream depth'').    */
+/* Every device in the trace is a stream with up to iostreamdepth      */
+/* requests outstanding.  Requests are read in trace order and wait in */
+/* their stream, with their time replaced by their think time, until   */
+/* a slot is free; the next one then arrives its think time after the  */
+/* stream's last issue or completion, whichever is later.  A stream's  */
+/* first request arrives at its offset into the trace.  Reading stops  */
+/* as soon as every stream with a free slot has a request, or once a   */
+/* stream has IO_STREAM_READAHEAD requests waiting.  A stream that has */
+/* finished, or is idle for a long stretch of the trace, then keeps    */
+/* its free slot until the others catch up instead of having the rest  */
+/* of the trace read in behind it.                                     */
+
+typedef struct io_stream {
+   int          used;
+   int          outstanding;
+   int          queued;
+   double       lasttrace;	/* trace time of the last request read */
+   double       last;		/* last issue or completion */
+   ioreq_event *head;		/* read but not yet issued */
+   ioreq_event *tail;
+} io_stream;
+
+
+static io_stream * io_stream_get (int devno)
+{
+   if (devno >= iostreamcnt) {
+      int newcnt = max((devno + 1), (2 * iostreamcnt));
+
+      iostreams = realloc(iostreams, (newcnt * sizeof(io_stream)));
+      ASSERT(iostreams != NULL);
+      bzero((char *) &iostreams[iostreamcnt], ((newcnt - iostreamcnt) * sizeof(io_stream)));
+      iostreamcnt = newcnt;
+   }
+   return(&iostreams[devno]);
+}
+
+
+/* Reads the next trace request into its stream. */
+
+static void io_stream_read (void)
+{
+   ioreq_event *curr = (ioreq_event *) io_get_next_external_event(disksim->iotracefile);
+   io_stream *s;
+   double think;
+
+   if (curr == NULL) {
+      iostreameof = TRUE;
+      return;
+   }
+   io_using_external_event((event *) curr);
+   if (!iostreamcnt) {
+      iostreambase = curr->time;
+   }
+   s = io_stream_get(curr->devno);
+   if (!s->used) {
+      s->used = TRUE;
+      s->lasttrace = iostreambase;
+   }
+   think = curr->time - s->lasttrace - iostreamsvc;
+   s->lasttrace = curr->time;
+   curr->time = max(think, 0.0);
+   curr->next = NULL;
+   if (s->tail) {
+      s->tail->next = curr;
+   } else {
+      s->head = curr;
+   }
+   s->tail = curr;
+   s->queued++;
+   if (s->queued == IO_STREAM_READAHEAD) {
+      iostreamsfull++;
+   }
+   iostreamqueued++;
+   iostreamqmax = max(iostreamqmax, iostreamqueued);
+}
+
+
+/* Issues requests from every stream with a free slot, reading the */
+/* trace as far as needed and allowed.                              */
+
+static void io_stream_fill (void)
+{
+   io_stream *s;
+   ioreq_event *curr;
+   int again = TRUE;
+   int i;
+
+   while (again) {
+      again = FALSE;
+      for (i=0; i<iostreamcnt; i++) {
+         s = &iostreams[i];
+         while ((s->used) && (s->outstanding < iostreamdepth)) {
+            if (s->head == NULL) {
+               if ((iostreameof) || (iostreamsfull)) {
+                  break;
+               }
+               /* may start new streams, which the next pass picks up */
+               io_stream_read();
+               again = TRUE;
+               s = &iostreams[i];
+               continue;
+            }
+            curr = s->head;
+            s->head = curr->next;
+            if (s->head == NULL) {
+               s->tail = NULL;
+            }
+            curr->next = NULL;
+            if (s->queued == IO_STREAM_READAHEAD) {
+               iostreamsfull--;
+            }
+            s->queued--;
+            iostreamqueued--;
+            curr->time += max(s->last, simtime);
+            s->last = curr->time;
+            s->outstanding++;
+            iostreamsout++;
+            addtointq((event *) curr);
+         }
+      }
+   }
+}
+
+
+/* Starts closed-loop stream replay; FALSE if it is not configured. */
+
+int io_stream_prime (void)
+{
+   if (!iostreamdepth) {
+      return(FALSE);
+   }
+   if ((disksim->closedios) || (disksim->traceformat == VALIDATE)) {
+      fprintf(stderr, "Closed-loop stream replay cannot be combined with a negative I/O trace time scale or validate traces\n");
+      exit(1);
+   }
+   io_stream_read();
+   io_stream_fill();
+   return(TRUE);
+}
+
+
+/* Frees curr's slot in its stream; the simulation stops once the */
+/* trace is done and nothing is outstanding.                       */
+
+void io_stream_done (ioreq_event *curr)
+{
+   io_stream *s;
+
+   if (!iostreamdepth) {
+      return;
+   }
+   s = io_stream_get(curr->devno);
+   ASSERT(s->outstanding > 0);
+   s->outstanding--;
+   iostreamsout--;
+   s->last = max(s->last, simtime);
+   io_stream_fill();
+   if (iostreamsout == 0) {
+      disksim_simstop();
+   }
+}
+
+
 void io_printstats()
 {
    int i;
@@ -658,6 +831,11 @@ void io_printstats()
 
    iotrace_printstats (outputfile);
 
+   if (iostreamdepth) {
+      fprintf (outputfile, "\n");
+      fprintf (outputfile, "Closed-loop requests read ahead max:\t%d\n", iostreamqmax);
+   }
+
    if ((tracestats) && (PRINTTRACESTATS)) {
       /* info relevant to HPL traces */
       for (i=0; i<tracemappings; i++) {
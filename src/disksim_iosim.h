@@ -113,6 +113,7 @@
 #define MAXOUTBUSES	4
 #define MAXSLOTS	15
 #define MAXLOGORGS	100
+#define IO_STREAM_READAHEAD	1024	/* requests read ahead per stream */
 
 
 #include "disksim_device.h"
@@ -242,6 +243,16 @@ int ioreq_compare (ioreq_event *first, ioreq_event *second);
 void iosim_get_path_to_controller (int iodriverno, int ctlno, intchar *buspath, intchar *slotpath);
 void iosim_get_path_to_device (int iodriverno, int devno, intchar *buspath, intchar *slotpath);
 
+/* Loaders the generated module code calls for the queue and disk */
+/* model blocks nested in device, controller and driver specs.    */
+/* Without these prototypes their pointer results would be cut to */
+/* int on 64-bit hosts.                                           */
+
+struct lp_block;
+struct dm_disk_if;
+struct ioq * disksim_ioqueue_loadparams (struct lp_block *b, int printqueuestats, int printcritstats, int printidlestats, int printintarrstats, int printsizestats);
+struct dm_disk_if * dm_disk_loadparams (struct lp_block *b, int *num);
+
 
 
 #include "disksim_global.h"
@@ -290,6 +301,16 @@ typedef struct iosim_info {
    statgen *tracestats3;
    statgen *tracestats4;
    statgen *tracestats5;
+   int     iostreamdepth;	/* per-stream closed-loop replay, if > 0 */
+   double  iostreamsvc;
+   struct io_stream *iostreams;	/* indexed by devno */
+   int     iostreamcnt;
+   int     iostreamsout;	/* stream requests issued but not completed */
+   int     iostreameof;
+   double  iostreambase;	/* trace time of the first request */
+   int     iostreamsfull;	/* streams with IO_STREAM_READAHEAD read */
+   int     iostreamqueued;	/* read but not yet issued */
+   int     iostreamqmax;
 } iosim_info_t;
 
 
@@ -313,6 +334,16 @@ typedef struct iosim_info {
 #define tracestats3              (disksim->iosim_info->tracestats3)
 #define tracestats4              (disksim->iosim_info->tracestats4)
 #define tracestats5              (disksim->iosim_info->tracestats5)
+#define iostreamdepth            (disksim->iosim_info->iostreamdepth)
+#define iostreamsvc              (disksim->iosim_info->iostreamsvc)
+#define iostreams                (disksim->iosim_info->iostreams)
+#define iostreamcnt              (disksim->iosim_info->iostreamcnt)
+#define iostreamsout             (disksim->iosim_info->iostreamsout)
+#define iostreameof              (disksim->iosim_info->iostreameof)
+#define iostreambase             (disksim->iosim_info->iostreambase)
+#define iostreamsfull            (disksim->iosim_info->iostreamsfull)
+#define iostreamqueued           (disksim->iosim_info->iostreamqueued)
+#define iostreamqmax             (disksim->iosim_info->iostreamqmax)
 
 
 #endif   /* DISKSIM_IOSIM_H */
@@ -103,11 +103,20 @@
 #include "disksim_global.h"
 #include "disksim_hptrace.h"
 #include "disksim_iotrace.h"
+#include "disksim_tracefile.h"
 
+#include <ctype.h>
 
-static void iotrace_initialize_iotrace_info ()
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static void iotrace_reset_iotrace_info ()
 {
-   disksim->iotrace_info = DISKSIM_malloc (sizeof(iotrace_info_t));
    bzero ((char *)disksim->iotrace_info, sizeof(iotrace_info_t));
 
    tracebasetime = 0.0;
@@ -123,6 +132,13 @@ static void iotrace_initialize_iotrace_info ()
 }
 
 
+static void iotrace_initialize_iotrace_info ()
+{
+   disksim->iotrace_info = DISKSIM_malloc (sizeof(iotrace_info_t));
+   iotrace_reset_iotrace_info ();
+}
+
+
 void iotrace_set_format (char *formatname)
 {
 	/**
@@ -192,11 +208,41 @@ void iotrace_set_format (char *formatname)
         /* ascii traces with added batch information */
       disksim->traceformat = BATCH;
    } 
+   else if (strcmp(formatname, "columnar") == 0) 
+   {
+        /* binary traces written by the `trace2col' program */
+      disksim->traceformat = COLUMNAR;
+   } 
+   else if (strcmp(formatname, "blktrace") == 0) 
+   {
+        /* binary Linux block traces, as dumped by `blkparse -d' */
+      disksim->traceformat = BLKTRACE;
+   } 
+   else if (strcmp(formatname, "msr") == 0) 
+   {
+        /* CSV traces in the MSR-Cambridge layout published by SNIA */
+      disksim->traceformat = MSRCSV;
+   } 
+   else if (strcmp(formatname, "spc") == 0) 
+   {
+        /* SPC-1 traces, e.g. the UMass Financial and WebSearch traces */
+      disksim->traceformat = SPC;
+   } 
+   else if (strcmp(formatname, "merge") == 0) 
+   {
+        /* a list of traces to be merged by time as they are read */
+      disksim->traceformat = MERGE;
+   } 
    else 
    {
       fprintf(stderr, "Unknown trace format - %s\n", formatname);
       exit(1);
    }
+
+   if (((disksim->traceformat == BLKTRACE) || (disksim->traceformat == MSRCSV)) && (devmap == NULL)) {
+      devmap = DISKSIM_malloc (sizeof(iotrace_devmap));
+      bzero ((char *)devmap, sizeof(iotrace_devmap));
+   }
 }
 
 
@@ -259,18 +305,24 @@ static int iotrace_read_int32 (FILE *tracefile, int32_t *intP)
 #define iotrace_read_float(a, b) iotrace_read_int32(a, b)
 
 
-ioreq_event * iotrace_validate_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+/* The readers below fill in new from the next request in the trace and */
+/* return it, or return NULL at the end of the trace.  They may be run   */
+/* ahead of the simulation by the prefetch thread (see further below),   */
+/* so apart from VALIDATE and headerless HPL traces (never prefetched)   */
+/* they must not depend on simulation state, allocate, or touch anything */
+/* but iotrace_info.                                                     */
+
+static ioreq_event * iotrace_validate_read_ioreq_event (FILE *tracefile, ioreq_event *new)
 {
    char line[201];
    char rw;
    double servtime;
 
    if (fgets(line, 200, tracefile) == NULL) {
-      addtoextraq((event *) new);
       return(NULL);
    }
    new->time = simtime + (validate_nextinter / (double) 1000);
-   if (sscanf(line, "%c %s %d %d %lf %lf\n", 
+   if (sscanf(line, "%c %s %lld %d %lf %lf\n", 
 	      &rw, 
 	      validate_buffaction, 
 	      &new->blkno, 
@@ -304,6 +356,16 @@ ioreq_event * iotrace_validate_get_ioreq_event (FILE *tracefile, ioreq_event *ne
 }
 
 
+ioreq_event * iotrace_validate_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+{
+   if (iotrace_validate_read_ioreq_event(tracefile, new) == NULL) {
+      addtoextraq((event *) new);
+      return(NULL);
+   }
+   return(new);
+}
+
+
 static ioreq_event * iotrace_dec_get_ioreq_event (FILE *tracefile, ioreq_event *new)
 {
    assert ("removed for distribution" == 0);
@@ -320,21 +382,34 @@ static void iotrace_hpl_srt_convert_flags (ioreq_event *curr)
    curr->flags = 0;
    if (flags & HPL_READ) {
       curr->flags |= READ;
+   }
+   if (!(flags & HPL_ASYNC)) {
+      curr->flags |= TIME_CRITICAL;
+   }
+   if ((flags & HPL_ASYNC) && (curr->flags & READ)) {
+      curr->flags |= TIME_LIMITED;
+   }
+}
+
+
+/* Counts a request by its converted flags, which is all it takes, so */
+/* prefetched requests can be counted when the simulation takes them. */
+
+static void iotrace_hpl_count (ioreq_event *curr)
+{
+   if (curr->flags & READ) {
       hpreads++;
    } else {
       hpwrites++;
    }
-   if (!(flags & HPL_ASYNC)) {
-      curr->flags |= TIME_CRITICAL;
+   if (curr->flags & TIME_CRITICAL) {
       if (curr->flags & READ) {
          syncreads++;
       } else {
          syncwrites++;
       }
-   }
-   if (flags & HPL_ASYNC) {
+   } else {
       if (curr->flags & READ) {
-         curr->flags |= TIME_LIMITED;
          asyncreads++;
       } else {
          asyncwrites++;
@@ -359,7 +434,6 @@ static ioreq_event * iotrace_hpl_get_ioreq_event (FILE *tracefile, ioreq_event *
       failure |= iotrace_read_int32(tracefile, &sec);
       failure |= iotrace_read_int32(tracefile, &usec);
       if (failure) {
-         addtoextraq((event *) new);
          return(NULL);
       }
       if (((id >> 16) < 1) || ((id >> 16) > 4)) {
@@ -402,6 +476,7 @@ static ioreq_event * iotrace_hpl_get_ioreq_event (FILE *tracefile, ioreq_event *
       failure |= iotrace_read_int32(tracefile, &val);
       new->flags = val;
       iotrace_hpl_srt_convert_flags(new);
+      iotrace_hpl_count(new);
       failure |= iotrace_read_int32(tracefile, &junkint);           /* info */
       size -= 13 * sizeof(int32_t);
       if ((id >> 16) == 4) {
@@ -414,7 +489,6 @@ static ioreq_event * iotrace_hpl_get_ioreq_event (FILE *tracefile, ioreq_event *
          size -= sizeof(int32_t);
       }
       if (failure) {
-         addtoextraq((event *) new);
          return(NULL);
       }
       if (size) {
@@ -533,7 +607,6 @@ static ioreq_event * iotrace_raw_get_ioreq_event (FILE *tracefile, ioreq_event *
    new->tempint1 = (int)((schedtime - new->time) * (double) 1000);
    new->tempint2 = (int)((donetime - schedtime) * (double) 1000);
    if (failure) {
-      addtoextraq((event *) new);
       new = NULL;
    }
    return(new);
@@ -547,10 +620,9 @@ static ioreq_event * iotrace_emcsymm_get_ioreq_event (FILE *tracefile, ioreq_eve
    unsigned int director;
 
    if (fgets(line, 200, tracefile) == NULL) {
-      addtoextraq((event *) new);
       return(NULL);
    }
-   if (sscanf(line, "%lf %s %x %x %d %d\n", &new->time, operation, &director, &new->devno, &new->blkno, &new->bcount) != 6) {
+   if (sscanf(line, "%lf %s %x %x %lld %d\n", &new->time, operation, &director, &new->devno, &new->blkno, &new->bcount) != 6) {
       fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
       fprintf(stderr, "line: %s", line);
       ddbg_assert(0);
@@ -580,11 +652,10 @@ static ioreq_event * iotrace_emcbackend_get_ioreq_event (FILE *tracefile, ioreq_
    unsigned int disk, hyper;
 
    if (fgets(line, 200, tracefile) == NULL) {
-      addtoextraq((event *) new);
       return(NULL);
    }
 
-   if (sscanf(line, "%lf %s %x %x %d %d %s %d %d\n", 
+   if (sscanf(line, "%lf %s %x %x %lld %d %s %d %d\n", 
               &new->time, operation, &director, &hyper, &new->blkno, &new->bcount, bus, &disk, &new->devno) != 9) {
       fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
       fprintf(stderr, "line: %s", line);
@@ -615,10 +686,9 @@ static ioreq_event * iotrace_ascii_get_ioreq_event (FILE *tracefile, ioreq_event
    char line[201];
 
    if (fgets(line, 200, tracefile) == NULL) {
-      addtoextraq((event *) new);
       return(NULL);
    }
-   if (sscanf(line, "%lf %d %d %d %x\n", &new->time, &new->devno, &new->blkno, &new->bcount, &new->flags) != 5) {
+   if (sscanf(line, "%lf %d %lld %d %x\n", &new->time, &new->devno, &new->blkno, &new->bcount, &new->flags) != 5) {
       fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
       fprintf(stderr, "line: %s", line);
       ddbg_assert(0);
@@ -641,10 +711,9 @@ static ioreq_event * iotrace_batch_get_ioreq_event (FILE *tracefile, ioreq_event
    char line[201];
 
    if (fgets(line, 200, tracefile) == NULL) {
-      addtoextraq((event *) new);
       return(NULL);
    }
-   if (sscanf(line, "%lf %d %d %d %x %d\n", &new->time, &new->devno, &new->blkno, &new->bcount, &new->flags, &new->batchno) != 6) {
+   if (sscanf(line, "%lf %d %lld %d %x %d\n", &new->time, &new->devno, &new->blkno, &new->bcount, &new->flags, &new->batchno) != 6) {
       fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
       fprintf(stderr, "line: %s", line);
       ddbg_assert(0);
@@ -654,11 +723,6 @@ static ioreq_event * iotrace_batch_get_ioreq_event (FILE *tracefile, ioreq_event
    } else if (new->flags & SYNCHRONOUS) {
       new->flags |= TIME_CRITICAL;
    }
-   if (new->flags & BATCH_COMPLETE) {
-     new->batch_complete = 1;
-   } else {
-     new->batch_complete = 0;
-   }
 
    new->buf = 0;
    new->opid = 0;
@@ -668,137 +732,1541 @@ static ioreq_event * iotrace_batch_get_ioreq_event (FILE *tracefile, ioreq_event
 }
 
 
-ioreq_event * iotrace_get_ioreq_event (FILE *tracefile, int traceformat, ioreq_event *temp)
+/* Columnar format.  A 32-byte file header (magic, version, records per   */
+/* full block, total records) is followed by blocks of up to             */
+/* IOTRACE_COL_BLOCKRECS requests.  Each block has a 16-byte header       */
+/* (record count, then the time of its first request in ns) followed by  */
+/* one fixed-width column per field: blkno (int64), the time since the   */
+/* previous request in ns (uint32), then bcount, devno, flags and        */
+/* batchno (int32).  Columns start 8-byte aligned and all values are     */
+/* little-endian.  Times already include the trace base time, and flags  */
+/* are DiskSim's own, as left by the reader of the original format.      */
+/*                                                                        */
+/* The reader maps the whole file (or, when that is not possible, e.g.   */
+/* for stdin, reads it in once) and takes each request straight from the */
+/* columns, so there is no per-request parsing or copying.               */
+
+#define IOTRACE_COL_MAGIC	"DSIMCOL1"
+#define IOTRACE_COL_VERSION	1
+#define IOTRACE_COL_HDRLEN	32
+#define IOTRACE_COL_BLKHDRLEN	16
+#define IOTRACE_COL_BLOCKRECS	4096
+
+/* 8 bytes per record for blkno plus 4 for each of the other five columns */
+#define IOTRACE_COL_BLOCKLEN(cnt) \
+   ((IOTRACE_COL_BLKHDRLEN + (28 * (size_t) (cnt)) + 7) & ~((size_t) 7))
+
+struct iotrace_colwriter {
+   FILE     *outfile;
+   int       cnt;
+   u_int64_t total;
+   disksim_tick_t basetime;
+   disksim_tick_t prevtime;
+   int64_t   blkno[IOTRACE_COL_BLOCKRECS];
+   u_int32_t delta[IOTRACE_COL_BLOCKRECS];
+   u_int32_t bcount[IOTRACE_COL_BLOCKRECS];
+   u_int32_t devno[IOTRACE_COL_BLOCKRECS];
+   u_int32_t flags[IOTRACE_COL_BLOCKRECS];
+   u_int32_t batchno[IOTRACE_COL_BLOCKRECS];
+};
+
+
+static void iotrace_col_swap (void *ptr, int len)
 {
-   switch (traceformat) {
-      
-   case ASCII:
-      temp = iotrace_ascii_get_ioreq_event(tracefile, temp);
-      break;
-      
-   case RAW:
-      temp = iotrace_raw_get_ioreq_event(tracefile, temp);
-      break;
-      
-   case HPL:
-      temp = iotrace_hpl_get_ioreq_event(tracefile, temp);
-      break;
+   char *bytes = ptr;
+   char tmp;
+   int i;
 
-   case DEC:
-      temp = iotrace_dec_get_ioreq_event(tracefile, temp);
-      break;
+   if (disksim->endian != _BIG_ENDIAN) {
+      return;
+   }
+   for (i=0; i<(len/2); i++) {
+      tmp = bytes[i];
+      bytes[i] = bytes[(len - i - 1)];
+      bytes[(len - i - 1)] = tmp;
+   }
+}
 
-   case VALIDATE:
-      temp = iotrace_validate_get_ioreq_event(tracefile, temp);
-      break;
 
-   case EMCSYMM:
-      temp = iotrace_emcsymm_get_ioreq_event(tracefile, temp);
-      break;
+static INLINE u_int32_t iotrace_col_get32 (char *ptr)
+{
+   u_int32_t val;
 
-   case EMCBACKEND:
-      temp = iotrace_emcbackend_get_ioreq_event(tracefile, temp);
-      break;
+   memcpy(&val, ptr, sizeof(val));
+   iotrace_col_swap(&val, sizeof(val));
+   return(val);
+}
 
-   case BATCH:
-      temp = iotrace_batch_get_ioreq_event(tracefile, temp);
-      break;
 
-   default:
-      fprintf(stderr, "Unknown traceformat in iotrace_get_ioreq_event - %d\n", traceformat);
-      exit(1);
-   }
+static INLINE int64_t iotrace_col_get64 (char *ptr)
+{
+   int64_t val;
 
-   return ((ioreq_event *)temp);
+   memcpy(&val, ptr, sizeof(val));
+   iotrace_col_swap(&val, sizeof(val));
+   return(val);
 }
 
 
-static void iotrace_hpl_srt_tracefile_start (char *tracedate)
+static void iotrace_columnar_attach (FILE *tracefile)
 {
-   char crap[40];
-   char monthstr[40];
-   int day;
-   int hour;
-   int minute;
-   int second;
-   int year;
+   size_t len = 0;
+   size_t size = 0;
+   size_t got;
+   char *buf = NULL;
+#ifndef _WIN32
+   struct stat st;
+   int fd = fileno(tracefile);
+
+   if ((fd >= 0) && (fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+      buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (buf != MAP_FAILED) {
+         madvise(buf, st.st_size, MADV_SEQUENTIAL);
+         colbase = buf;
+         collen = st.st_size;
+         colmapped = TRUE;
+         return;
+      }
+      buf = NULL;
+   }
+#endif
+   rewind(tracefile);
+   do {
+      if (len == size) {
+         size = (size) ? (2 * size) : (1 << 20);
+         buf = realloc(buf, size);
+         if (buf == NULL) {
+            fprintf(stderr, "Out of memory reading columnar trace\n");
+            exit(1);
+         }
+      }
+      got = fread((buf + len), 1, (size - len), tracefile);
+      len += got;
+   } while (got > 0);
+   colbase = buf;
+   collen = len;
+   colmapped = FALSE;
+}
 
-   if (sscanf(tracedate, "%s\t= \"%s %s %d %d:%d:%d %d\";\n", crap, crap, monthstr, &day, &hour, &minute, &second, &year) != 8) {
-      fprintf(stderr, "Format problem with 'tracedate' line in HPL trace - %s\n", tracedate);
+
+static void iotrace_columnar_initialize_file (FILE *tracefile)
+{
+   iotrace_columnar_attach(tracefile);
+   if ((collen < IOTRACE_COL_HDRLEN) || (memcmp(colbase, IOTRACE_COL_MAGIC, 8) != 0)) {
+      fprintf(stderr, "Tracefile is not in columnar format\n");
       exit(1);
    }
-   if (baseyear == 0) {
-      baseyear = year;
+   if (iotrace_col_get32(colbase + 8) != IOTRACE_COL_VERSION) {
+      fprintf(stderr, "Unsupported columnar trace version - %d\n", iotrace_col_get32(colbase + 8));
+      exit(1);
    }
-   day = day + iotrace_month_convert(monthstr, year);
-   if (year != baseyear) {
-      day += (baseyear % 4) ? 365 : 366;
+   colblock = IOTRACE_COL_HDRLEN;
+   colidx = 0;
+}
+
+
+static void iotrace_merge_detach (int release);
+
+/* Drops the columnar trace image.  After a checkpoint restore a     */
+/* mapping is gone and must only be forgotten (a copy read in lives  */
+/* on in the restored heap); the next read maps the file again and   */
+/* carries on from the saved block and index.  Releasing also closes */
+/* the member traces of a merged trace.                              */
+
+void iotrace_detach_file (int release)
+{
+   if ((disksim->iotrace_info != NULL) && (disksim->iotrace_info->merge != NULL)) {
+      iotrace_merge_detach(release);
    }
-   if (baseday == 0) {
-      baseday = day;
+   if ((disksim->iotrace_info == NULL) || (colbase == NULL)) {
+      return;
    }
-   second = second + (60 * minute) + (3600 * hour) + (86400 * (day - baseday));
-   if (basesecond == 0) {
-      basesecond = second;
+   if (colmapped) {
+#ifndef _WIN32
+      if (release) {
+         munmap(colbase, collen);
+      }
+#endif
+   } else if (release) {
+      free(colbase);
+   } else {
+      return;
    }
-   second -= basesecond;
-   tracebasetime += (double) 1000 * (double) second;
+   colbase = NULL;
 }
 
 
-static void iotrace_hpl_initialize_file (FILE *tracefile, int print_tracefile_header)
+static ioreq_event * iotrace_columnar_get_ioreq_event (FILE *tracefile, ioreq_event *new)
 {
-   char letter = '0';
-   char line[201];
-   char linetype[40];
+   char *blk;
+   char *col;
+   int cnt;
 
-   if (disksim->traceheader == FALSE) {
-      return;
+   if (colbase == NULL) {
+      iotrace_columnar_attach(tracefile);
    }
-   while (1) {
-      if (fgets(line, 200, tracefile) == NULL) {
-         fprintf(stderr, "No 'tracedate' line in HPL trace\n");
+   while (TRUE) {
+      if ((colblock + IOTRACE_COL_BLKHDRLEN) > collen) {
+         return(NULL);
+      }
+      blk = colbase + colblock;
+      cnt = iotrace_col_get32(blk);
+      if ((cnt <= 0) || (cnt > IOTRACE_COL_BLOCKRECS) || ((colblock + IOTRACE_COL_BLOCKLEN(cnt)) > collen)) {
+         fprintf(stderr, "Corrupt or truncated columnar trace block at offset %lu\n", (unsigned long) colblock);
          exit(1);
       }
-      sscanf(line, "%s", linetype);
-      if (strcmp(linetype, "tracedate") == 0) {
+      if (colidx < cnt) {
          break;
       }
+      colblock += IOTRACE_COL_BLOCKLEN(cnt);
+      colidx = 0;
    }
-   iotrace_hpl_srt_tracefile_start(line);
-   while (letter != 0x0C) {
-      if (fscanf(tracefile, "%c", &letter) != 1) {
-         fprintf(stderr, "End of header information never found - end of file\n");
-         exit(1);
-      }
-      if ((print_tracefile_header) && (letter != 0x0C)) {
-         printf("%c", letter);
-      }
+
+   col = blk + IOTRACE_COL_BLKHDRLEN;
+   new->blkno = iotrace_col_get64(col + (8 * colidx));
+   col += 8 * cnt;
+   if (colidx == 0) {
+      coltime = iotrace_col_get64(blk + 8);
+   } else {
+      coltime += iotrace_col_get32(col + (4 * colidx));
    }
+   new->time = disksim_ticks_to_msec(coltime);
+   col += 4 * cnt;
+   new->bcount = iotrace_col_get32(col + (4 * colidx));
+   col += 4 * cnt;
+   new->devno = iotrace_col_get32(col + (4 * colidx));
+   col += 4 * cnt;
+   new->flags = iotrace_col_get32(col + (4 * colidx));
+   col += 4 * cnt;
+   new->batchno = iotrace_col_get32(col + (4 * colidx));
+   colidx++;
+
+   new->buf = 0;
+   new->opid = 0;
+   new->busno = 0;
+   new->cause = 0;
+   return(new);
 }
 
 
-void iotrace_initialize_file (FILE *tracefile, int traceformat, int print_tracefile_header)
+static void iotrace_col_write (iotrace_colwriter *w, void *ptr, int size, int cnt)
 {
-   if (traceformat == HPL) {
-      iotrace_hpl_initialize_file(tracefile, print_tracefile_header);
+   char *bytes = ptr;
+   char val[8];
+   int i;
+
+   for (i=0; i<cnt; i++) {
+      memcpy(val, (bytes + (i * size)), size);
+      iotrace_col_swap(val, size);
+      fwrite(val, size, 1, w->outfile);
    }
 }
 
 
-void iotrace_printstats (FILE *outfile)
+static void iotrace_col_write_header (iotrace_colwriter *w)
 {
-   if (disksim->iotrace_info == NULL) {
+   u_int32_t val = IOTRACE_COL_VERSION;
+   u_int32_t blockrecs = IOTRACE_COL_BLOCKRECS;
+   u_int64_t reserved = 0;
+
+   fwrite(IOTRACE_COL_MAGIC, 8, 1, w->outfile);
+   iotrace_col_write(w, &val, sizeof(val), 1);
+   iotrace_col_write(w, &blockrecs, sizeof(blockrecs), 1);
+   iotrace_col_write(w, &w->total, sizeof(w->total), 1);
+   iotrace_col_write(w, &reserved, sizeof(reserved), 1);
+}
+
+
+static void iotrace_col_flush (iotrace_colwriter *w)
+{
+   u_int32_t cnt = w->cnt;
+   u_int32_t reserved = 0;
+   size_t pad;
+
+   if (w->cnt == 0) {
       return;
    }
-   if (hpreads | hpwrites) {
+   iotrace_col_write(w, &cnt, sizeof(cnt), 1);
+   iotrace_col_write(w, &reserved, sizeof(reserved), 1);
+   iotrace_col_write(w, &w->basetime, sizeof(w->basetime), 1);
+   iotrace_col_write(w, w->blkno, sizeof(int64_t), w->cnt);
+   iotrace_col_write(w, w->delta, sizeof(u_int32_t), w->cnt);
+   iotrace_col_write(w, w->bcount, sizeof(u_int32_t), w->cnt);
+   iotrace_col_write(w, w->devno, sizeof(u_int32_t), w->cnt);
+   iotrace_col_write(w, w->flags, sizeof(u_int32_t), w->cnt);
+   iotrace_col_write(w, w->batchno, sizeof(u_int32_t), w->cnt);
+   pad = IOTRACE_COL_BLOCKLEN(w->cnt) - IOTRACE_COL_BLKHDRLEN - (28 * (size_t) w->cnt);
+   fwrite(&reserved, 1, pad, w->outfile);
+   w->cnt = 0;
+}
+
+
+iotrace_colwriter * iotrace_columnar_open (FILE *outfile)
+{
+   iotrace_colwriter *w = calloc(1, sizeof(iotrace_colwriter));
+
+   if (w == NULL) {
+      return(NULL);
+   }
+   w->outfile = outfile;
+   iotrace_col_write_header(w);
+   return(w);
+}
+
+
+/* A request whose time does not fit in a 32-bit delta from the one  */
+/* before it (a gap over 4.29 seconds, or time going backwards) just */
+/* starts a new block.                                               */
+
+void iotrace_columnar_put (iotrace_colwriter *w, ioreq_event *curr)
+{
+   disksim_tick_t time = disksim_msec_to_ticks(curr->time);
+
+   if ((w->cnt > 0) && ((time < w->prevtime) || ((time - w->prevtime) > (disksim_tick_t) 0xFFFFFFFF))) {
+      iotrace_col_flush(w);
+   }
+   if (w->cnt == IOTRACE_COL_BLOCKRECS) {
+      iotrace_col_flush(w);
+   }
+   if (w->cnt == 0) {
+      w->basetime = time;
+      w->delta[0] = 0;
+   } else {
+      w->delta[w->cnt] = (u_int32_t) (time - w->prevtime);
+   }
+   w->prevtime = time;
+   w->blkno[w->cnt] = curr->blkno;
+   w->bcount[w->cnt] = curr->bcount;
+   w->devno[w->cnt] = curr->devno;
+   w->flags[w->cnt] = curr->flags;
+   w->batchno[w->cnt] = curr->batchno;
+   w->cnt++;
+   w->total++;
+}
+
+
+/* Writes out the last block and, unless the output cannot seek, the  */
+/* final record count.  Returns -1 if any of the writes failed.       */
+
+int iotrace_columnar_close (iotrace_colwriter *w)
+{
+   int ret;
+
+   iotrace_col_flush(w);
+   if (fseek(w->outfile, 0, SEEK_SET) == 0) {
+      iotrace_col_write_header(w);
+   }
+   ret = (fflush(w->outfile) == 0) && !ferror(w->outfile);
+   free(w);
+   return((ret) ? 0 : -1);
+}
+
+
+/* Readers for modern block traces.  Each one takes request times       */
+/* relative to the first request in the trace (kept in tracefirst, in   */
+/* the trace's own time units) and converts them to milliseconds,       */
+/* converts byte offsets and sizes to 512-byte sectors (rounding the    */
+/* extent out to whole sectors), and numbers the devices it names from  */
+/* 0 in the order they first appear (see iotrace_printstats).           */
+
+static int iotrace_devno (char *name)
+{
+   int i;
+
+   for (i=0; i<devmap->cnt; i++) {
+      if (strcmp(devmap->name[i], name) == 0) {
+         return(i);
+      }
+   }
+   if (devmap->cnt == IOTRACE_MAXDEVS) {
+      fprintf(stderr, "More than %d devices in I/O trace\n", IOTRACE_MAXDEVS);
+      exit(1);
+   }
+   strncpy(devmap->name[i], name, (IOTRACE_DEVNAMELEN - 1));
+   devmap->cnt++;
+   return(i);
+}
+
+
+static void iotrace_swap (void *ptr, int len)
+{
+   char *bytes = ptr;
+   char tmp;
+   int i;
+
+   for (i=0; i<(len/2); i++) {
+      tmp = bytes[i];
+      bytes[i] = bytes[(len - i - 1)];
+      bytes[(len - i - 1)] = tmp;
+   }
+}
+
+
+/* blktrace.  The trace is the stream of struct blk_io_trace records    */
+/* (each followed by pdu_len bytes of payload) that `blkparse -d' dumps, */
+/* in the byte order of the traced host, which is told by the magic     */
+/* number.  Only issue (D) events are taken, so the requests are what   */
+/* the traced device was sent after merging; notifications, SCSI        */
+/* pass-through, discards and empty flushes are skipped.  Devices are   */
+/* named by their "major,minor" numbers.                                */
+
+#define IOTRACE_BLK_MAGIC	0x65617400
+#define IOTRACE_BLK_ISSUE	7		/* __BLK_TA_ISSUE */
+#define IOTRACE_BLK_TC_WRITE	(1 << 1)
+#define IOTRACE_BLK_TC_SYNC	(1 << 3)
+#define IOTRACE_BLK_TC_PC	(1 << 9)
+#define IOTRACE_BLK_TC_NOTIFY	(1 << 10)
+#define IOTRACE_BLK_TC_DISCARD	(1 << 13)
+
+typedef struct {
+   u_int32_t magic;
+   u_int32_t sequence;
+   u_int64_t time;		/* ns */
+   u_int64_t sector;
+   u_int32_t bytes;
+   u_int32_t action;		/* category bits << 16 | action */
+   u_int32_t pid;
+   u_int32_t device;		/* major << 20 | minor */
+   u_int32_t cpu;
+   unsigned short error;
+   unsigned short pdu_len;
+} iotrace_blk_record;
+
+static ioreq_event * iotrace_blktrace_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+{
+   iotrace_blk_record rec;
+   char name[IOTRACE_DEVNAMELEN];
+   char pdu[256];
+   int len;
+   u_int32_t category;
+
+   StaticAssert (sizeof(iotrace_blk_record) == 48);
+   while (TRUE) {
+      if (fread(&rec, sizeof(rec), 1, tracefile) != 1) {
+         return(NULL);
+      }
+      if ((rec.magic & 0xFFFFFF00) != IOTRACE_BLK_MAGIC) {
+         iotrace_swap(&rec.magic, sizeof(rec.magic));
+         iotrace_swap(&rec.time, sizeof(rec.time));
+         iotrace_swap(&rec.sector, sizeof(rec.sector));
+         iotrace_swap(&rec.bytes, sizeof(rec.bytes));
+         iotrace_swap(&rec.action, sizeof(rec.action));
+         iotrace_swap(&rec.device, sizeof(rec.device));
+         iotrace_swap(&rec.pdu_len, sizeof(rec.pdu_len));
+      }
+      if ((rec.magic & 0xFFFFFF00) != IOTRACE_BLK_MAGIC) {
+         fprintf(stderr, "Bad magic number in blktrace record - %x\n", rec.magic);
+         exit(1);
+      }
+      for (len = rec.pdu_len; len > 0; len -= sizeof(pdu)) {
+         if (fread(pdu, ((len < sizeof(pdu)) ? len : sizeof(pdu)), 1, tracefile) != 1) {
+            return(NULL);
+         }
+      }
+      category = rec.action >> 16;
+      if (((rec.action & 0xFFFF) == IOTRACE_BLK_ISSUE) && (rec.bytes != 0) && !(category & (IOTRACE_BLK_TC_PC | IOTRACE_BLK_TC_NOTIFY | IOTRACE_BLK_TC_DISCARD))) {
+         break;
+      }
+   }
+
+   if (firstio) {
+      tracefirst = (long long) rec.time;
+      firstio = FALSE;
+   }
+   new->time = (double) ((long long) rec.time - tracefirst) / (double) 1000000;
+   sprintf(name, "%u,%u", (rec.device >> 20), (rec.device & 0xFFFFF));
+   new->devno = iotrace_devno(name);
+   new->blkno = (disksim_lbn_t) rec.sector;
+   new->bcount = (int) ((rec.bytes + 511) >> 9);
+   new->flags = (category & IOTRACE_BLK_TC_WRITE) ? WRITE : READ;
+   if (category & IOTRACE_BLK_TC_SYNC) {
+      new->flags |= SYNCHRONOUS | TIME_CRITICAL;
+   } else {
+      new->flags |= ASYNCHRONOUS | ((new->flags & READ) ? TIME_LIMITED : 0);
+   }
+   new->buf = 0;
+   new->opid = 0;
+   new->busno = 0;
+   new->cause = 0;
+   return(new);
+}
+
+
+/* MSR-Cambridge CSV:                                                   */
+/*    Timestamp,Hostname,DiskNumber,Type,Offset,Size,ResponseTime      */
+/* with Windows filetime stamps (100 ns ticks) and byte offsets and     */
+/* sizes.  Devices are named "Hostname:DiskNumber".  A header line, or  */
+/* any other line not starting with a timestamp, is skipped.            */
+
+static ioreq_event * iotrace_msr_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+{
+   char line[201];
+   char host[24];
+   char operation[15];
+   char name[IOTRACE_DEVNAMELEN];
+   long long stamp;
+   long long offset;
+   int disk;
+   int size;
+
+   do {
+      if (fgets(line, 200, tracefile) == NULL) {
+         return(NULL);
+      }
+   } while (!isdigit((unsigned char) line[0]));
+   if (sscanf(line, "%lld,%23[^,],%d,%14[^,],%lld,%d", &stamp, host, &disk, operation, &offset, &size) != 6) {
+      fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
+      fprintf(stderr, "line: %s", line);
+      ddbg_assert(0);
+   }
+   if (!strcasecmp(operation,"Read")) {
+      new->flags = READ;
+   } else if (!strcasecmp(operation,"Write")) {
+      new->flags = WRITE;
+   } else {
+      fprintf(stderr, "Unknown operation: %s in iotrace event\n",operation);
+      fprintf(stderr, "line: %s", line);
+      exit(1);
+   }
+
+   if (firstio) {
+      tracefirst = stamp;
+      firstio = FALSE;
+   }
+   new->time = (double) (stamp - tracefirst) / (double) 10000;
+   sprintf(name, "%s:%d", host, disk);
+   new->devno = iotrace_devno(name);
+   new->blkno = offset >> 9;
+   new->bcount = (int) (((offset & 511) + size + 511) >> 9);
+   new->buf = 0;
+   new->opid = 0;
+   new->busno = 0;
+   new->cause = 0;
+   return(new);
+}
+
+
+/* SPC-1:                                                               */
+/*    ASU,LBA,Size,Opcode,Timestamp[,...]                               */
+/* with LBAs in 512-byte sectors, sizes in bytes, opcodes r or w (in    */
+/* either case) and timestamps in seconds.  The ASU is the devno.       */
+
+static ioreq_event * iotrace_spc_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+{
+   char line[201];
+   char operation;
+   double stamp;
+   long long usecs;
+   int size;
+
+   do {
+      if (fgets(line, 200, tracefile) == NULL) {
+         return(NULL);
+      }
+   } while (!isdigit((unsigned char) line[0]));
+   if (sscanf(line, "%d,%lld,%d,%c,%lf", &new->devno, &new->blkno, &size, &operation, &stamp) != 5) {
+      fprintf(stderr, "Wrong number of arguments for I/O trace event type\n");
+      fprintf(stderr, "line: %s", line);
+      ddbg_assert(0);
+   }
+   if ((operation == 'r') || (operation == 'R')) {
+      new->flags = READ;
+   } else if ((operation == 'w') || (operation == 'W')) {
+      new->flags = WRITE;
+   } else {
+      fprintf(stderr, "Unknown operation: %c in iotrace event\n",operation);
+      fprintf(stderr, "line: %s", line);
+      exit(1);
+   }
+
+   /* whole microseconds, so the first stamp is subtracted exactly */
+   usecs = (long long) ((stamp * (double) 1000000) + 0.5);
+   if (firstio) {
+      tracefirst = usecs;
+      firstio = FALSE;
+   }
+   new->time = (double) (usecs - tracefirst) / (double) 1000;
+   new->bcount = (size + 511) >> 9;
+   new->buf = 0;
+   new->opid = 0;
+   new->busno = 0;
+   new->cause = 0;
+   return(new);
+}
+
+
+static ioreq_event * iotrace_merge_get_ioreq_event (FILE *tracefile, ioreq_event *new);
+static void iotrace_hpl_initialize_file (FILE *tracefile, int print_tracefile_header);
+
+static ioreq_event * iotrace_read_ioreq_event (FILE *tracefile, int traceformat, ioreq_event *temp)
+{
+   switch (traceformat) {
+      
+   case ASCII:
+      temp = iotrace_ascii_get_ioreq_event(tracefile, temp);
+      break;
+      
+   case RAW:
+      temp = iotrace_raw_get_ioreq_event(tracefile, temp);
+      break;
+      
+   case HPL:
+      temp = iotrace_hpl_get_ioreq_event(tracefile, temp);
+      break;
+
+   case DEC:
+      temp = iotrace_dec_get_ioreq_event(tracefile, temp);
+      break;
+
+   case VALIDATE:
+      temp = iotrace_validate_read_ioreq_event(tracefile, temp);
+      break;
+
+   case EMCSYMM:
+      temp = iotrace_emcsymm_get_ioreq_event(tracefile, temp);
+      break;
+
+   case EMCBACKEND:
+      temp = iotrace_emcbackend_get_ioreq_event(tracefile, temp);
+      break;
+
+   case BATCH:
+      temp = iotrace_batch_get_ioreq_event(tracefile, temp);
+      break;
+
+   case COLUMNAR:
+      temp = iotrace_columnar_get_ioreq_event(tracefile, temp);
+      break;
+
+   case BLKTRACE:
+      temp = iotrace_blktrace_get_ioreq_event(tracefile, temp);
+      break;
+
+   case MSRCSV:
+      temp = iotrace_msr_get_ioreq_event(tracefile, temp);
+      break;
+
+   case SPC:
+      temp = iotrace_spc_get_ioreq_event(tracefile, temp);
+      break;
+
+   case MERGE:
+      temp = iotrace_merge_get_ioreq_event(tracefile, temp);
+      break;
+
+   default:
+      fprintf(stderr, "Unknown traceformat in iotrace_read_ioreq_event - %d\n", traceformat);
+      exit(1);
+   }
+
+   return ((ioreq_event *)temp);
+}
+
+
+/* Merged traces.  The trace file of the "merge" format lists the traces */
+/* to merge, one per line:                                               */
+/*                                                                       */
+/*    <format> <trace file> [<devno offset> [<time offset> [<scale>]]]   */
+/*                                                                       */
+/* Each request read from a member has its time multiplied by the scale  */
+/* (default 1) and the time offset (in ms, default 0) added, and the     */
+/* devno offset (default 0) added to its devno.  Times are those of the  */
+/* member trace, without the base time some formats add (e.g., the HPL   */
+/* trace date).  Lines starting with # are ignored.                      */
+/*                                                                       */
+/* Every member is read by the usual reader, through its own copy of     */
+/* the reader state (iotrace_info) and the format settings kept in       */
+/* disksim, which are swapped in around each read.  The next request of  */
+/* each member waits in a binary heap ordered by time and then by the    */
+/* member's place in the list, so the merge never looks more than one    */
+/* request ahead in any member and the member traces can be any size.    */
+
+typedef struct iotrace_member {
+   FILE          *tracefile;
+   int            traceformat;
+   int            traceendian;
+   int            traceheader;
+   int            devoffset;
+   double         timeoffset;
+   double         timescale;
+   iotrace_info_t info;
+   ioreq_event    next;
+} iotrace_member;
+
+struct iotrace_merge {
+   int             cnt;
+   int             heaplen;
+   int            *heap;	/* members with a next request */
+   iotrace_member *member;
+};
+
+/* the merged trace's own state, while a member's is current */
+typedef struct iotrace_outer {
+   iotrace_info_t *info;
+   int             traceformat;
+   int             traceendian;
+   int             traceheader;
+} iotrace_outer;
+
+
+static void iotrace_merge_enter (iotrace_member *m, iotrace_outer *outer)
+{
+   outer->info = disksim->iotrace_info;
+   outer->traceformat = disksim->traceformat;
+   outer->traceendian = disksim->traceendian;
+   outer->traceheader = disksim->traceheader;
+   disksim->iotrace_info = &m->info;
+   disksim->traceformat = m->traceformat;
+   disksim->traceendian = m->traceendian;
+   disksim->traceheader = m->traceheader;
+}
+
+
+static void iotrace_merge_leave (iotrace_outer *outer)
+{
+   disksim->iotrace_info = outer->info;
+   disksim->traceformat = outer->traceformat;
+   disksim->traceendian = outer->traceendian;
+   disksim->traceheader = outer->traceheader;
+}
+
+
+/* Reads m's next request into m->next; FALSE at the end of m. */
+
+static int iotrace_merge_read (iotrace_member *m)
+{
+   iotrace_outer outer;
+   ioreq_event *new;
+
+   bzero(&m->next, sizeof(ioreq_event));
+   iotrace_merge_enter(m, &outer);
+   new = iotrace_read_ioreq_event(m->tracefile, m->traceformat, &m->next);
+   iotrace_merge_leave(&outer);
+   if (new == NULL) {
+      return(FALSE);
+   }
+   m->next.time = (m->next.time * m->timescale) + m->timeoffset;
+   m->next.devno += m->devoffset;
+   return(TRUE);
+}
+
+
+static INLINE int iotrace_merge_before (iotrace_merge *mg, int a, int b)
+{
+   double ta = mg->member[a].next.time;
+   double tb = mg->member[b].next.time;
+
+   return((ta < tb) || ((ta == tb) && (a < b)));
+}
+
+
+/* Moves the member at heap slot i down to its place. */
+
+static void iotrace_merge_sift (iotrace_merge *mg, int i)
+{
+   int child;
+   int tmp;
+
+   while ((child = (2 * i) + 1) < mg->heaplen) {
+      if (((child + 1) < mg->heaplen) && iotrace_merge_before(mg, mg->heap[(child + 1)], mg->heap[child])) {
+         child++;
+      }
+      if (!iotrace_merge_before(mg, mg->heap[child], mg->heap[i])) {
+         break;
+      }
+      tmp = mg->heap[i];
+      mg->heap[i] = mg->heap[child];
+      mg->heap[child] = tmp;
+      i = child;
+   }
+}
+
+
+static ioreq_event * iotrace_merge_get_ioreq_event (FILE *tracefile, ioreq_event *new)
+{
+   iotrace_merge *mg = disksim->iotrace_info->merge;
+   iotrace_member *m;
+
+   if (mg->heaplen == 0) {
+      return(NULL);
+   }
+   m = &mg->member[mg->heap[0]];
+   *new = m->next;
+   if (!iotrace_merge_read(m)) {
+      mg->heap[0] = mg->heap[--mg->heaplen];
+   }
+   iotrace_merge_sift(mg, 0);
+   return(new);
+}
+
+
+static void iotrace_merge_initialize_file (FILE *tracefile)
+{
+   iotrace_merge *mg;
+   iotrace_member *m;
+   iotrace_outer outer;
+   char line[601];
+   char format[40];
+   char name[512];
+   int size = 0;
+   int i;
+
+   mg = DISKSIM_malloc (sizeof(iotrace_merge));
+   bzero ((char *)mg, sizeof(iotrace_merge));
+   while (fgets(line, 600, tracefile) != NULL) {
+      if ((sscanf(line, "%39s", format) != 1) || (format[0] == '#')) {
+         continue;
+      }
+      if (mg->cnt == size) {
+         size = (size) ? (2 * size) : 16;
+         mg->member = realloc(mg->member, (size * sizeof(iotrace_member)));
+         if (mg->member == NULL) {
+            fprintf(stderr, "Out of memory reading merged trace list\n");
+            exit(1);
+         }
+      }
+      m = &mg->member[mg->cnt];
+      bzero ((char *)m, sizeof(iotrace_member));
+      m->timescale = 1.0;
+      if (sscanf(line, "%39s %511s %d %lf %lf", format, name, &m->devoffset, &m->timeoffset, &m->timescale) < 2) {
+         fprintf(stderr, "Bad line in merged trace list: %s", line);
+         exit(1);
+      }
+      if ((m->tracefile = fopen(name, "rb")) == NULL) {
+         fprintf(stderr, "Tracefile %s cannot be opened for read access\n", name);
+         exit(1);
+      }
+      m->tracefile = tracefile_open(m->tracefile, NULL);
+
+      /* let iotrace_set_format fill in the member's format settings */
+      iotrace_merge_enter(m, &outer);
+      iotrace_reset_iotrace_info();
+      iotrace_set_format(format);
+      m->traceformat = disksim->traceformat;
+      m->traceendian = disksim->traceendian;
+      m->traceheader = disksim->traceheader;
+      if ((m->traceformat == VALIDATE) || (m->traceformat == DEC) || (m->traceformat == MERGE) || ((m->traceformat == HPL) && (m->traceheader == FALSE))) {
+         /* request times depend on the simulation, or nested merge */
+         fprintf(stderr, "Traces in the %s format cannot be merged\n", format);
+         exit(1);
+      }
+      if (m->traceformat == HPL) {
+         iotrace_hpl_initialize_file(m->tracefile, FALSE);
+      } else if (m->traceformat == COLUMNAR) {
+         iotrace_columnar_initialize_file(m->tracefile);
+      }
+      iotrace_merge_leave(&outer);
+      mg->cnt++;
+   }
+   if (mg->cnt == 0) {
+      fprintf(stderr, "No traces listed in merged trace\n");
+      exit(1);
+   }
+
+   mg->heap = DISKSIM_malloc (mg->cnt * sizeof(int));
+   for (i=0; i<mg->cnt; i++) {
+      if (iotrace_merge_read(&mg->member[i])) {
+         mg->heap[mg->heaplen++] = i;
+      }
+   }
+   for (i=(mg->heaplen / 2) - 1; i>=0; i--) {
+      iotrace_merge_sift(mg, i);
+   }
+   disksim->iotrace_info->merge = mg;
+}
+
+
+/* Closes the member traces (see iotrace_detach_file). */
+
+static void iotrace_merge_detach (int release)
+{
+   iotrace_merge *mg = disksim->iotrace_info->merge;
+   iotrace_outer outer;
+   int i;
+
+   for (i=0; i<mg->cnt; i++) {
+      iotrace_merge_enter(&mg->member[i], &outer);
+      iotrace_detach_file(release);
+      iotrace_merge_leave(&outer);
+      if (release && (mg->member[i].tracefile != NULL)) {
+         fclose(mg->member[i].tracefile);
+         mg->member[i].tracefile = NULL;
+      }
+   }
+}
+
+
+/* Trace prefetching.  A producer thread runs the reader ahead of the    */
+/* simulation into a ring of ready requests, which the simulation thread */
+/* just copies out.  The ring is single-producer/single-consumer: each   */
+/* side only advances its own index, and only takes the lock to sleep    */
+/* when the ring is empty (consumer) or full (producer) and to wake the  */
+/* other side up.  The producer reads through a private copy of the      */
+/* disksim and iotrace_info structures, so the reader state it changes   */
+/* never races with the simulation; the HPL request counts are made by   */
+/* the consumer instead.  A thread does not survive fork(), so the       */
+/* producer is paused around one (see disksim_sweep.c).                  */
+
+#ifndef _WIN32
+
+#define IOTRACE_PF_SLOTS	1024	/* power of two */
+
+struct iotrace_prefetch {
+   FILE          *tracefile;
+   int            traceformat;
+   pthread_t      thread;
+   pthread_mutex_t lock;
+   pthread_cond_t cond;
+   int            running;
+   int            stop;		/* asks the producer to exit */
+   int            eof;		/* the producer hit the end of the trace */
+   int            cwait;	/* consumer is (about to be) asleep */
+   int            pwait;	/* producer is (about to be) asleep */
+   unsigned int   head;		/* next slot to take; consumer only */
+   unsigned int   tail;		/* next slot to fill; producer only */
+   disksim_t      shadow;
+   iotrace_info_t shadowinfo;
+   ioreq_event    slots[IOTRACE_PF_SLOTS];
+};
+
+#define IOTRACE_PF_LOAD(x)	__atomic_load_n(&(x), __ATOMIC_SEQ_CST)
+#define IOTRACE_PF_STORE(x, v)	__atomic_store_n(&(x), (v), __ATOMIC_SEQ_CST)
+
+
+static void iotrace_prefetch_wake (iotrace_prefetch *pf, int *waiting)
+{
+   if (IOTRACE_PF_LOAD(*waiting)) {
+      pthread_mutex_lock(&pf->lock);
+      pthread_cond_broadcast(&pf->cond);
+      pthread_mutex_unlock(&pf->lock);
+   }
+}
+
+
+static void * iotrace_prefetch_main (void *arg)
+{
+   iotrace_prefetch *pf = arg;
+   unsigned int tail = pf->tail;
+
+   disksim = &pf->shadow;
+   while (TRUE) {
+      if ((tail - IOTRACE_PF_LOAD(pf->head)) == IOTRACE_PF_SLOTS) {
+         pthread_mutex_lock(&pf->lock);
+         IOTRACE_PF_STORE(pf->pwait, TRUE);
+         while (((tail - IOTRACE_PF_LOAD(pf->head)) == IOTRACE_PF_SLOTS) && !pf->stop) {
+            pthread_cond_wait(&pf->cond, &pf->lock);
+         }
+         IOTRACE_PF_STORE(pf->pwait, FALSE);
+         pthread_mutex_unlock(&pf->lock);
+      }
+      if (IOTRACE_PF_LOAD(pf->stop)) {
+         break;
+      }
+      bzero(&pf->slots[(tail % IOTRACE_PF_SLOTS)], sizeof(ioreq_event));
+      if (iotrace_read_ioreq_event(pf->tracefile, pf->traceformat, &pf->slots[(tail % IOTRACE_PF_SLOTS)]) == NULL) {
+         IOTRACE_PF_STORE(pf->eof, TRUE);
+         iotrace_prefetch_wake(pf, &pf->cwait);
+         break;
+      }
+      tail++;
+      IOTRACE_PF_STORE(pf->tail, tail);
+      iotrace_prefetch_wake(pf, &pf->cwait);
+   }
+   return(NULL);
+}
+
+
+static ioreq_event * iotrace_prefetch_get (iotrace_prefetch *pf, ioreq_event *new)
+{
+   unsigned int head = pf->head;
+
+   while (head == IOTRACE_PF_LOAD(pf->tail)) {
+      if (IOTRACE_PF_LOAD(pf->eof) && (head == IOTRACE_PF_LOAD(pf->tail))) {
+         return(NULL);
+      }
+      pthread_mutex_lock(&pf->lock);
+      IOTRACE_PF_STORE(pf->cwait, TRUE);
+      while ((head == IOTRACE_PF_LOAD(pf->tail)) && !IOTRACE_PF_LOAD(pf->eof)) {
+         pthread_cond_wait(&pf->cond, &pf->lock);
+      }
+      IOTRACE_PF_STORE(pf->cwait, FALSE);
+      pthread_mutex_unlock(&pf->lock);
+   }
+   *new = pf->slots[(head % IOTRACE_PF_SLOTS)];
+   IOTRACE_PF_STORE(pf->head, (head + 1));
+   iotrace_prefetch_wake(pf, &pf->pwait);
+   if (pf->traceformat == HPL) {
+      iotrace_hpl_count(new);
+   }
+   return(new);
+}
+
+
+/* Returns the prefetch state if tracefile is being read ahead. */
+
+static iotrace_prefetch * iotrace_prefetching (FILE *tracefile)
+{
+   iotrace_prefetch *pf;
+
+   if ((disksim->iotrace_info == NULL) || ((pf = disksim->iotrace_info->prefetch) == NULL)) {
+      return(NULL);
+   }
+   return((pf->tracefile == tracefile) ? pf : NULL);
+}
+
+
+/* Starts reading tracefile ahead of the simulation.  VALIDATE traces   */
+/* and HPL traces without headers are read when needed as before, since */
+/* their request times depend on the simulated time.                    */
+
+void iotrace_prefetch_start (FILE *tracefile, int traceformat)
+{
+   iotrace_prefetch *pf;
+
+   if ((traceformat == VALIDATE) || (traceformat == DEC) || ((traceformat == HPL) && (disksim->traceheader == FALSE))) {
+      return;
+   }
+   pf = calloc(1, sizeof(iotrace_prefetch));
+   if (pf == NULL) {
+      return;
+   }
+   pf->tracefile = tracefile;
+   pf->traceformat = traceformat;
+   pf->shadowinfo = *disksim->iotrace_info;
+   pf->shadow = *disksim;
+   pf->shadow.iotrace_info = &pf->shadowinfo;
+   disksim->iotrace_info->prefetch = pf;
+   iotrace_prefetch_resume();
+}
+
+
+/* Stops the producer, keeping whatever it has read ahead. */
+
+void iotrace_prefetch_pause (void)
+{
+   iotrace_prefetch *pf;
+
+   if ((disksim->iotrace_info == NULL) || ((pf = disksim->iotrace_info->prefetch) == NULL) || !pf->running) {
+      return;
+   }
+   pthread_mutex_lock(&pf->lock);
+   IOTRACE_PF_STORE(pf->stop, TRUE);
+   pthread_cond_broadcast(&pf->cond);
+   pthread_mutex_unlock(&pf->lock);
+   pthread_join(pf->thread, NULL);
+   pthread_mutex_destroy(&pf->lock);
+   pthread_cond_destroy(&pf->cond);
+   pf->running = FALSE;
+}
+
+
+/* (Re)starts the producer, e.g. in a child forked while it was paused. */
+
+void iotrace_prefetch_resume (void)
+{
+   iotrace_prefetch *pf;
+
+   if ((disksim->iotrace_info == NULL) || ((pf = disksim->iotrace_info->prefetch) == NULL) || pf->running || pf->eof) {
+      return;
+   }
+   pf->stop = FALSE;
+   pthread_mutex_init(&pf->lock, NULL);
+   pthread_cond_init(&pf->cond, NULL);
+   if (pthread_create(&pf->thread, NULL, iotrace_prefetch_main, pf) != 0) {
+      fprintf(stderr, "Unable to start the trace prefetch thread\n");
+      exit(1);
+   }
+   pf->running = TRUE;
+}
+
+
+void iotrace_prefetch_stop (void)
+{
+   iotrace_prefetch *pf;
+
+   if ((disksim->iotrace_info == NULL) || ((pf = disksim->iotrace_info->prefetch) == NULL)) {
+      return;
+   }
+   iotrace_prefetch_pause();
+   disksim->iotrace_info->prefetch = NULL;
+   free(pf);
+}
+
+#else
+
+static iotrace_prefetch * iotrace_prefetching (FILE *tracefile)
+{
+   return(NULL);
+}
+
+static ioreq_event * iotrace_prefetch_get (iotrace_prefetch *pf, ioreq_event *new)
+{
+   return(NULL);
+}
+
+void iotrace_prefetch_start (FILE *tracefile, int traceformat) { }
+void iotrace_prefetch_pause (void) { }
+void iotrace_prefetch_resume (void) { }
+void iotrace_prefetch_stop (void) { }
+
+#endif
+
+
+/* Spatial sampling.  A request is kept if a hash of its device and of */
+/* the IOTRACE_SAMPLE_SHIFT-aligned region holding its first block falls */
+/* below the sample rate, so each region is seen in full or not at all.  */
+
+#define IOTRACE_SAMPLE_SHIFT	7	/* 64 KB regions */
+
+static int iotrace_sample_keep (ioreq_event *curr)
+{
+   u_int64_t h = ((u_int64_t) curr->devno << 48) ^ (u_int64_t) (curr->blkno >> IOTRACE_SAMPLE_SHIFT);
+
+   /* splitmix64 finalizer */
+   h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+   h = h ^ (h >> 31);
+   sampleseen++;
+   if (((double) (h >> 11) * (1.0 / 9007199254740992.0)) >= disksim->tracesample) {
+      return(FALSE);
+   }
+   samplekept++;
+   return(TRUE);
+}
+
+
+ioreq_event * iotrace_get_ioreq_event (FILE *tracefile, int traceformat, ioreq_event *temp)
+{
+   iotrace_prefetch *pf = iotrace_prefetching(tracefile);
+   ioreq_event *new;
+
+   while (TRUE) {
+      if (pf != NULL) {
+         new = iotrace_prefetch_get(pf, temp);
+      } else {
+         new = iotrace_read_ioreq_event(tracefile, traceformat, temp);
+      }
+      if (new == NULL) {
+         break;
+      }
+      if ((new->time + tracebasetime) < disksim->tracestart) {
+         continue;
+      }
+      if ((disksim->tracestop > 0.0) && ((new->time + tracebasetime) >= disksim->tracestop)) {
+         new = NULL;
+         break;
+      }
+      if (!TRACE_SAMPLED || iotrace_sample_keep(new)) {
+         break;
+      }
+   }
+   if (new == NULL) {
+      addtoextraq((event *) temp);
+   } else {
+      new->time -= disksim->tracestart;
+   }
+   return(new);
+}
+
+
+/* Time-range seeking.  With a trace start time, the requests before it */
+/* are skipped and the times of the rest are moved back by it (see      */
+/* iotrace_get_ioreq_event); with a stop time, the trace ends there.    */
+/* So that the skipping does not take as long as reading the trace,     */
+/* columnar traces are entered by walking their block headers, which    */
+/* touches one page per block, and the formats whose readers carry no   */
+/* state from one request to the next (apart from the time of the       */
+/* first request) are entered through a sparse index.  The index holds  */
+/* the time and file offset of every IOTRACE_IDX_INTERVAL'th request,   */
+/* together with that state and the device names, and is built by       */
+/* reading the trace once and kept in <trace>.idx, where later runs     */
+/* find it for as long as the trace's size and modification time are    */
+/* unchanged.  Compressed traces, stdin and other formats are just read */
+/* up to the start time.                                                 */
+
+static void iotrace_columnar_seek (double start)
+{
+   size_t off = IOTRACE_COL_HDRLEN;
+   size_t last = IOTRACE_COL_HDRLEN;
+   u_int32_t cnt;
+
+   /* the last block whose first request is before start; blocks may */
+   /* be short (see iotrace_columnar_put), so each header is read for */
+   /* the length of its block                                         */
+   while ((off + IOTRACE_COL_BLKHDRLEN) <= collen) {
+      cnt = iotrace_col_get32(colbase + off);
+      if ((cnt == 0) || (cnt > IOTRACE_COL_BLOCKRECS) || ((off + IOTRACE_COL_BLOCKLEN(cnt)) > collen)) {
+         break;
+      }
+      if (disksim_ticks_to_msec(iotrace_col_get64(colbase + off + 8)) >= start) {
+         break;
+      }
+      last = off;
+      off += IOTRACE_COL_BLOCKLEN(cnt);
+   }
+   colblock = last;
+   colidx = 0;
+}
+
+
+#ifndef _WIN32
+
+#define IOTRACE_IDX_MAGIC	"DSIMIDX1"
+#define IOTRACE_IDX_VERSION	1
+#define IOTRACE_IDX_INTERVAL	4096
+
+typedef struct {
+   char      magic[8];
+   int32_t   version;
+   int32_t   traceformat;
+   int64_t   tracesize;
+   int64_t   tracemtime;
+   int64_t   firsttime;	/* tracefirst */
+   int64_t   cnt;
+   int32_t   devcnt;
+   int32_t   reserved;
+} iotrace_idxhdr;
+
+typedef struct {
+   double    time;
+   int64_t   offset;
+} iotrace_idxent;
+
+
+static int iotrace_indexable (int traceformat)
+{
+   switch (traceformat) {
+   case ASCII:
+   case BATCH:
+   case EMCSYMM:
+   case EMCBACKEND:
+   case BLKTRACE:
+   case MSRCSV:
+   case SPC:
+      return(TRUE);
+   }
+   return(FALSE);
+}
+
+
+/* Returns the entries of the index in idxname, or NULL if there is no */
+/* usable index for the trace described by hdr.                        */
+
+static iotrace_idxent * iotrace_index_load (char *idxname, iotrace_idxhdr *hdr)
+{
+   FILE *idxfile;
+   iotrace_idxhdr got;
+   iotrace_idxent *ent = NULL;
+   int ok;
+
+   if ((idxfile = fopen(idxname, "rb")) == NULL) {
+      return(NULL);
+   }
+   ok = (fread(&got, sizeof(got), 1, idxfile) == 1)
+     && (memcmp(got.magic, IOTRACE_IDX_MAGIC, 8) == 0)
+     && (got.version == IOTRACE_IDX_VERSION)
+     && (got.traceformat == hdr->traceformat)
+     && (got.tracesize == hdr->tracesize)
+     && (got.tracemtime == hdr->tracemtime)
+     && (got.cnt > 0)
+     && (got.devcnt >= 0) && (got.devcnt <= IOTRACE_MAXDEVS);
+   if (ok && (got.devcnt > 0)) {
+      ok = (devmap != NULL) && (fread(devmap->name, IOTRACE_DEVNAMELEN, got.devcnt, idxfile) == got.devcnt);
+   }
+   if (ok) {
+      ent = malloc(got.cnt * sizeof(iotrace_idxent));
+      ok = (ent != NULL) && (fread(ent, sizeof(iotrace_idxent), got.cnt, idxfile) == got.cnt);
+   }
+   fclose(idxfile);
+   if (!ok) {
+      free(ent);
+      return(NULL);
+   }
+   if (devmap != NULL) {
+      devmap->cnt = got.devcnt;
+   }
+   *hdr = got;
+   return(ent);
+}
+
+
+/* Reads the whole trace to build its index, and leaves the reader */
+/* state as it found it, except for the device names.              */
+
+static iotrace_idxent * iotrace_index_build (FILE *tracefile, int traceformat, iotrace_idxhdr *hdr)
+{
+   iotrace_info_t saved = *disksim->iotrace_info;
+   iotrace_idxent *ent = NULL;
+   ioreq_event tmp;
+   off_t offset;
+   int64_t reqs = 0;
+   int64_t size = 0;
+
+   hdr->cnt = 0;
+   while (TRUE) {
+      offset = ftello(tracefile);
+      bzero(&tmp, sizeof(tmp));
+      if (iotrace_read_ioreq_event(tracefile, traceformat, &tmp) == NULL) {
+         break;
+      }
+      if ((reqs % IOTRACE_IDX_INTERVAL) == 0) {
+         if (hdr->cnt == size) {
+            size = (size) ? (2 * size) : 1024;
+            ent = realloc(ent, (size * sizeof(iotrace_idxent)));
+            if (ent == NULL) {
+               fprintf(stderr, "Out of memory indexing I/O trace\n");
+               exit(1);
+            }
+         }
+         ent[hdr->cnt].time = tmp.time;
+         ent[hdr->cnt].offset = offset;
+         hdr->cnt++;
+      }
+      reqs++;
+   }
+   clearerr(tracefile);
+   hdr->firsttime = tracefirst;
+   hdr->devcnt = (devmap != NULL) ? devmap->cnt : 0;
+   *disksim->iotrace_info = saved;
+   return(ent);
+}
+
+
+static void iotrace_index_save (char *idxname, iotrace_idxhdr *hdr, iotrace_idxent *ent)
+{
+   FILE *idxfile;
+   int ok;
+
+   if ((idxfile = fopen(idxname, "wb")) == NULL) {
+      fprintf(stderr, "Cannot write trace index %s; it will be rebuilt next time\n", idxname);
+      return;
+   }
+   ok = (fwrite(hdr, sizeof(*hdr), 1, idxfile) == 1);
+   if (ok && (hdr->devcnt > 0)) {
+      ok = (fwrite(devmap->name, IOTRACE_DEVNAMELEN, hdr->devcnt, idxfile) == hdr->devcnt);
+   }
+   if (ok) {
+      ok = (fwrite(ent, sizeof(iotrace_idxent), hdr->cnt, idxfile) == hdr->cnt);
+   }
+   if ((fclose(idxfile) != 0) || !ok) {
+      fprintf(stderr, "Error writing trace index %s\n", idxname);
+      unlink(idxname);
+   }
+}
+
+
+static void iotrace_index_seek (FILE *tracefile, int traceformat, double start)
+{
+   iotrace_idxhdr hdr;
+   iotrace_idxent *ent;
+   char idxname[sizeof(disksim->iotracefilename) + 4];
+   struct stat st;
+   off_t base;
+   int64_t lo, hi, mid;
+
+   /* stdin may be redirected from a regular file, but has no name to */
+   /* keep the index under                                             */
+   if (!iotrace_indexable(traceformat) || (disksim->iotracestate != NULL)
+       || (disksim->iotracefilename[0] == 0)
+       || (strcmp(disksim->iotracefilename, "stdin") == 0)
+       || (fstat(fileno(tracefile), &st) != 0) || !S_ISREG(st.st_mode)
+       || ((base = ftello(tracefile)) < 0)) {
+      return;
+   }
+   bzero(&hdr, sizeof(hdr));
+   memcpy(hdr.magic, IOTRACE_IDX_MAGIC, 8);
+   hdr.version = IOTRACE_IDX_VERSION;
+   hdr.traceformat = traceformat;
+   hdr.tracesize = st.st_size;
+   hdr.tracemtime = st.st_mtime;
+   sprintf(idxname, "%s.idx", disksim->iotracefilename);
+
+   if ((ent = iotrace_index_load(idxname, &hdr)) == NULL) {
+      ent = iotrace_index_build(tracefile, traceformat, &hdr);
+      if (fseeko(tracefile, base, SEEK_SET) != 0) {
+         fprintf(stderr, "Cannot seek in I/O trace\n");
+         exit(1);
+      }
+      if (hdr.cnt == 0) {
+         return;
+      }
+      iotrace_index_save(idxname, &hdr, ent);
+   }
+
+   /* the last indexed request before start */
+   lo = -1;
+   hi = hdr.cnt - 1;
+   while (lo < hi) {
+      mid = (lo + hi + 1) / 2;
+      if (ent[mid].time < start) {
+         lo = mid;
+      } else {
+         hi = mid - 1;
+      }
+   }
+   if (lo >= 0) {
+      if (fseeko(tracefile, ent[lo].offset, SEEK_SET) != 0) {
+         fprintf(stderr, "Cannot seek in I/O trace\n");
+         exit(1);
+      }
+      tracefirst = hdr.firsttime;
+      firstio = FALSE;
+   }
+   free(ent);
+}
+
+#else
+
+static void iotrace_index_seek (FILE *tracefile, int traceformat, double start) { }
+
+#endif
+
+
+static void iotrace_hpl_srt_tracefile_start (char *tracedate)
+{
+   char crap[40];
+   char monthstr[40];
+   int day;
+   int hour;
+   int minute;
+   int second;
+   int year;
+
+   if (sscanf(tracedate, "%s\t= \"%s %s %d %d:%d:%d %d\";\n", crap, crap, monthstr, &day, &hour, &minute, &second, &year) != 8) {
+      fprintf(stderr, "Format problem with 'tracedate' line in HPL trace - %s\n", tracedate);
+      exit(1);
+   }
+   if (baseyear == 0) {
+      baseyear = year;
+   }
+   day = day + iotrace_month_convert(monthstr, year);
+   if (year != baseyear) {
+      day += (baseyear % 4) ? 365 : 366;
+   }
+   if (baseday == 0) {
+      baseday = day;
+   }
+   second = second + (60 * minute) + (3600 * hour) + (86400 * (day - baseday));
+   if (basesecond == 0) {
+      basesecond = second;
+   }
+   second -= basesecond;
+   tracebasetime += (double) 1000 * (double) second;
+}
+
+
+static void iotrace_hpl_initialize_file (FILE *tracefile, int print_tracefile_header)
+{
+   char letter = '0';
+   char line[201];
+   char linetype[40];
+
+   if (disksim->traceheader == FALSE) {
+      return;
+   }
+   while (1) {
+      if (fgets(line, 200, tracefile) == NULL) {
+         fprintf(stderr, "No 'tracedate' line in HPL trace\n");
+         exit(1);
+      }
+      sscanf(line, "%s", linetype);
+      if (strcmp(linetype, "tracedate") == 0) {
+         break;
+      }
+   }
+   iotrace_hpl_srt_tracefile_start(line);
+   while (letter != 0x0C) {
+      if (fscanf(tracefile, "%c", &letter) != 1) {
+         fprintf(stderr, "End of header information never found - end of file\n");
+         exit(1);
+      }
+      if ((print_tracefile_header) && (letter != 0x0C)) {
+         printf("%c", letter);
+      }
+   }
+}
+
+
+void iotrace_initialize_file (FILE *tracefile, int traceformat, int print_tracefile_header)
+{
+   if (traceformat == HPL) {
+      iotrace_hpl_initialize_file(tracefile, print_tracefile_header);
+   } else if (traceformat == COLUMNAR) {
+      iotrace_columnar_initialize_file(tracefile);
+   } else if (traceformat == MERGE) {
+      iotrace_merge_initialize_file(tracefile);
+   }
+   if ((tracefile != NULL) && (disksim->tracestart > 0.0)) {
+      if (traceformat == COLUMNAR) {
+         iotrace_columnar_seek(disksim->tracestart);
+      } else {
+         iotrace_index_seek(tracefile, traceformat, disksim->tracestart);
+      }
+   }
+}
+
+
+void iotrace_printstats (FILE *outfile)
+{
+   int reads, writes, sreads, swrites, areads, awrites;
+   int i;
+
+   if (disksim->iotrace_info == NULL) {
+      return;
+   }
+   reads = hpreads;
+   writes = hpwrites;
+   sreads = syncreads;
+   swrites = syncwrites;
+   areads = asyncreads;
+   awrites = asyncwrites;
+   if (TRACE_SAMPLED) {
+      fprintf (outfile, "\n");
+      fprintf(outfile, "Trace sample rate:\t%f\n", disksim->tracesample);
+      fprintf(outfile, "Trace requests sampled:\t%lld\t%lld\t%6.4f\n", samplekept, sampleseen, ((sampleseen) ? ((double) samplekept / (double) sampleseen) : 0.0));
+   }
+   if ((devmap != NULL) && (devmap->cnt > 0)) {
+      /* the producer may still be adding devices */
+      iotrace_prefetch_pause();
+      fprintf (outfile, "\n");
+      fprintf(outfile, "Trace devices:  \t%d\n", devmap->cnt);
+      for (i=0; i<devmap->cnt; i++) {
+         fprintf(outfile, "Trace device #%d:\t%s\n", i, devmap->name[i]);
+      }
+   }
+   if (disksim->iotrace_info->merge != NULL) {
+      iotrace_merge *mg = disksim->iotrace_info->merge;
+      iotrace_outer outer;
+      int j;
+
+      iotrace_prefetch_pause();
+      for (i=0; i<mg->cnt; i++) {
+         iotrace_merge_enter(&mg->member[i], &outer);
+         /* each member counts its HPL requests in its own state */
+         reads += hpreads;
+         writes += hpwrites;
+         sreads += syncreads;
+         swrites += syncwrites;
+         areads += asyncreads;
+         awrites += asyncwrites;
+         if ((devmap != NULL) && (devmap->cnt > 0)) {
+            fprintf (outfile, "\n");
+            fprintf(outfile, "Merged trace #%d devices:\t%d\n", i, devmap->cnt);
+            for (j=0; j<devmap->cnt; j++) {
+               fprintf(outfile, "Merged trace #%d device #%d:\t%s\n", i, (j + mg->member[i].devoffset), devmap->name[j]);
+            }
+         }
+         iotrace_merge_leave(&outer);
+      }
+   }
+   if (reads | writes) {
       fprintf (outfile, "\n");
-      fprintf(outfile, "Total reads:    \t%d\t%5.2f\n", hpreads, ((double) hpreads / (double) (hpreads + hpwrites)));
-      fprintf(outfile, "Total writes:   \t%d\t%5.2f\n", hpwrites, ((double) hpwrites / (double) (hpreads + hpwrites)));
-      fprintf(outfile, "Sync Reads:  \t%d\t%5.2f\t%5.2f\n", syncreads, ((double) syncreads / (double) (hpreads + hpwrites)), ((double) syncreads / (double) hpreads));
-      fprintf(outfile, "Sync Writes: \t%d\t%5.2f\t%5.2f\n", syncwrites, ((double) syncwrites / (double) (hpreads + hpwrites)), ((double) syncwrites / (double) hpwrites));
-      fprintf(outfile, "Async Reads: \t%d\t%5.2f\t%5.2f\n", asyncreads, ((double) asyncreads / (double) (hpreads + hpwrites)), ((double) asyncreads / (double) hpreads));
-      fprintf(outfile, "Async Writes:\t%d\t%5.2f\t%5.2f\n", asyncwrites, ((double) asyncwrites / (double) (hpreads + hpwrites)), ((double) asyncwrites / (double) hpwrites));
+      fprintf(outfile, "Total reads:    \t%d\t%5.2f\n", reads, ((double) reads / (double) (reads + writes)));
+      fprintf(outfile, "Total writes:   \t%d\t%5.2f\n", writes, ((double) writes / (double) (reads + writes)));
+      fprintf(outfile, "Sync Reads:  \t%d\t%5.2f\t%5.2f\n", sreads, ((double) sreads / (double) (reads + writes)), ((double) sreads / (double) reads));
+      fprintf(outfile, "Sync Writes: \t%d\t%5.2f\t%5.2f\n", swrites, ((double) swrites / (double) (reads + writes)), ((double) swrites / (double) writes));
+      fprintf(outfile, "Async Reads: \t%d\t%5.2f\t%5.2f\n", areads, ((double) areads / (double) (reads + writes)), ((double) areads / (double) reads));
+      fprintf(outfile, "Async Writes:\t%d\t%5.2f\t%5.2f\n", awrites, ((double) awrites / (double) (reads + writes)), ((double) awrites / (double) writes));
    }
 }
 
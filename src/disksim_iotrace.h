@@ -62,6 +62,19 @@
 /* really need to clean interface between iotrace.c and iosim.c, such */
 /* that this stuff can be local to just iotrace.c ...                 */
 
+typedef struct iotrace_prefetch iotrace_prefetch;
+typedef struct iotrace_merge iotrace_merge;
+
+/* device names seen in blktrace and MSR traces, in devno order */
+
+#define IOTRACE_MAXDEVS		256
+#define IOTRACE_DEVNAMELEN	40
+
+typedef struct iotrace_devmap {
+   int  cnt;
+   char name[IOTRACE_MAXDEVS][IOTRACE_DEVNAMELEN];
+} iotrace_devmap;
+
 typedef struct iotrace_info {
    double tracebasetime;
    int syncreads;
@@ -82,13 +95,25 @@ typedef struct iotrace_info {
    int basesmalltime;
    double basesimtime;
    double validate_lastserv;
-   int validate_lastblkno;
+   disksim_lbn_t validate_lastblkno;
    int validate_lastbcount;
    int validate_lastread;
    double validate_nextinter;
    char validate_buffaction[20];
    double accumulated_event_time;
    double lastaccesstime;
+   char  *colbase;        /* columnar trace image, mapped or read in */
+   size_t collen;
+   int    colmapped;      /* colbase is a mapping of the trace file */
+   size_t colblock;       /* offset of the current block */
+   int    colidx;         /* next record within the current block */
+   disksim_tick_t coltime;  /* time of the previous record, in ns */
+   long long tracefirst;  /* first request time, in the trace's own units */
+   iotrace_devmap *devmap;
+   long long sampleseen;  /* requests considered and kept by sampling */
+   long long samplekept;
+   iotrace_prefetch *prefetch;  /* reading ahead in another thread */
+   iotrace_merge *merge;  /* the traces a merged trace is made of */
 } iotrace_info_t;
 
 
@@ -119,6 +144,16 @@ typedef struct iotrace_info {
 #define validate_buffaction     (disksim->iotrace_info->validate_buffaction)
 #define accumulated_event_time  (disksim->iotrace_info->accumulated_event_time)
 #define lastaccesstime          (disksim->iotrace_info->lastaccesstime)
+#define colbase                 (disksim->iotrace_info->colbase)
+#define collen                  (disksim->iotrace_info->collen)
+#define colmapped               (disksim->iotrace_info->colmapped)
+#define colblock                (disksim->iotrace_info->colblock)
+#define colidx                  (disksim->iotrace_info->colidx)
+#define coltime                 (disksim->iotrace_info->coltime)
+#define tracefirst              (disksim->iotrace_info->tracefirst)
+#define devmap                  (disksim->iotrace_info->devmap)
+#define sampleseen              (disksim->iotrace_info->sampleseen)
+#define samplekept              (disksim->iotrace_info->samplekept)
 
 
 /* exported disksim_iotrace.c functions */
@@ -128,6 +163,19 @@ void iotrace_initialize_file (FILE *tracefile, int traceformat, int print_tracef
 ioreq_event * iotrace_get_ioreq_event (FILE *tracefile, int traceformat, ioreq_event *temp);
 ioreq_event * iotrace_validate_get_ioreq_event(FILE *tracefile, ioreq_event *new);
 void iotrace_printstats (FILE *outfile);
+void iotrace_detach_file (int release);
+void iotrace_prefetch_start (FILE *tracefile, int traceformat);
+void iotrace_prefetch_pause (void);
+void iotrace_prefetch_resume (void);
+void iotrace_prefetch_stop (void);
+
+/* writer for the columnar trace format (see trace2col.c) */
+
+typedef struct iotrace_colwriter iotrace_colwriter;
+
+iotrace_colwriter * iotrace_columnar_open (FILE *outfile);
+void iotrace_columnar_put (iotrace_colwriter *w, ioreq_event *curr);
+int  iotrace_columnar_close (iotrace_colwriter *w);
 
 #endif    /* DISKSIM_IOTRACE_H */
 
@@ -36,6 +36,9 @@
 #include "disksim_global.h"
 #include "disksim_iodriver.h"
 #include "disksim_disk.h"
+#include "disksim_simpledisk.h"
+#include "disksim_ctlr.h"
+#include "disksim_cache.h"
 
 #include "modules/modules.h"
 
@@ -48,6 +51,12 @@
 
 #include <stdio.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 
 
 static void disksim_topoloader(struct lp_topospec *ts, int len) {
@@ -56,11 +65,27 @@ static void disksim_topoloader(struct lp_topospec *ts, int len) {
 }
 
 
-int disksim_loadparams(char *inputfile, int synthgen) {
-  int rv;
+/* libparam keeps its parser and type table in globals, so simulation */
+/* instances being set up on different threads take turns loading.    */
+#ifdef _WIN32
+static volatile LONG disksim_loadparams_busy = 0;
+#define disksim_loadparams_lock()    while (InterlockedExchange(&disksim_loadparams_busy, 1)) { Sleep(0); }
+#define disksim_loadparams_unlock()  InterlockedExchange(&disksim_loadparams_busy, 0)
+#else
+static pthread_mutex_t disksim_loadparams_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define disksim_loadparams_lock()    pthread_mutex_lock(&disksim_loadparams_mutex)
+#define disksim_loadparams_unlock()  pthread_mutex_unlock(&disksim_loadparams_mutex)
+#endif
+
+
+/* a parse made ahead of time by disksim_parseparams() */
+static char *disksim_preparsed_file = NULL;
+static struct lp_tlt **disksim_preparsed_tlts = NULL;
+static int disksim_preparsed_tlts_len = 0;
+
+
+static void disksim_register_modules(void) {
   int c;
-  struct lp_tlt **tlts;
-  int tlts_len;
 
   // register modules with libparam
   for(c = 0; c <= DISKSIM_MAX_MODULE; c++) {
@@ -83,23 +108,87 @@ int disksim_loadparams(char *inputfile, int synthgen) {
   }  
 
   lp_register_topoloader(disksim_topoloader);
+}
+
+
+/* Parses inputfile without instantiating anything.  The next        */
+/* disksim_loadparams() of the same file instantiates this parse,    */
+/* with that simulation's overrides, instead of reading the file     */
+/* again; processes forked after this call (see disksim_sweep.c)     */
+/* each get their own copy of it.                                    */
+
+int disksim_parseparams(char *inputfile) {
+  FILE *parfile;
+  int rv;
 
-  //  lp_init_typetbl();
+  disksim_loadparams_lock();
 
+  disksim_register_modules();
 
-  disksim->parfile = fopen(inputfile,"r");
-  ddbg_assert2(disksim->parfile != NULL, 
+  parfile = fopen(inputfile,"r");
+  ddbg_assert2(parfile != NULL, 
 	     ("Parameter file \"%s\" cannot be opened for read access\n", 
 	      inputfile));
 
   lp_init_typetbl();
 
-  rv = lp_loadfile(disksim->parfile, 
-		   &tlts, 
-		   &tlts_len, 
+  lp_defer_instantiation(1);
+  rv = lp_loadfile(parfile, 
+		   &disksim_preparsed_tlts, 
+		   &disksim_preparsed_tlts_len, 
 		   inputfile,
-		   disksim->overrides,
-		   disksim->overrides_len);
+		   NULL,
+		   0);
+  lp_defer_instantiation(0);
+
+  fclose(parfile);
+  disksim_preparsed_file = strdup(inputfile);
+  disksim_loadparams_unlock();
+  return rv;
+}
+
+
+int disksim_loadparams(char *inputfile, int synthgen) {
+  int rv = 0;
+  int c;
+  struct lp_tlt **tlts;
+  int tlts_len;
+
+  disksim_loadparams_lock();
+
+  if(disksim_preparsed_file && !strcmp(disksim_preparsed_file, inputfile)) {
+    tlts = disksim_preparsed_tlts;
+    tlts_len = disksim_preparsed_tlts_len;
+    free(disksim_preparsed_file);
+    disksim_preparsed_file = NULL;
+
+    lp_instantiate_tlts(tlts, 
+			tlts_len, 
+			disksim->overrides, 
+			disksim->overrides_len);
+  }
+  else {
+    disksim_register_modules();
+
+    //  lp_init_typetbl();
+
+
+    disksim->parfile = fopen(inputfile,"r");
+    ddbg_assert2(disksim->parfile != NULL, 
+	       ("Parameter file \"%s\" cannot be opened for read access\n", 
+		inputfile));
+
+    lp_init_typetbl();
+
+    rv = lp_loadfile(disksim->parfile, 
+		     &tlts, 
+		     &tlts_len, 
+		     inputfile,
+		     disksim->overrides,
+		     disksim->overrides_len);
+
+    fclose(disksim->parfile);
+  }
 
   lp_unparse_tlts(tlts, tlts_len, outputfile, inputfile);
 
@@ -126,6 +215,108 @@ int disksim_loadparams(char *inputfile, int synthgen) {
   }
 
 
-  fclose(disksim->parfile);
+  disksim_loadparams_unlock();
   return rv;
 }
+
+
+/* apply param = value to one component (or its "Scheduler" or        */
+/* "Cache" sub-block, when param has that prefix) that is already     */
+/* running, for changing a configuration partway through a simulation */
+/* (see disksim_sweep.c's warm-fork mode).  Components that keep a    */
+/* copy of their queue per device pass those copies in devs.          */
+
+static int disksim_setparam_component(char *param, char *value,
+				      struct lp_mod *m, void *it,
+				      struct ioq *queue,
+				      device *devs, int numdevs,
+				      struct cache_if *cache)
+{
+  char *block, *sub;
+  int rv;
+  int c;
+
+  if(dumb_split2(param, &block, &sub)) {
+    free(block);
+    return (it ? lp_setparam(it, m, param, value) : -1);
+  }
+
+  if(!strcmp(block, "Scheduler") && queue) {
+    rv = lp_setparam(queue, &disksim_ioqueue_mod, sub, value);
+    for(c = 0; (rv == 0) && (c < numdevs); c++) {
+      rv = lp_setparam(devs[c].queue, &disksim_ioqueue_mod, sub, value);
+    }
+  }
+  else if(!strcmp(block, "Cache") && cache) {
+    rv = disksim_cache_setparam(cache, sub, value);
+  }
+  else {
+    rv = -1;
+  }
+
+  free(block);
+  free(sub);
+  return rv;
+}
+
+
+/* Sets param to value in every iodriver, controller and disk whose   */
+/* name matches comp (which may be a range, as with command-line      */
+/* overrides).  Only int, double and string parameters can be set.    */
+/* Returns the number of components changed, or -1 if a matching      */
+/* component has no such parameter.                                   */
+
+int disksim_setparam(char *comp, char *param, char *value) {
+  int c;
+  int type;
+  int count = 0;
+  struct device_header *d;
+
+  for(c = 0; c < numiodrivers; c++) {
+    if(!iodrivers[c]->name || !range_match(comp, iodrivers[c]->name)) continue;
+    if(disksim_setparam_component(param, value, &disksim_iodriver_mod, 
+				  iodrivers[c], iodrivers[c]->queue, 
+				  iodrivers[c]->devices, iodrivers[c]->numdevices, 0)) {
+      return -1;
+    }
+    count++;
+  }
+
+  for(c = 0; c < disksim->ctlrinfo->numcontrollers; c++) {
+    controller *ctlr = disksim->ctlrinfo->controllers[c];
+    if(!ctlr->name || !range_match(comp, ctlr->name)) continue;
+    if(disksim_setparam_component(param, value, &disksim_ctlr_mod, 
+				  ctlr, ctlr->queue, 
+				  ctlr->devices, ctlr->numdevices, ctlr->cache)) {
+      return -1;
+    }
+    count++;
+  }
+
+  for(c = 0; c < disksim->deviceinfo->devs_len; c++) {
+    char *name = disksim->deviceinfo->devicenames[c];
+    if(!name || !range_match(comp, name)) continue;
+
+    d = getdevbyname(name, 0, 0, &type);
+    switch(type) {
+    case DEVICETYPE_DISK:
+      if(disksim_setparam_component(param, value, &disksim_disk_mod, 
+				    d, ((struct disk *)d)->queue, 0, 0, 0)) {
+	return -1;
+      }
+      break;
+    case DEVICETYPE_SIMPLEDISK:
+      if(disksim_setparam_component(param, value, &disksim_simpledisk_mod, 
+				    d, ((struct simpledisk *)d)->queue, 0, 0, 0)) {
+	return -1;
+      }
+      break;
+    default:
+      fprintf(stderr, "*** error: can't change parameters of device %s while it is running\n", name);
+      return -1;
+    }
+    count++;
+  }
+
+  return count;
+}
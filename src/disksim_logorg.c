@@ -120,9 +120,9 @@ static char *statdesc_streak =      "Streak length";
 static char *statdesc_locality =    "Inter-request distance";
 
 
-static int logorg_overlap (logorg *currlogorg, int devno, ioreq_event *curr, int blksperpart)
+static int logorg_overlap (logorg *currlogorg, int devno, ioreq_event *curr, disksim_lbn_t blksperpart)
 {
-   int calc;
+   disksim_lbn_t calc;
 
    calc = curr->blkno - currlogorg->devs[devno].startblkno;
    if ((calc >= 0) && (calc < blksperpart)) {
@@ -188,8 +188,8 @@ static void logorg_update_interfere_stats (logorg *currlogorg, ioreq_event *curr
 {
    int i;
    int first;
-   int *lastreq = currlogorg->stat.lastreq;
-   int diffblkno;
+   disksim_lbn_t *lastreq = currlogorg->stat.lastreq;
+   disksim_lbn_t diffblkno;
 
    if (currlogorg->printinterferestats == FALSE) {
       return;
@@ -260,7 +260,7 @@ static void logorg_update_blocking_stats (logorg *currlogorg, ioreq_event *curr)
          currlogorg->stat.blocked[i]++;
       }
    }
-   maxval = min(BLOCKINGMAX, curr->blkno);
+   maxval = (int) min(BLOCKINGMAX, curr->blkno);
    for (i=0; i<maxval; i++) {
       if ((curr->blkno % (i+1)) == 0) {
          currlogorg->stat.aligned[i]++;
@@ -397,7 +397,7 @@ fprintf (outputfile, "Midway through stats\n");
       fprintf(stderr,"Stopping simulation because of saturation: simtime %f, totalreqs %d\n", simtime, disksim->totalreqs);
       fflush(stderr);
       fprintf (outputfile, "Stopping simulation because of saturation: simtime %f, totalreqs %d\n", simtime, disksim->totalreqs);
-      fprintf (outputfile, "last request:  dev=%d, blk=%d, cnt=%d, %d (R==1)\n",curr->devno, curr->blkno, curr->bcount, (curr->flags & READ));
+      fprintf (outputfile, "last request:  dev=%d, blk=%lld, cnt=%d, %d (R==1)\n",curr->devno, curr->blkno, curr->bcount, (curr->flags & READ));
       disksim_simstop();
    }
    if (req->flags & READ) {
@@ -572,13 +572,13 @@ static void logorg_maprandom (logorg *currlogorg, ioreq_event *curr)
 static int logorg_mapinterleaved (logorg *currlogorg, ioreq_event *curr)
 {
    int numdisks;
-   int blkno;
+   disksim_lbn_t blkno;
    int i;
    ioreq_event *temp;
 
    numdisks = currlogorg->numdisks;
    blkno = curr->blkno / numdisks;
-   curr->bcount += curr->blkno - (blkno * numdisks);
+   curr->bcount += (int) (curr->blkno - (blkno * numdisks));
    curr->bcount = (curr->bcount + numdisks - 1) / numdisks;
    curr->blkno = blkno;
    curr->devno = 0;
@@ -597,8 +597,8 @@ static int logorg_mapstriped (logorg *currlogorg, ioreq_event *curr)
 {
    int numdisks;
    int stripeunit;
-   int unitno;
-   int stripeno;
+   disksim_lbn_t unitno;
+   disksim_lbn_t stripeno;
    int reqsize;
    int numstripes = 2;
    int numreqs = 1;
@@ -607,7 +607,7 @@ static int logorg_mapstriped (logorg *currlogorg, ioreq_event *curr)
    int startdevno;
    ioreq_event *newreq;
    ioreq_event *temp;
-   int blkno;
+   disksim_lbn_t blkno;
    int i;
    int last = FALSE;
 
@@ -625,15 +625,15 @@ static int logorg_mapstriped (logorg *currlogorg, ioreq_event *curr)
    stripeno = unitno / numdisks;
    if (stripeno == currlogorg->numfull) {
       last = TRUE;
-      stripeunit = currlogorg->blksperpart - (currlogorg->numfull * stripeunit);
+      stripeunit = (int) (currlogorg->blksperpart - (currlogorg->numfull * stripeunit));
       unitno = stripeno * numdisks;
       unitno += (curr->blkno - (unitno * currlogorg->stripeunit)) / stripeunit;
       curr->blkno -= stripeno * numdisks * currlogorg->stripeunit;
    }
-   devno = unitno % numdisks;
+   devno = (int) (unitno % numdisks);
    curr->devno = devno;
    curr->blkno = curr->blkno % stripeunit;
-   startslop = stripeunit - curr->blkno;
+   startslop = stripeunit - (int) curr->blkno;
    curr->blkno += stripeno * currlogorg->stripeunit;
    if (startslop < curr->bcount) {
       blkno = stripeno * currlogorg->stripeunit;
@@ -651,7 +651,7 @@ fprintf (outputfile, "Have a multi-disk request - bcount %d, startslop %d, strip
 	 devno = 0;
 	 stripeno++;
 	 if (stripeno == currlogorg->numfull) {
-	    stripeunit = currlogorg->blksperpart - (stripeno * stripeunit);
+	    stripeunit = (int) (currlogorg->blksperpart - (stripeno * stripeunit));
 	 }
       }
       while (reqsize > stripeunit) {
@@ -663,7 +663,7 @@ fprintf (outputfile, "Have a multi-disk request - bcount %d, startslop %d, strip
 	    devno = 0;
 	    stripeno++;
 	    if (stripeno == currlogorg->numfull) {
-	       stripeunit = currlogorg->blksperpart - (stripeno * stripeunit);
+	       stripeunit = (int) (currlogorg->blksperpart - (stripeno * stripeunit));
 	    }
 	 }
       }
@@ -678,6 +678,7 @@ fprintf (outputfile, "Have a multi-disk request - bcount %d, startslop %d, strip
          newreq->busno = curr->busno & 0x0000FFFF;
          newreq->bcount = currlogorg->sizes[(i % numdisks)];
          newreq->flags = curr->flags;
+         newreq->cause = curr->cause;
 	 newreq->next = NULL;
 	 newreq->prev = NULL;
 	 newreq->type = curr->type;
@@ -714,7 +715,7 @@ fprintf (outputfile, "flags %x, opid %d\n", curr->flags, curr->opid);
      curr->next = NULL;
      return(1);
    }
-   req = (outstand *) getfromextraq();
+   req = (outstand *) getfromextraq_type(DISKSIM_POOL_OUTSTAND);
    ASSERT (req != NULL);
    req->arrtime = simtime;
    req->bcount = curr->bcount;
@@ -758,7 +759,7 @@ fprintf (outputfile, "flags %x, opid %d\n", curr->flags, curr->opid);
 
    /* Every request must be covered by a logorg */
    if (logorgno == -1) {
-      fprintf (stderr, "unexpected request location: devno %x, blkno %d, bcount %d\n", curr->devno, curr->blkno, curr->bcount);
+      fprintf (stderr, "unexpected request location: devno %x, blkno %lld, bcount %d\n", curr->devno, curr->blkno, curr->bcount);
    }
    ASSERT(logorgno != -1);
    maptype = logorgs[logorgno]->maptype;
@@ -909,11 +910,11 @@ fprintf (outputfile, "Leaving logorg_mapcomplete\n");
 }
 
 
-void logorg_raise_priority (logorg **logorgs, int numlogorgs, int opid, int devno, int blkno, void *buf)
+void logorg_raise_priority (logorg **logorgs, int numlogorgs, int opid, int devno, disksim_lbn_t blkno, void *buf)
 {
    int i, j;
    int logorgno = -1;
-   int calc;
+   disksim_lbn_t calc;
    outstand *tmp;
    int found = 0;
 /*
@@ -980,7 +981,7 @@ static void logorg_postpass_per(logorg *currlogorg, int orgno)
 
    if ((currlogorg->stripeunit < 0) ||
        (currlogorg->stripeunit > currlogorg->blksperpart)) {
-      fprintf(stderr, "Invalid value for 'Stripe unit (in sectors)': %d (<0 || >%d)", currlogorg->stripeunit, currlogorg->blksperpart);
+      fprintf(stderr, "Invalid value for 'Stripe unit (in sectors)': %d (<0 || >%lld)", currlogorg->stripeunit, currlogorg->blksperpart);
    }
 
    if ((currlogorg->parityunit < 0) ||
@@ -1160,7 +1161,7 @@ void logorg_initialize (logorg **logorgs,
 	  logorgs[i]->maptype = ASIS;
 	  logorgs[i]->reduntype = PARITY_TABLE;
 	  logorgs[i]->blksperpart = 
-	    (int) ((double) 
+	    (disksim_lbn_t) ((double) 
 		   logorgs[i]->blksperpart * 
 		   (double) (logorgs[i]->numdisks - 1) / 
 		   (double) logorgs[i]->numdisks);
@@ -1168,7 +1169,7 @@ void logorg_initialize (logorg **logorgs,
 	} 
       else if (logorgs[i]->reduntype == PARITY_ROTATED) {
 	logorgs[i]->blksperpart = 
-	  (int) 
+	  (disksim_lbn_t) 
 	  ((double) 
 	   logorgs[i]->blksperpart * 
 	   (double) (logorgs[i]->numdisks - 1) / 
@@ -1210,7 +1211,7 @@ void logorg_initialize (logorg **logorgs,
 
       if (logorgs[i]->printinterferestats) {
          logorgs[i]->stat.lastreq = 
-	   DISKSIM_malloc(2 * INTERFEREMAX*sizeof(int));
+	   DISKSIM_malloc(2 * INTERFEREMAX*sizeof(disksim_lbn_t));
 
          for (j=0; j<(2*INTERFEREMAX); j++) {
             logorgs[i]->stat.lastreq[j] = 0;
@@ -151,7 +151,7 @@
 
 typedef struct dep {
    int    devno;
-   int    blkno;
+   disksim_lbn_t blkno;
    int    numdeps;
    struct dep *next;
    struct dep *cont;
@@ -164,7 +164,7 @@ typedef struct os {
    struct os *next;
    struct os *prev;
    u_int  bcount;
-   u_int  blkno;
+   disksim_lbn_t blkno;
    u_int  flags;
    u_int  busno;
    int    numreqs;
@@ -199,7 +199,7 @@ typedef struct {
    double       lastwrite;
    int          *blocked;
    int          *aligned;
-   int		*lastreq;
+   disksim_lbn_t *lastreq;
    int		*intdist;
    statgen      resptimestats;
    statgen	idlestats;
@@ -213,12 +213,12 @@ typedef struct {
 
 typedef struct {
    int    devno;
-   int    startblkno;
+   disksim_lbn_t startblkno;
    struct ioq * queue;
-   int    lastblkno;
+   disksim_lbn_t lastblkno;
    int    seqreads;
    int    seqwrites;
-   int    lastblkno2;
+   disksim_lbn_t lastblkno2;
    int    intreads;
    int    intwrites;
    int    numout;
@@ -230,7 +230,7 @@ typedef struct {
 
 typedef struct {
    int    devno;
-   int    blkno;
+   disksim_lbn_t blkno;
 } tableentry;
 
 typedef struct logorg {
@@ -250,8 +250,8 @@ typedef struct logorg {
    double rmwpoint;
    int    parityunit;
    int    rottype;
-   int    blksperpart;
-   int    actualblksperpart;
+   disksim_lbn_t blksperpart;
+   disksim_lbn_t actualblksperpart;
    int    stripeunit;
    int    sectionunit;
    int    tablestripes;
@@ -261,7 +261,7 @@ typedef struct logorg {
    int    idealno;
    int    reduntoggle;
    int    lastdiskaccessed;
-   int    numfull;
+   disksim_lbn_t numfull;
    int   *sizes;
    int   *redunsizes;
    int    printlocalitystats;
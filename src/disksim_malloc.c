@@ -85,3 +85,226 @@ void *DISKSIM_malloc (int size)
 
 }
 
+
+
+/* The checkpoint heap.  The disksim program links every allocation     */
+/* made by the simulator (see disksim_heap.c) to this allocator, which  */
+/* carves blocks out of one reserved range of address space at a fixed  */
+/* address.  Everything the simulation points to then lives either in   */
+/* that range or in the program's own data, so a checkpoint can write   */
+/* both out and a later run can map them back in at the same place      */
+/* (see disksim_checkpoint() and disksim_restore_from_checkpoint()).    */
+/*                                                                      */
+/* Blocks come in power-of-two sizes, with a 16-byte header holding     */
+/* the size class, and freed blocks are kept on one list per class.     */
+/* A mutex serializes the heap, for any helper threads that allocate.   */
+
+#ifdef SUPPORT_CHECKPOINTS
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define HEAP_BASE	((char *) 0x200000000000ULL)
+#define HEAP_RESERVE	((size_t) 1 << 36)
+#define HEAP_HDRSIZE	16
+#define HEAP_MINCLASS	5
+#define HEAP_CLASSES	48
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE	0
+#endif
+
+typedef union heap_block {
+   int    cls;			/* while allocated */
+   union heap_block *next;	/* while free */
+   char   pad[HEAP_HDRSIZE];
+} heap_block;
+
+/* These live in the program's data, so a checkpoint carries them too. */
+static char *heap_base = NULL;
+static char *heap_top = NULL;
+static char *heap_end = NULL;
+static int   heap_failed = FALSE;
+static heap_block *heap_free[HEAP_CLASSES];
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static char * heap_reserve (void)
+{
+   char *addr = mmap(HEAP_BASE, HEAP_RESERVE, (PROT_READ|PROT_WRITE), (MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE), -1, 0);
+
+   if (addr == MAP_FAILED) {
+      return(NULL);
+   }
+   if (addr != HEAP_BASE) {
+      munmap(addr, HEAP_RESERVE);
+      return(NULL);
+   }
+   return(addr);
+}
+
+
+static int heap_class (size_t size)
+{
+   int cls = HEAP_MINCLASS;
+
+   while ((cls < HEAP_CLASSES) && (((size_t) 1 << cls) < (size + HEAP_HDRSIZE))) {
+      cls++;
+   }
+   return(cls);
+}
+
+
+/* The heap_ functions below expect heap_lock to be held. */
+
+static void * heap_malloc (size_t size)
+{
+   int cls = heap_class(size);
+   heap_block *b;
+
+   if (heap_base == NULL) {
+      if (heap_failed || ((heap_base = heap_reserve()) == NULL)) {
+         heap_failed = TRUE;
+         return(NULL);
+      }
+      heap_top = heap_base;
+      heap_end = heap_base + HEAP_RESERVE;
+   }
+
+   if (cls >= HEAP_CLASSES) {
+      return(NULL);
+   }
+   if ((b = heap_free[cls]) != NULL) {
+      heap_free[cls] = b->next;
+   } else {
+      if ((size_t)(heap_end - heap_top) < ((size_t) 1 << cls)) {
+         return(NULL);
+      }
+      b = (heap_block *) heap_top;
+      heap_top += (size_t) 1 << cls;
+   }
+   b->cls = cls;
+   return(b + 1);
+}
+
+
+static void heap_release_block (void *ptr)
+{
+   heap_block *b = ((heap_block *) ptr) - 1;
+   int cls = b->cls;
+
+   b->next = heap_free[cls];
+   heap_free[cls] = b;
+}
+
+
+/* Returns NULL if the heap can't be set up or is full, in which case */
+/* the caller should fall back to the system allocator.               */
+
+void * disksim_heap_malloc (size_t size)
+{
+   void *ptr;
+
+   pthread_mutex_lock(&heap_lock);
+   ptr = heap_malloc(size);
+   pthread_mutex_unlock(&heap_lock);
+   return(ptr);
+}
+
+
+int disksim_heap_owns (void *ptr)
+{
+   return((heap_base != NULL) && ((char *)ptr >= heap_base) && ((char *)ptr < heap_top));
+}
+
+
+void disksim_heap_free (void *ptr)
+{
+   pthread_mutex_lock(&heap_lock);
+   heap_release_block(ptr);
+   pthread_mutex_unlock(&heap_lock);
+}
+
+
+/* ptr must belong to the heap */
+
+void * disksim_heap_realloc (void *ptr, size_t size)
+{
+   heap_block *b = ((heap_block *) ptr) - 1;
+   size_t oldsize = ((size_t) 1 << b->cls) - HEAP_HDRSIZE;
+   void *new;
+
+   if (size <= oldsize) {
+      return(ptr);
+   }
+   pthread_mutex_lock(&heap_lock);
+   if ((new = heap_malloc(size)) != NULL) {
+      memcpy(new, ptr, oldsize);
+      heap_release_block(ptr);
+   }
+   pthread_mutex_unlock(&heap_lock);
+   return(new);
+}
+
+
+/* Reports the part of the heap in use, or FALSE if nothing has been */
+/* allocated from it.                                                */
+
+int disksim_heap_extent (char **base, size_t *len)
+{
+   if (heap_base == NULL) {
+      return(FALSE);
+   }
+   *base = heap_base;
+   *len = heap_top - heap_base;
+   return(TRUE);
+}
+
+
+/* Gives back whatever heap this process has reserved, before a */
+/* checkpoint's program data (which includes the heap's own     */
+/* bookkeeping) is read over ours.                              */
+
+void disksim_heap_release (void)
+{
+   if (heap_base != NULL) {
+      munmap(heap_base, (heap_end - heap_base));
+   }
+   heap_base = NULL;
+}
+
+
+/* Maps a checkpoint's heap, len bytes at offset off in fd, back in */
+/* at the address it was written from; the heap's bookkeeping must  */
+/* already be the checkpoint's.  Returns -1 if that address range   */
+/* isn't free.                                                      */
+
+int disksim_heap_map (int fd, off_t off, size_t len)
+{
+   if (heap_base != HEAP_BASE) {
+      return(-1);
+   }
+   /* the lock came back with the checkpoint's data */
+   pthread_mutex_init(&heap_lock, NULL);
+   heap_base = NULL;
+   if ((heap_base = heap_reserve()) == NULL) {
+      return(-1);
+   }
+   if ((len > 0) && (mmap(heap_base, len, (PROT_READ|PROT_WRITE), (MAP_PRIVATE|MAP_FIXED), fd, off) != heap_base)) {
+      return(-1);
+   }
+   return(0);
+}
+
+#else  /* SUPPORT_CHECKPOINTS */
+
+void * disksim_heap_malloc (size_t size) { return(NULL); }
+int    disksim_heap_owns (void *ptr) { return(FALSE); }
+void   disksim_heap_free (void *ptr) { }
+void * disksim_heap_realloc (void *ptr, size_t size) { return(NULL); }
+int    disksim_heap_extent (char **base, size_t *len) { return(FALSE); }
+void   disksim_heap_release (void) { }
+int    disksim_heap_map (int fd, off_t off, size_t len) { return(-1); }
+
+#endif /* SUPPORT_CHECKPOINTS */
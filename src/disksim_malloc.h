@@ -58,10 +58,21 @@
 #ifndef DISKSIM_MALLOC_H
 #define DISKSIM_MALLOC_H
 
+#include <sys/types.h>
+
 /* To help with portability and checkpointing. */
 
 /* Get space within the pre-allocated range of space. */
 void * DISKSIM_malloc (int size);
 
+/* The checkpoint heap (see disksim_malloc.c and disksim_heap.c). */
+void * disksim_heap_malloc (size_t size);
+void * disksim_heap_realloc (void *ptr, size_t size);
+void   disksim_heap_free (void *ptr);
+int    disksim_heap_owns (void *ptr);
+int    disksim_heap_extent (char **base, size_t *len);
+void   disksim_heap_release (void);
+int    disksim_heap_map (int fd, off_t off, size_t len);
+
 #endif
 
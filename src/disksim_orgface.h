@@ -131,7 +131,7 @@ void  logorg_printstats (struct logorg **logorgs, int numlogorgs, char *sourcest
 void  logorg_cleanstats (struct logorg **logorgs, int numlogorgs);
 int   logorg_maprequest (struct logorg **logorgs, int numlogorgs, ioreq_event *curr);
 int   logorg_mapcomplete (struct logorg **logorgs, int numlogorgs, ioreq_event *curr);
-void  logorg_raise_priority (struct logorg **logorgs, int numlogorgs, int opid, int devno, int blkno, void *buf);
+void  logorg_raise_priority (struct logorg **logorgs, int numlogorgs, int opid, int devno, disksim_lbn_t blkno, void *buf);
 void  logorg_timestamp (ioreq_event *curr);
 
 #endif   /* DISKSIM_ORGFACE_H */
@@ -274,7 +274,7 @@ event * pf_io_done_notify (ioreq_event *curr, void *ctx)
    }
 
    if (pf_printhack) {
-     fprintf (outputfile, "pf_io_done_notify: curr->buf %p, curr->opid %x, curr->blkno %d\n", curr->buf, curr->opid, curr->blkno);
+     fprintf (outputfile, "pf_io_done_notify: curr->buf %p, curr->opid %x, curr->blkno %lld\n", curr->buf, curr->opid, curr->blkno);
    }
 
    ASSERT(pendiolist != NULL);
@@ -357,7 +357,7 @@ static int pf_iowait (void *chan, process *procp)
    }
 
 if (pf_printhack)
-fprintf (outputfile, "pf_iowait: chan %p, read %d, crit %d, opid %d, blkno %x\n", tmp->buf, (tmp->flags & READ), (tmp->flags & (TIME_LIMITED|TIME_CRITICAL)), tmp->opid, tmp->blkno);
+fprintf (outputfile, "pf_iowait: chan %p, read %d, crit %d, opid %d, blkno %llx\n", tmp->buf, (tmp->flags & READ), (tmp->flags & (TIME_LIMITED|TIME_CRITICAL)), tmp->opid, tmp->blkno);
 
    if (tmp->flags & TIME_LIMITED) {
       if (tmp->flags & READ) {
@@ -578,7 +578,7 @@ static void pf_handle_ioreq_event (ioreq_event *curr, cpu_event *cpu_ev)
    curr->next = NULL;
 
    if (pf_printhack)
-   fprintf (outputfile, "%f\tIOREQ cpu=%d opid=%d buf=%p blkno=%x flags=%x, bcount=%d\n", simtime, cpu_ev->cpunum, curr->opid, curr->buf, curr->blkno, curr->flags, curr->bcount);
+   fprintf (outputfile, "%f\tIOREQ cpu=%d opid=%d buf=%p blkno=%llx flags=%x, bcount=%d\n", simtime, cpu_ev->cpunum, curr->opid, curr->buf, curr->blkno, curr->flags, curr->bcount);
 
    curr->flags &= ~(TIMED_OUT|HALF_OUT); /* hack to help out ioqueue.c */
 
@@ -606,7 +606,7 @@ static void pf_handle_ioreq_event (ioreq_event *curr, cpu_event *cpu_ev)
 static void pf_handle_ioacc_event (ioreq_event *curr, cpu_event *cpu_ev)
 {
    if (pf_printhack)
-   fprintf (outputfile, "%f\tIOACC cpu=%d opid=%d blkno=%x\n", simtime, cpu_ev->cpunum, curr->opid, curr->blkno);
+   fprintf (outputfile, "%f\tIOACC cpu=%d opid=%d blkno=%llx\n", simtime, cpu_ev->cpunum, curr->opid, curr->blkno);
 
    io_schedule(curr);
 }
@@ -615,7 +615,7 @@ static void pf_handle_ioacc_event (ioreq_event *curr, cpu_event *cpu_ev)
 static void pf_handle_io_internal_event (ioreq_event *curr, cpu_event *cpu_ev)
 {
    if (pf_printhack)
-   fprintf (outputfile, "%f\tIO INTERNAL cpu=%d type %d opid=%d blkno=%x buf=%p\n", simtime, cpu_ev->cpunum, curr->type, curr->opid, curr->blkno, curr->buf);
+   fprintf (outputfile, "%f\tIO INTERNAL cpu=%d type %d opid=%d blkno=%llx buf=%p\n", simtime, cpu_ev->cpunum, curr->type, curr->opid, curr->blkno, curr->buf);
 
    if (curr->type == IO_REQUEST_ARRIVE) {
       ioreq_event *new = (ioreq_event *) io_request (curr);
@@ -181,6 +181,7 @@ typedef struct process {
 typedef struct {
    double      time;
    int         type;
+   int         intqpos;
    event      *next;
    event      *prev;
    int         cpunum;
@@ -215,6 +216,7 @@ typedef struct {
 typedef struct {
    double time;
    int    type;
+   int    intqpos;
    event * next;
    event * prev;
    int    vector;
@@ -223,6 +225,7 @@ typedef struct {
 typedef struct {
    double time;
    int    type;
+   int    intqpos;
    event * next;
    event * prev;
    process *newprocp;
@@ -231,6 +234,7 @@ typedef struct {
 typedef struct {
    double time;
    int    type;
+   int    intqpos;
    event * next;
    event * prev;
 } idleloop_event;
@@ -238,6 +242,7 @@ typedef struct {
 typedef struct {
    double time;
    int    type;
+   int    intqpos;
    event * next;
    event * prev;
    int    info;
@@ -249,6 +254,7 @@ typedef struct {
 typedef struct {
    double time;
    int    type;
+   int    intqpos;
    event * next;
    event * prev;
    int    info;
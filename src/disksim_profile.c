@@ -0,0 +1,320 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* Profiling of the simulator itself (see disksim_profile.h). */
+
+#include "disksim_global.h"
+#include "disksim_iosim.h"
+#include "disksim_profile.h"
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+/* Where it can, the profile counts CPU timestamp ticks, which are */
+/* cheaper to read than the clock, and converts them when printed  */
+/* by their rate over the whole run.                               */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PROFILE_TSC
+#endif
+
+#define PROFILE_TYPES	(SSD_MAX_EVENT + 1)
+
+/* timers, by the callback they go through */
+#define PROFILE_TIMER_WARMUP	0
+#define PROFILE_TIMER_IOQUEUE	1
+#define PROFILE_TIMER_CACHEMEM	2
+#define PROFILE_TIMER_CACHEDEV	3
+#define PROFILE_TIMER_TSERIES	4
+#define PROFILE_TIMER_OTHER	5
+#define PROFILE_TIMERS		6
+
+typedef struct profile_count {
+   double count;
+   double ticks;
+} profile_count;
+
+struct profile {
+   profile_count type[PROFILE_TYPES];
+   profile_count timer[PROFILE_TIMERS];
+   profile_count queue;		/* taking events off the event queue */
+   profile_count trace;		/* reading requests from the trace */
+   double        mark;		/* when the current charge started */
+   double        marktrace;	/* trace.ticks then */
+   double        openticks;	/* to convert ticks to nanoseconds */
+   double        openns;
+   int           intqmax;
+   int           eventsmax;
+};
+
+/* the I/O events, from IO_MIN_EVENT up (see disksim_iosim.h) */
+static char *profile_ionames[] = {
+   "IO_REQUEST_ARRIVE", "IO_ACCESS_ARRIVE", "IO_INTERRUPT_ARRIVE",
+   "IO_RESPOND_TO_DEVICE", "IO_ACCESS_COMPLETE", "IO_INTERRUPT_COMPLETE",
+   "DEVICE_OVERHEAD_COMPLETE", "DEVICE_ACCESS_COMPLETE",
+   "DEVICE_PREPARE_FOR_DATA_TRANSFER", "DEVICE_DATA_TRANSFER_COMPLETE",
+   "DEVICE_BUFFER_SEEKDONE", "DEVICE_BUFFER_TRACKACC_DONE",
+   "DEVICE_BUFFER_SECTOR_DONE", "DEVICE_GOT_REMAPPED_SECTOR",
+   "DEVICE_GOTO_REMAPPED_SECTOR", "BUS_OWNERSHIP_GRANTED",
+   "BUS_DELAY_COMPLETE", "CONTROLLER_DATA_TRANSFER_COMPLETE",
+   "TIMESTAMP_LOGORG", "IO_TRACE_REQUEST_START", "IO_QLEN_MAXCHECK",
+   "TIMER_EXPIRED", "CHECKPOINT", "STOP_SIM", "EXIT_DISKSIM"
+};
+
+static char *profile_timernames[PROFILE_TIMERS] = {
+   "warm-up", "queue idle detection", "cache flush", "cache device",
+   "interval statistics", "other"
+};
+
+
+static double profile_ns (void)
+{
+#ifndef _WIN32
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return(((double) ts.tv_sec * (double) NANO) + (double) ts.tv_nsec);
+#else
+   return((double) clock() * ((double) NANO / (double) CLOCKS_PER_SEC));
+#endif
+}
+
+
+static INLINE double profile_now (void)
+{
+#ifdef PROFILE_TSC
+   return((double) __rdtsc());
+#else
+   return(profile_ns());
+#endif
+}
+
+
+profile * profile_open (void)
+{
+   profile *p = calloc(1, sizeof(profile));
+
+   ASSERT(p != NULL);
+   p->openticks = profile_now();
+   p->openns = profile_ns();
+   return(p);
+}
+
+
+/* Charges the time since the last mark, less any trace reading in */
+/* it, to count and starts a new one.                              */
+
+static INLINE void profile_charge (profile *p, profile_count *count)
+{
+   double now = profile_now();
+
+   count->count++;
+   count->ticks += (now - p->mark) - (p->trace.ticks - p->marktrace);
+   p->mark = now;
+   p->marktrace = p->trace.ticks;
+}
+
+
+/* Only the first event needs a mark of its own; each one after that */
+/* starts where the one before it was charged.                       */
+
+void profile_start (profile *p)
+{
+   if (p->mark == 0.0) {
+      p->mark = profile_now();
+      p->marktrace = p->trace.ticks;
+   }
+}
+
+
+void profile_dequeued (profile *p)
+{
+   profile_charge(p, &p->queue);
+}
+
+
+void profile_handled (profile *p, int type, void *func)
+{
+   int timer = PROFILE_TIMER_OTHER;
+
+   if ((type < 0) || (type >= PROFILE_TYPES)) {
+      type = NULL_EVENT;
+   }
+   if (type == TIMER_EXPIRED) {
+      if (func == &disksim->timerfunc_disksim) {
+         timer = PROFILE_TIMER_WARMUP;
+      } else if (func == &disksim->timerfunc_ioqueue) {
+         timer = PROFILE_TIMER_IOQUEUE;
+      } else if (func == &disksim->timerfunc_cachemem) {
+         timer = PROFILE_TIMER_CACHEMEM;
+      } else if (func == &disksim->timerfunc_cachedev) {
+         timer = PROFILE_TIMER_CACHEDEV;
+      } else if (func == &disksim->timerfunc_tseries) {
+         timer = PROFILE_TIMER_TSERIES;
+      }
+      profile_charge(p, &p->timer[timer]);
+   } else {
+      profile_charge(p, &p->type[type]);
+   }
+   if (disksim->intqlen > p->intqmax) {
+      p->intqmax = disksim->intqlen;
+   }
+   if (disksim->poolstat[DISKSIM_POOL_EVENT].live > p->eventsmax) {
+      p->eventsmax = disksim->poolstat[DISKSIM_POOL_EVENT].live;
+   }
+}
+
+
+double profile_trace_start (profile *p)
+{
+   return(profile_now());
+}
+
+
+void profile_trace_done (profile *p, double start)
+{
+   p->trace.count++;
+   p->trace.ticks += profile_now() - start;
+}
+
+
+void profile_restore (profile *p)
+{
+   p->mark = 0.0;
+   p->openticks = profile_now();
+   p->openns = profile_ns();
+}
+
+
+static char * profile_module (int type)
+{
+   if ((type >= PF_MIN_EVENT) && (type <= PF_MAX_EVENT)) {
+      return("process-flow");
+   } else if ((type == INTR_EVENT) || (type == INTEND_EVENT)) {
+      return("interrupt");
+   } else if ((type >= DEVICE_OVERHEAD_COMPLETE) && (type <= DEVICE_GOTO_REMAPPED_SECTOR)) {
+      return("device");
+   } else if ((type == BUS_OWNERSHIP_GRANTED) || (type == BUS_DELAY_COMPLETE)) {
+      return("bus");
+   } else if (type == CONTROLLER_DATA_TRANSFER_COMPLETE) {
+      return("controller");
+   } else if (type == TIMESTAMP_LOGORG) {
+      return("logorg");
+   } else if ((type >= IO_MIN_EVENT) && (type <= IO_MAX_EVENT)) {
+      return("iodriver");
+   } else if ((type >= MEMS_MIN_EVENT) && (type <= MEMS_MAX_EVENT)) {
+      return("mems");
+   } else if ((type >= SSD_MIN_EVENT) && (type <= SSD_MAX_EVENT)) {
+      return("ssd");
+   }
+   return("disksim");
+}
+
+
+static void profile_print_count (char *module, char *name, profile_count *count, double total, double nspertick)
+{
+   double ns = count->ticks * nspertick;
+
+   if (count->count == 0) {
+      return;
+   }
+   fprintf(outputfile, "Profile %s %s:\t%.0f\t%f\t%f\t%f\n", module, name, count->count,
+           (ns / (double) MICRO), (ns / count->count),
+           ((total > 0.0) ? (count->ticks / total) : 0.0));
+}
+
+
+/* One line per event type, then per module: events handled, host   */
+/* milliseconds, nanoseconds per event and share of the total.       */
+
+void profile_print (profile *p)
+{
+   char *modules[] = { "process-flow", "interrupt", "iodriver", "device", "bus", "controller", "logorg", "mems", "ssd", "disksim" };
+   int nmodules = sizeof(modules) / sizeof(char *);
+   profile_count sum;
+   double total = p->queue.ticks + p->trace.ticks;
+   double nspertick = 1.0;
+   char name[40];
+   int i, m;
+
+   for (i=0; i<PROFILE_TYPES; i++) {
+      total += p->type[i].ticks;
+   }
+   for (i=0; i<PROFILE_TIMERS; i++) {
+      total += p->timer[i].ticks;
+   }
+#ifdef PROFILE_TSC
+   if (profile_now() > p->openticks) {
+      nspertick = (profile_ns() - p->openns) / (profile_now() - p->openticks);
+   }
+#endif
+
+   fprintf(outputfile, "\nSIMULATOR PROFILE\n");
+   fprintf(outputfile, "-----------------\n\n");
+   fprintf(outputfile, "Profile host time (ms):\t%f\n", ((total * nspertick) / (double) MICRO));
+   fprintf(outputfile, "Profile event queue high-water mark:\t%d\n", p->intqmax);
+   fprintf(outputfile, "Profile events allocated high-water mark:\t%d\n", p->eventsmax);
+   fprintf(outputfile, "Profile columns:\tcount\tms\tns per event\tshare\n");
+   profile_print_count("disksim", "event queue", &p->queue, total, nspertick);
+   profile_print_count("iosim", "trace reading", &p->trace, total, nspertick);
+   for (i=0; i<PROFILE_TYPES; i++) {
+      if (i == TIMER_EXPIRED) {
+         for (m=0; m<PROFILE_TIMERS; m++) {
+            sprintf(name, "%s timer", profile_timernames[m]);
+            profile_print_count("disksim", name, &p->timer[m], total, nspertick);
+         }
+      } else if ((i >= IO_MIN_EVENT) && (i <= EXIT_DISKSIM)) {
+         profile_print_count(profile_module(i), profile_ionames[(i - IO_MIN_EVENT)], &p->type[i], total, nspertick);
+      } else {
+         sprintf(name, "event %d", i);
+         profile_print_count(profile_module(i), name, &p->type[i], total, nspertick);
+      }
+   }
+   for (m=0; m<nmodules; m++) {
+      sum.count = 0;
+      sum.ticks = 0.0;
+      for (i=0; i<PROFILE_TYPES; i++) {
+         if (strcmp(profile_module(i), modules[m]) == 0) {
+            sum.count += p->type[i].count;
+            sum.ticks += p->type[i].ticks;
+         }
+      }
+      if (strcmp(modules[m], "disksim") == 0) {
+         for (i=0; i<PROFILE_TIMERS; i++) {
+            sum.count += p->timer[i].count;
+            sum.ticks += p->timer[i].ticks;
+         }
+      }
+      profile_print_count(modules[m], "total", &sum, total, nspertick);
+   }
+   fprintf(outputfile, "\n");
+}
@@ -0,0 +1,67 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#ifndef DISKSIM_PROFILE_H
+#define DISKSIM_PROFILE_H
+
+/* Profiling of the simulator itself ("Profile simulator events").  The */
+/* host time spent handling each event is charged to the event's type  */
+/* (timers to whoever set them), the time taken to pull events off the */
+/* event queue to the queue, and the time spent reading the trace to   */
+/* the trace, less any of it spent inside the other two.  Each event's */
+/* time runs from where the last one's ended, so any time between      */
+/* calls to disksim_simulate_event() counts as event queue time.  The  */
+/* largest event queue and number of events allocated are noted as     */
+/* well.  The profile covers the whole run, warm-up included, and is   */
+/* printed with the statistics.                                         */
+
+typedef struct profile profile;
+
+profile * profile_open (void);
+
+/* starts timing events, if not already started */
+void profile_start (profile *p);
+
+/* the event of the given type (and timer function, for timers) has */
+/* been taken off the queue, and next has been handled              */
+void profile_dequeued (profile *p);
+void profile_handled (profile *p, int type, void *func);
+
+/* brackets reading a request from the trace */
+double profile_trace_start (profile *p);
+void profile_trace_done (profile *p, double start);
+
+/* after a checkpoint restore, in a new process */
+void profile_restore (profile *p);
+
+void profile_print (profile *p);
+
+#endif    /* DISKSIM_PROFILE_H */
@@ -168,9 +168,9 @@ static void logorg_parity_rotate_random (logorg *currlogorg, ioreq_event *curr)
 static int logorg_shadowed_get_short_dist (logorg *currlogorg, ioreq_event *curr, int numtocheck, int *checklist)
 {
    int i, j;
-   int dist;
+   disksim_lbn_t dist;
    int shortdev = -1;
-   int shortdist = 999999999;
+   disksim_lbn_t shortdist = -1;
    int ties[MAXCOPIES];
    int no;
 
@@ -178,10 +178,6 @@ static int logorg_shadowed_get_short_dist (logorg *currlogorg, ioreq_event *curr
    for (i = 0; i < numtocheck; i++) {
       no = checklist[i];
       dist = ioqueue_get_dist(currlogorg->devs[(curr->devno + (no * currlogorg->numdisks))].queue, (curr->blkno + currlogorg->devs[(curr->devno + (no * currlogorg->numdisks))].startblkno));
-      if (dist >= 999999999) {
-	 fprintf(stderr, "Haven't allowed for large enough 'dist's in logorg_shadowed_get_short_dist - %d\n", dist);
-	 exit(1);
-      }
       if (dist == shortdist) {
 	 j++;
 	 if (j >= MAXCOPIES) {
@@ -190,7 +186,7 @@ static int logorg_shadowed_get_short_dist (logorg *currlogorg, ioreq_event *curr
 	 }
 	 ties[j] = no;
       }
-      if (dist < shortdist) {
+      if ((shortdist < 0) || (dist < shortdist)) {
 	 shortdist = dist;
 	 shortdev = no;
 	 j = -1;
@@ -363,14 +359,14 @@ int logorg_parity_disk (logorg *currlogorg, ioreq_event *curr, int numreqs)
 static int logorg_parity_rotate_updates (logorg *currlogorg, ioreq_event *curr, int inc)
 {
    int reqs = 2;
-   int parityno;
+   disksim_lbn_t parityno;
    int blksleft;
    int bcount;
    ioreq_event *newreq;
    int parityunit;
    int numdisks;
    int devno;
-   int parityblock;
+   disksim_lbn_t parityblock;
 
    parityunit = currlogorg->parityunit;
    numdisks = currlogorg->numdisks;
@@ -379,16 +375,16 @@ static int logorg_parity_rotate_updates (logorg *currlogorg, ioreq_event *curr,
    parityno = (curr->blkno % (parityunit * (numdisks - 1))) / parityunit;
    curr->blkno += parityblock * parityunit;
    if (inc == -1) {
-      devno = numdisks - (parityno % numdisks) - 1;
+      devno = numdisks - (int) (parityno % numdisks) - 1;
    } else {
-      devno = parityno % numdisks;
+      devno = (int) (parityno % numdisks);
    }
    if (((inc == 1) && (curr->devno <= devno)) || ((inc == -1) && (curr->devno >=devno))) {
       curr->blkno += parityunit;
       devno = logorg_modulus_update(inc, devno, numdisks);
       parityno++;
    }
-   blksleft = parityunit - (curr->blkno % currlogorg->parityunit);
+   blksleft = parityunit - (int) (curr->blkno % currlogorg->parityunit);
    bcount = curr->bcount;
    if ((parityunit != currlogorg->parityunit) && ((bcount > blksleft) || (parityunit > currlogorg->parityunit))) {
       fprintf(stderr, "Failed integrity check in logorg_parity_rotate_left\n");
@@ -564,23 +560,23 @@ static int logorg_join_seqreqs (ioreq_event *reqlist, ioreq_event *curr, int seq
    ioreq_event *temp;
    ioreq_event *del;
    int numreqs = 0;
-   int distance;
+   disksim_lbn_t distance;
 
    temp = reqlist;
    if (temp) {
       while (temp->next) {
 	 distance = temp->next->blkno - temp->blkno - temp->bcount;
 /*
-fprintf (outputfile, "In logorg_join_seqreqs, devno %d, blkno %d, bcount %d, read %d, distance %d\n", temp->devno, temp->blkno, temp->bcount, (temp->flags & READ), distance);
+fprintf (outputfile, "In logorg_join_seqreqs, devno %d, blkno %lld, bcount %d, read %d, distance %lld\n", temp->devno, temp->blkno, temp->bcount, (temp->flags & READ), distance);
 */
          if (distance < 0) {
-            fprintf(stderr, "Integrity check failure at logorg_join_seqreqs - blkno %d, bcount %d, blkno %d, read %d\n", temp->blkno, temp->bcount, temp->next->blkno, (temp->flags & READ));
+            fprintf(stderr, "Integrity check failure at logorg_join_seqreqs - blkno %lld, bcount %d, blkno %lld, read %d\n", temp->blkno, temp->bcount, temp->next->blkno, (temp->flags & READ));
             exit(1);
          }
          if (((temp->flags & READ) == (temp->next->flags & READ)) && (distance <= seqgive)) {
             del = temp->next;
             temp->next = del->next;
-            temp->bcount += del->bcount + distance;
+            temp->bcount += del->bcount + (int) distance;
 	    temp->opid |= del->opid;
             addtoextraq((event *) del);
          } else {
@@ -634,6 +630,7 @@ static void logorg_parity_table_read_old (logorg *currlogorg, ioreq_event *rowhe
       newreq->devno = temp->devno;
       newreq->bcount = temp->bcount;
       newreq->flags = temp->flags | READ;
+      newreq->cause = temp->cause;
       newreq->opid = opid;
       logorg_parity_table_insert(&reqlist[newreq->devno], newreq);
       newreq->prev = prev;
@@ -647,17 +644,17 @@ static void logorg_parity_table_read_old (logorg *currlogorg, ioreq_event *rowhe
 }
 
 
-static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead, ioreq_event **reqlist, int stripeno, int unitno, int tableadd, int opid)
+static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead, ioreq_event **reqlist, int stripeno, int unitno, disksim_lbn_t tableadd, int opid)
 {
    ioreq_event *temp;
    ioreq_event *newreq;
    int entryno;
-   int minblkno;
-   int maxblkno;
+   disksim_lbn_t minblkno;
+   disksim_lbn_t maxblkno;
    int lastentry;
    int i;
-   int blkno;
-   int offset;
+   disksim_lbn_t blkno;
+   disksim_lbn_t offset;
 
    temp = rowhead;
    if (temp == NULL) {
@@ -676,8 +673,9 @@ static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead,
       newreq = (ioreq_event *) getfromextraq();
       newreq->devno = currlogorg->table[entryno].devno;
       newreq->blkno = tableadd + minblkno + currlogorg->table[entryno].blkno;
-      newreq->bcount = maxblkno - minblkno;
+      newreq->bcount = (int) (maxblkno - minblkno);
       newreq->flags = rowhead->flags | READ;
+      newreq->cause = rowhead->cause;
       newreq->opid = opid;
       logorg_parity_table_insert(&reqlist[newreq->devno], newreq);
       entryno++;
@@ -690,8 +688,9 @@ static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead,
          newreq = (ioreq_event *) getfromextraq();
          newreq->devno = temp->devno;
          newreq->blkno = tableadd + blkno + minblkno;
-         newreq->bcount = offset - minblkno;
+         newreq->bcount = (int) (offset - minblkno);
          newreq->flags = temp->flags | READ;
+         newreq->cause = temp->cause;
 	 newreq->opid = opid;
          logorg_parity_table_insert(&reqlist[newreq->devno], newreq);
       }
@@ -699,8 +698,9 @@ static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead,
          newreq = (ioreq_event *) getfromextraq();
          newreq->devno = temp->devno;
          newreq->blkno = temp->blkno + temp->bcount;
-         newreq->bcount = maxblkno - offset - temp->bcount;
+         newreq->bcount = (int) (maxblkno - offset) - temp->bcount;
          newreq->flags = temp->flags | READ;
+         newreq->cause = temp->cause;
 	 newreq->opid = opid;
          logorg_parity_table_insert(&reqlist[newreq->devno], newreq);
       }
@@ -711,8 +711,9 @@ static void logorg_parity_table_recon (logorg *currlogorg, ioreq_event *rowhead,
       newreq = (ioreq_event *) getfromextraq();
       newreq->devno = currlogorg->table[entryno].devno;
       newreq->blkno = tableadd + minblkno + currlogorg->table[entryno].blkno;
-      newreq->bcount = maxblkno - minblkno;
+      newreq->bcount = (int) (maxblkno - minblkno);
       newreq->flags = rowhead->flags | READ;
+      newreq->cause = rowhead->cause;
       newreq->opid = opid;
       logorg_parity_table_insert(&reqlist[newreq->devno], newreq);
    }
@@ -902,8 +903,9 @@ int logorg_parity_table (logorg *currlogorg, ioreq_event *curr, int numreqs)
    ioreq_event *newreq;
    int unitno;
    int stripeno;
+   disksim_lbn_t unit;
    int entryno;
-   int blkno;
+   disksim_lbn_t blkno;
    int blksinpart;
    int reqsize;
    int partsperstripe;
@@ -912,10 +914,10 @@ int logorg_parity_table (logorg *currlogorg, ioreq_event *curr, int numreqs)
    int opid = 0x1;
    int blkscovered;
    tableentry *table;
-   int tablestart;
+   disksim_lbn_t tablestart;
    int preventryno;
 /*
-fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %d, read %d\n", curr->devno, curr->blkno, curr->bcount, (curr->flags & READ));
+fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %lld, bcount %d, read %d\n", curr->devno, curr->blkno, curr->bcount, (curr->flags & READ));
 */
    if (numreqs != 1) {
       fprintf(stderr, "Multiple numreqs at logorg_parity_table is not acceptable - %d\n", numreqs);
@@ -931,32 +933,31 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
    for (i=0; i<currlogorg->actualnumdisks; i++) {
       reqs[i] = NULL;
    }
-   unitno = curr->blkno / stripeunit;
-   stripeno = unitno / partsperstripe;
-   tablestart = (stripeno / currlogorg->tablestripes) * currlogorg->tablesize;
-   stripeno = stripeno % currlogorg->tablestripes;
+   unit = curr->blkno / stripeunit;
+   tablestart = ((unit / partsperstripe) / currlogorg->tablestripes) * currlogorg->tablesize;
+   stripeno = (int) ((unit / partsperstripe) % currlogorg->tablestripes);
    blkno = tablestart + table[(stripeno*(partsperstripe+1))].blkno;
    if (blkno == currlogorg->numfull) {
-      stripeunit = currlogorg->actualblksperpart - blkno;
+      stripeunit = (int) (currlogorg->actualblksperpart - blkno);
       curr->blkno -= blkno;
-      unitno = curr->blkno / stripeunit;
+      unit = curr->blkno / stripeunit;
    }
    blksinpart = stripeunit;
-   unitno = unitno % partsperstripe;
+   unitno = (int) (unit % partsperstripe);
    curr->blkno = curr->blkno % stripeunit;
    reqsize = curr->bcount;
    entryno = stripeno * partsperstripe + stripeno + unitno;
    blkno = tablestart + table[entryno].blkno;
-   blksinpart -= curr->blkno;
+   blksinpart -= (int) curr->blkno;
    temp = ioreq_copy(curr);
    curr->next = temp;
    temp->blkno = blkno + curr->blkno;
    temp->devno = table[entryno].devno;
    temp->opid = 0;
    blkscovered = curr->bcount;
-   curr->blkno = stripeno;
+   curr->blkno = tablestart;
    curr->devno = unitno;
-   curr->bcount = tablestart;
+   curr->bcount = stripeno;
    reqs[temp->devno] = curr->next;
    temp->next = NULL;
    temp->prev = NULL;
@@ -973,6 +974,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
 	    newreq->blkno += tablestart + temp->blkno - blkno;
 	    newreq->bcount = blkscovered;
 	    newreq->flags = curr->flags;
+	    newreq->cause = curr->cause;
             newreq->opid = 0;
 	    reqs[newreq->devno] = newreq;
 	    newreq->next = NULL;
@@ -994,7 +996,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
       }
       entryno = (stripeno * partsperstripe) + stripeno + unitno;
       blkno = tablestart + table[entryno].blkno;
-      blksinpart = (blkno != currlogorg->numfull) ? stripeunit : currlogorg->actualblksperpart - blkno;
+      blksinpart = (blkno != currlogorg->numfull) ? stripeunit : (int) (currlogorg->actualblksperpart - blkno);
       while (reqsize > blksinpart) {
 	 rowcnt++;
 	 newreq = (ioreq_event *) getfromextraq();
@@ -1003,6 +1005,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
 	 newreq->bcount = blksinpart;
 	 blkscovered = max(blkscovered, blksinpart);
 	 newreq->flags = curr->flags;
+	 newreq->cause = curr->cause;
          newreq->opid = 0;
 	 newreq->prev = NULL;
 	 if (temp) {
@@ -1021,6 +1024,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
 	       newreq->blkno = table[(entryno+1)].blkno + tablestart;
 	       newreq->bcount = blkscovered;
 	       newreq->flags = curr->flags;
+	       newreq->cause = curr->cause;
                newreq->opid = 0;
                temp->prev = newreq;
 	       newreq->prev = NULL;
@@ -1041,7 +1045,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
          }
          entryno = (stripeno * partsperstripe) + stripeno + unitno;
          blkno = tablestart + table[entryno].blkno;
-         blksinpart = (blkno != currlogorg->numfull) ? stripeunit : currlogorg->actualblksperpart - blkno;
+         blksinpart = (blkno != currlogorg->numfull) ? stripeunit : (int) (currlogorg->actualblksperpart - blkno);
       }
       newreq = (ioreq_event *) getfromextraq();
       newreq->blkno = blkno;
@@ -1050,6 +1054,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
       rowcnt++;
       blkscovered = max(blkscovered, blksinpart);
       newreq->flags = curr->flags;
+      newreq->cause = curr->cause;
       newreq->opid = 0;
       newreq->prev = NULL;
       if (temp) {
@@ -1073,6 +1078,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
       newreq->blkno = table[entryno].blkno + temp->blkno - table[preventryno].blkno;
       newreq->bcount = (rowcnt == 1) ? temp->bcount : blkscovered;
       newreq->flags = curr->flags;
+      newreq->cause = curr->cause;
       newreq->opid = 0;
       temp->prev = newreq;
       newreq->prev = NULL;
@@ -1087,6 +1093,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
 	    newreq->blkno = table[entryno].blkno + temp->blkno - table[(preventryno-1)].blkno;
 	    newreq->bcount = temp->bcount;
 	    newreq->flags = curr->flags;
+	    newreq->cause = curr->cause;
 	    newreq->opid = 0;
 	    temp->prev = newreq;
 	    newreq->prev = NULL;
@@ -1105,7 +1112,7 @@ fprintf (outputfile, "Entered logorg_parity_table - devno %d, blkno %d, bcount %
 	 if (firstrow < currlogorg->rmwpoint) {
 	    logorg_parity_table_read_old(currlogorg, curr->next, redunreqs, opid);
 	 } else {
-	    logorg_parity_table_recon(currlogorg, curr->next, redunreqs, curr->blkno, curr->devno, curr->bcount, opid);
+	    logorg_parity_table_recon(currlogorg, curr->next, redunreqs, curr->bcount, curr->devno, curr->blkno, opid);
 	 }
 	 opid = opid << 1;
       }
@@ -1156,7 +1163,7 @@ static void logorg_create_table_left_sym (logorg *currlogorg)
    int numdisks;
    int stripeno = 0;
    int devno = 0;
-   int blkno = 0;
+   disksim_lbn_t blkno = 0;
    int parityno;
 
    numdisks = currlogorg->numdisks;
@@ -1227,7 +1234,7 @@ void logorg_create_table (logorg *currlogorg)
    }
 /*
    for (i=0; i<(currlogorg->tablestripes * numdisks); i++) {
-      fprintf (outputfile, "tableentry #%d: devno %d, blkno %d\n", i, currlogorg->table[i].devno, currlogorg->table[i].blkno);
+      fprintf (outputfile, "tableentry #%d: devno %d, blkno %lld\n", i, currlogorg->table[i].devno, currlogorg->table[i].blkno);
    }
 */
 }
@@ -428,7 +428,7 @@ static void simpledisk_request_arrive (ioreq_event *curr)
    /* verify that request is valid. */
    if ((curr->blkno < 0) || (curr->bcount <= 0) ||
        ((curr->blkno + curr->bcount) > currdisk->numblocks)) {
-      fprintf(stderr, "Invalid set of blocks requested from simpledisk - blkno %d, bcount %d, numblocks %d\n", curr->blkno, curr->bcount, currdisk->numblocks);
+      fprintf(stderr, "Invalid set of blocks requested from simpledisk - blkno %lld, bcount %d, numblocks %lld\n", curr->blkno, curr->bcount, currdisk->numblocks);
       exit(1);
    }
 
@@ -628,7 +628,7 @@ void simpledisk_event_arrive (ioreq_event *curr)
 }
 
 
-int simpledisk_get_number_of_blocks (int devno)
+disksim_lbn_t simpledisk_get_number_of_blocks (int devno)
 {
    simpledisk_t *currdisk = getsimpledisk (devno);
    return (currdisk->numblocks);
@@ -638,21 +638,21 @@ int simpledisk_get_number_of_blocks (int devno)
 int simpledisk_get_numcyls (int devno)
 {
    simpledisk_t *currdisk = getsimpledisk (devno);
-   return (currdisk->numblocks);
+   return ((int) currdisk->numblocks);
 }
 
 
-void simpledisk_get_mapping (int maptype, int devno, int blkno, int *cylptr, int *surfaceptr, int *blkptr)
+void simpledisk_get_mapping (int maptype, int devno, disksim_lbn_t blkno, int *cylptr, int *surfaceptr, int *blkptr)
 {
    simpledisk_t *currdisk = getsimpledisk (devno);
 
    if ((blkno < 0) || (blkno >= currdisk->numblocks)) {
-      fprintf(stderr, "Invalid blkno at simpledisk_get_mapping: %d\n", blkno);
+      fprintf(stderr, "Invalid blkno at simpledisk_get_mapping: %lld\n", blkno);
       exit(1);
    }
 
    if (cylptr) {
-      *cylptr = blkno;
+      *cylptr = (int) blkno;
    }
    if (surfaceptr) {
       *surfaceptr = 0;
@@ -669,7 +669,7 @@ int simpledisk_get_avg_sectpercyl (int devno)
 }
 
 
-int simpledisk_get_distance (int devno, ioreq_event *req, int exact, int direction)
+int simpledisk_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction)
 {
    /* just return an arbitrary constant, since acctime is constant */
    return 1;
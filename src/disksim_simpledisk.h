@@ -82,15 +82,15 @@ int     simpledisk_get_depth (int devno);
 int     simpledisk_get_inbus (int devno);
 int     simpledisk_get_busno (ioreq_event *curr);
 int     simpledisk_get_slotno (int devno);
-int     simpledisk_get_number_of_blocks (int devno);
+disksim_lbn_t simpledisk_get_number_of_blocks (int devno);
 int     simpledisk_get_maxoutstanding (int devno);
 int     simpledisk_get_numdisks (void);
 int     simpledisk_get_numcyls (int devno);
 double  simpledisk_get_blktranstime (ioreq_event *curr);
 int     simpledisk_get_avg_sectpercyl (int devno);
-void    simpledisk_get_mapping (int maptype, int devno, int blkno, int *cylptr, int *surfaceptr, int *blkptr);
+void    simpledisk_get_mapping (int maptype, int devno, disksim_lbn_t blkno, int *cylptr, int *surfaceptr, int *blkptr);
 void    simpledisk_event_arrive (ioreq_event *curr);
-int     simpledisk_get_distance (int devno, ioreq_event *req, int exact, int direction);
+int     simpledisk_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction);
 double  simpledisk_get_servtime (int devno, ioreq_event *req, int checkcache, double maxtime);
 double  simpledisk_get_acctime (int devno, ioreq_event *req, double maxtime);
 void    simpledisk_bus_delay_complete (int devno, ioreq_event *curr, int sentbusno);
@@ -116,7 +116,7 @@ typedef struct simpledisk {
    double acctime;
    double overhead;
    double bus_transaction_latency;
-   int numblocks;
+   disksim_lbn_t numblocks;
    int devno;
    int inited;
    struct ioq *queue;
@@ -127,6 +127,92 @@ double stat_get_runval (statgen *statptr)
 }
 
 
+/* Percentiles (see disksim_stat.h). */
+
+static double stat_percentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+
+static INLINE int stat_hdr_index (statgen *statptr, double value)
+{
+   int exp;
+   double frac = frexp(value, &exp);	/* value = frac * 2^exp, 0.5 <= frac < 1 */
+
+   exp -= STAT_HDR_MINEXP + 1;
+   if ((value <= 0.0) || (exp < 0)) {
+      return(0);
+   }
+   if (exp >= STAT_HDR_EXPS) {
+      return(STAT_HDR_BUCKETS(statptr->hdrsubs) - 1);
+   }
+   return(1 + (exp * statptr->hdrsubs) + (int) (((2.0 * frac) - 1.0) * (double) statptr->hdrsubs));
+}
+
+
+/* Returns the pct-th percentile of a set of stats with percentiles,   */
+/* as the top of the bucket it falls in (so within the precision asked */
+/* for above the true value), or 0 for the bucket below 2^MINEXP, kept */
+/* within the minimum and maximum seen.                                 */
+
+double stat_get_percentile_set (statgen **statset, int statcnt, double pct)
+{
+   int subs = statset[0]->hdrsubs;
+   int buckets = STAT_HDR_BUCKETS(subs);
+   double count = 0.0;
+   double maxval = 0.0;
+   double minval = 0.0;
+   double seen = 0.0;
+   double rank;
+   double val;
+   int i, j;
+
+   for (j=0; j<statcnt; j++) {
+      if (statset[j]->count == 0) {
+         continue;
+      }
+      minval = (count == 0.0) ? statset[j]->minval : min(minval, statset[j]->minval);
+      count += (double) statset[j]->count;
+      maxval = max(maxval, statset[j]->maxval);
+   }
+   if ((statset[0]->hdrvals == NULL) || (count == 0.0)) {
+      return(0.0);
+   }
+   rank = max(ceil((pct * count / 100.0) - 0.000001), 1.0);
+   for (i=0; i<buckets; i++) {
+      for (j=0; j<statcnt; j++) {
+         seen += (double) statset[j]->hdrvals[i];
+      }
+      if (seen >= rank) {
+         break;
+      }
+   }
+   val = 0.0;
+   if (i > 0) {
+      i--;
+      val = ldexp((1.0 + ((double) ((i % subs) + 1) / (double) subs)), (STAT_HDR_MINEXP + (i / subs)));
+   }
+   return(max(min(val, maxval), minval));
+}
+
+
+double stat_get_percentile (statgen *statptr, double pct)
+{
+   return(stat_get_percentile_set(&statptr, 1, pct));
+}
+
+
+static void stat_print_percentiles (statgen **statset, int statcnt, int count, char *identstr, FILE *outfile)
+{
+   int pcts = sizeof(stat_percentiles) / sizeof(double);
+   int p;
+
+   if ((statset[0]->hdrvals == NULL) || (count == 0)) {
+      return;
+   }
+   for (p=0; p<pcts; p++) {
+      fprintf(outfile, "%s%s %gth percentile:\t%f\n", identstr, statset[0]->statdesc, stat_percentiles[p], stat_get_percentile_set(statset, statcnt, stat_percentiles[p]));
+   }
+}
+
+
 void stat_update (statgen *statptr, double value)
 {
    int  i = 0;
@@ -141,8 +227,14 @@ void stat_update (statgen *statptr, double value)
    if (statptr->maxval < value) {
       statptr->maxval = value;
    }
+   if ((statptr->count == 1) || (statptr->minval > value)) {
+      statptr->minval = value;
+   }
    statptr->runval += value;
    statptr->runsquares += (value*value);
+   if (statptr->hdrvals) {
+      statptr->hdrvals[stat_hdr_index(statptr, value)]++;
+   }
    if (buckets > DISTSIZE) {
       if (intval < start) {
       } else if (!grow) {
@@ -235,6 +327,164 @@ static void stat_print_large_dist (statgen **statset, int statcnt, int count, ch
 }
 
 
+/* Statistics in JSON.  While a file is open, every statistic printed */
+/* is also written to it as one record of the "statistics" array:     */
+/*                                                                      */
+/*    {"scope": <identstr>, "name": <statdesc>, "count": ...,          */
+/*     "average": ..., "stddev": ..., "maximum": ...,                  */
+/*     "percentiles": {"50": ..., ...},                                */
+/*     "distribution": {"bounds": [...], "exact": n, "counts": [...]}} */
+/*                                                                      */
+/* The first n bounds are values counted exactly, the rest exclusive   */
+/* upper bounds, and the last count is of everything above.  Large     */
+/* distributions give the "starts" of their buckets instead.  Plain    */
+/* values (stat_json_value) have a "value" in place of all but the     */
+/* scope and name.  Values that are not finite are written as null.    */
+
+#define stat_jsonfile	(disksim->statjsonfile)
+#define stat_jsoncnt	(disksim->statjsoncnt)
+
+int stat_json_open (char *filename)
+{
+   if ((stat_jsonfile = fopen(filename, "w")) == NULL) {
+      return(-1);
+   }
+   stat_jsoncnt = 0;
+   fprintf(stat_jsonfile, "{\"statistics\": [");
+   return(0);
+}
+
+
+int stat_json_close (void)
+{
+   int error;
+
+   if (stat_jsonfile == NULL) {
+      return(0);
+   }
+   fprintf(stat_jsonfile, "\n]}\n");
+   error = (fclose(stat_jsonfile) != 0);
+   stat_jsonfile = NULL;
+   return(error);
+}
+
+
+/* the scope is the prefix of the text output, without its trailing blanks */
+
+static void stat_json_string (char *str, int trim)
+{
+   int len = strlen(str);
+   int i;
+
+   if (trim) {
+      while ((len > 0) && (str[(len-1)] == ' ')) {
+         len--;
+      }
+   }
+   fputc('"', stat_jsonfile);
+   for (i=0; i<len; i++) {
+      if ((str[i] == '"') || (str[i] == '\\')) {
+         fputc('\\', stat_jsonfile);
+         fputc(str[i], stat_jsonfile);
+      } else if ((unsigned char) str[i] < ' ') {
+         fprintf(stat_jsonfile, "\\u%04x", str[i]);
+      } else {
+         fputc(str[i], stat_jsonfile);
+      }
+   }
+   fputc('"', stat_jsonfile);
+}
+
+
+static void stat_json_double (char *prefix, double value)
+{
+   if (isfinite(value)) {
+      fprintf(stat_jsonfile, "%s%.10g", prefix, value);
+   } else {
+      fprintf(stat_jsonfile, "%snull", prefix);
+   }
+}
+
+
+static void stat_json_begin (char *identstr, char *name)
+{
+   fprintf(stat_jsonfile, "%s\n{\"scope\": ", ((stat_jsoncnt++) ? "," : ""));
+   stat_json_string(identstr, TRUE);
+   fprintf(stat_jsonfile, ", \"name\": ");
+   stat_json_string(name, FALSE);
+}
+
+
+void stat_json_value (char *identstr, char *name, double value)
+{
+   if (stat_jsonfile == NULL) {
+      return;
+   }
+   stat_json_begin(identstr, name);
+   stat_json_double(", \"value\": ", value);
+   fprintf(stat_jsonfile, "}");
+}
+
+
+static void stat_json_stat (statgen **statset, int statcnt, int count, double avg, double stddev, double maxval, char *identstr)
+{
+   statgen *statptr = statset[0];
+   int buckets = statptr->distbrks[(DISTSIZE-1)];
+   double scale = (double) statptr->scale;
+   int pcts = sizeof(stat_percentiles) / sizeof(double);
+   int bucketcnt;
+   int bucketno;
+   int i, j;
+
+   stat_json_begin(identstr, statptr->statdesc);
+   fprintf(stat_jsonfile, ", \"count\": %d", count);
+   stat_json_double(", \"average\": ", avg);
+   stat_json_double(", \"stddev\": ", stddev);
+   stat_json_double(", \"maximum\": ", maxval);
+   if ((statptr->hdrvals) && (count > 0)) {
+      fprintf(stat_jsonfile, ", \"percentiles\": {");
+      for (i=0; i<pcts; i++) {
+         fprintf(stat_jsonfile, "%s\"%g\": ", ((i) ? ", " : ""), stat_percentiles[i]);
+         stat_json_double("", stat_get_percentile_set(statset, statcnt, stat_percentiles[i]));
+      }
+      fprintf(stat_jsonfile, "}");
+   }
+   if (buckets > DISTSIZE) {
+      int step = statptr->distbrks[1];
+      int grow = statptr->distbrks[2];
+
+      fprintf(stat_jsonfile, ", \"distribution\": {\"starts\": [");
+      bucketno = statptr->distbrks[0];
+      for (i=0; i<buckets; i++) {
+         fprintf(stat_jsonfile, "%s%.10g", ((i) ? ", " : ""), ((double) bucketno / scale));
+         bucketno += step + (int)((double) (abs(bucketno) * grow) / (double) 100);
+      }
+      fprintf(stat_jsonfile, "], \"counts\": [");
+      for (i=0; i<buckets; i++) {
+         bucketcnt = 0;
+         for (j=0; j<statcnt; j++) {
+            bucketcnt += statset[j]->largedistvals[i];
+         }
+         fprintf(stat_jsonfile, "%s%d", ((i) ? ", " : ""), bucketcnt);
+      }
+   } else {
+      fprintf(stat_jsonfile, ", \"distribution\": {\"bounds\": [");
+      for (i=(DISTSIZE-buckets); i<(DISTSIZE-1); i++) {
+         fprintf(stat_jsonfile, "%s%.10g", ((i > (DISTSIZE-buckets)) ? ", " : ""), ((double) statptr->distbrks[i] / scale));
+      }
+      fprintf(stat_jsonfile, "], \"exact\": %d, \"counts\": [", max(0, (min(statptr->equals, (DISTSIZE-1)) - (DISTSIZE-buckets))));
+      for (i=(DISTSIZE-buckets); i<DISTSIZE; i++) {
+         bucketcnt = 0;
+         for (j=0; j<statcnt; j++) {
+            bucketcnt += statset[j]->smalldistvals[i];
+         }
+         fprintf(stat_jsonfile, "%s%d", ((i > (DISTSIZE-buckets)) ? ", " : ""), bucketcnt);
+      }
+   }
+   fprintf(stat_jsonfile, "]}}");
+}
+
+
 void stat_print (statgen *statptr, char *identstr)
 {
   stat_print_file(statptr, identstr, outputfile);
@@ -264,6 +514,10 @@ void stat_print_file (statgen *statptr, char *identstr, FILE *outfile){
    } else {
       fprintf(outfile, "%s%s maximum:\t%f\n", identstr, statdesc, statptr->maxval);
    }
+   stat_print_percentiles(&statptr, 1, statptr->count, identstr, outfile);
+   if (stat_jsonfile) {
+      stat_json_stat(&statptr, 1, statptr->count, avg, runsquares, statptr->maxval, identstr);
+   }
    if (buckets > DISTSIZE) {
       stat_print_large_dist(&statptr, 1, statptr->count, identstr);
       return;
@@ -334,6 +588,10 @@ void stat_print_set (statgen **statset, int statcnt, char *identstr)
    } else {
       fprintf(outputfile, "%s%s maximum:\t%f\n", identstr, statdesc, maxval);
    }
+   stat_print_percentiles(statset, statcnt, runcount, identstr, outputfile);
+   if (stat_jsonfile) {
+      stat_json_stat(statset, statcnt, runcount, avg, runsquares, maxval, identstr);
+   }
    if (buckets > DISTSIZE) {
       stat_print_large_dist(statset, statcnt, runcount, identstr);
       return;
@@ -381,6 +639,10 @@ void stat_reset (statgen *statptr)
    statptr->runval = 0.0;
    statptr->runsquares = 0.0;
    statptr->maxval = 0.0;
+   statptr->minval = 0.0;
+   if (statptr->hdrvals) {
+      bzero((char *) statptr->hdrvals, (STAT_HDR_BUCKETS(statptr->hdrsubs) * sizeof(int)));
+   }
    if (buckets > DISTSIZE) {
       for (i=0; i<buckets; i++) {
          statptr->largedistvals[i] = 0;
@@ -429,10 +691,43 @@ static void stat_get_large_dist (FILE *statdef_file, statgen *statptr, int bucke
 }
 
 
+/* Sets up percentiles to the given number of significant digits. */
+
+static void stat_get_percentiles (statgen *statptr, int digits)
+{
+   double prec = pow(10.0, (double) digits);
+
+   if ((digits < 1) || (digits > 5)) {
+      fprintf(stderr, "Percentile precision must be 1 to 5 digits: %s\n", statptr->statdesc);
+      exit(1);
+   }
+   for (statptr->hdrsubs = 1; statptr->hdrsubs < prec; statptr->hdrsubs *= 2) ;
+   statptr->hdrvals = (int *) DISKSIM_malloc(STAT_HDR_BUCKETS(statptr->hdrsubs) * sizeof(int));
+   ASSERT(statptr->hdrvals != NULL);
+   bzero((char *) statptr->hdrvals, (STAT_HDR_BUCKETS(statptr->hdrsubs) * sizeof(int)));
+}
+
+
+/* Sets up a stat that only keeps percentiles, for statistics that */
+/* are not in the statdefs file.                                    */
+
+void stat_initialize_percentiles (char *statdesc, statgen *statptr, int digits)
+{
+   bzero((char *) statptr, sizeof(statgen));
+   statptr->statdesc = DISKSIM_malloc (strlen(statdesc)+1);
+   strcpy (statptr->statdesc, statdesc);
+   statptr->scale = 1;
+   statptr->distbrks[(DISTSIZE-1)] = DISTSIZE;
+   stat_get_percentiles(statptr, digits);
+}
+
+
 void stat_initialize (FILE *statdef_file, char *statdesc, statgen *statptr)
 {
    int i;
    int buckets;
+   int digits;
+   long pos;
    char line[201];
    char line2[201];
 
@@ -475,6 +770,7 @@ void stat_initialize (FILE *statdef_file, char *statdesc, statgen *statptr)
    statptr->runval = 0.0;
    statptr->runsquares = 0.0;
    statptr->maxval = 0.0;
+   statptr->minval = 0.0;
    statptr->statdesc = DISKSIM_malloc (strlen(statdesc)+1);
    strcpy (statptr->statdesc, statdesc);
    for (i=0; i<DISTSIZE; i++) {
@@ -484,6 +780,16 @@ void stat_initialize (FILE *statdef_file, char *statdesc, statgen *statptr)
    statptr->distbrks[(DISTSIZE-1)] = buckets;
    statptr->largedistvals = NULL;
    statptr->largediststarts = NULL;
+   statptr->hdrsubs = 0;
+   statptr->hdrvals = NULL;
+
+   /* an optional line asks for percentiles */
+   pos = ftell(statdef_file);
+   if ((fgets(line, 200, statdef_file) != NULL) && (sscanf(line, "Percentiles: %d", &digits) == 1)) {
+      stat_get_percentiles(statptr, digits);
+   } else {
+      fseek(statdef_file, pos, SEEK_SET);
+   }
 
    if (buckets > DISTSIZE) {
       stat_get_large_dist(statdef_file, statptr, buckets);
@@ -106,6 +106,17 @@
 
 #define DISTSIZE	10
 
+/* Log-linear (HDR-style) histograms, for percentiles.  Row r of subs  */
+/* buckets splits [2^(MINEXP+r), 2^(MINEXP+r+1)) into equal slices, so */
+/* a value's bucket comes straight from its binary exponent and        */
+/* mantissa.  Values below 2^MINEXP, zeros included, go in a bucket of */
+/* their own in front of the rows, and those of 2^(MINEXP+EXPS) and    */
+/* over in the last bucket of the last row.                            */
+
+#define STAT_HDR_MINEXP	-10
+#define STAT_HDR_EXPS	42
+#define STAT_HDR_BUCKETS(subs)	((STAT_HDR_EXPS * (subs)) + 1)
+
 typedef struct {
    int     count;
    char   *statdesc;
@@ -114,18 +125,22 @@ typedef struct {
    int     scale;
    int     equals;
    double  maxval;
+   double  minval;
    double  runval;
    double  runsquares;
    int    *largedistvals;
    int    *largediststarts;
    int     distbrks[DISTSIZE];
    int     smalldistvals[DISTSIZE];
+   int     hdrsubs;		/* percentile buckets per power of two */
+   int    *hdrvals;		/* NULL unless the statdefs ask for percentiles */
 } statgen;
 
 
 /* functions exported by disksim_stat.c */
 
 void   stat_initialize (FILE *statdef_file, char *statdesc, statgen *statptr);
+void   stat_initialize_percentiles (char *statdesc, statgen *statptr, int digits);
 void   stat_reset (statgen *statptr);
 void   stat_update (statgen *statptr, double value);
 int    stat_get_count (statgen *statptr);
@@ -134,6 +149,11 @@ void   stat_print (statgen *statptr, char *identstr);
 void   stat_print_file (statgen *statptr, char *identstr, FILE *outfile);
 void   stat_print_set (statgen **statset, int statcnt, char *identstr);
 int    stat_get_count_set (statgen **statset, int statcnt);
+double stat_get_percentile (statgen *statptr, double pct);
+double stat_get_percentile_set (statgen **statset, int statcnt, double pct);
+int    stat_json_open (char *filename);
+void   stat_json_value (char *identstr, char *name, double value);
+int    stat_json_close (void);
 
 #endif  /* DISKSIM_STAT_H */
 
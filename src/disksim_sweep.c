@@ -0,0 +1,561 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* disksim_sweep runs one simulation per point of a parameter sweep.  The */
+/* parameter file is parsed, and the trace read into memory, only once;  */
+/* each point then runs in a forked child that instantiates that parse   */
+/* with its own overrides and reads its own in-memory copy of the trace. */
+/*                                                                        */
+/*    disksim_sweep [-j workers] [-w] <sweep file> <param file>           */
+/*                  <output prefix> <trace format> <trace file>           */
+/*                  <synthgen?> [overrides]                               */
+/*                                                                        */
+/* All but the first two arguments are disksim's own; the overrides     */
+/* given here apply to every point.  Point n writes <output prefix>.n,   */
+/* and its interval statistics and completion log, if any, to their      */
+/* file names plus .n.                                                   */
+/* The sweep file holds lines of the form                                */
+/*                                                                        */
+/*    vary <component> <parameter> <value> [<value>...]                   */
+/*    point <component> <parameter> <value> [<comp> <param> <value>...]  */
+/*                                                                        */
+/* Each point line is one set of overrides, and the sweep crosses every  */
+/* vary line with every other and with the point lines (if any).  Double */
+/* quotes group words, e.g. "Scheduler:Scheduling policy".  Lines        */
+/* starting with # are ignored.                                          */
+/*                                                                        */
+/* With -w, the simulation is instead set up once, run through its     */
+/* warm-up period (see "Statistic warm-up time" and "Statistic warm-up */
+/* IOs") in this process, and each point forked from that warmed state */
+/* with its overrides applied to the running components (see          */
+/* disksim_setparam()).  Only parameters of iodrivers, controllers and */
+/* disks that are read while simulating make sense to sweep this way;  */
+/* changes to e.g. geometry or cache size do not take effect.  The    */
+/* output produced during warm-up is written to <output prefix>.warmup */
+/* and copied to the head of each point's output.                      */
+/*                                                                        */
+/* When every point has finished, one tab-separated line per point is    */
+/* printed with its wall time, exit status and headline statistics.      */
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "disksim_global.h"
+#include "config.h"
+#include "disksim_iotrace.h"
+#include "disksim_complog.h"
+#include "disksim_tseries.h"
+
+#define SWEEP_MAXTOKENS	256
+#define SWEEP_LINELEN	4096
+
+
+typedef struct sweep_list {
+   char **args;
+   int    len;
+} sweep_list;
+
+typedef struct sweep_point {
+   sweep_list overrides;
+   char   suffix[16];		/* ".n", for the point's output files */
+   char   outfile[256];
+   pid_t  pid;
+   double start;
+   double wall;
+   int    status;
+} sweep_point;
+
+
+static void usage (char *progname)
+{
+   fprintf(stderr, "usage: %s [-j workers] [-w] <sweep file> <param file> <output prefix> <trace format> <trace file> <synthgen?> [overrides]\n", progname);
+   exit(1);
+}
+
+
+static double sweep_now (void)
+{
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return(tv.tv_sec + (tv.tv_usec / 1000000.0));
+}
+
+
+static void sweep_append (sweep_list *l, char **args, int len)
+{
+   l->args = realloc(l->args, (l->len + len) * sizeof(char *));
+   ddbg_assert(l->args != NULL);
+   memcpy(l->args + l->len, args, len * sizeof(char *));
+   l->len += len;
+}
+
+
+/* Splits line into words, honoring double quotes. */
+
+static int sweep_tokenize (char *line, char **tokens)
+{
+   int cnt = 0;
+   char *p = line;
+
+   while (*p) {
+      char *out;
+      while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r')) {
+         p++;
+      }
+      if ((*p == 0) || (*p == '#')) {
+         break;
+      }
+      if (cnt == SWEEP_MAXTOKENS) {
+         fprintf(stderr, "Too many words on a sweep file line\n");
+         exit(1);
+      }
+      tokens[cnt++] = out = p;
+      while (*p && (*p != ' ') && (*p != '\t') && (*p != '\n') && (*p != '\r')) {
+         if (*p == '"') {
+            p++;
+            while (*p && (*p != '"')) {
+               *out++ = *p++;
+            }
+            if (*p == '"') {
+               p++;
+            }
+         } else {
+            *out++ = *p++;
+         }
+      }
+      if (*p) {
+         p++;
+      }
+      *out = 0;
+   }
+   return(cnt);
+}
+
+
+/* Builds the list of points: each point line (or a single empty point */
+/* if there are none) crossed with every value of every vary line.     */
+
+static sweep_point * sweep_load (char *filename, int *pointcnt)
+{
+   FILE *fp = fopen(filename, "r");
+   char line[SWEEP_LINELEN];
+   char *tokens[SWEEP_MAXTOKENS];
+   sweep_point *points = NULL;
+   int cnt = 0;
+   int lineno = 0;
+
+   if (fp == NULL) {
+      fprintf(stderr, "Sweep file %s cannot be opened for read access\n", filename);
+      exit(1);
+   }
+   while (fgets(line, SWEEP_LINELEN, fp)) {
+      int len = sweep_tokenize(strdup(line), tokens);
+      lineno++;
+      if (len == 0) {
+         continue;
+      }
+      if (!strcmp(tokens[0], "point") && (len >= 4) && (((len - 1) % 3) == 0)) {
+         points = realloc(points, (cnt + 1) * sizeof(sweep_point));
+         ddbg_assert(points != NULL);
+         bzero(&points[cnt], sizeof(sweep_point));
+         sweep_append(&points[cnt].overrides, tokens + 1, len - 1);
+         cnt++;
+      } else if (strcmp(tokens[0], "vary") && strcmp(tokens[0], "point")) {
+         fprintf(stderr, "%s:%d: expected \"vary\" or \"point\"\n", filename, lineno);
+         exit(1);
+      } else if (strcmp(tokens[0], "vary") || (len < 4)) {
+         fprintf(stderr, "%s:%d: malformed %s line\n", filename, lineno, tokens[0]);
+         exit(1);
+      }
+   }
+
+   if (cnt == 0) {
+      points = calloc(1, sizeof(sweep_point));
+      ddbg_assert(points != NULL);
+      cnt = 1;
+   }
+
+   /* second pass crosses in the vary lines */
+   rewind(fp);
+   while (fgets(line, SWEEP_LINELEN, fp)) {
+      int len = sweep_tokenize(strdup(line), tokens);
+      sweep_point *crossed;
+      int i, j;
+
+      if ((len == 0) || strcmp(tokens[0], "vary")) {
+         continue;
+      }
+      crossed = calloc(cnt * (len - 3), sizeof(sweep_point));
+      ddbg_assert(crossed != NULL);
+      for (i = 0; i < cnt; i++) {
+         for (j = 3; j < len; j++) {
+            sweep_point *pt = &crossed[(i * (len - 3)) + (j - 3)];
+            sweep_append(&pt->overrides, points[i].overrides.args, points[i].overrides.len);
+            sweep_append(&pt->overrides, tokens + 1, 2);
+            sweep_append(&pt->overrides, tokens + j, 1);
+         }
+      }
+      free(points);
+      points = crossed;
+      cnt *= (len - 3);
+   }
+
+   fclose(fp);
+   *pointcnt = cnt;
+   return(points);
+}
+
+
+static char * sweep_readtrace (char *filename, size_t *len)
+{
+   FILE *fp;
+   char *buf = NULL;
+   size_t size = 0;
+   size_t cnt = 0;
+
+   if (!strcmp(filename, "0")) {
+      return(NULL);
+   }
+   /* every point would otherwise share (and race on) the same stdin */
+   if (!strcmp(filename, "stdin")) {
+      fp = stdin;
+   } else if ((fp = fopen(filename, "rb")) == NULL) {
+      fprintf(stderr, "Tracefile %s cannot be opened for read access\n", filename);
+      exit(1);
+   }
+   while (1) {
+      if (cnt == size) {
+         size = (size) ? (2 * size) : (1 << 20);
+         buf = realloc(buf, size);
+         ddbg_assert(buf != NULL);
+      }
+      cnt += fread(buf + cnt, 1, (size - cnt), fp);
+      if (cnt < size) {
+         break;
+      }
+   }
+   if (fp != stdin) {
+      fclose(fp);
+   }
+   *len = cnt;
+   if (cnt == 0) {
+      /* fmemopen() rejects empty buffers; let the child open the file */
+      free(buf);
+      return(NULL);
+   }
+   return(buf);
+}
+
+
+static void sweep_run (sweep_point *pt, int argc, char **argv, char *trace, size_t tracelen)
+{
+   char **args = calloc(argc + pt->overrides.len + 1, sizeof(char *));
+
+   ddbg_assert(args != NULL);
+   memcpy(args, argv, argc * sizeof(char *));
+   memcpy(args + argc, pt->overrides.args, pt->overrides.len * sizeof(char *));
+   args[2] = pt->outfile;
+   strcpy(disksim->pointsuffix, pt->suffix);
+
+   if (trace) {
+      disksim->iotracefile = fmemopen(trace, tracelen, "rb");
+      ddbg_assert(disksim->iotracefile != NULL);
+   }
+   disksim_setup_disksim(argc + pt->overrides.len, args);
+   disksim_run_simulation();
+   disksim_cleanup_and_printstats();
+   exit(0);
+}
+
+
+/* Runs the shared simulation, set up with the common overrides only, */
+/* until its statistics have been reset for the last time.            */
+
+static void sweep_warmup (int argc, char **argv, char *trace, size_t tracelen)
+{
+   char **args = calloc(argc, sizeof(char *));
+   char warmfile[256];
+
+   ddbg_assert(args != NULL);
+   memcpy(args, argv, argc * sizeof(char *));
+   sprintf(warmfile, "%.240s.warmup", argv[2]);
+   args[2] = warmfile;
+
+   if (trace) {
+      disksim->iotracefile = fmemopen(trace, tracelen, "rb");
+      ddbg_assert(disksim->iotracefile != NULL);
+   }
+   disksim_setup_disksim(argc, args);
+   free(args);
+   DISKSIM_srand48(1000003);
+   while ((disksim->stop_sim == FALSE) && (disksim_warmup_done() == FALSE)) {
+      disksim_simulate_event(0);
+   }
+   fflush(outputfile);
+   /* the children each restart trace prefetching and the completion */
+   /* log writer for themselves                                       */
+   iotrace_prefetch_pause();
+   if (disksim->complog) {
+      complog_sync(disksim->complog, &disksim->complogfileposition);
+      complog_pause(disksim->complog);
+   }
+   if (disksim->tseries) {
+      tseries_sync(disksim->tseries, &disksim->tseriesfileposition);
+   }
+   fprintf(stderr, "*** Warm-up done at simtime %f after %d requests\n", simtime, disksim->totalreqs);
+}
+
+
+/* Copies a file written during warm-up to a point's own file, which */
+/* is named with the point's suffix, and sets name to the latter.     */
+
+static void sweep_branch (char *name, char *suffix)
+{
+   char newname[256];
+   char buf[SWEEP_LINELEN];
+   FILE *from, *to;
+   size_t cnt;
+
+   snprintf(newname, sizeof(newname), "%s%s", name, suffix);
+   if ((from = fopen(name, "rb")) == NULL) {
+      fprintf(stderr, "Output file %s cannot be opened for read access\n", name);
+      exit(1);
+   }
+   if ((to = fopen(newname, "wb")) == NULL) {
+      fprintf(stderr, "Output file %s cannot be opened for write access\n", newname);
+      exit(1);
+   }
+   while ((cnt = fread(buf, 1, SWEEP_LINELEN, from)) > 0) {
+      fwrite(buf, 1, cnt, to);
+   }
+   fclose(from);
+   if (fclose(to) != 0) {
+      fprintf(stderr, "Error writing %s\n", newname);
+      exit(1);
+   }
+   strcpy(name, newname);
+}
+
+
+/* Continues the warmed simulation inherited from sweep_warmup() with */
+/* this point's overrides, writing its output after a copy of the     */
+/* warm-up output.  The interval statistics and the completion log   */
+/* carry on in copies of those written during warm-up, named after    */
+/* the point.                                                          */
+
+static void sweep_run_warm (sweep_point *pt)
+{
+   FILE *warm = fopen(disksim->outputfilename, "r");
+   FILE *out = fopen(pt->outfile, "w");
+   char buf[SWEEP_LINELEN];
+   size_t cnt;
+   int i;
+
+   if ((warm == NULL) || (out == NULL)) {
+      fprintf(stderr, "Output file %s cannot be opened for write access\n", pt->outfile);
+      exit(1);
+   }
+   while ((cnt = fread(buf, 1, SWEEP_LINELEN, warm)) > 0) {
+      fwrite(buf, 1, cnt, out);
+   }
+   fclose(warm);
+   fclose(outputfile);
+   outputfile = out;
+   strcpy(disksim->outputfilename, pt->outfile);
+   strcpy(disksim->pointsuffix, pt->suffix);
+   if (disksim->tseries) {
+      sweep_branch(disksim->tseriesfilename, pt->suffix);
+      tseries_restore(disksim->tseries, disksim->tseriesfilename, &disksim->tseriesfileposition);
+   }
+   if (disksim->complog) {
+      sweep_branch(disksim->complogfilename, pt->suffix);
+      complog_restore(disksim->complog, disksim->complogfilename, &disksim->complogfileposition);
+   }
+
+   iotrace_prefetch_resume();
+   fprintf(outputfile, "\n*** Forked from warm-up at simtime %f\n", simtime);
+   for (i = 0; i < pt->overrides.len; i += 3) {
+      char **o = pt->overrides.args + i;
+      if (disksim_setparam(o[0], o[1], o[2]) <= 0) {
+         fprintf(stderr, "*** error: cannot set \"%s\" of %s to %s after warm-up\n", o[1], o[0], o[2]);
+         exit(1);
+      }
+      fprintf(outputfile, "*** Override: %s \"%s\" %s\n", o[0], o[1], o[2]);
+   }
+
+   while (disksim->stop_sim == FALSE) {
+      disksim_simulate_event(0);
+   }
+   disksim_cleanup_and_printstats();
+   exit(0);
+}
+
+
+/* Pulls a statistic out of a point's output file, or -1 if absent. */
+
+static double sweep_getstat (char *outfile, char *name)
+{
+   FILE *fp = fopen(outfile, "r");
+   char line[SWEEP_LINELEN];
+   double val = -1.0;
+   int namelen = strlen(name);
+
+   if (fp == NULL) {
+      return(val);
+   }
+   while (fgets(line, SWEEP_LINELEN, fp)) {
+      if (!strncmp(line, name, namelen) && (line[namelen] == ':')) {
+         val = atof(line + namelen + 1);
+         break;
+      }
+   }
+   fclose(fp);
+   return(val);
+}
+
+
+static void sweep_report (sweep_point *points, int pointcnt)
+{
+   int i, j;
+
+   printf("point\tstatus\twall_s\trequests\treq_per_s\tresp_avg_ms\toverrides\n");
+   for (i = 0; i < pointcnt; i++) {
+      sweep_point *pt = &points[i];
+      printf("%d\t%d\t%.3f\t%.0f\t%f\t%f\t", i, pt->status, pt->wall,
+             sweep_getstat(pt->outfile, "Overall I/O System Total Requests handled"),
+             sweep_getstat(pt->outfile, "Overall I/O System Requests per second"),
+             sweep_getstat(pt->outfile, "Overall I/O System Response time average"));
+      for (j = 0; j < pt->overrides.len; j++) {
+         char *fmt = ((j % 3) == 1) ? "%s\"%s\"" : "%s%s";
+         printf(fmt, (j ? ((j % 3) ? " " : "; ") : ""), pt->overrides.args[j]);
+      }
+      printf("\n");
+   }
+}
+
+
+int main (int argc, char **argv)
+{
+   sweep_point *points;
+   int pointcnt;
+   int workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+   int running = 0;
+   int next = 0;
+   int failed = 0;
+   int warm = FALSE;
+   char *trace;
+   size_t tracelen = 0;
+   int i;
+
+   setlinebuf(stdout);
+   setlinebuf(stderr);
+
+   while ((argc > 1) && (argv[1][0] == '-')) {
+      if ((argc > 2) && !strcmp(argv[1], "-j")) {
+         workers = atoi(argv[2]);
+         argc -= 2;
+         argv += 2;
+      } else if (!strcmp(argv[1], "-w")) {
+         warm = TRUE;
+         argc--;
+         argv++;
+      } else {
+         usage(argv[0]);
+      }
+   }
+   /* from here on argv[1] is the sweep file and argv + 1 is disksim's */
+   if ((argc < 7) || (workers < 1) || ((argc - 7) % 3)) {
+      usage(argv[0]);
+   }
+
+   points = sweep_load(argv[1], &pointcnt);
+   for (i = 0; i < pointcnt; i++) {
+      sprintf(points[i].suffix, ".%d", i);
+      sprintf(points[i].outfile, "%.240s%s", argv[3], points[i].suffix);
+   }
+
+   disksim = calloc(1, sizeof(struct disksim));
+   ddbg_assert(disksim != NULL);
+   disksim_initialize_disksim_structure(disksim);
+   if (warm && !strcmp(argv[4], "merge")) {
+      /* the points would share the open member traces */
+      fprintf(stderr, "*** error: merged traces cannot be used with -w\n");
+      exit(1);
+   }
+   trace = sweep_readtrace(argv[5], &tracelen);
+   if (warm) {
+      sweep_warmup((argc - 1), (argv + 1), trace, tracelen);
+   } else if (disksim_parseparams(argv[2])) {
+      fprintf(stderr, "*** error: FATAL: failed to load disksim parameter file.\n");
+      exit(1);
+   }
+
+   fprintf(stderr, "*** Sweeping %d points with %d workers\n", pointcnt, workers);
+   fflush(stdout);
+   while ((next < pointcnt) || (running > 0)) {
+      int status;
+      pid_t pid;
+
+      if ((next < pointcnt) && (running < workers)) {
+         sweep_point *pt = &points[next++];
+         pt->start = sweep_now();
+         if ((pt->pid = fork()) == 0) {
+            if (warm) {
+               sweep_run_warm(pt);
+            }
+            sweep_run(pt, (argc - 1), (argv + 1), trace, tracelen);
+         }
+         ddbg_assert(pt->pid > 0);
+         running++;
+         continue;
+      }
+
+      pid = wait(&status);
+      ddbg_assert(pid > 0);
+      for (i = 0; i < pointcnt; i++) {
+         if (points[i].pid == pid) {
+            points[i].wall = sweep_now() - points[i].start;
+            points[i].status = WIFEXITED(status) ? WEXITSTATUS(status) : (128 + WTERMSIG(status));
+            if (points[i].status) {
+               failed++;
+            }
+            break;
+         }
+      }
+      running--;
+   }
+
+   sweep_report(points, pointcnt);
+   exit(failed ? 1 : 0);
+}
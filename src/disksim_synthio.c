@@ -354,7 +354,7 @@ static int synthio_generatenextio (synthio_generator *gen)
 {
    double type;
    double reqclass;
-   int blkno;
+   disksim_lbn_t blkno;
    ioreq_event *tmp;
 
    if ((simtime >= synthio_endtime) || (synthio_iocnt >= synthio_endiocnt))
@@ -877,7 +877,7 @@ static int loadgen(struct lp_block *b, synthio_generator **result) {
   //#include "modules/disksim_synthgen_param.c"
   lp_loadparams(result, b, &disksim_synthgen_mod);
 
-  (*result)->numblocks = (*result)->sectsperdisk * (*result)->numdisks; 
+  (*result)->numblocks = (disksim_lbn_t) (*result)->sectsperdisk * (*result)->numdisks; 
   (*result)->blksperdisk = (*result)->sectsperdisk / (*result)->blocksize;
 
   return 0;
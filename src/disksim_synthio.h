@@ -142,7 +142,7 @@ typedef struct gen {
    sleep_event *  limits;
    int            numdisks;
    int            *devno;
-   int            numblocks;
+   disksim_lbn_t  numblocks;
    int            sectsperdisk;
    int            blksperdisk;
    int            blocksize;
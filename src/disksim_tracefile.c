@@ -0,0 +1,646 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* Transparent decompression of gzip, zstd and xz traces (see             */
+/* disksim_tracefile.h).  The decompressed bytes are served from a stdio  */
+/* stream made with fopencookie.  The last TRACEFILE_HISTORY bytes handed */
+/* out stay buffered, which covers the short backward seeks that stdio    */
+/* itself makes on fflush and fgetpos.                                    */
+/*                                                                        */
+/* Decoder libraries keep pointers into themselves, so their state cannot */
+/* survive a checkpoint.  Instead the decoder records restart points, at  */
+/* most TRACEFILE_POINTS of them roughly TRACEFILE_SPAN output bytes      */
+/* apart, and anything it cannot serve from the buffer is decoded again   */
+/* from the nearest restart point before it.  For gzip this is a deflate  */
+/* block boundary plus the 32KB window that precedes it.  For zstd it is  */
+/* a frame boundary, so zstd traces written as many frames restart        */
+/* cheaply.  xz is only restarted from the beginning of the file.         */
+/*                                                                        */
+/* Support for each format is compiled in with HAVE_ZLIB, HAVE_ZSTD and   */
+/* HAVE_LZMA (see the Makefile).                                          */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "disksim_global.h"
+#include "disksim_tracefile.h"
+
+#include <errno.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#define TRACEFILE_PLAIN		0	/* uncompressed, from a stream that cannot seek */
+#define TRACEFILE_GZIP		1
+#define TRACEFILE_ZSTD		2
+#define TRACEFILE_XZ		3
+
+#define TRACEFILE_INSIZE	(64 * 1024)
+#define TRACEFILE_OUTSIZE	(256 * 1024)
+#define TRACEFILE_HISTORY	(64 * 1024)
+#define TRACEFILE_WINDOW	(32 * 1024)
+#define TRACEFILE_SPAN		(1024 * 1024)
+#define TRACEFILE_POINTS	2
+
+static char *tracefile_names[] = { "uncompressed", "gzip", "zstd", "xz" };
+
+typedef struct tracefile_point {
+   off_t  rawoff;	/* compressed offset */
+   off_t  outoff;	/* decompressed offset */
+   int    bits;		/* gzip: bits of the byte before rawoff not yet decoded */
+   int    winlen;	/* gzip: decompressed bytes preceding outoff */
+   unsigned char window[TRACEFILE_WINDOW];
+} tracefile_point;
+
+typedef struct tracefile {
+   int    type;
+   FILE  *raw;
+   off_t  rawstart;	/* offset of the trace in raw */
+   off_t  rawpos;	/* offset in raw of the end of in[] */
+   int    live;		/* decoder set up by this process */
+   int    pending;	/* decoder may have output without more input */
+   int    member;	/* within a gzip member or zstd frame */
+   int    rawdeflate;	/* gzip: restarted part way through a member */
+   int    eof;
+   size_t inpos;
+   size_t inlen;
+   off_t  outbase;	/* decompressed offset of out[0] */
+   size_t outpos;
+   size_t outlen;
+   int    npoints;
+   tracefile_point point[TRACEFILE_POINTS];
+   union {
+#ifdef HAVE_ZLIB
+      z_stream gz;
+#endif
+#ifdef HAVE_ZSTD
+      ZSTD_DStream *zs;
+#endif
+#ifdef HAVE_LZMA
+      lzma_stream xz;
+#endif
+      int    none;
+   } dec;
+   unsigned char in[TRACEFILE_INSIZE];
+   unsigned char out[TRACEFILE_OUTSIZE];
+} tracefile;
+
+
+#ifndef _WIN32
+
+static void tracefile_fail (tracefile *tf, char *msg)
+{
+   fprintf(stderr, "Cannot decompress %s tracefile: %s\n", tracefile_names[tf->type], msg);
+   exit(1);
+}
+
+
+static int tracefile_fillin (tracefile *tf)
+{
+   size_t got;
+
+   if (tf->inpos < tf->inlen) {
+      return(TRUE);
+   }
+   got = fread(tf->in, 1, TRACEFILE_INSIZE, tf->raw);
+   tf->rawpos += got;
+   tf->inpos = 0;
+   tf->inlen = got;
+   return(got > 0);
+}
+
+
+/* Notes a restart point at the current decoder position, unless the */
+/* newest one is less than TRACEFILE_SPAN bytes back.                */
+
+static void tracefile_note_point (tracefile *tf, int bits)
+{
+   tracefile_point *newest = (tf->npoints) ? &tf->point[(tf->npoints - 1) % TRACEFILE_POINTS] : NULL;
+   tracefile_point *pt;
+   off_t outoff = tf->outbase + tf->outlen;
+   int winlen = (int) min(TRACEFILE_WINDOW, outoff);
+
+   if ((outoff - ((newest) ? newest->outoff : 0)) < TRACEFILE_SPAN) {
+      return;
+   }
+   if ((tf->type == TRACEFILE_GZIP) && (tf->outlen < winlen)) {
+      return;
+   }
+   pt = &tf->point[tf->npoints % TRACEFILE_POINTS];
+   pt->rawoff = tf->rawpos - (tf->inlen - tf->inpos);
+   pt->outoff = outoff;
+   pt->bits = bits;
+   pt->winlen = 0;
+   if (tf->type == TRACEFILE_GZIP) {
+      pt->winlen = winlen;
+      memcpy(pt->window, (tf->out + tf->outlen - winlen), winlen);
+   }
+   tf->npoints++;
+}
+
+
+static void tracefile_end (tracefile *tf)
+{
+   if (!tf->live) {
+      return;
+   }
+   switch (tf->type) {
+#ifdef HAVE_ZLIB
+   case TRACEFILE_GZIP:
+      inflateEnd(&tf->dec.gz);
+      break;
+#endif
+#ifdef HAVE_ZSTD
+   case TRACEFILE_ZSTD:
+      ZSTD_freeDStream(tf->dec.zs);
+      break;
+#endif
+#ifdef HAVE_LZMA
+   case TRACEFILE_XZ:
+      lzma_end(&tf->dec.xz);
+      break;
+#endif
+   }
+   tf->live = FALSE;
+}
+
+
+/* Sets the decoder up to carry on from pt, or from the beginning of */
+/* the trace if pt is NULL.  With seek FALSE the input already read  */
+/* (the magic number) is the beginning of the trace.                 */
+
+static void tracefile_start (tracefile *tf, tracefile_point *pt, int seek)
+{
+   off_t rawoff = (pt) ? pt->rawoff : tf->rawstart;
+
+   tracefile_end(tf);
+   if ((pt) && (pt->bits)) {
+      rawoff--;
+   }
+   if (seek) {
+      if (fseeko(tf->raw, rawoff, SEEK_SET) != 0) {
+         tracefile_fail(tf, "the trace must be re-read, but cannot be seeked");
+      }
+      tf->rawpos = rawoff;
+      tf->inpos = tf->inlen = 0;
+   }
+   tf->outbase = (pt) ? pt->outoff : 0;
+   tf->outpos = tf->outlen = 0;
+   tf->pending = FALSE;
+   tf->member = FALSE;
+   tf->rawdeflate = FALSE;
+   tf->eof = FALSE;
+
+   switch (tf->type) {
+#ifdef HAVE_ZLIB
+   case TRACEFILE_GZIP:
+      bzero(&tf->dec.gz, sizeof(tf->dec.gz));
+      if (pt == NULL) {
+         if (inflateInit2(&tf->dec.gz, (15 + 16)) != Z_OK) {
+            tracefile_fail(tf, "out of memory");
+         }
+         break;
+      }
+      if (inflateInit2(&tf->dec.gz, -15) != Z_OK) {
+         tracefile_fail(tf, "out of memory");
+      }
+      if (pt->bits) {
+         if (!tracefile_fillin(tf)) {
+            tracefile_fail(tf, "the trace is shorter than before");
+         }
+         inflatePrime(&tf->dec.gz, pt->bits, (tf->in[tf->inpos++] >> (8 - pt->bits)));
+      }
+      inflateSetDictionary(&tf->dec.gz, pt->window, pt->winlen);
+      tf->member = TRUE;
+      tf->rawdeflate = TRUE;
+      break;
+#endif
+#ifdef HAVE_ZSTD
+   case TRACEFILE_ZSTD:
+      if ((tf->dec.zs = ZSTD_createDStream()) == NULL) {
+         tracefile_fail(tf, "out of memory");
+      }
+      ZSTD_initDStream(tf->dec.zs);
+      break;
+#endif
+#ifdef HAVE_LZMA
+   case TRACEFILE_XZ:
+      bzero(&tf->dec.xz, sizeof(tf->dec.xz));
+      if (lzma_stream_decoder(&tf->dec.xz, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+         tracefile_fail(tf, "out of memory");
+      }
+      break;
+#endif
+   case TRACEFILE_PLAIN:
+      break;
+   default:
+      tracefile_fail(tf, "support for it was not compiled in");
+   }
+   tf->live = TRUE;
+}
+
+
+#ifdef HAVE_ZLIB
+static void tracefile_gzip_decode (tracefile *tf)
+{
+   z_stream *z = &tf->dec.gz;
+   size_t avail;
+   int ret;
+
+   while ((tf->outlen < TRACEFILE_OUTSIZE) && (!tf->eof)) {
+      if ((!tf->pending) && (!tracefile_fillin(tf))) {
+         if (tf->member) {
+            tracefile_fail(tf, "the trace is truncated");
+         }
+         tf->eof = TRUE;
+         break;
+      }
+      if (!tf->member) {
+         /* between members, anything but another member ends the trace */
+         if (tf->in[tf->inpos] != 0x1f) {
+            tf->eof = TRUE;
+            break;
+         }
+         tf->member = TRUE;
+      }
+      avail = TRACEFILE_OUTSIZE - tf->outlen;
+      z->next_in = tf->in + tf->inpos;
+      z->avail_in = tf->inlen - tf->inpos;
+      z->next_out = tf->out + tf->outlen;
+      z->avail_out = avail;
+      ret = inflate(z, Z_BLOCK);
+      tf->inpos = tf->inlen - z->avail_in;
+      tf->outlen += avail - z->avail_out;
+      tf->pending = (z->avail_out == 0);
+
+      if (ret == Z_STREAM_END) {
+         if (tf->rawdeflate) {
+            /* skip the member's trailer (CRC and length) ourselves */
+            int skip = 8;
+            while ((skip > 0) && (tracefile_fillin(tf))) {
+               int n = (int) min((size_t) skip, (tf->inlen - tf->inpos));
+               tf->inpos += n;
+               skip -= n;
+            }
+            tf->rawdeflate = FALSE;
+         }
+         inflateReset2(z, (15 + 16));
+         tf->member = FALSE;
+         tf->pending = FALSE;
+      } else if ((ret != Z_OK) && (ret != Z_BUF_ERROR)) {
+         tracefile_fail(tf, ((z->msg) ? z->msg : "corrupt data"));
+      } else if ((z->data_type & 128) && !(z->data_type & 64)) {
+         tracefile_note_point(tf, (z->data_type & 7));
+      }
+   }
+}
+#endif
+
+
+#ifdef HAVE_ZSTD
+static void tracefile_zstd_decode (tracefile *tf)
+{
+   ZSTD_inBuffer in;
+   ZSTD_outBuffer out;
+   size_t ret;
+
+   while ((tf->outlen < TRACEFILE_OUTSIZE) && (!tf->eof)) {
+      if ((!tf->pending) && (!tracefile_fillin(tf))) {
+         if (tf->member) {
+            tracefile_fail(tf, "the trace is truncated");
+         }
+         tf->eof = TRUE;
+         break;
+      }
+      in.src = tf->in;
+      in.size = tf->inlen;
+      in.pos = tf->inpos;
+      out.dst = tf->out;
+      out.size = TRACEFILE_OUTSIZE;
+      out.pos = tf->outlen;
+      ret = ZSTD_decompressStream(tf->dec.zs, &out, &in);
+      if (ZSTD_isError(ret)) {
+         tracefile_fail(tf, (char *) ZSTD_getErrorName(ret));
+      }
+      tf->inpos = in.pos;
+      tf->outlen = out.pos;
+      tf->pending = (out.pos == out.size);
+      tf->member = (ret != 0);
+      if (ret == 0) {
+         tracefile_note_point(tf, 0);
+      }
+   }
+}
+#endif
+
+
+#ifdef HAVE_LZMA
+static void tracefile_xz_decode (tracefile *tf)
+{
+   lzma_stream *x = &tf->dec.xz;
+   lzma_action action = LZMA_RUN;
+   size_t avail;
+   lzma_ret ret;
+
+   while ((tf->outlen < TRACEFILE_OUTSIZE) && (!tf->eof)) {
+      if ((!tf->pending) && (!tracefile_fillin(tf))) {
+         action = LZMA_FINISH;
+      }
+      avail = TRACEFILE_OUTSIZE - tf->outlen;
+      x->next_in = tf->in + tf->inpos;
+      x->avail_in = tf->inlen - tf->inpos;
+      x->next_out = tf->out + tf->outlen;
+      x->avail_out = avail;
+      ret = lzma_code(x, action);
+      tf->inpos = tf->inlen - x->avail_in;
+      tf->outlen += avail - x->avail_out;
+      tf->pending = (x->avail_out == 0);
+      if (ret == LZMA_STREAM_END) {
+         tf->eof = TRUE;
+      } else if (ret == LZMA_BUF_ERROR) {
+         tracefile_fail(tf, "the trace is truncated");
+      } else if (ret != LZMA_OK) {
+         tracefile_fail(tf, "corrupt data");
+      }
+   }
+}
+#endif
+
+
+static void tracefile_plain_decode (tracefile *tf)
+{
+   size_t n;
+
+   while ((tf->outlen < TRACEFILE_OUTSIZE) && (!tf->eof)) {
+      if (!tracefile_fillin(tf)) {
+         tf->eof = TRUE;
+         break;
+      }
+      n = min((TRACEFILE_OUTSIZE - tf->outlen), (tf->inlen - tf->inpos));
+      memcpy((tf->out + tf->outlen), (tf->in + tf->inpos), n);
+      tf->inpos += n;
+      tf->outlen += n;
+   }
+}
+
+
+/* Makes room in out[] (keeping TRACEFILE_HISTORY bytes before outpos) */
+/* and decodes into it.  Returns FALSE at the end of the trace.        */
+
+static int tracefile_decode (tracefile *tf)
+{
+   size_t drop;
+   size_t before = tf->outlen;
+
+   if (tf->outpos > TRACEFILE_HISTORY) {
+      drop = tf->outpos - TRACEFILE_HISTORY;
+      memmove(tf->out, (tf->out + drop), (tf->outlen - drop));
+      tf->outbase += drop;
+      tf->outpos -= drop;
+      tf->outlen -= drop;
+      before -= drop;
+   }
+   switch (tf->type) {
+#ifdef HAVE_ZLIB
+   case TRACEFILE_GZIP:
+      tracefile_gzip_decode(tf);
+      break;
+#endif
+#ifdef HAVE_ZSTD
+   case TRACEFILE_ZSTD:
+      tracefile_zstd_decode(tf);
+      break;
+#endif
+#ifdef HAVE_LZMA
+   case TRACEFILE_XZ:
+      tracefile_xz_decode(tf);
+      break;
+#endif
+   default:
+      tracefile_plain_decode(tf);
+      break;
+   }
+   return(tf->outlen > before);
+}
+
+
+/* Decodes from the nearest restart point before decompressed offset  */
+/* target up to target.  Returns FALSE if the trace ends before it.    */
+
+static int tracefile_restart (tracefile *tf, off_t target)
+{
+   tracefile_point *best = NULL;
+   int i;
+
+   for (i = 0; i < min(tf->npoints, TRACEFILE_POINTS); i++) {
+      if ((tf->point[i].outoff <= target) && ((best == NULL) || (tf->point[i].outoff > best->outoff))) {
+         best = &tf->point[i];
+      }
+   }
+   tracefile_start(tf, best, TRUE);
+   while ((tf->outbase + tf->outlen) < target) {
+      tf->outpos = tf->outlen;
+      if (!tracefile_decode(tf)) {
+         return(FALSE);
+      }
+   }
+   tf->outpos = target - tf->outbase;
+   return(TRUE);
+}
+
+
+/* Moves the read position to decompressed offset target.  Returns */
+/* FALSE if target is beyond the end of the trace.                 */
+
+static int tracefile_seekto (tracefile *tf, off_t target)
+{
+   if ((target >= tf->outbase) && (target <= (tf->outbase + tf->outlen))) {
+      tf->outpos = target - tf->outbase;
+      return(TRUE);
+   }
+   if ((!tf->live) || (target < tf->outbase)) {
+      return(tracefile_restart(tf, target));
+   }
+   while ((tf->outbase + tf->outlen) < target) {
+      tf->outpos = tf->outlen;
+      if (!tracefile_decode(tf)) {
+         return(FALSE);
+      }
+   }
+   tf->outpos = target - tf->outbase;
+   return(TRUE);
+}
+
+
+static ssize_t tracefile_read (void *cookie, char *buf, size_t size)
+{
+   tracefile *tf = cookie;
+   size_t n;
+
+   /* restored from a checkpoint: catch a new decoder up with out[] */
+   if ((tf->outpos == tf->outlen) && (!tf->live) &&
+       (!tracefile_restart(tf, (tf->outbase + tf->outlen)))) {
+      tracefile_fail(tf, "the trace is shorter than before");
+   }
+   if ((tf->outpos == tf->outlen) && (!tracefile_decode(tf))) {
+      return(0);
+   }
+   n = min(size, (tf->outlen - tf->outpos));
+   memcpy(buf, (tf->out + tf->outpos), n);
+   tf->outpos += n;
+   return(n);
+}
+
+
+static int tracefile_seek (void *cookie, off64_t *offset, int whence)
+{
+   tracefile *tf = cookie;
+   off_t target = *offset;
+
+   if (whence == SEEK_CUR) {
+      target += tf->outbase + tf->outpos;
+   } else if (whence != SEEK_SET) {
+      errno = EINVAL;
+      return(-1);
+   }
+   if ((target < 0) || (!tracefile_seekto(tf, target))) {
+      errno = EINVAL;
+      return(-1);
+   }
+   *offset = target;
+   return(0);
+}
+
+
+static int tracefile_close (void *cookie)
+{
+   tracefile *tf = cookie;
+   int ret = fclose(tf->raw);
+
+   tracefile_end(tf);
+   free(tf);
+   return(ret);
+}
+
+
+static FILE * tracefile_stream (tracefile *tf)
+{
+   cookie_io_functions_t funcs = { tracefile_read, NULL, tracefile_seek, tracefile_close };
+   FILE *fp = fopencookie(tf, "rb", funcs);
+
+   if (fp == NULL) {
+      fprintf(stderr, "Cannot open a stream for the decompressed tracefile\n");
+      exit(1);
+   }
+   return(fp);
+}
+
+
+FILE * tracefile_open (FILE *raw, struct tracefile **statep)
+{
+   static const unsigned char gzipmagic[] = { 0x1f, 0x8b };
+   static const unsigned char zstdmagic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+   static const unsigned char xzmagic[] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+   unsigned char magic[6];
+   off_t start = ftello(raw);
+   size_t got = fread(magic, 1, sizeof(magic), raw);
+   int type = TRACEFILE_PLAIN;
+   tracefile *tf;
+
+   if (statep) {
+      *statep = NULL;
+   }
+   if ((got >= sizeof(gzipmagic)) && (memcmp(magic, gzipmagic, sizeof(gzipmagic)) == 0)) {
+      type = TRACEFILE_GZIP;
+   } else if ((got >= sizeof(zstdmagic)) && (memcmp(magic, zstdmagic, sizeof(zstdmagic)) == 0)) {
+      type = TRACEFILE_ZSTD;
+   } else if ((got >= sizeof(xzmagic)) && (memcmp(magic, xzmagic, sizeof(xzmagic)) == 0)) {
+      type = TRACEFILE_XZ;
+   }
+   if ((type == TRACEFILE_PLAIN) && (start >= 0) && (fseeko(raw, start, SEEK_SET) == 0)) {
+      return(raw);
+   }
+
+   tf = malloc(sizeof(tracefile));
+   if (tf == NULL) {
+      fprintf(stderr, "Out of memory opening tracefile\n");
+      exit(1);
+   }
+   bzero(tf, sizeof(tracefile));
+   tf->type = type;
+   tf->raw = raw;
+   tf->rawstart = (start >= 0) ? start : 0;
+   tf->rawpos = tf->rawstart + got;
+   memcpy(tf->in, magic, got);
+   tf->inlen = got;
+   tracefile_start(tf, NULL, FALSE);
+   if (statep) {
+      *statep = tf;
+   }
+   return(tracefile_stream(tf));
+}
+
+
+FILE * tracefile_reopen (FILE *raw, struct tracefile *state)
+{
+   /* the decoder itself was left behind with the old process */
+   state->raw = raw;
+   state->live = FALSE;
+   state->pending = FALSE;
+   state->inpos = state->inlen = 0;
+   return(tracefile_stream(state));
+}
+
+#else    /* _WIN32 */
+
+FILE * tracefile_open (FILE *raw, struct tracefile **statep)
+{
+   if (statep) {
+      *statep = NULL;
+   }
+   return(raw);
+}
+
+
+FILE * tracefile_reopen (FILE *raw, struct tracefile *state)
+{
+   return(raw);
+}
+
+#endif    /* _WIN32 */
@@ -0,0 +1,56 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#ifndef DISKSIM_TRACEFILE_H
+#define DISKSIM_TRACEFILE_H
+
+/* Compressed trace files.  tracefile_open looks at the first bytes of  */
+/* a trace and, if it was written by gzip, zstd or xz, hands back a     */
+/* stdio stream that reads the decompressed trace, so that the trace    */
+/* readers never see the compression.  Uncompressed traces come back    */
+/* unchanged.                                                           */
+/*                                                                      */
+/* Decompressed streams can be fgetpos'd and fsetpos'd.  The decoder    */
+/* notes restart points as it goes, and the state it keeps (allocated   */
+/* with malloc, so a checkpoint carries it) is enough for               */
+/* tracefile_reopen to carry on from a restored position without        */
+/* decompressing the whole trace again.                                 */
+
+struct tracefile;
+
+/* Takes over raw; *statep (if non-NULL) is set to the decoder state, */
+/* or to NULL if raw is returned as is.  fclose releases both.        */
+FILE *tracefile_open (FILE *raw, struct tracefile **statep);
+
+/* A new stream over state (restored from a checkpoint) reading raw */
+FILE *tracefile_reopen (FILE *raw, struct tracefile *state);
+
+#endif    /* DISKSIM_TRACEFILE_H */
@@ -0,0 +1,278 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* Interval statistics (see disksim_tseries.h).  Each device keeps its */
+/* counts for the current interval, which tseries_tick() writes out    */
+/* and clears.  Device cache and cleaning activity comes from running  */
+/* totals (device_get_counters), less those at the last tick.          */
+
+#include "disksim_global.h"
+#include "disksim_stat.h"
+#include "disksim_device.h"
+#include "disksim_tseries.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+typedef struct tseries_dev {
+   int       arrivals;
+   int       completions;
+   int       reads;
+   int       writes;
+   long long blocks;
+   statgen   resptime;
+   int       outstanding;
+   double    lastchange;	/* when outstanding last changed */
+   double    area;		/* outstanding x time, this interval */
+   device_counters last;	/* device totals at the last tick */
+} tseries_dev;
+
+struct tseries {
+   FILE        *outfile;
+   double       start;		/* of the current interval */
+   int          numdevs;
+   tseries_dev *dev;
+   timer_event *timer;
+   int          idle;		/* timer left out of the queue */
+};
+
+
+tseries * tseries_open (char *filename)
+{
+   tseries *ts = calloc(1, sizeof(tseries));
+
+   if (ts == NULL) {
+      return(NULL);
+   }
+   if ((ts->outfile = fopen(filename, "w")) == NULL) {
+      free(ts);
+      return(NULL);
+   }
+   fprintf(ts->outfile, "time,devno,arrivals,completions,reads,writes,blocks,iops,mbps,respavg,resp50,resp99,resp999,respmax,outstanding,cacheaccesses,cachehits,cleans,pagesmoved\n");
+   return(ts);
+}
+
+
+void tseries_start (tseries *ts)
+{
+   int i;
+
+   ts->numdevs = device_get_numdevices();
+   ts->dev = calloc(ts->numdevs, sizeof(tseries_dev));
+   ASSERT(ts->dev != NULL);
+   for (i=0; i<ts->numdevs; i++) {
+      stat_initialize_percentiles("Response time", &ts->dev[i].resptime, TSERIES_DIGITS);
+      device_get_counters(i, &ts->dev[i].last);
+   }
+   ts->start = simtime;
+   if (disksim->tseriesinterval <= 0.0) {
+      disksim->tseriesinterval = 1000.0;
+   }
+   ts->timer = (timer_event *) getfromextraq();
+   ts->timer->type = TIMER_EXPIRED;
+   ts->timer->func = &disksim->timerfunc_tseries;
+   ts->timer->time = simtime + disksim->tseriesinterval;
+   ts->timer->ptr = ts;
+   addtointq((event *) ts->timer);
+}
+
+
+static INLINE void tseries_outstanding (tseries_dev *dev, int change)
+{
+   dev->area += (double) dev->outstanding * (simtime - dev->lastchange);
+   dev->lastchange = simtime;
+   dev->outstanding += change;
+}
+
+
+/* Puts the timer back after an idle spell.  The intervals in between */
+/* saw no requests and are not written out; the one this arrival falls */
+/* in starts where it would have, had the timer kept running.          */
+
+static void tseries_rearm (tseries *ts)
+{
+   double skipped = floor((simtime - ts->start) / disksim->tseriesinterval);
+   int i;
+
+   ts->start += skipped * disksim->tseriesinterval;
+   for (i=0; i<ts->numdevs; i++) {
+      ts->dev[i].lastchange = ts->start;
+   }
+   ts->timer->time = ts->start + disksim->tseriesinterval;
+   addtointq((event *) ts->timer);
+   ts->idle = FALSE;
+}
+
+
+/* Requests are counted against the device number they were issued to, */
+/* which for a logical device (array) may not name a device of its own. */
+
+void tseries_arrive (tseries *ts, ioreq_event *curr)
+{
+   tseries_dev *dev;
+
+   if (ts->idle) {
+      tseries_rearm(ts);
+   }
+   if ((curr->devno < 0) || (curr->devno >= ts->numdevs)) {
+      return;
+   }
+   dev = &ts->dev[curr->devno];
+   dev->arrivals++;
+   tseries_outstanding(dev, 1);
+}
+
+
+void tseries_done (tseries *ts, ioreq_event *curr, double resptime)
+{
+   tseries_dev *dev;
+
+   if ((curr->devno < 0) || (curr->devno >= ts->numdevs)) {
+      return;
+   }
+   dev = &ts->dev[curr->devno];
+   dev->completions++;
+   if (curr->flags & READ) {
+      dev->reads++;
+   } else {
+      dev->writes++;
+   }
+   dev->blocks += curr->bcount;
+   stat_update(&dev->resptime, resptime);
+   /* a request that died in the warm-up reset may show up here */
+   tseries_outstanding(dev, ((dev->outstanding > 0) ? -1 : 0));
+}
+
+
+/* Writes out and clears the current interval, which ends now. */
+
+static void tseries_write (tseries *ts)
+{
+   double len = simtime - ts->start;
+   device_counters now;
+   tseries_dev *dev;
+   int i;
+
+   if (len <= 0.0) {
+      return;
+   }
+   for (i=0; i<ts->numdevs; i++) {
+      dev = &ts->dev[i];
+      tseries_outstanding(dev, 0);
+      device_get_counters(i, &now);
+      /* totals that went down were reset (e.g., at the end of warm-up) */
+      if ((now.cacheaccesses < dev->last.cacheaccesses) || (now.cleans < dev->last.cleans)) {
+         bzero((char *) &dev->last, sizeof(device_counters));
+      }
+      fprintf(ts->outfile, "%f,%d,%d,%d,%d,%d,%lld,%f,%f,%f,%f,%f,%f,%f,%f,%d,%d,%d,%d\n",
+              simtime, i, dev->arrivals, dev->completions, dev->reads, dev->writes, dev->blocks,
+              ((double) dev->completions * 1000.0 / len),
+              ((double) dev->blocks * 512.0 / 1000.0 / len),
+              ((dev->completions) ? (stat_get_runval(&dev->resptime) / (double) dev->completions) : 0.0),
+              stat_get_percentile(&dev->resptime, 50.0),
+              stat_get_percentile(&dev->resptime, 99.0),
+              stat_get_percentile(&dev->resptime, 99.9),
+              dev->resptime.maxval,
+              (dev->area / len),
+              (now.cacheaccesses - dev->last.cacheaccesses), (now.cachehits - dev->last.cachehits),
+              (now.cleans - dev->last.cleans), (now.pagesmoved - dev->last.pagesmoved));
+      dev->arrivals = 0;
+      dev->completions = 0;
+      dev->reads = 0;
+      dev->writes = 0;
+      dev->blocks = 0;
+      dev->area = 0.0;
+      stat_reset(&dev->resptime);
+      dev->last = now;
+   }
+   ts->start = simtime;
+}
+
+
+/* When the timer is the last event left, re-arming it would keep the */
+/* simulation from ever running dry (the external interface, e.g.,    */
+/* only stops once the queue is empty), so it is left out until the   */
+/* next request arrives.                                               */
+
+void tseries_tick (timer_event *timer)
+{
+   tseries *ts = (tseries *) timer->ptr;
+
+   tseries_write(ts);
+   if (disksim->intqlen == 0) {
+      ts->idle = TRUE;
+      return;
+   }
+   timer->time = simtime + disksim->tseriesinterval;
+   addtointq((event *) timer);
+}
+
+
+void tseries_sync (tseries *ts, fpos_t *pos)
+{
+   fflush(ts->outfile);
+   if (pos) {
+      fgetpos(ts->outfile, pos);
+   }
+}
+
+
+void tseries_restore (tseries *ts, char *filename, fpos_t *pos)
+{
+   int ret;
+
+   if ((ts->outfile = fopen(filename, "r+")) == NULL) {
+      fprintf(stderr, "Interval statistics file %s cannot be opened for write access\n", filename);
+      exit(1);
+   }
+   ret = fsetpos(ts->outfile, pos);
+   assert(ret >= 0);
+#ifndef _WIN32
+   /* drop whatever the interrupted run wrote after the checkpoint */
+   ret = ftruncate(fileno(ts->outfile), ftello(ts->outfile));
+   assert(ret >= 0);
+#endif
+}
+
+
+int tseries_close (tseries *ts)
+{
+   int error;
+
+   if (ts->dev) {
+      tseries_write(ts);
+   }
+   error = (fclose(ts->outfile) != 0);
+   free(ts->dev);
+   free(ts);
+   return(error);
+}
@@ -0,0 +1,64 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+#ifndef DISKSIM_TSERIES_H
+#define DISKSIM_TSERIES_H
+
+/* Interval statistics.  Every "Statistics interval" of simulated time, */
+/* one CSV line per device goes to the "Output file for interval        */
+/* statistics", covering just that interval: requests arrived and       */
+/* completed, throughput, response time average and percentiles, the    */
+/* average number of requests outstanding, and any device cache and SSD */
+/* cleaning activity.  Response times and outstanding requests are      */
+/* those of the device driver's overall queue.  When no file is given,  */
+/* nothing is collected and the hooks below cost a test each.           */
+
+#define TSERIES_DIGITS	2	/* percentile precision (see disksim_stat.h) */
+
+typedef struct tseries tseries;
+
+tseries * tseries_open (char *filename);
+
+/* sets up the devices and the timer, once the devices are known */
+void tseries_start (tseries *ts);
+
+void tseries_arrive (tseries *ts, ioreq_event *curr);
+void tseries_done (tseries *ts, ioreq_event *curr, double resptime);
+void tseries_tick (timer_event *timer);
+
+/* flushes the file and, if pos is given, notes where it carries on */
+void tseries_sync (tseries *ts, fpos_t *pos);
+void tseries_restore (tseries *ts, char *filename, fpos_t *pos);
+
+/* writes out the last, partial interval */
+int  tseries_close (tseries *ts);
+
+#endif    /* DISKSIM_TSERIES_H */
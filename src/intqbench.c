@@ -0,0 +1,287 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* intqbench replays a stream of event queue operations against each of */
+/* the intq implementations and reports how fast each one ran it.  The  */
+/* stream is either a recording made by a simulation run with the       */
+/* "Event queue trace file" global parameter set, or a synthetic "hold" */
+/* workload that keeps a fixed number of events pending and reschedules */
+/* each dequeued event a random (exponential) interval later.           */
+/*                                                                      */
+/*    intqbench [-t type]... <recorded stream>                          */
+/*    intqbench [-t type]... -hold <events pending> <operations>        */
+/*                                                                      */
+/* Each -t limits the run to the given "Event queue type" values, e.g. */
+/* to leave out the list when thousands of events are pending.         */
+/*                                                                      */
+/* Every implementation must dequeue the events in the same order; the */
+/* order checksum printed for each one makes a mismatch obvious.       */
+
+#include <time.h>
+#include <math.h>
+
+#include "disksim_global.h"
+#include "disksim_intq.h"
+#include "disksim_rand48.h"
+
+
+static char *intqbench_names[] = {
+   "list",
+   "binary heap",
+   "4-ary heap",
+   "calendar"
+};
+
+
+static void usage (char *progname)
+{
+   fprintf(stderr, "usage: %s [-t type]... <event queue trace file>\n", progname);
+   fprintf(stderr, "       %s [-t type]... -hold <events pending> <operations>\n", progname);
+   exit(1);
+}
+
+
+static intq_traceop * intqbench_load (char *filename, int *opcnt)
+{
+   FILE *fp = fopen(filename, "rb");
+   intq_traceop *ops = NULL;
+   int size = 0;
+   int cnt = 0;
+
+   if (fp == NULL) {
+      fprintf(stderr, "Cannot open %s\n", filename);
+      exit(1);
+   }
+   while (1) {
+      if (cnt == size) {
+         size = (size) ? (2 * size) : 65536;
+         ops = realloc(ops, size * sizeof(intq_traceop));
+         if (ops == NULL) {
+            fprintf(stderr, "Out of memory reading %s\n", filename);
+            exit(1);
+         }
+      }
+      if (fread(&ops[cnt], sizeof(intq_traceop), 1, fp) != 1) {
+         break;
+      }
+      cnt++;
+   }
+   fclose(fp);
+   *opcnt = cnt;
+   return(ops);
+}
+
+
+/* Generates the hold workload by running it through a 4-ary heap. */
+/* The ids are already the dense event indices used for replay.     */
+
+static intq_traceop * intqbench_hold (int pending, int opcnt, int *outcnt)
+{
+   intq_traceop *ops = malloc((pending + (2 * opcnt)) * sizeof(intq_traceop));
+   event *events = calloc(pending, sizeof(event));
+   int cnt = 0;
+   int i;
+
+   if ((ops == NULL) || (events == NULL)) {
+      fprintf(stderr, "Out of memory generating hold workload\n");
+      exit(1);
+   }
+   DISKSIM_srand48(1);
+   intq_settype(INTQ_4HEAP);
+   for (i = 0; i < pending; i++) {
+      events[i].time = -log(1.0 - DISKSIM_drand48());
+      intq_insert(&events[i]);
+      ops[cnt].time = events[i].time;
+      ops[cnt].id = i;
+      ops[cnt].op = INTQ_OP_INSERT;
+      ops[cnt].type = 0;
+      cnt++;
+   }
+   for (i = 0; i < opcnt; i++) {
+      event *curr = intq_getnext();
+      ops[cnt].time = curr->time;
+      ops[cnt].id = curr - events;
+      ops[cnt].op = INTQ_OP_GETNEXT;
+      ops[cnt].type = 0;
+      cnt++;
+      curr->time += -log(1.0 - DISKSIM_drand48());
+      intq_insert(curr);
+      ops[cnt] = ops[cnt - 1];
+      ops[cnt].time = curr->time;
+      ops[cnt].op = INTQ_OP_INSERT;
+      cnt++;
+   }
+   while (intq_getnext() != NULL) {
+   }
+   intq_cleanup();
+   free(events);
+   *outcnt = cnt;
+   return(ops);
+}
+
+
+static int intqbench_idcmp (const void *a, const void *b)
+{
+   u_int64_t x = *(const u_int64_t *) a;
+   u_int64_t y = *(const u_int64_t *) b;
+
+   return((x < y) ? -1 : (x > y));
+}
+
+
+/* Replaces each recorded event address with a dense index, so replay */
+/* can find its stand-in event without a lookup.                      */
+
+static int intqbench_index (intq_traceop *ops, int opcnt)
+{
+   u_int64_t *ids = malloc(opcnt * sizeof(u_int64_t));
+   int idcnt = 0;
+   int i;
+
+   if ((ids == NULL) && (opcnt > 0)) {
+      fprintf(stderr, "Out of memory indexing events\n");
+      exit(1);
+   }
+   for (i = 0; i < opcnt; i++) {
+      ids[i] = ops[i].id;
+   }
+   qsort(ids, opcnt, sizeof(u_int64_t), intqbench_idcmp);
+   for (i = 0; i < opcnt; i++) {
+      if ((idcnt == 0) || (ids[idcnt - 1] != ids[i])) {
+         ids[idcnt++] = ids[i];
+      }
+   }
+   for (i = 0; i < opcnt; i++) {
+      u_int64_t *found = bsearch(&ops[i].id, ids, idcnt, sizeof(u_int64_t), intqbench_idcmp);
+      ops[i].id = found - ids;
+   }
+   free(ids);
+   return(idcnt);
+}
+
+
+static double intqbench_run (int type, intq_traceop *ops, int opcnt, int evcnt, u_int64_t *checksum)
+{
+   event *events = calloc((evcnt) ? evcnt : 1, sizeof(event));
+   u_int64_t sum = 0;
+   clock_t start;
+   clock_t stop;
+   int i;
+
+   if (events == NULL) {
+      fprintf(stderr, "Out of memory allocating events\n");
+      exit(1);
+   }
+   intq_settype(type);
+   start = clock();
+   for (i = 0; i < opcnt; i++) {
+      event *curr = &events[ops[i].id];
+      switch (ops[i].op) {
+         case INTQ_OP_INSERT:
+            curr->time = ops[i].time;
+            curr->type = ops[i].type;
+            intq_insert(curr);
+            break;
+         case INTQ_OP_GETNEXT:
+            curr = intq_getnext();
+            sum = (sum * 31) + ((curr) ? (curr - events) + 1 : 0);
+            break;
+         case INTQ_OP_REMOVE:
+            intq_remove(curr);
+            break;
+      }
+   }
+   stop = clock();
+   while (intq_getnext() != NULL) {
+   }
+   intq_cleanup();
+   free(events);
+   *checksum = sum;
+   return((double) (stop - start) / CLOCKS_PER_SEC);
+}
+
+
+int main (int argc, char **argv)
+{
+   intq_traceop *ops;
+   int opcnt;
+   int evcnt;
+   int type;
+   int selected[INTQ_MAX_TYPE + 1];
+   int anyselected = FALSE;
+   int arg = 1;
+
+   bzero(selected, sizeof(selected));
+   while (((arg + 1) < argc) && (strcmp(argv[arg], "-t") == 0)) {
+      type = atoi(argv[arg + 1]);
+      if ((type < INTQ_MIN_TYPE) || (type > INTQ_MAX_TYPE)) {
+         usage(argv[0]);
+      }
+      selected[type] = TRUE;
+      anyselected = TRUE;
+      arg += 2;
+   }
+
+   disksim = calloc(1, sizeof(disksim_t));
+   if (disksim == NULL) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+   }
+
+   if (((argc - arg) == 3) && (strcmp(argv[arg], "-hold") == 0)) {
+      int pending = atoi(argv[arg + 1]);
+      int holds = atoi(argv[arg + 2]);
+      if ((pending <= 0) || (holds < 0)) {
+         usage(argv[0]);
+      }
+      ops = intqbench_hold(pending, holds, &opcnt);
+   } else if ((argc - arg) == 1) {
+      ops = intqbench_load(argv[arg], &opcnt);
+   } else {
+      usage(argv[0]);
+      return(1);
+   }
+   evcnt = intqbench_index(ops, opcnt);
+
+   printf("%d operations on %d distinct events\n", opcnt, evcnt);
+   for (type = INTQ_MIN_TYPE; type <= INTQ_MAX_TYPE; type++) {
+      u_int64_t checksum;
+      double secs;
+      if (anyselected && !selected[type]) {
+         continue;
+      }
+      secs = intqbench_run(type, ops, opcnt, evcnt, &checksum);
+      printf("%-12s %10.3f s  %12.0f ops/s  order %016llx\n", intqbench_names[type], secs, ((secs > 0.0) ? (opcnt / secs) : 0.0), (unsigned long long) checksum);
+   }
+
+   free(ops);
+   return(0);
+}
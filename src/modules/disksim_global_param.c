@@ -2,6 +2,10 @@
 #include <libparam/bitvector.h>
 #include "../disksim_global.h"
 #include <libddbg/libddbg.h>
+#include "../disksim_intq.h"
+#include "../disksim_complog.h"
+#include "../disksim_tseries.h"
+#include "../disksim_profile.h"
 static int
 DISKSIM_GLOBAL_INIT_SEED_depend (char *bv)
 {
@@ -156,6 +160,266 @@ DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE_loader (int result, char *s)
 
 }
 
+static int
+DISKSIM_GLOBAL_EVENT_QUEUE_TYPE_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_EVENT_QUEUE_TYPE_loader (int result, int i)
+{
+  if (!(RANGE (i, INTQ_MIN_TYPE, INTQ_MAX_TYPE)))
+    {				// foo 
+    }
+  intq_settype (i);
+
+}
+
+static int
+DISKSIM_GLOBAL_EVENT_QUEUE_TRACE_FILE_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_EVENT_QUEUE_TRACE_FILE_loader (int result, char *s)
+{
+  if (!((disksim->intqtrace = fopen (s, "wb")) != NULL))
+    {				// foo 
+    }
+
+}
+
+static int
+DISKSIM_GLOBAL_PRINT_ALLOCATOR_STATS_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_PRINT_ALLOCATOR_STATS_loader (int result, int i)
+{
+  if (!(RANGE (i, 0, 1)))
+    {				// foo 
+    }
+  disksim->poolprintstats = i;
+
+}
+
+static int
+DISKSIM_GLOBAL_CHECKPOINT_FILE_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_CHECKPOINT_FILE_loader (int result, char *s)
+{
+  strncpy (disksim->checkpointfilename, s,
+	   sizeof (disksim->checkpointfilename) - 1);
+
+}
+
+static int
+DISKSIM_GLOBAL_CHECKPOINT_INTERVAL_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_CHECKPOINT_INTERVAL_loader (int result, double d)
+{
+  if (!(d >= 0))
+    {				// foo 
+    }
+  disksim->checkpoint_interval = d * (double) 1000.0;
+
+}
+
+static int
+DISKSIM_GLOBAL_CHECKPOINT_IOS_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_CHECKPOINT_IOS_loader (int result, int i)
+{
+  if (!(i >= 0))
+    {				// foo 
+    }
+  disksim->checkpoint_iocnt = i;
+
+}
+
+static int
+DISKSIM_GLOBAL_INTEGER_EVENT_TIMES_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_INTEGER_EVENT_TIMES_loader (int result, int i)
+{
+  if (!(RANGE (i, 0, 1)))
+    {				// foo 
+    }
+  disksim->inttime = i;
+
+}
+
+static int
+DISKSIM_GLOBAL_PREFETCH_TRACE_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_PREFETCH_TRACE_loader (int result, int i)
+{
+  if (!(RANGE (i, 0, 1)))
+    {				// foo 
+    }
+  disksim->traceprefetch = i;
+
+}
+
+static int
+DISKSIM_GLOBAL_TRACE_START_TIME_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_TRACE_START_TIME_loader (int result, double d)
+{
+  if (!(d >= 0))
+    {				// foo 
+    }
+  disksim->tracestart = d * (double) 1000.0;
+
+}
+
+static int
+DISKSIM_GLOBAL_TRACE_STOP_TIME_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_TRACE_STOP_TIME_loader (int result, double d)
+{
+  if (!(d >= 0))
+    {				// foo 
+    }
+  disksim->tracestop = d * (double) 1000.0;
+
+}
+
+static int
+DISKSIM_GLOBAL_TRACE_SAMPLE_RATE_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_TRACE_SAMPLE_RATE_loader (int result, double d)
+{
+  if (!((d > 0) && (d <= 1)))
+    {				// foo 
+    }
+  disksim->tracesample = d;
+
+}
+
+static int
+DISKSIM_GLOBAL_OUTPUT_FILE_FOR_BINARY_IO_COMPLETIONS_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_OUTPUT_FILE_FOR_BINARY_IO_COMPLETIONS_loader (int result,
+							     char *s)
+{
+  snprintf (disksim->complogfilename, sizeof (disksim->complogfilename),
+	    "%s%s", s, disksim->pointsuffix);
+  disksim->complog = complog_open (disksim->complogfilename);
+  ddbg_assert2 (disksim->complog != NULL,
+		"failed to open binary I/O completion log!");
+
+}
+
+static int
+DISKSIM_GLOBAL_STATISTICS_INTERVAL_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_STATISTICS_INTERVAL_loader (int result, double d)
+{
+  if (!(d > 0))
+    {				// foo 
+    }
+  disksim->tseriesinterval = d * (double) 1000.0;
+
+}
+
+static int
+DISKSIM_GLOBAL_OUTPUT_FILE_FOR_INTERVAL_STATISTICS_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_OUTPUT_FILE_FOR_INTERVAL_STATISTICS_loader (int result,
+							   char *s)
+{
+  snprintf (disksim->tseriesfilename, sizeof (disksim->tseriesfilename),
+	    "%s%s", s, disksim->pointsuffix);
+  disksim->tseries = tseries_open (disksim->tseriesfilename);
+  ddbg_assert2 (disksim->tseries != NULL,
+		"failed to open interval statistics file!");
+
+}
+
+static int
+DISKSIM_GLOBAL_PRINT_STATISTICS_IN_JSON_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_PRINT_STATISTICS_IN_JSON_loader (int result, int i)
+{
+  if (!(RANGE (i, 0, 1)))
+    {				// foo 
+    }
+  disksim->statjson = i;
+
+}
+
+static int
+DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS_loader (int result, int i)
+{
+  if (!(RANGE (i, 0, 1)))
+    {				// foo 
+    }
+  if (i)
+    {
+      disksim->profile = profile_open ();
+    }
+
+}
+
 void *DISKSIM_GLOBAL_loaders[] = {
   (void *) DISKSIM_GLOBAL_INIT_SEED_loader,
   (void *) DISKSIM_GLOBAL_INIT_SEED_WITH_TIME_loader,
@@ -166,7 +430,23 @@ void *DISKSIM_GLOBAL_loaders[] = {
   (void *) DISKSIM_GLOBAL_STAT_DEFINITION_FILE_loader,
   (void *)
     DISKSIM_GLOBAL_OUTPUT_FILE_FOR_TRACE_OF_IO_REQUESTS_SIMULATED_loader,
-  (void *) DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE_loader
+  (void *) DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE_loader,
+  (void *) DISKSIM_GLOBAL_EVENT_QUEUE_TYPE_loader,
+  (void *) DISKSIM_GLOBAL_EVENT_QUEUE_TRACE_FILE_loader,
+  (void *) DISKSIM_GLOBAL_PRINT_ALLOCATOR_STATS_loader,
+  (void *) DISKSIM_GLOBAL_CHECKPOINT_FILE_loader,
+  (void *) DISKSIM_GLOBAL_CHECKPOINT_INTERVAL_loader,
+  (void *) DISKSIM_GLOBAL_CHECKPOINT_IOS_loader,
+  (void *) DISKSIM_GLOBAL_INTEGER_EVENT_TIMES_loader,
+  (void *) DISKSIM_GLOBAL_PREFETCH_TRACE_loader,
+  (void *) DISKSIM_GLOBAL_TRACE_START_TIME_loader,
+  (void *) DISKSIM_GLOBAL_TRACE_STOP_TIME_loader,
+  (void *) DISKSIM_GLOBAL_TRACE_SAMPLE_RATE_loader,
+  (void *) DISKSIM_GLOBAL_OUTPUT_FILE_FOR_BINARY_IO_COMPLETIONS_loader,
+  (void *) DISKSIM_GLOBAL_STATISTICS_INTERVAL_loader,
+  (void *) DISKSIM_GLOBAL_OUTPUT_FILE_FOR_INTERVAL_STATISTICS_loader,
+  (void *) DISKSIM_GLOBAL_PRINT_STATISTICS_IN_JSON_loader,
+  (void *) DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS_loader
 };
 
 lp_paramdep_t DISKSIM_GLOBAL_deps[] = {
@@ -178,5 +458,21 @@ lp_paramdep_t DISKSIM_GLOBAL_deps[] = {
   DISKSIM_GLOBAL_STATISTIC_WARM_UP_IOS_depend,
   DISKSIM_GLOBAL_STAT_DEFINITION_FILE_depend,
   DISKSIM_GLOBAL_OUTPUT_FILE_FOR_TRACE_OF_IO_REQUESTS_SIMULATED_depend,
-  DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE_depend
+  DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE_depend,
+  DISKSIM_GLOBAL_EVENT_QUEUE_TYPE_depend,
+  DISKSIM_GLOBAL_EVENT_QUEUE_TRACE_FILE_depend,
+  DISKSIM_GLOBAL_PRINT_ALLOCATOR_STATS_depend,
+  DISKSIM_GLOBAL_CHECKPOINT_FILE_depend,
+  DISKSIM_GLOBAL_CHECKPOINT_INTERVAL_depend,
+  DISKSIM_GLOBAL_CHECKPOINT_IOS_depend,
+  DISKSIM_GLOBAL_INTEGER_EVENT_TIMES_depend,
+  DISKSIM_GLOBAL_PREFETCH_TRACE_depend,
+  DISKSIM_GLOBAL_TRACE_START_TIME_depend,
+  DISKSIM_GLOBAL_TRACE_STOP_TIME_depend,
+  DISKSIM_GLOBAL_TRACE_SAMPLE_RATE_depend,
+  DISKSIM_GLOBAL_OUTPUT_FILE_FOR_BINARY_IO_COMPLETIONS_depend,
+  DISKSIM_GLOBAL_STATISTICS_INTERVAL_depend,
+  DISKSIM_GLOBAL_OUTPUT_FILE_FOR_INTERVAL_STATISTICS_depend,
+  DISKSIM_GLOBAL_PRINT_STATISTICS_IN_JSON_depend,
+  DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS_depend
 };
@@ -20,10 +20,26 @@ typedef enum {
    DISKSIM_GLOBAL_STATISTIC_WARM_UP_IOS,
    DISKSIM_GLOBAL_STAT_DEFINITION_FILE,
    DISKSIM_GLOBAL_OUTPUT_FILE_FOR_TRACE_OF_IO_REQUESTS_SIMULATED,
-   DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE
+   DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE,
+   DISKSIM_GLOBAL_EVENT_QUEUE_TYPE,
+   DISKSIM_GLOBAL_EVENT_QUEUE_TRACE_FILE,
+   DISKSIM_GLOBAL_PRINT_ALLOCATOR_STATS,
+   DISKSIM_GLOBAL_CHECKPOINT_FILE,
+   DISKSIM_GLOBAL_CHECKPOINT_INTERVAL,
+   DISKSIM_GLOBAL_CHECKPOINT_IOS,
+   DISKSIM_GLOBAL_INTEGER_EVENT_TIMES,
+   DISKSIM_GLOBAL_PREFETCH_TRACE,
+   DISKSIM_GLOBAL_TRACE_START_TIME,
+   DISKSIM_GLOBAL_TRACE_STOP_TIME,
+   DISKSIM_GLOBAL_TRACE_SAMPLE_RATE,
+   DISKSIM_GLOBAL_OUTPUT_FILE_FOR_BINARY_IO_COMPLETIONS,
+   DISKSIM_GLOBAL_STATISTICS_INTERVAL,
+   DISKSIM_GLOBAL_OUTPUT_FILE_FOR_INTERVAL_STATISTICS,
+   DISKSIM_GLOBAL_PRINT_STATISTICS_IN_JSON,
+   DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS
 } disksim_global_param_t;
 
-#define DISKSIM_GLOBAL_MAX_PARAM		DISKSIM_GLOBAL_DETAILED_EXECUTION_TRACE
+#define DISKSIM_GLOBAL_MAX_PARAM		DISKSIM_GLOBAL_PROFILE_SIMULATOR_EVENTS
 extern void * DISKSIM_GLOBAL_loaders[];
 extern lp_paramdep_t DISKSIM_GLOBAL_deps[];
 
@@ -38,9 +54,25 @@ static struct lp_varspec disksim_global_params [] = {
    {"Stat definition file", S, 1 },
    {"Output file for trace of I/O requests simulated", S, 0 },
    {"Detailed execution trace", S, 0 },
+   {"Event queue type", I, 0 },
+   {"Event queue trace file", S, 0 },
+   {"Print allocator stats", I, 0 },
+   {"Checkpoint file", S, 0 },
+   {"Checkpoint interval", D, 0 },
+   {"Checkpoint IOs", I, 0 },
+   {"Integer event times", I, 0 },
+   {"Prefetch trace", I, 0 },
+   {"Trace start time", D, 0 },
+   {"Trace stop time", D, 0 },
+   {"Trace sample rate", D, 0 },
+   {"Output file for binary I/O completions", S, 0 },
+   {"Statistics interval", D, 0 },
+   {"Output file for interval statistics", S, 0 },
+   {"Print statistics in JSON", I, 0 },
+   {"Profile simulator events", I, 0 },
    {0,0,0}
 };
-#define DISKSIM_GLOBAL_MAX 9
+#define DISKSIM_GLOBAL_MAX 25
 static struct lp_mod disksim_global_mod = { "disksim_global", disksim_global_params, DISKSIM_GLOBAL_MAX, (lp_modloader_t)disksim_global_loadparams,  0, 0, DISKSIM_GLOBAL_loaders, DISKSIM_GLOBAL_deps };
 
 
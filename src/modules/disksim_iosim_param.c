@@ -10,6 +10,7 @@ DISKSIM_IOSIM_IO_TRACE_TIME_SCALE_depend (char *bv)
 static void
 DISKSIM_IOSIM_IO_TRACE_TIME_SCALE_loader (int result, double d)
 {
+  ioscale = d;
   if (ioscale < 0.0)
     {
       if (ioscale > -1.0)
@@ -47,12 +48,48 @@ DISKSIM_IOSIM_IO_MAPPINGS_loader (int result, struct lp_list *l)
 
 }
 
+static int
+DISKSIM_IOSIM_CLOSED_LOOP_STREAM_DEPTH_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_IOSIM_CLOSED_LOOP_STREAM_DEPTH_loader (int result, int i)
+{
+  if (!(i >= 0))
+    {				// foo 
+    }
+  iostreamdepth = i;
+
+}
+
+static int
+DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME_depend (char *bv)
+{
+  return -1;
+}
+
+static void
+DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME_loader (int result, double d)
+{
+  if (!(d >= 0))
+    {				// foo 
+    }
+  iostreamsvc = d;
+
+}
+
 void *DISKSIM_IOSIM_loaders[] = {
   (void *) DISKSIM_IOSIM_IO_TRACE_TIME_SCALE_loader,
-  (void *) DISKSIM_IOSIM_IO_MAPPINGS_loader
+  (void *) DISKSIM_IOSIM_IO_MAPPINGS_loader,
+  (void *) DISKSIM_IOSIM_CLOSED_LOOP_STREAM_DEPTH_loader,
+  (void *) DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME_loader
 };
 
 lp_paramdep_t DISKSIM_IOSIM_deps[] = {
   DISKSIM_IOSIM_IO_TRACE_TIME_SCALE_depend,
-  DISKSIM_IOSIM_IO_MAPPINGS_depend
+  DISKSIM_IOSIM_IO_MAPPINGS_depend,
+  DISKSIM_IOSIM_CLOSED_LOOP_STREAM_DEPTH_depend,
+  DISKSIM_IOSIM_CLOSED_LOOP_STREAM_SERVICE_TIME_depend
 };
@@ -111,12 +111,12 @@ void syssim_report_completion(SysTime t, struct disksim_request *r, void *ctx)
 int main(int argc, char *argv[])
 {
   int i;
-  int nsectors;
+  long long nsectors;
   struct stat buf;
   struct disksim_request r;
   struct disksim_interface *disksim;
 
-  if (argc != 4 || (nsectors = atoi(argv[3])) <= 0) {
+  if (argc != 4 || (nsectors = atoll(argv[3])) <= 0) {
     fprintf(stderr, "usage: %s <param file> <output file> <#sectors>\n",
 	    argv[0]);
     exit(1);
@@ -0,0 +1,126 @@
+/*
+ * DiskSim Storage Subsystem Simulation Environment (Version 4.0)
+ * Revision Authors: John Bucy, Greg Ganger
+ * Contributors: John Griffin, Jiri Schindler, Steve Schlosser
+ *
+ * Copyright (c) of Carnegie Mellon University, 2001-2008.
+ *
+ * This software is being provided by the copyright holders under the
+ * following license. By obtaining, using and/or copying this software,
+ * you agree that you have read, understood, and will comply with the
+ * following terms and conditions:
+ *
+ * Permission to reproduce, use, and prepare derivative works of this
+ * software is granted provided the copyright and "No Warranty" statements
+ * are included with all reproductions and derivative works and associated
+ * documentation. This software may also be redistributed without charge
+ * provided that the copyright and "No Warranty" statements are included
+ * in all redistributions.
+ *
+ * NO WARRANTY. THIS SOFTWARE IS FURNISHED ON AN "AS IS" BASIS.
+ * CARNEGIE MELLON UNIVERSITY MAKES NO WARRANTIES OF ANY KIND, EITHER
+ * EXPRESSED OR IMPLIED AS TO THE MATTER INCLUDING, BUT NOT LIMITED
+ * TO: WARRANTY OF FITNESS FOR PURPOSE OR MERCHANTABILITY, EXCLUSIVITY
+ * OF RESULTS OR RESULTS OBTAINED FROM USE OF THIS SOFTWARE. CARNEGIE
+ * MELLON UNIVERSITY DOES NOT MAKE ANY WARRANTY OF ANY KIND WITH RESPECT
+ * TO FREEDOM FROM PATENT, TRADEMARK, OR COPYRIGHT INFRINGEMENT.
+ * COPYRIGHT HOLDERS WILL BEAR NO LIABILITY FOR ANY USE OF THIS SOFTWARE
+ * OR DOCUMENTATION.
+ *
+ */
+
+/* trace2col converts an I/O trace in any of the formats DiskSim reads  */
+/* into the columnar format (see disksim_iotrace.c), which DiskSim then */
+/* reads with trace format "columnar".  The requests are read with      */
+/* DiskSim's own trace readers, so the result is exactly what the       */
+/* original trace would have fed the simulation, apart from fields     */
+/* only some formats carry (e.g., the traced response times in HPL     */
+/* traces) and times being rounded to the nearest nanosecond.  The     */
+/* input trace may be compressed (see disksim_tracefile.h).             */
+/*                                                                      */
+/*    trace2col <format> <input trace> <output file>                    */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "disksim_global.h"
+#include "disksim_iotrace.h"
+#include "disksim_tracefile.h"
+
+
+static void usage (char *progname)
+{
+   fprintf(stderr, "usage: %s <format> <input trace> <output file>\n", progname);
+   fprintf(stderr, "       format is one of ascii, batch, raw, hpl, hpl2, emcsymm, emcbackend,\n");
+   fprintf(stderr, "       blktrace, msr, spc, merge\n");
+   exit(1);
+}
+
+
+int main (int argc, char **argv)
+{
+   int n = 0x11223344;
+   FILE *infile;
+   FILE *outfile;
+   iotrace_colwriter *w;
+   ioreq_event *curr;
+   double reqs = 0.0;
+
+   if (argc != 4) {
+      usage(argv[0]);
+   }
+
+   disksim = calloc(1, sizeof(disksim_t));
+   if (disksim == NULL) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+   }
+   disksim->endian = (*((char *) &n) == 0x11) ? _BIG_ENDIAN : _LITTLE_ENDIAN;
+
+   iotrace_set_format(argv[1]);
+   if (disksim->traceformat == VALIDATE) {
+      /* request times depend on when the previous request completed */
+      fprintf(stderr, "Validation traces cannot be converted\n");
+      exit(1);
+   }
+   if (disksim->traceformat == DEC) {
+      fprintf(stderr, "The DEC trace reader is not part of this distribution\n");
+      exit(1);
+   }
+
+   if (strcmp(argv[2], "stdin") == 0) {
+      infile = stdin;
+   } else if ((infile = fopen(argv[2], "rb")) == NULL) {
+      fprintf(stderr, "Tracefile %s cannot be opened for read access\n", argv[2]);
+      exit(1);
+   }
+   infile = tracefile_open(infile, NULL);
+   if ((outfile = fopen(argv[3], "wb")) == NULL) {
+      fprintf(stderr, "Output file %s cannot be opened for write access\n", argv[3]);
+      exit(1);
+   }
+   w = iotrace_columnar_open(outfile);
+   if (w == NULL) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+   }
+
+   iotrace_initialize_file(infile, disksim->traceformat, FALSE);
+   while ((curr = iotrace_get_ioreq_event(infile, disksim->traceformat, (ioreq_event *) getfromextraq())) != NULL) {
+      curr->time += tracebasetime;
+      iotrace_columnar_put(w, curr);
+      addtoextraq((event *) curr);
+      reqs += 1.0;
+   }
+
+   if (iotrace_columnar_close(w) != 0) {
+      fprintf(stderr, "Error writing %s\n", argv[3]);
+      exit(1);
+   }
+   fclose(outfile);
+   printf("%.0f requests converted\n", reqs);
+   /* e.g. the devnos given to named devices */
+   iotrace_printstats(stdout);
+   exit(0);
+}
@@ -0,0 +1,23 @@
+# Compressed trace support (disksim_tracefile.c), shared by every
+# Makefile that links libdisksim.  A decompressor is compiled in when
+# pkg-config, or failing that the compiler, can find it; plain traces
+# are read either way.
+
+tracefile_have = $(shell (pkg-config --exists $(1) 2>/dev/null || \
+	printf '\043include <$(2)>\n' | gcc -E - >/dev/null 2>&1) && echo yes)
+
+TRACEFILE_CFLAGS =
+TRACEFILE_LDFLAGS =
+
+ifeq ($(call tracefile_have,zlib,zlib.h),yes)
+TRACEFILE_CFLAGS += -DHAVE_ZLIB
+TRACEFILE_LDFLAGS += -lz
+endif
+ifeq ($(call tracefile_have,libzstd,zstd.h),yes)
+TRACEFILE_CFLAGS += -DHAVE_ZSTD
+TRACEFILE_LDFLAGS += -lzstd
+endif
+ifeq ($(call tracefile_have,liblzma,lzma.h),yes)
+TRACEFILE_CFLAGS += -DHAVE_LZMA
+TRACEFILE_LDFLAGS += -llzma
+endif
@@ -353,9 +353,9 @@ static void ssd_bustransfer_complete (ioreq_event *curr)
  * returns the logical page number within an element given a block number as
  * issued by the file system
  */
-int ssd_logical_pageno(int blkno, ssd_t *s)
+int ssd_logical_pageno(disksim_lbn_t blkno, ssd_t *s)
 {
-    int apn;
+    disksim_lbn_t apn;
     int lpn;
 
     // absolute page number is the block number as written by the above layer
@@ -367,12 +367,44 @@ int ssd_logical_pageno(int blkno, ssd_t *s)
     // apn we calculated above and the physical page number. but the range
     // of apn is several times bigger and so we chose to go with the mapping
     // b/w lpn --> physical page number
-    lpn = ((apn - (apn % (s->params.element_stride_pages * s->params.nelements)))/
-                      s->params.nelements) + (apn % s->params.element_stride_pages);
+    lpn = (int) (((apn - (apn % (s->params.element_stride_pages * s->params.nelements)))/
+                      s->params.nelements) + (apn % s->params.element_stride_pages));
 
     return lpn;
 }
 
+/*
+ * with a sampled trace, returns where the unit holding blkno was packed
+ * into the scaled flash (see ssd_sample_init), giving it the next unused
+ * unit the first time it is touched. if the sample touches more units
+ * than fit, the rest share units by wrapping around.
+ */
+disksim_lbn_t ssd_sample_blkno(ssd_t *s, disksim_lbn_t blkno)
+{
+    disksim_lbn_t unit;
+    u_int64_t h;
+    unsigned int slot;
+
+    if (s->samplekey == NULL) {
+        return blkno;
+    }
+
+    unit = blkno / s->sampleunit;
+    h = (u_int64_t) unit * 0x9E3779B97F4A7C15ULL;
+    slot = (unsigned int) (h >> 32) & s->samplemask;
+    while ((s->samplekey[slot] != 0) && (s->samplekey[slot] != (unit + 1))) {
+        slot = (slot + 1) & s->samplemask;
+    }
+    if (s->samplekey[slot] == 0) {
+        if (s->samplenext == s->samplecap) {
+            return ((unit % s->samplecap) * s->sampleunit) + (blkno % s->sampleunit);
+        }
+        s->samplekey[slot] = unit + 1;
+        s->sampleval[slot] = s->samplenext++;
+    }
+    return ((disksim_lbn_t) s->sampleval[slot] * s->sampleunit) + (blkno % s->sampleunit);
+}
+
 int ssd_already_present(ssd_req **reqs, int total, ioreq_event *req)
 {
     int i;
@@ -420,7 +452,7 @@ static int ssd_invoke_element_cleaning(int elem_num, ssd_t *s)
         tmp->devno = s->devno;
         tmp->time = simtime + max_cost;
         tmp->blkno = elem_num;
-        tmp->ssd_elem_num = elem_num;
+        tmp->dev.ssd.elem_num = elem_num;
         tmp->type = SSD_CLEAN_ELEMENT;
         tmp->flags = SSD_CLEAN_ELEMENT;
         tmp->busno = -1;
@@ -496,8 +528,8 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
         // in order to simplify the overlapping strategy, let's issue
         // requests of the same type together.
 
-        read_reqs = (ssd_req **) malloc(max_reqs * sizeof(ssd_req *));
-        write_reqs = (ssd_req **) malloc(max_reqs * sizeof(ssd_req *));
+        read_reqs = (ssd_req **) disksim_pool_get(DISKSIM_POOL_SSDREQ, max_reqs * sizeof(ssd_req *));
+        write_reqs = (ssd_req **) disksim_pool_get(DISKSIM_POOL_SSDREQ, max_reqs * sizeof(ssd_req *));
 
         // collect the requests
         while ((req = ioqueue_get_next_request(elem->queue)) != NULL) {
@@ -516,7 +548,7 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
 
             if (!found) {
                 // this is a valid request
-                ssd_req *r = malloc(sizeof(ssd_req));
+                ssd_req *r = disksim_pool_get(DISKSIM_POOL_SSDREQ, sizeof(ssd_req));
                 r->blk = req->blkno;
                 r->count = req->bcount;
                 r->is_read = req->flags & READ;
@@ -540,7 +572,7 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
                 // throw this request -- it doesn't make sense
                 stat_update (&currdisk->stat.acctimestats, 0);
                 req->time = simtime;
-                req->ssd_elem_num = elem_num;
+                req->dev.ssd.elem_num = elem_num;
                 req->type = DEVICE_ACCESS_COMPLETE;
                 addtointq ((event *)req);
             }
@@ -563,18 +595,18 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
 
               stat_update (&currdisk->stat.acctimestats, read_reqs[i]->acctime);
               read_reqs[i]->org_req->time = simtime + read_reqs[i]->schtime;
-              read_reqs[i]->org_req->ssd_elem_num = elem_num;
+              read_reqs[i]->org_req->dev.ssd.elem_num = elem_num;
               read_reqs[i]->org_req->type = DEVICE_ACCESS_COMPLETE;
 
               //printf("R: blk %d elem %d acctime %f simtime %f\n", read_reqs[i]->blk,
                 //  elem_num, read_reqs[i]->acctime, read_reqs[i]->org_req->time);
 
               addtointq ((event *)read_reqs[i]->org_req);
-              free(read_reqs[i]);
+              disksim_pool_put(read_reqs[i]);
             }
         }
 
-        free(read_reqs);
+        disksim_pool_put(read_reqs);
 
         max_time_taken = schtime;
 
@@ -596,17 +628,17 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
                   max_time_taken = (schtime+write_reqs[i]->schtime);
               }
 
-              write_reqs[i]->org_req->ssd_elem_num = elem_num;
+              write_reqs[i]->org_req->dev.ssd.elem_num = elem_num;
               write_reqs[i]->org_req->type = DEVICE_ACCESS_COMPLETE;
               //printf("W: blk %d elem %d acctime %f simtime %f\n", write_reqs[i]->blk,
                 //  elem_num, write_reqs[i]->acctime, write_reqs[i]->org_req->time);
 
               addtointq ((event *)write_reqs[i]->org_req);
-              free(write_reqs[i]);
+              disksim_pool_put(write_reqs[i]);
             }
         }
 
-        free(write_reqs);
+        disksim_pool_put(write_reqs);
 
         // statistics
         tot_reqs_issued = read_total + write_total;
@@ -620,7 +652,7 @@ static void ssd_activate_elem(ssd_t *currdisk, int elem_num)
 static void ssd_media_access_request_element (ioreq_event *curr)
 {
    ssd_t *currdisk = getssd(curr->devno);
-   int blkno = curr->blkno;
+   disksim_lbn_t blkno = curr->blkno;
    int count = curr->bcount;
 
    /* **** CAREFUL ... HIJACKING tempint2 and tempptr2 fields here **** */
@@ -628,7 +660,8 @@ static void ssd_media_access_request_element (ioreq_event *curr)
    while (count != 0) {
 
        // find the element (package) to direct the request
-       int elem_num = currdisk->timing_t->choose_element(currdisk->timing_t, blkno);
+       disksim_lbn_t mapped = ssd_sample_blkno(currdisk, blkno);
+       int elem_num = currdisk->timing_t->choose_element(currdisk->timing_t, mapped);
        ssd_element *elem = &currdisk->elements[elem_num];
 
        // create a new sub-request for the element
@@ -636,7 +669,7 @@ static void ssd_media_access_request_element (ioreq_event *curr)
        tmp->devno = curr->devno;
        tmp->busno = curr->busno;
        tmp->flags = curr->flags;
-       tmp->blkno = blkno;
+       tmp->blkno = mapped;
        tmp->bcount = ssd_choose_aligned_count(currdisk->params.page_size, blkno, count);
        ASSERT(tmp->bcount == currdisk->params.page_size);
 
@@ -723,7 +756,7 @@ static void ssd_request_arrive (ioreq_event *curr)
    /* verify that request is valid. */
    if ((curr->blkno < 0) || (curr->bcount <= 0) ||
        ((curr->blkno + curr->bcount) > currdisk->numblocks)) {
-      fprintf(stderr, "Invalid set of blocks requested from ssd - blkno %d, bcount %d, numblocks %d\n", curr->blkno, curr->bcount, currdisk->numblocks);
+      fprintf(stderr, "Invalid set of blocks requested from ssd - blkno %lld, bcount %d, numblocks %lld\n", curr->blkno, curr->bcount, currdisk->numblocks);
       exit(1);
    }
 
@@ -763,7 +796,7 @@ static void ssd_clean_element_complete(ioreq_event *curr)
    int elem_num;
 
    currdisk = getssd (curr->devno);
-   elem_num = curr->ssd_elem_num;
+   elem_num = curr->dev.ssd.elem_num;
    ASSERT(currdisk->elements[elem_num].media_busy == TRUE);
 
    // release this event
@@ -811,7 +844,7 @@ static void ssd_access_complete_element(ioreq_event *curr)
 
    currdisk = getssd (curr->devno);
    elem_num = currdisk->timing_t->choose_element(currdisk->timing_t, curr->blkno);
-   ASSERT(elem_num == curr->ssd_elem_num);
+   ASSERT(elem_num == curr->dev.ssd.elem_num);
    elem = &currdisk->elements[elem_num];
 
    if ((x = ioqueue_physical_access_done(elem->queue,curr)) == NULL) {
@@ -971,7 +1004,7 @@ void ssd_event_arrive (ioreq_event *curr)
 }
 
 
-int ssd_get_number_of_blocks (int devno)
+disksim_lbn_t ssd_get_number_of_blocks (int devno)
 {
    ssd_t *currdisk = getssd (devno);
    return (currdisk->numblocks);
@@ -981,21 +1014,33 @@ int ssd_get_number_of_blocks (int devno)
 int ssd_get_numcyls (int devno)
 {
    ssd_t *currdisk = getssd (devno);
-   return (currdisk->numblocks);
+   return ((int) currdisk->numblocks);
+}
+
+
+void ssd_get_counters (int devno, device_counters *counters)
+{
+   ssd_t *currdisk = getssd (devno);
+   int i;
+
+   for (i=0; i<currdisk->params.nelements; i++) {
+      counters->cleans += currdisk->elements[i].stat.num_clean;
+      counters->pagesmoved += currdisk->elements[i].stat.pages_moved;
+   }
 }
 
 
-void ssd_get_mapping (int maptype, int devno, int blkno, int *cylptr, int *surfaceptr, int *blkptr)
+void ssd_get_mapping (int maptype, int devno, disksim_lbn_t blkno, int *cylptr, int *surfaceptr, int *blkptr)
 {
    ssd_t *currdisk = getssd (devno);
 
    if ((blkno < 0) || (blkno >= currdisk->numblocks)) {
-      fprintf(stderr, "Invalid blkno at ssd_get_mapping: %d\n", blkno);
+      fprintf(stderr, "Invalid blkno at ssd_get_mapping: %lld\n", blkno);
       exit(1);
    }
 
    if (cylptr) {
-      *cylptr = blkno;
+      *cylptr = (int) blkno;
    }
    if (surfaceptr) {
       *surfaceptr = 0;
@@ -1012,7 +1057,7 @@ int ssd_get_avg_sectpercyl (int devno)
 }
 
 
-int ssd_get_distance (int devno, ioreq_event *req, int exact, int direction)
+int ssd_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction)
 {
    /* just return an arbitrary constant, since acctime is constant */
    return 1;
@@ -1266,6 +1311,7 @@ void ssd_printcleanstats(int *set, int setsize, char *sourcestr)
                 double avg_lifetime;
                 double elem_iops = 0;
                 double elem_clean_iops = 0;
+                char elemstr[100];
 
                 ssd_element_stat *stat = &(s->elements[j].stat);
 
@@ -1321,6 +1367,15 @@ void ssd_printcleanstats(int *set, int setsize, char *sourcestr)
                 }
                 fprintf(outputfile, "%s #%d elem #%d   Average lifetime:\t%f\n",
                     sourcestr, set[i], j, avg_lifetime);
+
+                sprintf(elemstr, "%s #%d elem #%d", sourcestr, set[i], j);
+                stat_json_value(elemstr, "Total reqs issued", stat->tot_reqs_issued);
+                stat_json_value(elemstr, "Total time taken", stat->tot_time_taken);
+                stat_json_value(elemstr, "Total cleaning reqs issued", stat->num_clean);
+                stat_json_value(elemstr, "Total cleaning time taken", stat->tot_clean_time);
+                stat_json_value(elemstr, "Number of free blocks", s->elements[j].metadata.tot_free_blocks);
+                stat_json_value(elemstr, "Pages moved", stat->pages_moved);
+                stat_json_value(elemstr, "Average lifetime", avg_lifetime);
                 fprintf(outputfile, "%s #%d elem #%d   Plane Level Statistics\n",
                     sourcestr, set[i], j);
                 fprintf(outputfile, "%s #%d elem #%d   ", sourcestr, set[i], j);
@@ -1505,5 +1560,6 @@ struct device_header ssd_hdr_initializer = {
   ssd_get_seektime,
   ssd_get_acctime,
   ssd_bus_delay_complete,
-  ssd_bus_ownership_grant
+  ssd_bus_ownership_grant,
+  ssd_get_counters
 };
@@ -279,6 +279,9 @@ typedef struct _gang_metadata {
 #define SSD_ALLOC_POOL_CHIP                     1   // each element is an allocation pool
 #define SSD_ALLOC_POOL_PLANE                    2
 
+// fewest blocks per plane left to a sampled ssd
+#define SSD_SAMPLE_MIN_BLOCKS                   64
+
 // what do the gangs share?
 #define SSD_SHARED_BUS_GANG                     1  // shares both data and control
 #define SSD_SHARED_CONTROL_GANG                 2  // shares only the control
@@ -338,7 +341,7 @@ typedef struct ssd {
 
    double overhead;
    double bus_transaction_latency;
-   int numblocks;
+   disksim_lbn_t numblocks;
    int devno;
    int inited;
    int reconnect_reason;
@@ -353,6 +356,15 @@ typedef struct ssd {
    unsigned int data_pages_per_elem;    // number of pages that can be used to store data
    gang_metadata gang_meta[SSD_MAX_ELEMENTS];
 
+   // for sampled traces (see "Trace sample rate"): where each logical
+   // unit the sample touches was packed into the smaller flash
+   int sampleunit;                 // sectors per unit
+   int samplecap;                  // units that fit
+   int samplenext;                 // next unused unit
+   unsigned int samplemask;        // hash table size - 1
+   disksim_lbn_t *samplekey;       // unit + 1, or 0 for a free slot
+   int *sampleval;
+
    double blktranstime;
    int maxqlen;
    int busowned;
@@ -375,7 +387,7 @@ typedef struct ssd_info {
 
 /* request structure */
 typedef struct _ssd_req {
-    int blk;
+    disksim_lbn_t blk;
     int count;
     int is_read;
     int plane_num;
@@ -423,26 +435,28 @@ int     ssd_get_depth (int devno);
 int     ssd_get_inbus (int devno);
 int     ssd_get_busno (ioreq_event *curr);
 int     ssd_get_slotno (int devno);
-int     ssd_get_number_of_blocks (int devno);
+disksim_lbn_t ssd_get_number_of_blocks (int devno);
 int     ssd_get_maxoutstanding (int devno);
 int     ssd_get_numdisks (void);
 int     ssd_get_numcyls (int devno);
 double  ssd_get_blktranstime (ioreq_event *curr);
 int     ssd_get_avg_sectpercyl (int devno);
-void    ssd_get_mapping (int maptype, int devno, int blkno, int *cylptr, int *surfaceptr, int *blkptr);
+void    ssd_get_mapping (int maptype, int devno, disksim_lbn_t blkno, int *cylptr, int *surfaceptr, int *blkptr);
 void    ssd_event_arrive (ioreq_event *curr);
-int     ssd_get_distance (int devno, ioreq_event *req, int exact, int direction);
+int     ssd_get_distance (int devno, ioreq_event *req, disksim_lbn_t exact, int direction);
 double  ssd_get_servtime (int devno, ioreq_event *req, int checkcache, double maxtime);
 double  ssd_get_acctime (int devno, ioreq_event *req, double maxtime);
 void    ssd_bus_delay_complete (int devno, ioreq_event *curr, int sentbusno);
 void    ssd_bus_ownership_grant (int devno, ioreq_event *curr, int busno, double arbdelay);
+void    ssd_get_counters (int devno, device_counters *counters);
 
 void    ssd_assert_free_blocks(ssd_t *s, ssd_element_metadata *metadata);
 void    ssd_assert_valid_pages(int plane_num, ssd_element_metadata *metadata, ssd_t *s);
 double  ssd_data_transfer_cost(ssd_t *s, int sectors_count);
 int     ssd_last_page_in_block(int page_num, ssd_t *s);
 double  _ssd_write_page_osr(ssd_t *s, ssd_element_metadata *metadata, int lpn);
-int     ssd_logical_pageno(int blkno, ssd_t *s);
+int     ssd_logical_pageno(disksim_lbn_t blkno, ssd_t *s);
+disksim_lbn_t ssd_sample_blkno(ssd_t *s, disksim_lbn_t blkno);
 int     ssd_block_to_bitpos(ssd_t *currdisk, int block);
 int     ssd_bitpos_to_block(int bitpos, ssd_t *s);
 void    _ssd_alloc_active_block(int plane_num, int elem_num, ssd_t *s);
@@ -46,7 +46,7 @@ static int ssd_invoke_gang_cleaning(int gang_num, ssd_t *s)
         tmp->devno = s->devno;
         tmp->time = simtime + max_cost;
         tmp->blkno = gang_num;
-        tmp->ssd_gang_num = gang_num;
+        tmp->dev.ssd.gang_num = gang_num;
         tmp->type = SSD_CLEAN_GANG;
         tmp->flags = SSD_CLEAN_GANG;
         tmp->busno = -1;
@@ -108,7 +108,7 @@ static void ssd_collect_req_in_gang
 
             if (!found) {
                 // this is a valid request
-                ssd_req *r = malloc(sizeof(ssd_req));
+                ssd_req *r = disksim_pool_get(DISKSIM_POOL_SSDREQ, sizeof(ssd_req));
                 r->blk = req->blkno;
                 r->count = req->bcount;
                 r->is_read = req->flags & READ;
@@ -126,8 +126,8 @@ static void ssd_collect_req_in_gang
                 // throw this request -- it doesn't make sense
                 stat_update (&s->stat.acctimestats, 0);
                 req->time = simtime;
-                req->ssd_elem_num = i;
-                req->ssd_gang_num = gang_num;
+                req->dev.ssd.elem_num = i;
+                req->dev.ssd.gang_num = gang_num;
 
                 req->type = DEVICE_ACCESS_COMPLETE;
                 addtointq ((event *)req);
@@ -144,36 +144,36 @@ static void ssd_collect_req_in_gang
     } while (i != start);
 }
 
-int choose_gang(int blk, ssd_t *s)
+int choose_gang(disksim_lbn_t blk, ssd_t *s)
 {
     int num_gangs = SSD_NUM_GANG(s);
-    int page = blk / s->params.page_size;
+    disksim_lbn_t page = blk / s->params.page_size;
 
     // assuming stripping across the gangs
-    return ((page/s->params.elements_per_gang) % num_gangs);
+    return (int) ((page/s->params.elements_per_gang) % num_gangs);
 }
 
-int ssd_gang_index(int blk, ssd_t *s)
+int ssd_gang_index(disksim_lbn_t blk, ssd_t *s)
 {
-    int page = blk/s->params.page_size;
-    int i = page/s->params.elements_per_gang;
-    return (i/SSD_NUM_GANG(s));
+    disksim_lbn_t page = blk/s->params.page_size;
+    disksim_lbn_t i = page/s->params.elements_per_gang;
+    return (int) (i/SSD_NUM_GANG(s));
 }
 
-int choose_elem_in_gang(int blk, int gang_num, ssd_t *s)
+int choose_elem_in_gang(disksim_lbn_t blk, int gang_num, ssd_t *s)
 {
     int j;
     int elem_num;
     int num_gangs = SSD_NUM_GANG(s);
-    int page = blk / s->params.page_size;
+    disksim_lbn_t page = blk / s->params.page_size;
     int pg_index_in_gang;
     gang_metadata *gm = &s->gang_meta[gang_num];
 
     pg_index_in_gang = ssd_gang_index(blk, s);
 
     // assuming: stripping within the gang, across all its elements
-    elem_num = (gang_num)*s->params.elements_per_gang + page%s->params.elements_per_gang;
-    j = (page % s->params.elements_per_gang) * s->data_pages_per_elem + pg_index_in_gang;
+    elem_num = (gang_num)*s->params.elements_per_gang + (int) (page % s->params.elements_per_gang);
+    j = (int) (page % s->params.elements_per_gang) * s->data_pages_per_elem + pg_index_in_gang;
 
     ASSERT(elem_num == (int)gm->pg2elem[j].e);
     ASSERT((elem_num >= (gang_num)*s->params.elements_per_gang) && (elem_num < (gang_num+1)*s->params.elements_per_gang));
@@ -181,7 +181,7 @@ int choose_elem_in_gang(int blk, int gang_num, ssd_t *s)
     return elem_num;
 }
 
-void choose_gang_and_element(int blk, ioreq_event *req, ssd_t *s, int *gang_num, int *elem_num)
+void choose_gang_and_element(disksim_lbn_t blk, ioreq_event *req, ssd_t *s, int *gang_num, int *elem_num)
 {
     int gnum = choose_gang(blk, s);
     int e = choose_elem_in_gang(blk, gnum, s);
@@ -191,11 +191,11 @@ void choose_gang_and_element(int blk, ioreq_event *req, ssd_t *s, int *gang_num,
     return;
 }
 
-double ssd_gang_read_sync(int gang_num, int blkno, int count, ssd_t *s)
+double ssd_gang_read_sync(int gang_num, disksim_lbn_t blkno, int count, ssd_t *s)
 {
     gang_metadata *g;
     double req_time = 0;
-    int blk;
+    disksim_lbn_t blk;
     int gindex;
 
     g = &s->gang_meta[gang_num];
@@ -287,7 +287,7 @@ static void ssd_activate_gang_sync(int gang_num, ssd_t *s)
             // add an event for request completion
             req->time = simtime + req_time;
             req->type = DEVICE_ACCESS_COMPLETE;
-            req->ssd_gang_num = gang_num;
+            req->dev.ssd.gang_num = gang_num;
             addtointq ((event *)req);
             //printf("Gang %d blk %d end %f\n", gang_num, req->blkno, req->time);
         } else {
@@ -299,7 +299,8 @@ static void ssd_activate_gang_sync(int gang_num, ssd_t *s)
 
             double read_time = 0;
             double xfer_time = 0;
-            int count, blk, pg, start_pg;
+            int count;
+            disksim_lbn_t blk, pg, start_pg;
             int gindex;
             int wrote_summary = 0;
             ssd_req *elem_req[1];
@@ -337,7 +338,7 @@ static void ssd_activate_gang_sync(int gang_num, ssd_t *s)
             }
 
             // we need to issue a new write request, so allocate
-            elem_req[0] = malloc(sizeof(ssd_req));
+            elem_req[0] = disksim_pool_get(DISKSIM_POOL_SSDREQ, sizeof(ssd_req));
             memset(elem_req[0], 0, sizeof(ssd_req));
 
             blk = start_pg * s->params.page_size;
@@ -391,11 +392,11 @@ static void ssd_activate_gang_sync(int gang_num, ssd_t *s)
             // add an event for request completion
             req->time = simtime + req_time;
             req->type = DEVICE_ACCESS_COMPLETE;
-            req->ssd_gang_num = gang_num;
+            req->dev.ssd.gang_num = gang_num;
             addtointq ((event *)req);
 
             // free
-            free(elem_req[0]);
+            disksim_pool_put(elem_req[0]);
         }
 
         // we've processed one request from the queue
@@ -414,7 +415,7 @@ static void _ssd_activate_gang
         return;
     }
 
-    first = (ssd_req ***) malloc (s->params.elements_per_gang * sizeof(ssd_req **));
+    first = (ssd_req ***) disksim_pool_get(DISKSIM_POOL_SSDREQ, s->params.elements_per_gang * sizeof(ssd_req **));
     for (i = 0; i < s->params.elements_per_gang; i ++) {
         first[i] = &reqs_queue[i][0];
     }
@@ -454,8 +455,8 @@ static void _ssd_activate_gang
                 stat_update (&s->stat.acctimestats, reqs_queue[i][0]->acctime);
                 reqs_queue[i][0]->org_req->time = simtime + after + reqs_queue[i][0]->acctime;
                 reqs_queue[i][0]->org_req->type = DEVICE_ACCESS_COMPLETE;
-                reqs_queue[i][0]->org_req->ssd_elem_num = elem_num;
-                reqs_queue[i][0]->org_req->ssd_gang_num = gang_num;
+                reqs_queue[i][0]->org_req->dev.ssd.elem_num = elem_num;
+                reqs_queue[i][0]->org_req->dev.ssd.gang_num = gang_num;
 
                 addtointq ((event *)reqs_queue[i][0]->org_req);
                 //printf("Adding gang %d blk %d time %f\n",
@@ -464,7 +465,7 @@ static void _ssd_activate_gang
 
                 // go to the next request in this element
                 reqs_queue[i] = &reqs_queue[i][1];
-                free(to_free);
+                disksim_pool_put(to_free);
 
                 reqs_issued ++;
 
@@ -495,7 +496,7 @@ static void _ssd_activate_gang
         reqs_queue[i] = first[i];
     }
 
-    free(first);
+    disksim_pool_put(first);
 }
 
 /*
@@ -537,11 +538,11 @@ static void ssd_activate_gang(ssd_t *s, int gang_num)
         }
 
         // allocate
-        rd_q = (ssd_req ***) malloc(s->params.elements_per_gang * sizeof (ssd_req **));
-        wr_q = (ssd_req ***) malloc(s->params.elements_per_gang * sizeof (ssd_req **));
+        rd_q = (ssd_req ***) disksim_pool_get(DISKSIM_POOL_SSDREQ, s->params.elements_per_gang * sizeof (ssd_req **));
+        wr_q = (ssd_req ***) disksim_pool_get(DISKSIM_POOL_SSDREQ, s->params.elements_per_gang * sizeof (ssd_req **));
         for (i = 0; i < s->params.elements_per_gang; i ++) {
-            rd_q[i] = malloc(MAX_REQS * sizeof(ssd_req *));
-            wr_q[i] = malloc(MAX_REQS * sizeof(ssd_req *));
+            rd_q[i] = disksim_pool_get(DISKSIM_POOL_SSDREQ, MAX_REQS * sizeof(ssd_req *));
+            wr_q[i] = disksim_pool_get(DISKSIM_POOL_SSDREQ, MAX_REQS * sizeof(ssd_req *));
             memset(rd_q[i], 0, MAX_REQS * sizeof(ssd_req *));
             memset(wr_q[i], 0, MAX_REQS * sizeof(ssd_req *));
         }
@@ -557,11 +558,11 @@ static void ssd_activate_gang(ssd_t *s, int gang_num)
 
         // free
         for (i = 0; i < s->params.elements_per_gang; i ++) {
-            free(rd_q[i]);
-            free(wr_q[i]);
+            disksim_pool_put(rd_q[i]);
+            disksim_pool_put(wr_q[i]);
         }
-        free(rd_q);
-        free(wr_q);
+        disksim_pool_put(rd_q);
+        disksim_pool_put(wr_q);
     }
 }
 
@@ -570,7 +571,7 @@ void ssd_media_access_request_gang_sync(ioreq_event *curr)
     int i;
     int gang_to_activate[SSD_MAX_ELEMENTS];
     ssd_t *currdisk = getssd(curr->devno);
-    int blkno = curr->blkno;
+    disksim_lbn_t blkno = curr->blkno;
     int count = curr->bcount;
 
     memset(gang_to_activate, 0, SSD_MAX_ELEMENTS * sizeof(int));
@@ -579,10 +580,12 @@ void ssd_media_access_request_gang_sync(ioreq_event *curr)
     curr->tempint2 = count;
     while (count != 0) {
         int gang_num;
+        disksim_lbn_t mapped;
         ioreq_event *tmp;
         gang_metadata *g;
 
-        gang_num = choose_gang(blkno, currdisk);
+        mapped = ssd_sample_blkno(currdisk, blkno);
+        gang_num = choose_gang(mapped, currdisk);
         g = &currdisk->gang_meta[gang_num];
 
         // this gang must be activated
@@ -593,7 +596,7 @@ void ssd_media_access_request_gang_sync(ioreq_event *curr)
         tmp->devno = curr->devno;
         tmp->busno = curr->busno;
         tmp->flags = curr->flags;
-        tmp->blkno = blkno;
+        tmp->blkno = mapped;
         tmp->tempptr2 = curr;
         tmp->bcount = ssd_choose_aligned_count(SSD_GANG_PAGE_SIZE(currdisk), blkno, count);
         ASSERT(tmp->bcount <= SSD_GANG_PAGE_SIZE(currdisk));
@@ -626,7 +629,7 @@ void ssd_media_access_request_gang (ioreq_event *curr)
     int i;
     int gang_to_activate[SSD_MAX_ELEMENTS];
     ssd_t *currdisk = getssd(curr->devno);
-    int blkno = curr->blkno;
+    disksim_lbn_t blkno = curr->blkno;
     int count = curr->bcount;
 
    memset(gang_to_activate, 0, SSD_MAX_ELEMENTS * sizeof(int));
@@ -636,12 +639,14 @@ void ssd_media_access_request_gang (ioreq_event *curr)
    while (count != 0) {
         int gang_num;
         int elem_num;
+        disksim_lbn_t mapped;
         ssd_element *elem;
         ioreq_event *tmp;
         gang_metadata *g;
 
        // find the gang to direct the request
-        choose_gang_and_element(blkno, curr, currdisk, &gang_num, &elem_num);
+        mapped = ssd_sample_blkno(currdisk, blkno);
+        choose_gang_and_element(mapped, curr, currdisk, &gang_num, &elem_num);
 
         // this gang must be activated
         gang_to_activate[gang_num] = 1;
@@ -654,7 +659,7 @@ void ssd_media_access_request_gang (ioreq_event *curr)
        tmp->devno = curr->devno;
        tmp->busno = curr->busno;
        tmp->flags = curr->flags;
-       tmp->blkno = blkno;
+       tmp->blkno = mapped;
        tmp->bcount = ssd_choose_aligned_count(currdisk->params.page_size, blkno, count);
        ASSERT(tmp->bcount == currdisk->params.page_size);
 
@@ -692,7 +697,7 @@ void ssd_clean_gang_complete(ioreq_event *curr)
    int gang_num;
 
    currdisk = getssd (curr->devno);
-   gang_num = curr->ssd_gang_num;
+   gang_num = curr->dev.ssd.gang_num;
 
    ASSERT(currdisk->gang_meta[gang_num].busy == TRUE);
    ASSERT(currdisk->gang_meta[gang_num].cleaning == TRUE);
@@ -724,7 +729,7 @@ void ssd_access_complete_gang_sync(ioreq_event *curr)
     gang_metadata *gm;
 
     currdisk = getssd (curr->devno);
-    gang_num = curr->ssd_gang_num;
+    gang_num = curr->dev.ssd.gang_num;
     gm = &currdisk->gang_meta[gang_num];
 
     if (ioqueue_physical_access_done(gm->queue,curr) == NULL) {
@@ -756,9 +761,9 @@ void ssd_access_complete_gang (ioreq_event *curr)
    // fprintf (outputfile, "Entering ssd_access_complete: %12.6f\n", simtime);
 
    currdisk = getssd (curr->devno);
-   elem_num = curr->ssd_elem_num;
+   elem_num = curr->dev.ssd.elem_num;
    elem = &currdisk->elements[elem_num];
-   gang_num = curr->ssd_gang_num;
+   gang_num = curr->dev.ssd.gang_num;
    ASSERT(gang_num == elem->metadata.gang_num);
 
    if ((x = ioqueue_physical_access_done(elem->queue,curr)) == NULL) {
@@ -421,6 +421,50 @@ void ssd_verify_parameters(ssd_t *currdisk)
     }
 }
 
+/*
+ * with a sampled trace, shrinks every plane to the sample rate's share of
+ * its blocks so that the flash fills up (and gets cleaned) about as
+ * often as the full-size device would under the full trace. the sampled
+ * requests are spread over the whole logical space, so ssd_sample_blkno
+ * packs the units they touch into the smaller flash in first-touch order.
+ * numblocks keeps the full capacity the host sees.
+ */
+void ssd_sample_init(ssd_t *currdisk)
+{
+    unsigned int bpp = currdisk->params.blocks_per_plane;
+    unsigned int scaled;
+    unsigned int size;
+
+    scaled = (unsigned int) ceil(bpp * disksim->tracesample);
+    if (scaled < SSD_SAMPLE_MIN_BLOCKS) {
+        scaled = SSD_SAMPLE_MIN_BLOCKS;
+    }
+    if (scaled > bpp) {
+        scaled = bpp;
+    }
+    currdisk->params.blocks_per_plane = scaled;
+    currdisk->params.blocks_per_element = scaled * currdisk->params.planes_per_pkg;
+
+#if SYNC_GANG
+    if (currdisk->params.alloc_pool_logic == SSD_ALLOC_POOL_GANG) {
+        currdisk->sampleunit = SSD_GANG_PAGE_SIZE(currdisk);
+    } else
+#endif
+    {
+        currdisk->sampleunit = currdisk->params.page_size;
+    }
+    currdisk->samplecap = (int) (((disksim_lbn_t) currdisk->params.nelements *
+                          ssd_elem_export_size(currdisk) *
+                          currdisk->params.page_size) / currdisk->sampleunit);
+    currdisk->samplenext = 0;
+
+    for (size = 1; size < (2 * (unsigned int) currdisk->samplecap); size <<= 1);
+    currdisk->samplemask = size - 1;
+    currdisk->samplekey = calloc(size, sizeof(disksim_lbn_t));
+    currdisk->sampleval = calloc(size, sizeof(int));
+    ASSERT((currdisk->samplekey != NULL) && (currdisk->sampleval != NULL));
+}
+
 void ssd_alloc_queues(ssd_t *t)
 {
    // gross hack !!!!!
@@ -471,10 +515,13 @@ fprintf (outputfile, "Entered ssd_initialize - numssds %d\n", numssds);
 
       if (!currdisk) continue;
 /*        if (!currdisk->inited) { */
-         currdisk->numblocks = currdisk->params.nelements *
+         currdisk->numblocks = (disksim_lbn_t) currdisk->params.nelements *
                    currdisk->params.blocks_per_element *
                    currdisk->params.pages_per_block *
                    currdisk->params.page_size;
+         if (TRACE_SAMPLED && (currdisk->samplekey == NULL)) {
+             ssd_sample_init(currdisk);
+         }
          currdisk->reconnect_reason = -1;
          addlisttoextraq ((event **) &currdisk->buswait);
          currdisk->busowned = -1;
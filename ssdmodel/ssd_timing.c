@@ -14,15 +14,15 @@ struct my_timing_t {
     int next_write_page[SSD_MAX_ELEMENTS];
 };
 
-int ssd_choose_element(ssd_timing_t *t, int blkno)
+int ssd_choose_element(ssd_timing_t *t, disksim_lbn_t blkno)
 {
     struct my_timing_t *tt = (struct my_timing_t *) t;
-    return (blkno/(tt->params->element_stride_pages*tt->params->page_size)) % tt->params->nelements;
+    return (int) ((blkno/(tt->params->element_stride_pages*tt->params->page_size)) % tt->params->nelements);
 }
 
-int ssd_choose_aligned_count(int page_size, int blkno, int count)
+int ssd_choose_aligned_count(int page_size, disksim_lbn_t blkno, int count)
 {
-    int res = page_size - (blkno % page_size);
+    int res = page_size - (int) (blkno % page_size);
     if (res > count)
         res = count;
     return res;
@@ -35,7 +35,7 @@ int ssd_choose_aligned_count(int page_size, int blkno, int count)
 /*
  * implements the simple write policy wrote by ted.
  */
-static double ssd_write_policy_simple(int blkno, int count, int elem_num, ssd_t *s)
+static double ssd_write_policy_simple(disksim_lbn_t blkno, int count, int elem_num, ssd_t *s)
 {
     double cost;
     int pages_moved;        // for statistics
@@ -49,9 +49,9 @@ static double ssd_write_policy_simple(int blkno, int count, int elem_num, ssd_t
     int blockpos, lastpos;
     int ppb = tt->params->pages_per_block;
     int last_pn = tt->next_write_page[elem_num];
-    int apn = blkno/tt->params->page_size;
-    int pn = ((apn - (apn % (tt->params->element_stride_pages*tt->params->nelements)))/
-                      tt->params->nelements) + (apn % tt->params->element_stride_pages);
+    disksim_lbn_t apn = blkno/tt->params->page_size;
+    int pn = (int) (((apn - (apn % (tt->params->element_stride_pages*tt->params->nelements)))/
+                      tt->params->nelements) + (apn % tt->params->element_stride_pages));
 
     blockpos = pn % ppb;
     lastpos = last_pn % ppb;
@@ -486,7 +486,7 @@ listnode **ssd_pick_parunits(ssd_req **reqs, int total, int elem_num, ssd_elemen
 
     // parunits is an array of linked list structures, where
     // each entry in the array corresponds to one parallel unit
-    parunits = (listnode **)malloc(SSD_PARUNITS_PER_ELEM(s) * sizeof(listnode *));
+    parunits = (listnode **)disksim_pool_get(DISKSIM_POOL_SSDLIST, SSD_PARUNITS_PER_ELEM(s) * sizeof(listnode *));
     for (i = 0; i < SSD_PARUNITS_PER_ELEM(s); i ++) {
         ll_create(&parunits[i]);
     }
@@ -739,12 +739,12 @@ static double ssd_issue_overlapped_ios(ssd_req **reqs, int total, int elem_num,
     for (i = 0; i < SSD_PARUNITS_PER_ELEM(s); i ++) {
         ll_release(parunits[i]);
     }
-    free(parunits);
+    disksim_pool_put(parunits);
 
     return max_cost;
 }
 
-static double ssd_write_one_active_page(int blkno, int count, int elem_num, ssd_t *s)
+static double ssd_write_one_active_page(disksim_lbn_t blkno, int count, int elem_num, ssd_t *s)
 {
     double cost = 0;
     int cleaning_invoked = 0;
@@ -806,7 +806,7 @@ static void ssd_compute_access_time_one_active_page
 {
     // we assume that requests have been broken down into page sized chunks
     double cost;
-    int blkno;
+    disksim_lbn_t blkno;
     int count;
     int is_read;
 
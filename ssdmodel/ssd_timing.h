@@ -5,7 +5,7 @@
 #define DISKSIM_SSD_TIMING_H
 
 typedef struct _ssd_timing_t {
-    int     (*choose_element)(struct _ssd_timing_t *t, int blkno);
+    int     (*choose_element)(struct _ssd_timing_t *t, disksim_lbn_t blkno);
     void    (*free)(struct _ssd_timing_t *t);
 } ssd_timing_t;
 
@@ -19,7 +19,7 @@ typedef struct _ssd_timing_t {
 
 // get a timing object ... params pointer is valid for lifetime of element
 ssd_timing_t   *ssd_new_timing_t(ssd_timing_params *params);
-int ssd_choose_aligned_count(int page_size, int blkno, int count);
+int ssd_choose_aligned_count(int page_size, disksim_lbn_t blkno, int count);
 void ssd_compute_access_time(ssd_t *s, int elem_num, ssd_req **reqs, int total);
 
 #endif
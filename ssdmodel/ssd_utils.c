@@ -73,17 +73,17 @@ int ssd_find_zero_bit(unsigned char *c, int total, int start)
 
 void ll_create(listnode **start)
 {
-    *start = (listnode *)malloc(sizeof(listnode));
+    *start = (listnode *)disksim_pool_get(DISKSIM_POOL_SSDLIST, sizeof(listnode));
     memset(*start, 0, sizeof(listnode));
 
-    (*start)->data = (header_data *)malloc(sizeof(header_data));
+    (*start)->data = (header_data *)disksim_pool_get(DISKSIM_POOL_SSDLIST, sizeof(header_data));
     ((header_data *)(*start)->data)->size = 0;
 }
 
 // Free all the nodes in the list.
 void ll_release(listnode *start)
 {
-    free(start->data);
+    disksim_pool_put(start->data);
 
     while (start) {
         listnode *next = start->next;
@@ -104,7 +104,7 @@ void ll_release(listnode *start)
          * data that is contained in the node. that is the
          * responsibility of the function that is using
          * this linked list */
-        free(start);
+        disksim_pool_put(start);
 
         start = next;
     }
@@ -166,7 +166,7 @@ listnode *_ll_insert_at_head(listnode *start, listnode *toinsert)
 listnode *ll_insert_at_tail(listnode *start, void *data)
 {
     /* allocate a new node */
-    listnode *newnode = malloc(sizeof(listnode));
+    listnode *newnode = disksim_pool_get(DISKSIM_POOL_SSDLIST, sizeof(listnode));
     newnode->data = data;
 
     /* increment the number of entries */
@@ -181,7 +181,7 @@ listnode *ll_insert_at_tail(listnode *start, void *data)
 listnode *ll_insert_at_head(listnode *start, void *data)
 {
     /* allocate a new node */
-    listnode *newnode = malloc(sizeof(listnode));
+    listnode *newnode = disksim_pool_get(DISKSIM_POOL_SSDLIST, sizeof(listnode));
     newnode->data = data;
 
     /* increment the number of entries */
@@ -226,7 +226,7 @@ void ll_release_node(listnode *start, listnode *node)
          * data that is contained in the node. that is the
          * responsibility of the function that is using
          * this linked list */
-        free(node);
+        disksim_pool_put(node);
     }
 }
 